@@ -0,0 +1,1237 @@
+/**
+* @file bench.c
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Native benchmark harness of the CPU, built without Python by
+* `python setup.py bench`.
+*
+* Every ROM of the corpus (the synthetic ROMs below, plus the ROM files given on the
+* command line) is run on every engine for a fixed number of instructions, and the
+* reset and snapshot latencies are measured. The results are written as JSON:
+*
+*         {
+*             "version": 1, "cycles": int, "repeat": int, "stats": bool,
+*             "roms": [{
+*                 "name": str, "path": str | null, "size": int,
+*                 "reset_ns": float, "snapshot_ns": float, "snapshot_full_ns": float,
+*                 "restore_ns": float,
+*                 "engines": {
+*                     "<engine>": {
+*                         "cycles": int, "seconds": float, "mips": float,
+*                         "ns_per_instruc": float, "draws": int, "draws_per_s": float,
+*                         "errors": int
+*                     }, ...
+*                 }
+*             }, ...],
+*             "verify": {"frames": int, "random": int, "failures": int} | null,
+*             "totals": {"<engine>": float, ...}
+*         }
+*
+* The engines are `decode` (`snek8_cpuStep` decoding every opcode), `reference` (the
+* dispatch table of `snek8_cpuRun`), `threaded`, `block` and `batch` (the lanes of a
+* `Snek8Batch`, which is verified but not benchmarked). `draws` counts the screen
+* writes, i.e. the DRW and CLS instructions. The timings are the best of
+* `repeat` runs, and `totals` holds the MIPS of every engine over the whole corpus.
+*
+* With `--verify`, every ROM is first traced on every engine against `snek8_cpuStep`,
+* under every combination of implementation flags, along with random opcode streams:
+* the hashes of both states are compared after every frame, and any divergence is
+* reported and fails the run. The `fx55`, `fx65` and `fx33` ROMs, which are verified
+* but not benchmarked, also check the state every engine ends in against the semantics
+* of these instructions (about 200 frames are needed for them to finish). The `idle`
+* ROMs, verified too, spin in idle loops for a few runs of millions of instructions
+* each, frame by frame at `SNEK8_CPU_MAX_IPS` and `SNEK8_BENCH_IDLE_CYCLES` at a time
+* at the default rate, and every run of an engine must return within
+* `SNEK8_BENCH_TIMEOUT` seconds. With
+* `--baseline`, the run also fails when the total MIPS of an engine fell short of a
+* baseline saved by an earlier run, so that the harness gates both the correctness and
+* the speed of the engines.
+*/
+#ifndef SNEK8_BENCH_C
+    #define SNEK8_BENCH_C
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#ifndef _WIN32
+    #define _POSIX_C_SOURCE 200809L
+#endif
+#include <stdlib.h>
+#include <signal.h>
+#include <time.h>
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+#include "cpu.h"
+#include "block.h"
+#include "batch.h"
+#include "rom.h"
+
+#ifdef TIME_MONOTONIC
+    #define SNEK8_BENCH_CLOCK           TIME_MONOTONIC
+#else
+    #define SNEK8_BENCH_CLOCK           TIME_UTC
+#endif
+
+/**
+* @def SNEK8_BENCH_CHUNK
+* @brief The number of instructions executed by each call to an engine.
+*/
+#define SNEK8_BENCH_CHUNK               (1u << 20)
+
+/**
+* @def SNEK8_BENCH_LATENCY_ROUNDS
+* @brief The number of resets, snapshots and restores timed per ROM.
+*/
+#define SNEK8_BENCH_LATENCY_ROUNDS      20000
+
+/**
+* @def SNEK8_BENCH_SEED
+* @brief The seed of the CPUs' random number generator, so runs are reproducible.
+*/
+#define SNEK8_BENCH_SEED                0x5EED
+
+/**
+* @def SNEK8_BENCH_RANDOM_SIZE
+* @brief The size of the random opcode streams, in bytes.
+*/
+#define SNEK8_BENCH_RANDOM_SIZE         512
+
+/**
+* @def SNEK8_BENCH_LANES
+* @brief The number of lanes of the batch behind the `batch` engine.
+*/
+#define SNEK8_BENCH_LANES               4
+
+/**
+* @def SNEK8_BENCH_IDLE_CYCLES
+* @brief The instructions of every run of the idle ROMs at the default rate, past the
+* instructions the block engine chains at most between two clock updates.
+*/
+#define SNEK8_BENCH_IDLE_CYCLES         (3u << 20)
+
+/**
+* @def SNEK8_BENCH_IDLE_RUNS
+* @brief The number of runs the idle ROMs are verified for, at each rate.
+*/
+#define SNEK8_BENCH_IDLE_RUNS           2
+
+/**
+* @def SNEK8_BENCH_TIMEOUT
+* @brief The seconds a single run of an engine may take while verified before the
+* harness gives up on it as hung (not enforced on Windows).
+*/
+#define SNEK8_BENCH_TIMEOUT             30
+
+/**
+* @brief Checks the state a CPU reached by running a ROM against the behaviour of the
+* instructions it tests.
+*
+* @return NULL if the state is the expected one, or what is wrong with it.
+*/
+typedef const char* (*Snek8BenchCheck)(const Snek8CPU* cpu);
+
+/**
+* @brief A ROM of the corpus.
+*
+* @param `name`.
+* @param `path` The file it was read from, or NULL for the synthetic ROMs.
+* @param `size` The size of the ROM in bytes.
+* @param `data` The ROM.
+* @param `check` Checks the state of every engine at the end of `--verify`'s traces,
+*        or NULL.
+*/
+typedef struct{
+    const char* name;
+    const char* path;
+    size_t size;
+    const uint8_t* data;
+    Snek8BenchCheck check;
+} Snek8BenchRom;
+
+/**
+* @brief An engine being benchmarked.
+*
+* @param `name`.
+* @param `run`.
+* @param `blocks` Whether the engine needs a block cache.
+* @param `faster` Whether the engine is meant to outrun `reference`: the ROMs it runs
+*        slower are reported.
+* @param `timed` Whether the engine is benchmarked, besides being verified.
+*/
+typedef struct{
+    const char* name;
+    Snek8RunEngine run;
+    bool blocks;
+    bool faster;
+    bool timed;
+} Snek8BenchEngine;
+
+/**
+* @brief The measures of a ROM on an engine.
+*/
+typedef struct{
+    uint64_t cycles;
+    double seconds;
+    uint64_t draws;
+    uint64_t errors;
+} Snek8BenchResult;
+
+/*
+* Synthetic ROMs, each an endless loop stressing one kind of instruction.
+*/
+
+/// Arithmetic and logic on registers.
+static const uint8_t _snek8_bench_alu[] = {
+    0x60, 0x01,     // 0x200 LD V0, 0x01
+    0x61, 0x03,     // 0x202 LD V1, 0x03
+    0x70, 0x01,     // 0x204 ADD V0, 0x01
+    0x80, 0x14,     // 0x206 ADD V0, V1
+    0x81, 0x05,     // 0x208 SUB V1, V0
+    0x82, 0x02,     // 0x20A AND V2, V0
+    0x83, 0x13,     // 0x20C XOR V3, V1
+    0x84, 0x16,     // 0x20E SHR V4, V1
+    0x85, 0x1E,     // 0x210 SHL V5, V1
+    0x80, 0x21,     // 0x212 OR V0, V2
+    0x12, 0x04,     // 0x214 JP 0x204
+};
+
+/// Sprites drawn all over the screen.
+static const uint8_t _snek8_bench_draw[] = {
+    0x60, 0x00,     // 0x200 LD V0, 0x00
+    0x61, 0x00,     // 0x202 LD V1, 0x00
+    0x62, 0x00,     // 0x204 LD V2, 0x00
+    0x63, 0x0F,     // 0x206 LD V3, 0x0F
+    0xF2, 0x29,     // 0x208 LD F, V2
+    0xD0, 0x15,     // 0x20A DRW V0, V1, 5
+    0x70, 0x05,     // 0x20C ADD V0, 0x05
+    0x71, 0x03,     // 0x20E ADD V1, 0x03
+    0x72, 0x01,     // 0x210 ADD V2, 0x01
+    0x82, 0x32,     // 0x212 AND V2, V3
+    0x12, 0x08,     // 0x214 JP 0x208
+};
+
+/// Skips, calls and returns.
+static const uint8_t _snek8_bench_branch[] = {
+    0x60, 0x00,     // 0x200 LD V0, 0x00
+    0x22, 0x10,     // 0x202 CALL 0x210
+    0x30, 0x00,     // 0x204 SE V0, 0x00
+    0x70, 0x01,     // 0x206 ADD V0, 0x01
+    0x40, 0x05,     // 0x208 SNE V0, 0x05
+    0x60, 0x00,     // 0x20A LD V0, 0x00
+    0x12, 0x02,     // 0x20C JP 0x202
+    0x00, 0x00,     // 0x20E
+    0x71, 0x01,     // 0x210 ADD V1, 0x01
+    0x00, 0xEE,     // 0x212 RET
+};
+
+/// Transfers between the registers and the memory.
+static const uint8_t _snek8_bench_memory[] = {
+    0xA3, 0x00,     // 0x200 LD I, 0x300
+    0xF5, 0x33,     // 0x202 LD B, V5
+    0xF7, 0x55,     // 0x204 LD [I], V7
+    0xF7, 0x65,     // 0x206 LD V7, [I]
+    0x75, 0x11,     // 0x208 ADD V5, 0x11
+    0xA3, 0x00,     // 0x20A LD I, 0x300
+    0x12, 0x02,     // 0x20C JP 0x202
+};
+
+/// Random numbers, timers and skips.
+static const uint8_t _snek8_bench_mixed[] = {
+    0xC0, 0xFF,     // 0x200 RND V0, 0xFF
+    0xF0, 0x15,     // 0x202 LD DT, V0
+    0xF1, 0x07,     // 0x204 LD V1, DT
+    0x80, 0x14,     // 0x206 ADD V0, V1
+    0x30, 0x00,     // 0x208 SE V0, 0x00
+    0x71, 0x01,     // 0x20A ADD V1, 0x01
+    0x12, 0x00,     // 0x20C JP 0x200
+};
+
+/// Transfers that reach the end of the memory, leaving I past it if they increment it.
+static const uint8_t _snek8_bench_index[] = {
+    0xAF, 0xF8,     // 0x200 LD I, 0xFF8
+    0xF7, 0x55,     // 0x202 LD [I], V7
+    0x70, 0x01,     // 0x204 ADD V0, 0x01
+    0xAF, 0xF8,     // 0x206 LD I, 0xFF8
+    0xF7, 0x65,     // 0x208 LD V7, [I]
+    0x71, 0x01,     // 0x20A ADD V1, 0x01
+    0x12, 0x00,     // 0x20C JP 0x200
+};
+
+/// Indexed jumps, landing on either path: V0 picks the first, V2 (BNNN_USES_VX) the second.
+/// The other targets are invalid opcodes.
+static const uint8_t _snek8_bench_jump[] = {
+    0x60, 0x04,     // 0x200 LD V0, 0x04
+    0x62, 0x08,     // 0x202 LD V2, 0x08
+    0xB2, 0x0A,     // 0x204 JP V0, 0x20A
+    0x00, 0x00,     // 0x206
+    0x00, 0x00,     // 0x208
+    0x00, 0x00,     // 0x20A
+    0x00, 0x00,     // 0x20C
+    0x71, 0x01,     // 0x20E ADD V1, 0x01
+    0x12, 0x04,     // 0x210 JP 0x204
+    0x73, 0x01,     // 0x212 ADD V3, 0x01
+    0x12, 0x04,     // 0x214 JP 0x204
+};
+
+/**
+* @brief Whether the indexed jumps took the path of the implementation flags.
+*/
+static const char*
+_snek8_benchCheckJump(const Snek8CPU* cpu){
+    bool uses_vx = cpu->implm_flags & SNEK8_IMPLM_MODE_BNNN_USES_VX;
+    if (!cpu->registers[uses_vx? 0x3: 0x1] || cpu->registers[uses_vx? 0x1: 0x3]){
+        return uses_vx? "JP V0, 0x20A did not jump to 0x20A + V2": "JP V0, 0x20A did not jump to 0x20A + V0";
+    }
+    return NULL;
+}
+
+/**
+* @def SNEK8_BENCH_STORE_AT
+* @brief Where the `fx55` ROM stores the registers of its `k`-th transfer.
+*
+* @def SNEK8_BENCH_LOAD_AT
+* @brief Where the `fx65` ROM dumps the registers loaded by its `k`-th transfer.
+*
+* @def SNEK8_BENCH_BCD_AT
+* @brief Where the `fx33` ROM writes the digits of every value.
+*/
+#define SNEK8_BENCH_STORE_AT(k)         (0x600u + 0x20u * (k))
+#define SNEK8_BENCH_LOAD_AT(k)          (0x680u + 0x20u * (k))
+#define SNEK8_BENCH_BCD_AT              0x800u
+
+/// The registers moved by the transfers of the `fx55` and `fx65` ROMs, whose edges are
+/// the edges of the overlapping moves of `snek8_cpuCopyRegisters`.
+static const uint8_t _snek8_bench_moves[] = {0x0, 0x7, 0x8, 0xF};
+
+/// LD [I], V{x}, with V0 = 0x10, then LD [I], V0 with V0 = 0xEE: the second store lands
+/// past VX in the memory if the first one incremented I, and over V0 otherwise.
+#define SNEK8_BENCH_STORE(x, k)                                                     \
+    0x60, 0x10,                                                 /* LD V0, 0x10 */   \
+    0xA0 | (SNEK8_BENCH_STORE_AT(k) >> 8), SNEK8_BENCH_STORE_AT(k) & 0xFFu,         \
+    0xF0 | (x), 0x55,                                           /* LD [I], V{x} */  \
+    0x60, 0xEE,                                                 /* LD V0, 0xEE */   \
+    0xF0, 0x55                                                  /* LD [I], V0 */
+
+/// Stores of every edge case of the moves, over registers set to 0x10 + i.
+static const uint8_t _snek8_bench_fx55[] = {
+    0xA2, 0x2E,     // 0x200 LD I, 0x22E
+    0xFF, 0x65,     // 0x202 LD VF, [I]
+    SNEK8_BENCH_STORE(0x0, 0),
+    SNEK8_BENCH_STORE(0x7, 1),
+    SNEK8_BENCH_STORE(0x8, 2),
+    SNEK8_BENCH_STORE(0xF, 3),
+    0x12, 0x2C,     // 0x22C JP 0x22C
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F,
+};
+
+/// LD V{x}, [I] from the table 0xA0, 0xA1... over registers set to 0x55, then LD V0, [I]:
+/// V0 is loaded past VX in the table if the first load incremented I, and again from its
+/// start otherwise. Every register is then stored for the check.
+#define SNEK8_BENCH_LOAD(x, k)                                                      \
+    0xA2, 0x3A,                                                 /* LD I, 0x23A */   \
+    0xFF, 0x65,                                                 /* LD VF, [I] */    \
+    0xA2, 0x4A,                                                 /* LD I, 0x24A */   \
+    0xF0 | (x), 0x65,                                           /* LD V{x}, [I] */  \
+    0xF0, 0x65,                                                 /* LD V0, [I] */    \
+    0xA0 | (SNEK8_BENCH_LOAD_AT(k) >> 8), SNEK8_BENCH_LOAD_AT(k) & 0xFFu,           \
+    0xFF, 0x55                                                  /* LD [I], VF */
+
+/// Loads of every edge case of the moves.
+static const uint8_t _snek8_bench_fx65[] = {
+    SNEK8_BENCH_LOAD(0x0, 0),
+    SNEK8_BENCH_LOAD(0x7, 1),
+    SNEK8_BENCH_LOAD(0x8, 2),
+    SNEK8_BENCH_LOAD(0xF, 3),
+    0x12, 0x38,     // 0x238 JP 0x238
+    0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+    0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55,
+    0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7,
+    0xA8, 0xA9, 0xAA, 0xAB, 0xAC, 0xAD, 0xAE, 0xAF, 0xB0,
+};
+
+/// The digits of every value of V0, three bytes apart from 0x800 on: v at 0x800 + 3v.
+static const uint8_t _snek8_bench_fx33[] = {
+    0x60, 0x00,     // 0x200 LD V0, 0x00
+    0xA8, 0x00,     // 0x202 LD I, 0x800
+    0xF0, 0x1E,     // 0x204 ADD I, V0
+    0xF0, 0x1E,     // 0x206 ADD I, V0
+    0xF0, 0x1E,     // 0x208 ADD I, V0
+    0xF0, 0x33,     // 0x20A LD B, V0
+    0x70, 0x01,     // 0x20C ADD V0, 0x01
+    0x30, 0x00,     // 0x20E SE V0, 0x00
+    0x12, 0x02,     // 0x210 JP 0x202
+    0x12, 0x12,     // 0x212 JP 0x212
+};
+
+/// A wait for a key pressed, polled.
+static const uint8_t _snek8_bench_idle_key[] = {
+    0xE0, 0x9E,     // 0x200 SKP V0
+    0x12, 0x00,     // 0x202 JP 0x200
+    0x71, 0x01,     // 0x204 ADD V1, 0x01
+    0x12, 0x00,     // 0x206 JP 0x200
+};
+
+/// A wait for the delay timer to run out, started over whenever it does.
+static const uint8_t _snek8_bench_idle_dt[] = {
+    0x60, 0x20,     // 0x200 LD V0, 0x20
+    0xF0, 0x15,     // 0x202 LD DT, V0
+    0xF1, 0x07,     // 0x204 LD V1, DT
+    0x31, 0x00,     // 0x206 SE V1, 0x00
+    0x12, 0x04,     // 0x208 JP 0x204
+    0x72, 0x01,     // 0x20A ADD V2, 0x01
+    0x12, 0x02,     // 0x20C JP 0x202
+};
+
+/// A jump to itself, past a sound.
+static const uint8_t _snek8_bench_idle_halt[] = {
+    0x60, 0xFF,     // 0x200 LD V0, 0xFF
+    0xF0, 0x18,     // 0x202 LD ST, V0
+    0x12, 0x04,     // 0x204 JP 0x204
+};
+
+/**
+* @brief Whether a CPU halted, i.e. sits on a jump to itself.
+*/
+static inline bool
+_snek8_benchHalted(const Snek8CPU* cpu){
+    uint16_t opcode = (uint16_t) ((cpu->memory[cpu->pc] << 8) | cpu->memory[cpu->pc + 1]);
+    return (0x1000u | cpu->pc) == opcode;
+}
+
+static char _snek8_bench_wrong[96];
+
+/**
+* @brief Whether the stores moved the registers and I as the implementation flags say:
+* V0 to VX land at I and nothing next to them, and I ends past VX if FX_CHANGES_I.
+*/
+static const char*
+_snek8_benchCheckStore(const Snek8CPU* cpu){
+    bool changes_i = cpu->implm_flags & SNEK8_IMPLM_MODE_FX_CHANGES_I;
+    if (!_snek8_benchHalted(cpu)){
+        return "the ROM did not halt within the frames traced";
+    }
+    for (unsigned k = 0; k < sizeof(_snek8_bench_moves); k++){
+        unsigned x = _snek8_bench_moves[k];
+        const uint8_t* at = cpu->memory + SNEK8_BENCH_STORE_AT(k);
+        bool right = !at[-1] && at[0] == (changes_i? 0x10: 0xEE) && at[x + 1] == (changes_i? 0xEE: 0x00)
+                     && !at[x + 2];
+        for (unsigned i = 1; i <= x; i++){
+            right = right && at[i] == 0x10 + i;
+        }
+        if (!right){
+            (void) snprintf(_snek8_bench_wrong, sizeof(_snek8_bench_wrong),
+                            "LD [I], V%X stores the wrong bytes at 0x%03X", x, SNEK8_BENCH_STORE_AT(k));
+            return _snek8_bench_wrong;
+        }
+    }
+    // I last held 0x660, for LD [I], VF then LD [I], V0.
+    if (cpu->ir != (changes_i? SNEK8_BENCH_STORE_AT(3) + 0x11u: SNEK8_BENCH_STORE_AT(3))){
+        (void) snprintf(_snek8_bench_wrong, sizeof(_snek8_bench_wrong), "LD [I], VX leaves I at 0x%03X",
+                        (unsigned) cpu->ir);
+        return _snek8_bench_wrong;
+    }
+    return NULL;
+}
+
+/**
+* @brief Whether the loads moved the memory and I as the implementation flags say: V0 to
+* VX are loaded from I and no other register, and I ends past VX if FX_CHANGES_I.
+*/
+static const char*
+_snek8_benchCheckLoad(const Snek8CPU* cpu){
+    bool changes_i = cpu->implm_flags & SNEK8_IMPLM_MODE_FX_CHANGES_I;
+    if (!_snek8_benchHalted(cpu)){
+        return "the ROM did not halt within the frames traced";
+    }
+    for (unsigned k = 0; k < sizeof(_snek8_bench_moves); k++){
+        unsigned x = _snek8_bench_moves[k];
+        const uint8_t* registers = cpu->memory + SNEK8_BENCH_LOAD_AT(k);
+        bool right = registers[0] == (changes_i? 0xA1 + x: 0xA0);
+        for (unsigned i = 1; i < SNEK8_SIZE_REGISTERS; i++){
+            right = right && registers[i] == ((i <= x)? 0xA0 + i: 0x55);
+        }
+        if (!right){
+            (void) snprintf(_snek8_bench_wrong, sizeof(_snek8_bench_wrong),
+                            "LD V%X, [I] loads the wrong registers (stored at 0x%03X)", x,
+                            SNEK8_BENCH_LOAD_AT(k));
+            return _snek8_bench_wrong;
+        }
+    }
+    if (cpu->ir != (changes_i? SNEK8_BENCH_LOAD_AT(3) + 0x10u: SNEK8_BENCH_LOAD_AT(3))){
+        (void) snprintf(_snek8_bench_wrong, sizeof(_snek8_bench_wrong), "LD V%X, [I] leaves I at 0x%03X",
+                        0xFu, (unsigned) cpu->ir);
+        return _snek8_bench_wrong;
+    }
+    return NULL;
+}
+
+/**
+* @brief Whether LD B, VX wrote the decimal digits of every value.
+*/
+static const char*
+_snek8_benchCheckBcd(const Snek8CPU* cpu){
+    if (!_snek8_benchHalted(cpu)){
+        return "the ROM did not halt within the frames traced";
+    }
+    for (unsigned v = 0; v < 256; v++){
+        const uint8_t* digits = cpu->memory + SNEK8_BENCH_BCD_AT + 3 * v;
+        if (digits[0] != v / 100 || digits[1] != v / 10 % 10 || digits[2] != v % 10){
+            (void) snprintf(_snek8_bench_wrong, sizeof(_snek8_bench_wrong),
+                            "LD B, VX writes %u%u%u for %u", digits[0], digits[1], digits[2], v);
+            return _snek8_bench_wrong;
+        }
+    }
+    return NULL;
+}
+
+#define SNEK8_BENCH_SYNTHETIC(rom_name, rom)                                        \
+    {.name = (rom_name), .path = NULL, .size = sizeof(rom), .data = (rom), .check = NULL}
+
+#define SNEK8_BENCH_CHECKED(rom_name, rom, rom_check)                               \
+    {.name = (rom_name), .path = NULL, .size = sizeof(rom), .data = (rom), .check = (rom_check)}
+
+static const Snek8BenchRom _snek8_bench_synthetic[] = {
+    SNEK8_BENCH_SYNTHETIC("alu", _snek8_bench_alu),
+    SNEK8_BENCH_SYNTHETIC("draw", _snek8_bench_draw),
+    SNEK8_BENCH_SYNTHETIC("branch", _snek8_bench_branch),
+    SNEK8_BENCH_SYNTHETIC("memory", _snek8_bench_memory),
+    SNEK8_BENCH_SYNTHETIC("mixed", _snek8_bench_mixed),
+    SNEK8_BENCH_SYNTHETIC("index", _snek8_bench_index),
+    SNEK8_BENCH_CHECKED("jump", _snek8_bench_jump, _snek8_benchCheckJump),
+};
+
+/// The ROMs that check the semantics of a few instructions: they halt soon, so they are
+/// verified but not benchmarked.
+static const Snek8BenchRom _snek8_bench_checked[] = {
+    SNEK8_BENCH_CHECKED("fx55", _snek8_bench_fx55, _snek8_benchCheckStore),
+    SNEK8_BENCH_CHECKED("fx65", _snek8_bench_fx65, _snek8_benchCheckLoad),
+    SNEK8_BENCH_CHECKED("fx33", _snek8_bench_fx33, _snek8_benchCheckBcd),
+};
+
+/// The ROMs that spin in idle loops, verified over runs that are long enough for the
+/// engines to skip millions of instructions at once.
+static const Snek8BenchRom _snek8_bench_idle[] = {
+    SNEK8_BENCH_SYNTHETIC("idle-key", _snek8_bench_idle_key),
+    SNEK8_BENCH_SYNTHETIC("idle-dt", _snek8_bench_idle_dt),
+    SNEK8_BENCH_SYNTHETIC("idle-halt", _snek8_bench_idle_halt),
+};
+
+/**
+* @brief `snek8_cpuStep` decoding every opcode, as a batched run.
+*/
+static enum Snek8ExecutionOutput
+_snek8_benchRunDecode(Snek8CPU* cpu, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+                      enum Snek8RunStop* stop){
+    (void) break_flags;
+    enum Snek8ExecutionOutput out = SNEK8_EXECOUT_SUCCESS;
+    Snek8Instruction instruction;
+    size_t executed = 0;
+    while (executed < max_cycles && SNEK8_EXECOUT_SUCCESS == out){
+        out = snek8_cpuStep(cpu, &instruction);
+        executed++;
+    }
+    if (cycles){
+        *cycles = executed;
+    }
+    if (stop){
+        *stop = (SNEK8_EXECOUT_SUCCESS == out)? SNEK8_RUNSTOP_CYCLES: SNEK8_RUNSTOP_ERROR;
+    }
+    return out;
+}
+
+static Snek8Batch* _snek8_bench_batch = NULL;
+static size_t _snek8_bench_lane = 0;
+
+/**
+* @brief The lanes of a batch, as a batched run: the CPU is loaded into every lane of
+* the batch, which runs, and one of the lanes, a different one at every run, is stored
+* back into the CPU. The batch is allocated on the first run, and again whenever the
+* implementation flags change.
+*/
+static enum Snek8ExecutionOutput
+_snek8_benchRunBatch(Snek8CPU* cpu, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+                     enum Snek8RunStop* stop){
+    (void) break_flags;
+    if (!_snek8_bench_batch || _snek8_bench_batch->implm_flags != cpu->implm_flags){
+        snek8_batchDel(_snek8_bench_batch);
+        _snek8_bench_batch = snek8_batchNew(SNEK8_BENCH_LANES, cpu->implm_flags);
+        if (!_snek8_bench_batch){
+            return SNEK8_EXECOUT_OUT_OF_MEMORY;
+        }
+    }
+    Snek8Batch* const batch = _snek8_bench_batch;
+    for (size_t lane = 0; lane < SNEK8_BENCH_LANES; lane++){
+        (void) snek8_batchLoadLane(batch, lane, cpu);
+    }
+    // The lanes take the clock of the batch, which takes the one of the CPU.
+    batch->cycles = cpu->cycles;
+    batch->ips = cpu->ips;
+    batch->timer_phase = cpu->timer_phase;
+    (void) snek8_batchRun(batch, max_cycles);
+    size_t lane = _snek8_bench_lane++ % SNEK8_BENCH_LANES;
+    uint64_t before = cpu->cycles;
+    (void) snek8_batchStoreLane(batch, lane, cpu);
+    enum Snek8ExecutionOutput out = (enum Snek8ExecutionOutput) batch->status[lane];
+    if (cycles){
+        *cycles = (size_t) (cpu->cycles - before);
+    }
+    if (stop){
+        *stop = (SNEK8_EXECOUT_SUCCESS == out)? SNEK8_RUNSTOP_CYCLES: SNEK8_RUNSTOP_ERROR;
+    }
+    return out;
+}
+
+#ifndef _WIN32
+static char _snek8_bench_hung[128];
+static size_t _snek8_bench_hung_len = 0;
+
+/**
+* @brief Reports the run that outlived `SNEK8_BENCH_TIMEOUT` and fails the harness.
+*/
+static void
+_snek8_benchHung(int signal){
+    (void) signal;
+    (void) write(STDERR_FILENO, _snek8_bench_hung, _snek8_bench_hung_len);
+    _Exit(EXIT_FAILURE);
+}
+#endif
+
+/**
+* @brief Arms the timeout of a run of `engine` on `name`, or disarms it if `engine` is
+* NULL.
+*/
+static void
+_snek8_benchTimeout(const char* engine, const char* name, uint8_t flags){
+#ifndef _WIN32
+    if (!engine){
+        (void) alarm(0);
+        return;
+    }
+    int len = snprintf(_snek8_bench_hung, sizeof(_snek8_bench_hung),
+                       "snek8-bench: %s hangs on %s (flags %u).\n", engine, name, (unsigned) flags);
+    _snek8_bench_hung_len = (len < 0)? 0: ((size_t) len < sizeof(_snek8_bench_hung))? (size_t) len:
+                            sizeof(_snek8_bench_hung) - 1;
+    (void) signal(SIGALRM, _snek8_benchHung);
+    (void) alarm(SNEK8_BENCH_TIMEOUT);
+#else
+    (void) engine;
+    (void) name;
+    (void) flags;
+#endif
+}
+
+static double
+_snek8_benchNow(void){
+    struct timespec ts;
+    (void) timespec_get(&ts, SNEK8_BENCH_CLOCK);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+/**
+* @brief Runs `cycles` instructions on a CPU booted from `image`, booting it again
+* whenever an instruction fails.
+*/
+static Snek8BenchResult
+_snek8_benchRun(Snek8CPU* cpu, const Snek8CPU* image, Snek8RunEngine run, uint64_t cycles){
+    Snek8BenchResult result = {0};
+    uint32_t gen = cpu->graphics_gen;
+    double start = _snek8_benchNow();
+    while (result.cycles < cycles){
+        uint64_t left = cycles - result.cycles;
+        size_t executed = 0;
+        enum Snek8ExecutionOutput out = run(cpu, (left < SNEK8_BENCH_CHUNK)? (size_t) left: SNEK8_BENCH_CHUNK,
+                                            0, &executed, NULL);
+        result.cycles += executed;
+        if (SNEK8_EXECOUT_SUCCESS != out){
+            result.errors++;
+            result.draws += (uint32_t) (cpu->graphics_gen - gen);
+            (void) snek8_cpuReset(cpu, image);
+            gen = cpu->graphics_gen;
+        }
+    }
+    result.seconds = _snek8_benchNow() - start;
+    result.draws += (uint32_t) (cpu->graphics_gen - gen);
+    return result;
+}
+
+/**
+* @brief Writes `text` as a JSON string.
+*/
+static void
+_snek8_benchString(FILE* file, const char* text){
+    if (!text){
+        (void) fputs("null", file);
+        return;
+    }
+    (void) fputc('"', file);
+    for (const unsigned char* c = (const unsigned char*) text; *c; c++){
+        if ('"' == *c || '\\' == *c){
+            (void) fprintf(file, "\\%c", *c);
+        }else if (*c < 0x20){
+            (void) fprintf(file, "\\u%04x", *c);
+        }else{
+            (void) fputc(*c, file);
+        }
+    }
+    (void) fputc('"', file);
+}
+
+/**
+* @brief Benchmarks a ROM on the selected engines and writes its JSON object, preceded
+* by `separator`. The best run of every engine is added to its entry of `totals`, and
+* the engines meant to be faster than `reference` that run the ROM slower are reported.
+*
+* @return 0 on success, -1 if the ROM could not be loaded (nothing is written then).
+*/
+static int
+_snek8_benchRom(FILE* file, const char* separator, const Snek8BenchRom* rom, const Snek8BenchEngine* engines,
+                size_t n_engines, uint64_t cycles, unsigned repeat, Snek8BenchResult* totals){
+    static Snek8CPU image;
+    static Snek8CPU cpu;
+    static Snek8Snapshot snapshots[2];
+    (void) snek8_cpuInit(&image, 0);
+    (void) snek8_cpuSeed(&image, SNEK8_BENCH_SEED);
+    enum Snek8ExecutionOutput out = snek8_cpuLoadRomBytes(&image, rom->data, rom->size);
+    if (SNEK8_EXECOUT_SUCCESS != out){
+        (void) fprintf(stderr, "snek8-bench: cannot load %s (error %d).\n", rom->name, (int) out);
+        return -1;
+    }
+    // Reset and snapshot latencies, on a CPU that ran for a while.
+    cpu = image;
+    (void) _snek8_benchRun(&cpu, &image, snek8_cpuRun, 100000);
+    double start = _snek8_benchNow();
+    for (size_t i = 0; i < SNEK8_BENCH_LATENCY_ROUNDS; i++){
+        (void) snek8_cpuReset(&cpu, &image);
+    }
+    double reset_ns = (_snek8_benchNow() - start) * 1e9 / SNEK8_BENCH_LATENCY_ROUNDS;
+    snapshots[0].id = 0;
+    snapshots[1].id = 0;
+    start = _snek8_benchNow();
+    for (size_t i = 0; i < SNEK8_BENCH_LATENCY_ROUNDS; i++){
+        // Alternating between two snapshots makes every save copy the whole memory.
+        (void) snek8_cpuSnapshot(&cpu, &snapshots[i & 1u]);
+    }
+    double snapshot_full_ns = (_snek8_benchNow() - start) * 1e9 / SNEK8_BENCH_LATENCY_ROUNDS;
+    start = _snek8_benchNow();
+    for (size_t i = 0; i < SNEK8_BENCH_LATENCY_ROUNDS; i++){
+        (void) snek8_cpuSnapshot(&cpu, &snapshots[0]);
+    }
+    double snapshot_ns = (_snek8_benchNow() - start) * 1e9 / SNEK8_BENCH_LATENCY_ROUNDS;
+    start = _snek8_benchNow();
+    for (size_t i = 0; i < SNEK8_BENCH_LATENCY_ROUNDS; i++){
+        (void) snek8_cpuRestore(&cpu, &snapshots[0]);
+    }
+    double restore_ns = (_snek8_benchNow() - start) * 1e9 / SNEK8_BENCH_LATENCY_ROUNDS;
+
+    (void) fputs(separator, file);
+    (void) fputs("{\"name\": ", file);
+    _snek8_benchString(file, rom->name);
+    (void) fputs(", \"path\": ", file);
+    _snek8_benchString(file, rom->path);
+    (void) fprintf(file, ", \"size\": %zu, \"reset_ns\": %.2f, \"snapshot_ns\": %.2f, "
+                   "\"snapshot_full_ns\": %.2f, \"restore_ns\": %.2f, \"engines\": {",
+                   rom->size, reset_ns, snapshot_ns, snapshot_full_ns, restore_ns);
+    double reference_mips = 0.0;
+    const char* comma = "";
+    for (size_t e = 0; e < n_engines; e++){
+        if (!engines[e].timed){
+            continue;
+        }
+        Snek8BenchResult best = {0};
+        for (unsigned r = 0; r < repeat; r++){
+            cpu = image;
+            if (engines[e].blocks){
+                cpu.blocks = snek8_blockCacheNew();
+                if (!cpu.blocks){
+                    (void) fputs("snek8-bench: out of memory.\n", stderr);
+                    return -1;
+                }
+            }
+            // Warm up the caches (and the block cache) before timing.
+            (void) _snek8_benchRun(&cpu, &image, engines[e].run, SNEK8_BENCH_CHUNK);
+            Snek8BenchResult result = _snek8_benchRun(&cpu, &image, engines[e].run, cycles);
+            if (!r || result.seconds < best.seconds){
+                best = result;
+            }
+            snek8_blockCacheDel(cpu.blocks);
+        }
+        totals[e].cycles += best.cycles;
+        totals[e].seconds += best.seconds;
+        double seconds = (best.seconds > 0.0)? best.seconds: 1e-9;
+        double mips = (double) best.cycles / seconds * 1e-6;
+        if (snek8_cpuRun == engines[e].run){
+            reference_mips = mips;
+        }else if (engines[e].faster && mips < reference_mips){
+            (void) fprintf(stderr, "snek8-bench: %s runs %s slower than reference: %.3f MIPS instead of %.3f.\n",
+                           engines[e].name, rom->name, mips, reference_mips);
+        }
+        (void) fprintf(file, "%s\"%s\": {\"cycles\": %llu, \"seconds\": %.6f, \"mips\": %.3f, "
+                       "\"ns_per_instruc\": %.4f, \"draws\": %llu, \"draws_per_s\": %.1f, "
+                       "\"errors\": %llu}",
+                       comma, engines[e].name, (unsigned long long) best.cycles, best.seconds, mips,
+                       best.cycles? seconds * 1e9 / (double) best.cycles: 0.0,
+                       (unsigned long long) best.draws, (double) best.draws / seconds,
+                       (unsigned long long) best.errors);
+        comma = ", ";
+    }
+    (void) fputs("}}", file);
+    return 0;
+}
+
+/**
+* @brief The next number of a xorshift64 generator, which drives the random opcode
+* streams and the key presses of the traces.
+*/
+static inline uint64_t
+_snek8_benchRandom(uint64_t* state){
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+/**
+* @brief The FNV-1a hash of the state of a CPU, serialized in the snapshot format.
+*/
+static uint64_t
+_snek8_benchHash(const uint8_t* data){
+    uint64_t hash = UINT64_C(0xCBF29CE484222325);
+    for (size_t i = 0; i < SNEK8_SIZE_SNAPSHOT; i++){
+        hash = (hash ^ data[i]) * UINT64_C(0x100000001B3);
+    }
+    return hash;
+}
+
+/**
+* @brief Fills a ROM with random valid opcodes. The jumps and calls land on an
+* instruction of the ROM, so that the stream keeps executing random opcodes instead of
+* the empty memory past it.
+*/
+static void
+_snek8_benchRandomRom(uint8_t* data, size_t size, uint64_t* state){
+    for (size_t i = 0; i + 1 < size; i += 2){
+        uint16_t opcode;
+        do{
+            opcode = (uint16_t) (_snek8_benchRandom(state) >> 48);
+        }while (SNEK8_INSTRUC_NOP == snek8_opcodeFamily(opcode));
+        enum Snek8InstructionFamily family = snek8_opcodeFamily(opcode);
+        if (SNEK8_INSTRUC_JMP_ADDR == family || SNEK8_INSTRUC_CALL == family
+            || SNEK8_INSTRUC_JP_V0_ADDR == family){
+            uint16_t target = (uint16_t) (SNEK8_MEM_ADDR_PROG_START + ((opcode & 0x0FFFu) % size & ~0x1u));
+            opcode = (uint16_t) ((opcode & 0xF000u) | target);
+        }
+        data[i] = (uint8_t) (opcode >> 8);
+        data[i + 1] = (uint8_t) opcode;
+    }
+}
+
+/**
+* @brief Runs a CPU booted from `image` on an engine and with `snek8_cpuStep` side by
+* side, one frame (or `step` instructions, if not 0) at a time, pressing and releasing
+* the same keys on both between the frames, and compares the hashes of their states
+* after every frame. The snapshot of every state reached must also be valid. The trace
+* ends after `frames` frames, or at the first instruction that fails, which must fail
+* alike; then `check`, if not NULL, checks the state of the engine.
+*
+* @return 0 if the engine matched `snek8_cpuStep`, 1 if it diverged (which is reported),
+* -1 if its block cache could not be allocated.
+*/
+static int
+_snek8_benchTrace(const char* name, const Snek8CPU* image, const Snek8BenchEngine* engine,
+                  unsigned long frames, size_t step, uint64_t seed, Snek8BenchCheck check){
+    static Snek8CPU reference;
+    static Snek8CPU cpu;
+    reference = *image;
+    cpu = *image;
+    if (engine->blocks){
+        cpu.blocks = snek8_blockCacheNew();
+        if (!cpu.blocks){
+            (void) fputs("snek8-bench: out of memory.\n", stderr);
+            return -1;
+        }
+    }
+    uint64_t keys = seed | 0x1u;
+    int diverged = 0;
+    for (unsigned long frame = 0; frame < frames && !diverged; frame++){
+        size_t budget = step? step: snek8_cpuCyclesToFrame(&reference);
+        enum Snek8ExecutionOutput expected = SNEK8_EXECOUT_SUCCESS;
+        Snek8Instruction instruction;
+        size_t expected_cycles = 0;
+        while (expected_cycles < budget && SNEK8_EXECOUT_SUCCESS == expected){
+            expected = snek8_cpuStep(&reference, &instruction);
+            expected_cycles++;
+        }
+        enum Snek8ExecutionOutput out = SNEK8_EXECOUT_SUCCESS;
+        size_t cycles = 0;
+        while (cycles < budget && SNEK8_EXECOUT_SUCCESS == out){
+            size_t executed = 0;
+            _snek8_benchTimeout(engine->name, name, image->implm_flags);
+            out = engine->run(&cpu, budget - cycles, 0, &executed, NULL);
+            _snek8_benchTimeout(NULL, NULL, 0);
+            cycles += executed;
+        }
+        static uint8_t data[SNEK8_SIZE_SNAPSHOT];
+        (void) snek8_cpuSerialize(&reference, data);
+        uint64_t expected_hash = _snek8_benchHash(data);
+        // Every state the CPU reaches must be one that its snapshots can restore.
+        if (SNEK8_EXECOUT_SUCCESS != snek8_snapshotValidate(data, sizeof(data))){
+            (void) fprintf(stderr, "snek8-bench: the snapshot of %s (flags %u) at frame %lu is rejected.\n",
+                           name, (unsigned) image->implm_flags, frame);
+            diverged = 1;
+        }
+        (void) snek8_cpuSerialize(&cpu, data);
+        uint64_t hash = _snek8_benchHash(data);
+        if (hash != expected_hash || cycles != expected_cycles || out != expected){
+            (void) fprintf(stderr, "snek8-bench: %s diverges from snek8_cpuStep on %s (flags %u) at frame %lu: "
+                           "state %016llx instead of %016llx, %zu cycles instead of %zu, "
+                           "error %d instead of %d.\n",
+                           engine->name, name, (unsigned) image->implm_flags, frame,
+                           (unsigned long long) hash, (unsigned long long) expected_hash, cycles,
+                           expected_cycles, (int) out, (int) expected);
+            diverged = 1;
+        }
+        if (SNEK8_EXECOUT_SUCCESS != expected){
+            break;
+        }
+        if (!(_snek8_benchRandom(&keys) & 0x3u)){
+            size_t key = (size_t) (keys >> 60);
+            bool value = !((reference.keys >> key) & 0x1u);
+            (void) snek8_cpuSetKey(&reference, key, value);
+            (void) snek8_cpuSetKey(&cpu, key, value);
+        }
+    }
+    const char* wrong = (check && !diverged)? check(&cpu): NULL;
+    if (wrong){
+        (void) fprintf(stderr, "snek8-bench: %s ends %s (flags %u) in a wrong state: %s.\n", engine->name, name,
+                       (unsigned) image->implm_flags, wrong);
+        diverged = 1;
+    }
+    snek8_blockCacheDel(cpu.blocks);
+    return diverged;
+}
+
+/**
+* @brief Traces a ROM on the selected engines, under every combination of
+* implementation flags, at `ips` instructions per second and `step` instructions at a
+* time (see `_snek8_benchTrace`).
+*
+* @return The number of traces that diverged, or -1 if the ROM could not be loaded or
+* a block cache allocated.
+*/
+static long
+_snek8_benchVerify(const Snek8BenchRom* rom, const Snek8BenchEngine* engines, size_t n_engines,
+                   unsigned long frames, uint32_t ips, size_t step){
+    static Snek8CPU image;
+    long failures = 0;
+    for (uint8_t flags = 0; flags < SNEK8_SIZE_QUIRK_SETS; flags++){
+        (void) snek8_cpuInit(&image, flags);
+        (void) snek8_cpuSeed(&image, SNEK8_BENCH_SEED);
+        (void) snek8_cpuSetIPS(&image, ips);
+        enum Snek8ExecutionOutput out = snek8_cpuLoadRomBytes(&image, rom->data, rom->size);
+        if (SNEK8_EXECOUT_SUCCESS != out){
+            (void) fprintf(stderr, "snek8-bench: cannot load %s (error %d).\n", rom->name, (int) out);
+            return -1;
+        }
+        for (size_t e = 0; e < n_engines; e++){
+            int diverged = _snek8_benchTrace(rom->name, &image, &engines[e], frames, step,
+                                             SNEK8_BENCH_SEED + flags, rom->check);
+            if (diverged < 0){
+                return -1;
+            }
+            failures += diverged;
+        }
+    }
+    return failures;
+}
+
+/**
+* @brief Compares the throughput of the engines, over the whole corpus, with the one
+* of a baseline file, which holds an `<engine> <mips>` line per engine (as written by
+* `--save-baseline`). The engines missing from either side are not compared.
+*
+* @return The number of engines slower than their baseline by more than `tolerance`
+* percent (which are reported), or -1 if the file could not be read.
+*/
+static long
+_snek8_benchCheckBaseline(const char* path, const Snek8BenchEngine* engines, size_t n_engines,
+                          const Snek8BenchResult* totals, double tolerance){
+    FILE* file = fopen(path, "r");
+    if (!file){
+        (void) fprintf(stderr, "snek8-bench: cannot open %s.\n", path);
+        return -1;
+    }
+    long regressions = 0;
+    char name[32];
+    double baseline;
+    while (2 == fscanf(file, "%31s %lf", name, &baseline)){
+        for (size_t e = 0; e < n_engines; e++){
+            if (strcmp(name, engines[e].name) || !(totals[e].seconds > 0.0)){
+                continue;
+            }
+            double mips = (double) totals[e].cycles / totals[e].seconds * 1e-6;
+            if (mips < baseline * (1.0 - tolerance / 100.0)){
+                (void) fprintf(stderr, "snek8-bench: %s regressed to %.3f MIPS from a baseline of %.3f MIPS.\n",
+                               name, mips, baseline);
+                regressions++;
+            }
+        }
+    }
+    (void) fclose(file);
+    return regressions;
+}
+
+static void
+_snek8_benchUsage(FILE* file){
+    (void) fputs("usage: snek8-bench [-c MILLIONS] [-r REPEAT] [-e ENGINE[,ENGINE...]]\n"
+                 "                   [-o OUTPUT] [--no-synthetic] [--verify FRAMES]\n"
+                 "                   [--random STREAMS] [--baseline FILE] [--tolerance PERCENT]\n"
+                 "                   [--save-baseline FILE] [ROM...]\n"
+                 "\n"
+                 "  -c MILLIONS             instructions per ROM and engine, in millions\n"
+                 "                          (default 10)\n"
+                 "  -r REPEAT               runs per ROM and engine, the best one is kept\n"
+                 "                          (default 3)\n"
+                 "  -e ENGINES              engines to run among decode, reference, threaded,\n"
+                 "                          block and batch, which is only verified (default all)\n"
+                 "  -o OUTPUT               write the JSON results to OUTPUT instead of stdout\n"
+                 "  --no-synthetic          only run the given ROM files\n"
+                 "  --verify FRAMES         first compare the engines with snek8_cpuStep, frame\n"
+                 "                          by frame, for up to FRAMES frames per ROM (the\n"
+                 "                          instruction checks need about 200)\n"
+                 "  --random STREAMS        random opcode streams verified besides the corpus\n"
+                 "                          (default 32)\n"
+                 "  --baseline FILE         fail if an engine is slower than in FILE\n"
+                 "  --tolerance PERCENT     slowdown allowed by --baseline (default 10)\n"
+                 "  --save-baseline FILE    write the throughput of the engines to FILE\n", file);
+}
+
+int
+main(int argc, char** argv){
+    static const Snek8BenchEngine all_engines[] = {
+        {.name = "decode", .run = _snek8_benchRunDecode, .blocks = false, .faster = false, .timed = true},
+        {.name = "reference", .run = snek8_cpuRun, .blocks = false, .faster = false, .timed = true},
+        {.name = "threaded", .run = snek8_cpuRunThreaded, .blocks = false, .faster = true, .timed = true},
+        {.name = "block", .run = snek8_cpuRunBlocks, .blocks = true, .faster = true, .timed = true},
+        {.name = "batch", .run = _snek8_benchRunBatch, .blocks = false, .faster = false, .timed = false},
+    };
+    const size_t n_all = sizeof(all_engines) / sizeof(all_engines[0]);
+    Snek8BenchEngine engines[sizeof(all_engines) / sizeof(all_engines[0])];
+    size_t n_engines = 0;
+    double millions = 10.0;
+    long repeat = 3;
+    const char* output = NULL;
+    const char* engine_list = NULL;
+    bool synthetic = true;
+    unsigned long frames = 0;
+    long streams = 32;
+    const char* baseline = NULL;
+    const char* save_baseline = NULL;
+    double tolerance = 10.0;
+    int first_rom = argc;
+    for (int i = 1; i < argc; i++){
+        bool has_value = i + 1 < argc;
+        if (!strcmp(argv[i], "-c") && has_value){
+            millions = strtod(argv[++i], NULL);
+        }else if (!strcmp(argv[i], "-r") && has_value){
+            repeat = strtol(argv[++i], NULL, 10);
+        }else if (!strcmp(argv[i], "-e") && has_value){
+            engine_list = argv[++i];
+        }else if (!strcmp(argv[i], "-o") && has_value){
+            output = argv[++i];
+        }else if (!strcmp(argv[i], "--no-synthetic")){
+            synthetic = false;
+        }else if (!strcmp(argv[i], "--verify") && has_value){
+            frames = strtoul(argv[++i], NULL, 10);
+        }else if (!strcmp(argv[i], "--random") && has_value){
+            streams = strtol(argv[++i], NULL, 10);
+        }else if (!strcmp(argv[i], "--baseline") && has_value){
+            baseline = argv[++i];
+        }else if (!strcmp(argv[i], "--tolerance") && has_value){
+            tolerance = strtod(argv[++i], NULL);
+        }else if (!strcmp(argv[i], "--save-baseline") && has_value){
+            save_baseline = argv[++i];
+        }else if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")){
+            _snek8_benchUsage(stdout);
+            return EXIT_SUCCESS;
+        }else if ('-' == argv[i][0]){
+            _snek8_benchUsage(stderr);
+            return EXIT_FAILURE;
+        }else{
+            first_rom = i;
+            break;
+        }
+    }
+    if (!(millions > 0.0) || repeat < 1 || streams < 0 || !(tolerance >= 0.0)){
+        _snek8_benchUsage(stderr);
+        return EXIT_FAILURE;
+    }
+    for (size_t e = 0; e < n_all; e++){
+        const char* found = engine_list? strstr(engine_list, all_engines[e].name): NULL;
+        size_t len = strlen(all_engines[e].name);
+        if (!engine_list || (found && (found == engine_list || ',' == found[-1])
+                             && (',' == found[len] || '\0' == found[len]))){
+            engines[n_engines++] = all_engines[e];
+        }
+    }
+    if (!n_engines){
+        (void) fprintf(stderr, "snek8-bench: no engine matches '%s'.\n", engine_list);
+        return EXIT_FAILURE;
+    }
+    FILE* file = output? fopen(output, "w"): stdout;
+    if (!file){
+        (void) fprintf(stderr, "snek8-bench: cannot open %s.\n", output);
+        return EXIT_FAILURE;
+    }
+    uint64_t cycles = (uint64_t) (millions * 1e6);
+    (void) fprintf(file, "{\"version\": 1, \"cycles\": %llu, \"repeat\": %ld, \"stats\": %s, \"roms\": [",
+                   (unsigned long long) cycles, repeat, SNEK8_STATS? "true": "false");
+    int status = EXIT_SUCCESS;
+    bool first = true;
+    long failures = 0;
+    Snek8BenchResult totals[sizeof(all_engines) / sizeof(all_engines[0])] = {0};
+    size_t n_synthetic = synthetic? sizeof(_snek8_bench_synthetic) / sizeof(_snek8_bench_synthetic[0]): 0;
+    for (size_t i = 0; i < n_synthetic; i++){
+        long failed = frames? _snek8_benchVerify(&_snek8_bench_synthetic[i], engines, n_engines, frames,
+                                                  SNEK8_CPU_DEFAULT_IPS, 0): 0;
+        if (failed < 0){
+            status = EXIT_FAILURE;
+        }else{
+            failures += failed;
+        }
+        if (_snek8_benchRom(file, first? "\n": ",\n", &_snek8_bench_synthetic[i], engines, n_engines,
+                            cycles, (unsigned) repeat, totals) < 0){
+            status = EXIT_FAILURE;
+        }else{
+            first = false;
+        }
+    }
+    size_t n_checked = (synthetic && frames)? sizeof(_snek8_bench_checked) / sizeof(_snek8_bench_checked[0]): 0;
+    for (size_t i = 0; i < n_checked; i++){
+        long failed = _snek8_benchVerify(&_snek8_bench_checked[i], engines, n_engines, frames,
+                                         SNEK8_CPU_DEFAULT_IPS, 0);
+        if (failed < 0){
+            status = EXIT_FAILURE;
+        }else{
+            failures += failed;
+        }
+    }
+    // Frame by frame at the highest rate, then in longer runs at the default one.
+    size_t n_idle = (synthetic && frames)? sizeof(_snek8_bench_idle) / sizeof(_snek8_bench_idle[0]): 0;
+    for (size_t i = 0; i < n_idle; i++){
+        long failed = _snek8_benchVerify(&_snek8_bench_idle[i], engines, n_engines, SNEK8_BENCH_IDLE_RUNS,
+                                         SNEK8_CPU_MAX_IPS, 0);
+        long failed_long = _snek8_benchVerify(&_snek8_bench_idle[i], engines, n_engines, SNEK8_BENCH_IDLE_RUNS,
+                                              SNEK8_CPU_DEFAULT_IPS, SNEK8_BENCH_IDLE_CYCLES);
+        if (failed < 0 || failed_long < 0){
+            status = EXIT_FAILURE;
+        }else{
+            failures += failed + failed_long;
+        }
+    }
+    static Snek8Rom rom_file;
+    for (int i = first_rom; i < argc; i++){
+        enum Snek8ExecutionOutput out = snek8_romRead(argv[i], &rom_file);
+        if (SNEK8_EXECOUT_SUCCESS != out){
+            (void) fprintf(stderr, "snek8-bench: cannot read %s (error %d).\n", argv[i], (int) out);
+            status = EXIT_FAILURE;
+            continue;
+        }
+        const char* name = strrchr(argv[i], '/');
+        Snek8BenchRom rom = {
+            .name = name? name + 1: argv[i],
+            .path = argv[i],
+            .size = rom_file.size,
+            .data = rom_file.data,
+            .check = NULL,
+        };
+        long failed = frames? _snek8_benchVerify(&rom, engines, n_engines, frames, SNEK8_CPU_DEFAULT_IPS, 0): 0;
+        if (failed < 0){
+            status = EXIT_FAILURE;
+        }else{
+            failures += failed;
+        }
+        if (_snek8_benchRom(file, first? "\n": ",\n", &rom, engines, n_engines, cycles,
+                            (unsigned) repeat, totals) < 0){
+            status = EXIT_FAILURE;
+        }else{
+            first = false;
+        }
+    }
+    // Random opcode streams, verified but not benchmarked: most of them soon fail.
+    static uint8_t random_data[SNEK8_BENCH_RANDOM_SIZE];
+    static char random_name[32];
+    uint64_t state = SNEK8_BENCH_SEED;
+    snek8_opcodeTableInit();
+    for (long i = 0; frames && i < streams; i++){
+        _snek8_benchRandomRom(random_data, sizeof(random_data), &state);
+        (void) snprintf(random_name, sizeof(random_name), "random-%ld", i);
+        Snek8BenchRom rom = {
+            .name = random_name,
+            .path = NULL,
+            .size = sizeof(random_data),
+            .data = random_data,
+            .check = NULL,
+        };
+        long failed = _snek8_benchVerify(&rom, engines, n_engines, frames, SNEK8_CPU_DEFAULT_IPS, 0);
+        if (failed < 0){
+            status = EXIT_FAILURE;
+        }else{
+            failures += failed;
+        }
+    }
+    snek8_batchDel(_snek8_bench_batch);
+    (void) fputs("\n], \"verify\": ", file);
+    if (frames){
+        (void) fprintf(file, "{\"frames\": %lu, \"random\": %ld, \"failures\": %ld}", frames, streams,
+                       failures);
+    }else{
+        (void) fputs("null", file);
+    }
+    (void) fputs(", \"totals\": {", file);
+    const char* comma = "";
+    for (size_t e = 0; e < n_engines; e++){
+        if (!engines[e].timed){
+            continue;
+        }
+        double seconds = (totals[e].seconds > 0.0)? totals[e].seconds: 1e-9;
+        (void) fprintf(file, "%s\"%s\": %.3f", comma, engines[e].name,
+                       (double) totals[e].cycles / seconds * 1e-6);
+        comma = ", ";
+    }
+    (void) fputs("}}\n", file);
+    if (output){
+        (void) fclose(file);
+    }
+    if (failures){
+        (void) fprintf(stderr, "snek8-bench: %ld traces diverged from snek8_cpuStep.\n", failures);
+        status = EXIT_FAILURE;
+    }
+    if (save_baseline){
+        FILE* saved = fopen(save_baseline, "w");
+        if (!saved){
+            (void) fprintf(stderr, "snek8-bench: cannot open %s.\n", save_baseline);
+            return EXIT_FAILURE;
+        }
+        for (size_t e = 0; e < n_engines; e++){
+            if (!engines[e].timed){
+                continue;
+            }
+            double seconds = (totals[e].seconds > 0.0)? totals[e].seconds: 1e-9;
+            (void) fprintf(saved, "%s %.3f\n", engines[e].name, (double) totals[e].cycles / seconds * 1e-6);
+        }
+        (void) fclose(saved);
+    }
+    if (baseline && _snek8_benchCheckBaseline(baseline, engines, n_engines, totals, tolerance)){
+        status = EXIT_FAILURE;
+    }
+    return status;
+}
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_BENCH_C
@@ -0,0 +1,178 @@
+/**
+* @file audio.h
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Declaration of the audio generator.
+*
+* The generator synthesizes the buzzer into a PCM ring buffer provided by the caller:
+* signed 16-bit mono samples at the caller's rate, one 60 Hz frame (`rate` / 60
+* samples, spread with the same Bresenham scheme as the timers) per tick of the
+* timers. The buzzer sounds during the frames in which the sound timer is non-zero.
+* Its waveform is either a square wave of a fixed tone (CHIP8 and SUPER-CHIP) or the
+* 128 1-bit samples of the XO-CHIP audio pattern, played at the rate set by the pitch
+* register: 4000 * 2 ^ ((pitch - 64) / 48) samples per second.
+*
+* The phase of the waveform carries over from a frame to the next, and the envelope
+* ramps up and down over `SNEK8_AUDIO_RAMP` samples, so that the buzzer starts and
+* stops without clicks.
+*
+* The ring is written by the owner of the CPU and may be read concurrently: the
+* number of samples written so far is published with release semantics once they are
+* in the ring (see `snek8_audioWritten`), the sample n being at the index
+* n % `capacity`. A reader that falls behind by more than `capacity` samples has
+* missed some.
+*/
+#ifndef SNEK8_AUDIO_H
+    #define SNEK8_AUDIO_H
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include <stdatomic.h>
+#include "cpu.h"
+
+/**
+* @def SNEK8_AUDIO_DEFAULT_RATE
+* @brief The default number of samples per second.
+*/
+#define SNEK8_AUDIO_DEFAULT_RATE        44100
+
+/**
+* @def SNEK8_AUDIO_MAX_RATE
+* @brief The largest number of samples per second.
+*/
+#define SNEK8_AUDIO_MAX_RATE            192000
+
+/**
+* @def SNEK8_AUDIO_DEFAULT_TONE
+* @brief The default frequency of the square wave, in Hz.
+*/
+#define SNEK8_AUDIO_DEFAULT_TONE        440
+
+/**
+* @def SNEK8_AUDIO_DEFAULT_VOLUME
+* @brief The default amplitude of the buzzer.
+*/
+#define SNEK8_AUDIO_DEFAULT_VOLUME      8192
+
+/**
+* @def SNEK8_AUDIO_RAMP
+* @brief The number of samples the envelope takes to rise or fall completely.
+*/
+#define SNEK8_AUDIO_RAMP                64
+
+/**
+* @def SNEK8_AUDIO_PATTERN_BITS
+* @brief The number of 1-bit samples of an audio pattern.
+*/
+#define SNEK8_AUDIO_PATTERN_BITS        128
+
+/**
+* @def SNEK8_AUDIO_PATTERN_RATE
+* @brief The playback rate of an audio pattern at the default pitch (64), in samples
+*        per second.
+*/
+#define SNEK8_AUDIO_PATTERN_RATE        4000
+
+/**
+* @brief Implementation of the audio generator.
+*
+* @param `samples` The ring buffer, owned by the caller.
+* @param `capacity` The number of samples of the ring.
+* @param `written` The number of samples written since the initialization.
+* @param `rate` The number of samples per second.
+* @param `tone` The frequency of the square wave, in Hz.
+* @param `volume` The amplitude of the buzzer.
+* @param `envelope` The current amplitude, moving towards `volume` or 0.
+* @param `frame_phase` The fraction of a sample carried over by the frames, in units of
+*        1 / `SNEK8_TIMER_FREQUENCY` samples.
+* @param `wave_phase` The position in the waveform, 2^32 being a whole period (of the
+*        square wave or of the pattern).
+*/
+typedef struct{
+    int16_t* samples;
+    size_t capacity;
+    atomic_uint_least64_t written;
+    uint32_t rate;
+    uint32_t tone;
+    int32_t volume;
+    int32_t envelope;
+    uint32_t frame_phase;
+    uint32_t wave_phase;
+} Snek8Audio;
+
+/**
+* @brief Set the generator up over a ring buffer.
+*
+* @param[out] `audio`.
+* @param[in] `samples` The ring buffer.
+* @param[in] `capacity` The number of samples of the ring, at least one frame
+*            (`snek8_audioFrameSize`).
+* @param[in] `rate` `SNEK8_TIMER_FREQUENCY` <= rate <= `SNEK8_AUDIO_MAX_RATE`.
+* @param[in] `tone` 0 < tone < rate / 2.
+* @param[in] `volume` 0 <= volume <= INT16_MAX.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`: NULL generator or ring.
+* - `SNEK8_EXECOUT_INDEX_OUT_RANGE`: invalid capacity, rate, tone or volume.
+*/
+enum Snek8ExecutionOutput
+snek8_audioInit(Snek8Audio* audio, int16_t* samples, size_t capacity, uint32_t rate,
+                uint32_t tone, int32_t volume);
+
+/**
+* @brief The largest number of samples of a frame at a given rate.
+*/
+static inline size_t
+snek8_audioFrameSize(uint32_t rate){
+    return (rate + SNEK8_TIMER_FREQUENCY - 1) / SNEK8_TIMER_FREQUENCY;
+}
+
+/**
+* @brief Retrieves the number of samples written since the initialization; all of
+* them are in the ring when the function returns.
+*
+* @param[in] `audio`.
+*/
+static inline uint64_t
+snek8_audioWritten(Snek8Audio* audio){
+    return atomic_load_explicit(&audio->written, memory_order_acquire);
+}
+
+/**
+* @brief Synthesizes the frame that precedes a tick of the timers.
+*
+* @param[in, out] `audio`.
+* @param[in] `on` Whether the buzzer sounds during the frame.
+* @param[in] `pattern` The `SNEK8_AUDIO_PATTERN_BITS` bits of the XO-CHIP audio
+*            pattern, most significant bit first, or NULL for the square wave.
+* @param[in] `pitch` The XO-CHIP pitch register (ignored without pattern).
+*/
+void
+snek8_audioFrame(Snek8Audio* audio, bool on, const uint8_t* pattern, uint8_t pitch);
+
+/**
+* @brief Synthesizes the frames of the ticks of the timers that happened during a
+* run, from the sound timer before and after it.
+*
+* Frame j (1 <= j <= `ticks`) sounds when the sound timer was still running at its
+* end, i.e. if j <= `st_before`; the last one also sounds when the timer is running
+* after the run, which catches the buzzer started during the run (LD ST, V{0xX}).
+* Only the last `capacity` samples of long runs are synthesized, the others are
+* skipped.
+*
+* @param[in, out] `audio`.
+* @param[in] `ticks` The number of ticks of the timers during the run.
+* @param[in] `st_before` The sound timer before the run.
+* @param[in] `st_after` The sound timer after the run.
+* @param[in] `pattern` See `snek8_audioFrame`.
+* @param[in] `pitch` See `snek8_audioFrame`.
+*/
+void
+snek8_audioTicks(Snek8Audio* audio, uint64_t ticks, uint8_t st_before, uint8_t st_after,
+                 const uint8_t* pattern, uint8_t pitch);
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_AUDIO_H
@@ -0,0 +1,203 @@
+/**
+* @file batch.h
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Declaration of the lockstep batch of CPUs.
+*
+* A batch holds N independent Chip8 CPUs (the lanes) that run the same ROM in
+* lockstep: every step executes one instruction on each lane. The state of the lanes
+* is kept in structure-of-arrays layout (all the program counters, then all the index
+* registers, the register V{0x0} of all the lanes, then V{0x1} and so on), so that
+* when all the lanes execute the same opcode, which is the common case, the
+* instruction runs as a loop over contiguous arrays that the compiler vectorizes.
+* Lanes that diverge execute their own opcodes one by one.
+*
+* The memory, the screen and the stack, which are accessed at lane-dependent
+* addresses, are kept per lane. All lanes share the implementation flags and the
+* timers' clock, since they execute the same number of instructions.
+*
+* A lane whose instruction fails halts and keeps its state; the other lanes go on.
+*/
+#ifndef SNEK8_BATCH_H
+    #define SNEK8_BATCH_H
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include "cpu.h"
+
+/**
+* @brief Implementation of the batch of CPUs.
+*
+* @param `lanes` The number of CPUs of the batch.
+* @param `implm_flags` The implementation flags of all lanes.
+* @param `ips` The number of instructions per emulated second of all lanes.
+* @param `timer_phase` The timers' clock phase of all lanes (see `Snek8CPU`).
+* @param `cycles` The number of steps executed by the batch.
+* @param `skipped_cycles` The number of those steps retired at once because every
+*        running lane was spinning in an idle loop (see `snek8_batchRun`).
+* @param `halted` The number of halted lanes.
+* @param `memory` The memory of each lane (`lanes` x `SNEK8_SIZE_RAM`).
+* @param `graphics` The packed screen of each lane (`lanes` x `SNEK8_GRAPHICS_HEIGTH`).
+* @param `graphics_gen` The screen generation of each lane.
+* @param `graphics_dirty` The screen's dirty rows mask of each lane.
+* @param `stacks` The stack of each lane.
+* @param `registers` The registers, register-major (`SNEK8_SIZE_REGISTERS` x `lanes`).
+* @param `keys` The key set of each lane.
+* @param `key_wait` Whether each lane waits on LD V{0xX}, K (see `Snek8CPU`).
+* @param `key_armed` The keys pressed while waiting of each lane.
+* @param `pc` The program counter of each lane.
+* @param `ir` The index register of each lane.
+* @param `dt` The delay timer of each lane.
+* @param `st` The sound timer of each lane.
+* @param `rng` The state of the random number generator of each lane.
+* @param `status` The execution output that halted each lane, or
+*        `SNEK8_EXECOUT_SUCCESS` while the lane runs.
+* @param `halt_cycles` The number of instructions each halted lane executed.
+* @param `opcodes` Scratch buffer of the current opcode of each lane.
+*/
+typedef struct{
+    size_t lanes;
+    uint8_t implm_flags;
+    uint32_t ips;
+    uint32_t timer_phase;
+    uint64_t cycles;
+    uint64_t skipped_cycles;
+    size_t halted;
+    uint8_t* memory;
+    uint64_t* graphics;
+    uint32_t* graphics_gen;
+    uint32_t* graphics_dirty;
+    Snek8Stack* stacks;
+    uint8_t* registers;
+    uint16_t* keys;
+    uint8_t* key_wait;
+    uint16_t* key_armed;
+    uint16_t* pc;
+    uint16_t* ir;
+    uint8_t* dt;
+    uint8_t* st;
+    uint32_t* rng;
+    uint8_t* status;
+    uint64_t* halt_cycles;
+    uint16_t* opcodes;
+} Snek8Batch;
+
+/**
+* @brief Allocates a batch whose lanes are initialized CPUs (see `snek8_cpuInit`).
+*
+* @param[in] `lanes` The number of CPUs (at least 1).
+* @param[in] `implm_flags` The implementation flags of all lanes.
+* @return The new batch, or NULL if `lanes` is 0 or the allocation failed.
+* @note The batch must be released with `snek8_batchDel`.
+*/
+Snek8Batch*
+snek8_batchNew(size_t lanes, uint8_t implm_flags);
+
+/**
+* @brief Releases a batch.
+*
+* @param[in, out] `batch` (may be NULL).
+*/
+void
+snek8_batchDel(Snek8Batch* batch);
+
+/**
+* @brief Copies the state of a CPU into a lane, which then runs again if halted.
+*
+* The number of instructions per second and the timers' clock of the CPU are ignored:
+* the ones of the batch apply. The CPU's random number generator is copied, so that
+* loading, running and storing a lane continues the CPU's sequence; the CPU must have
+* the implementation flags of the batch, which runs every lane under them.
+*
+* @param[in, out] `batch`.
+* @param[in] `lane`.
+* @param[in] `cpu`.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - `SNEK8_EXECOUT_INDEX_OUT_RANGE`.
+* - `SNEK8_EXECOUT_INVALID_ARG`: the implementation flags differ from the batch's.
+*/
+enum Snek8ExecutionOutput
+snek8_batchLoadLane(Snek8Batch* batch, size_t lane, const Snek8CPU* cpu);
+
+/**
+* @brief Copies the state of a lane into a CPU. The CPU's block cache is left
+* untouched.
+*
+* @param[in] `batch`.
+* @param[in] `lane`.
+* @param[out] `cpu`.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - `SNEK8_EXECOUT_INDEX_OUT_RANGE`.
+*/
+enum Snek8ExecutionOutput
+snek8_batchStoreLane(const Snek8Batch* batch, size_t lane, Snek8CPU* cpu);
+
+/**
+* @brief Seeds the random number generators of the lanes, each lane getting a
+* distinct sequence: the lane l draws the same numbers as a CPU seeded with
+* `seed` + l (see `snek8_cpuSeed`).
+*
+* @param[in, out] `batch`.
+* @param[in] `seed`.
+*/
+void
+snek8_batchSeed(Snek8Batch* batch, uint32_t seed);
+
+/**
+* @brief Sets the number of instructions the lanes execute per emulated second (see
+* `snek8_cpuSetIPS`).
+*
+* @param[in, out] `batch`.
+* @param[in] `ips` The new rate (1 <= ips <= `SNEK8_CPU_MAX_IPS`).
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - `SNEK8_EXECOUT_INDEX_OUT_RANGE`.
+*/
+enum Snek8ExecutionOutput
+snek8_batchSetIPS(Snek8Batch* batch, uint32_t ips);
+
+/**
+* @brief Sets the key set of a lane, the changed keys driving a pending LD V{0xX}, K
+* as `snek8_cpuSetKey` does for a CPU.
+*
+* @param[in, out] `batch`.
+* @param[in] `lane`.
+* @param[in] `keys` The new key set, the bit k being the key k.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - `SNEK8_EXECOUT_INDEX_OUT_RANGE`.
+*/
+enum Snek8ExecutionOutput
+snek8_batchSetKeys(Snek8Batch* batch, size_t lane, uint16_t keys);
+
+/**
+* @brief Executes up to `max_cycles` steps of the batch.
+*
+* Each lane behaves as a CPU run by `snek8_cpuRun` without break flags, except that
+* LD V{0xX}, K does not stop the batch (a waiting lane keeps re-executing it until
+* `snek8_batchSetKeys` completes it) and that a lane whose instruction fails halts
+* instead. The run returns early once every lane is halted.
+*
+* When all the lanes jump back in lockstep to the start of idle loops, or wait for a
+* key, the steps until the next timer tick (or all of them, if no loop reads a
+* running delay timer) are retired at once, as `snek8_cpuRun` does for a CPU (see
+* `snek8_cpuIdleLoop`), provided the loops' lengths divide them.
+*
+* @param[in, out] `batch`.
+* @param[in] `max_cycles` The maximum number of steps to execute.
+* @return The number of steps executed.
+*/
+size_t
+snek8_batchRun(Snek8Batch* batch, size_t max_cycles);
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_BATCH_H
@@ -0,0 +1,57 @@
+/**
+* @file blit.h
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Declaration of the screen blitter.
+*
+* The blitter renders the packed screen (one 64-bit word per row, see
+* `Snek8CPU.graphics`) into a 32-bit image, each pixel of the screen becoming a
+* `scale` x `scale` square of the foreground or background colour. The colours are
+* written as native 32-bit integers, so 0xAARRGGBB values produce the layout of the
+* ARGB32 images of Qt and of most toolkits.
+*
+* Only the first line of each screen row is computed, 4 pixels at a time with SSE2
+* when the target supports it: a nibble (or a pair of bits at scale 2) of the row is
+* broadcast and compared against per-lane bit masks, and the resulting lane masks
+* select between the two colours. The remaining `scale - 1` lines are copies of it.
+*/
+#ifndef SNEK8_BLIT_H
+    #define SNEK8_BLIT_H
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include "cpu.h"
+
+/**
+* @def SNEK8_BLIT_MAX_SCALE
+* @brief The largest scale factor of the blitter.
+*/
+#define SNEK8_BLIT_MAX_SCALE            64
+
+/**
+* @brief Renders rows of the screen into a 32-bit image of
+* (`SNEK8_GRAPHICS_WIDTH` * `scale`) x (`SNEK8_GRAPHICS_HEIGTH` * `scale`) pixels.
+*
+* @param[in] `rows` The packed screen, `SNEK8_GRAPHICS_HEIGTH` rows.
+* @param[in] `mask` The rows to render: the bit y stands for the row y (e.g. the
+*            damage of the screen). The lines of the other rows are left untouched.
+* @param[out] `image`.
+* @param[in] `stride` The distance between two lines of the image, in pixels
+*            (at least `SNEK8_GRAPHICS_WIDTH` * `scale`).
+* @param[in] `scale` 1 <= scale <= `SNEK8_BLIT_MAX_SCALE`.
+* @param[in] `foreground` The colour of the active pixels.
+* @param[in] `background` The colour of the inactive pixels.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - `SNEK8_EXECOUT_INDEX_OUT_RANGE`: invalid scale or stride.
+*/
+enum Snek8ExecutionOutput
+snek8_blit(const uint64_t* rows, uint32_t mask, uint32_t* image, size_t stride, size_t scale,
+           uint32_t foreground, uint32_t background);
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_BLIT_H
@@ -0,0 +1,176 @@
+/**
+* @file block.h
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Declaration of the block cache and of the block engine.
+*
+* Chip8 programs are small and, with few exceptions, never modify their own code.
+* The block engine exploits that by decoding each straight-line run of instructions
+* (a basic block) only once: the first time the program counter reaches a given
+* address, the instructions starting there are decoded, with their operands already
+* extracted, up to and including the first instruction that either transfers
+* control (JP, CALL, RET), draws (DRW), waits for a key (LD V{0xX}, K), accesses the
+* timers or writes to the memory (LD B, V{0xX} and LD [I], V{0xX}). The skips do not
+* end a block, which carries on with the instructions executed when they do not skip
+* (a skip that skips goes on past the skipped instruction, within the block wherever
+* it can), and neither do the forward jumps and calls, which the block follows to their
+* target. From then on, the block is executed straight from
+* the cache, without fetching and decoding.
+*
+* The cache keeps a bitmap of the memory bytes covered by its blocks. Whenever an
+* instruction writes to a covered byte, no matter the engine that executes it, the
+* whole cache is flushed, so self-modifying programs stay correct. Blocks are
+* rebuilt lazily on their next execution.
+*/
+#ifndef SNEK8_BLOCK_H
+    #define SNEK8_BLOCK_H
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include "cpu.h"
+
+/**
+* @def SNEK8_BLOCK_MAX_OPS
+* @brief The maximum number of instructions of a single block.
+*/
+#define SNEK8_BLOCK_MAX_OPS              32
+
+/**
+* @def SNEK8_BLOCK_POOL_OPS
+* @brief The number of pre-decoded instructions that the cache can hold. When full,
+* the cache is flushed.
+*
+* @note A ROM cannot have more than `SNEK8_SIZE_MAX_ROM_FILE / 2` instructions, so
+* the pool only fills up when the same code is entered at many distinct addresses.
+*/
+#define SNEK8_BLOCK_POOL_OPS             2048
+
+/**
+* @def SNEK8_BLOCK_COVERAGE_WORDS
+* @brief The number of 64-bit words of the coverage bitmap (one bit per byte of RAM).
+*/
+#define SNEK8_BLOCK_COVERAGE_WORDS       (SNEK8_SIZE_RAM / 64)
+
+/**
+* @brief A pre-decoded instruction.
+*
+* @param `handler` Where the block engine executes the instruction under the quirk set
+*        of the cache, resolved when the block engine first enters the block (only
+*        used where the compiler supports computed gotos).
+* @param `family` The instruction family (see `enum Snek8InstructionFamily`).
+* @param `x` The second most significant nibble of the opcode.
+* @param `y` The third most significant nibble of the opcode.
+* @param `n` The least significant nibble of the opcode.
+* @param `kk` The least significant byte of the opcode.
+* @param `nnn` The address held at the lowest 12 bits of the opcode.
+*/
+typedef struct{
+    const void* handler;
+    uint8_t family;
+    uint8_t x;
+    uint8_t y;
+    uint8_t n;
+    uint8_t kk;
+    uint16_t nnn;
+} Snek8BlockOp;
+
+/**
+* @brief The location of a block in the cache's pool.
+*
+* @param `first` The index of the block's first instruction in the pool.
+* @param `length` The number of instructions of the block, 0 if not cached.
+*/
+typedef struct{
+    uint16_t first;
+    uint16_t length;
+} Snek8BlockEntry;
+
+/**
+* @brief Implementation of the block cache.
+*
+* @param `entries` The blocks, indexed by the address (masked by
+*        `SNEK8_MEM_ADDR_RAM_END`) of their first instruction.
+* @param `ops` Pool of the pre-decoded instructions of all blocks.
+* @param `coverage` Bitmap of the memory bytes decoded into some block.
+* @param `code_pages` The memory pages holding a byte decoded into some block: the
+*        bit p is set for the page p. The writes to the other pages skip `coverage`.
+* @param `used` The number of instructions in use in the pool.
+* @param `quirks` The implementation flags (masked by `SNEK8_IMPLM_MODE_MASK`) the
+*        handlers of the instructions were resolved for. The block engine flushes the
+*        cache when it runs a CPU with other flags.
+*/
+struct Snek8BlockCache{
+    Snek8BlockEntry entries[SNEK8_SIZE_RAM];
+    Snek8BlockOp ops[SNEK8_BLOCK_POOL_OPS];
+    uint64_t coverage[SNEK8_BLOCK_COVERAGE_WORDS];
+    uint16_t code_pages;
+    uint16_t used;
+    uint8_t quirks;
+};
+
+/**
+* @brief Allocates an empty block cache.
+*
+* @return The new cache, or NULL if the allocation failed.
+* @note The cache must be released with `snek8_blockCacheDel`.
+*/
+Snek8BlockCache*
+snek8_blockCacheNew(void);
+
+/**
+* @brief Releases a block cache.
+*
+* @param[in, out] `cache` (may be NULL).
+*/
+void
+snek8_blockCacheDel(Snek8BlockCache* cache);
+
+/**
+* @brief Drops every block of the cache.
+*
+* @param[in, out] `cache`.
+*/
+void
+snek8_blockFlush(Snek8BlockCache* cache);
+
+/**
+* @brief Notifies the cache that the memory range [`addr`, `addr` + `len`) was
+* written to. The cache is flushed if any byte of the range belongs to a block.
+*
+* @param[in, out] `cache`.
+* @param[in] `addr` The first address written to.
+* @param[in] `len` The number of bytes written.
+*/
+void
+snek8_blockInvalidate(Snek8BlockCache* cache, uint16_t addr, size_t len);
+
+/**
+* @brief Retrieves the block starting at `pc`, decoding it first if it is not cached.
+*
+* @param[in, out] `cache`.
+* @param[in] `memory` The CPU's memory.
+* @param[in] `pc` The address of the block's first instruction.
+* @return The block's entry in the cache.
+*/
+const Snek8BlockEntry*
+snek8_blockBuild(Snek8BlockCache* cache, const uint8_t* memory, uint16_t pc);
+
+/**
+* @brief Block-cached alternative to `snek8_cpuRun`.
+*
+* Parameters, results and semantics are the same as the ones of `snek8_cpuRun`.
+* The cache used is the one attached to `cpu->blocks`.
+*
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`, also if no cache is attached to the CPU.
+* - Any error code returned by an instruction.
+*/
+enum Snek8ExecutionOutput
+snek8_cpuRunBlocks(Snek8CPU* cpu, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+                   enum Snek8RunStop* stop);
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_BLOCK_H
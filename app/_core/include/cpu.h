@@ -146,6 +146,12 @@
 */
 #define SNEK8_SIZE_FONTSET_PIXELS        80
 
+/**
+* @def SNEK8_SIZE_BCD_DIGITS
+* @brief The number of decimal digits LD B, V{0xX} stores.
+*/
+#define SNEK8_SIZE_BCD_DIGITS            3
+
 /**
 * @def SNEK8_SIZE_FONTSET_PIXEL_PER_SPRITE
 * @brief The total number of pixels that each fonteset character has.
@@ -158,6 +164,11 @@
 */
 #define SNEK8_SIZE_GRAPHICS              2048
 
+/**
+* @def SNEK8_SIZE_GRAPHICS_BYTES
+* @brief The number of bytes of the packed screen (one 64-bit word per row).
+*/
+#define SNEK8_SIZE_GRAPHICS_BYTES        256
 
 /**
 * @def SNEK8_GRAPHICS_WIDTH
@@ -175,6 +186,48 @@
 */
 #define SNEK8_GRAPHICS_HEIGTH            32
 
+/**
+* @def SNEK8_TIMER_FREQUENCY
+* @brief The frequency, in Hz, at which the delay and sound timers count down.
+*/
+#define SNEK8_TIMER_FREQUENCY            60
+
+/**
+* @def SNEK8_CPU_DEFAULT_IPS
+* @brief The default number of instructions the CPU executes per emulated second.
+*/
+#define SNEK8_CPU_DEFAULT_IPS            700
+
+/**
+* @def SNEK8_CPU_MAX_IPS
+* @brief The largest supported number of instructions per emulated second.
+*/
+#define SNEK8_CPU_MAX_IPS                100000000
+
+/**
+* @def SNEK8_SIZE_PAGE
+* @brief The size of the memory pages tracked by the snapshots (see `Snek8Snapshot`).
+*/
+#define SNEK8_SIZE_PAGE                  256
+
+/**
+* @def SNEK8_SIZE_PAGES
+* @brief The number of memory pages of CHIP8's RAM.
+*/
+#define SNEK8_SIZE_PAGES                 16
+
+/**
+* @def SNEK8_SNAPSHOT_VERSION
+* @brief The version of the snapshot format written by `snek8_cpuSnapshot`.
+*/
+#define SNEK8_SNAPSHOT_VERSION           3
+
+/**
+* @def SNEK8_SIZE_SNAPSHOT
+* @brief The size, in bytes, of a serialized snapshot.
+*/
+#define SNEK8_SIZE_SNAPSHOT              4448
+
 /**
 * @def SNEK8_MEM_ADDR_PROG_START
 * @brief The memory address where the sector dedicated to store the program starts.
@@ -212,6 +265,19 @@
 */
 #define SNEK8_IMPLM_MODE_FX_CHANGES_I     4
 
+/**
+* @def SNEK8_IMPLM_MODE_MASK
+* @brief All the implementation flags.
+*/
+#define SNEK8_IMPLM_MODE_MASK             7
+
+/**
+* @def SNEK8_SIZE_QUIRK_SETS
+* @brief The number of combinations of implementation flags. Each one gets its own set
+*        of instruction handlers, specialized for it (see `snek8_cpuSetImplmFlags`).
+*/
+#define SNEK8_SIZE_QUIRK_SETS             8
+
 /**
 * @def UNUSED
 * @brief Ignore an object or return value.
@@ -242,8 +308,38 @@ enum Snek8ExecutionOutput{
     SNEK8_EXECOUT_ROM_FILE_EXCEEDS_MAX_MEM,
     SNEK8_EXECOUT_EMPTY_STRUCT,
     SNEK8_EXECOUT_INDEX_OUT_RANGE,
+    SNEK8_EXECOUT_SNAPSHOT_INVALID,
+    SNEK8_EXECOUT_REPLAY_INVALID,
+    SNEK8_EXECOUT_OUT_OF_MEMORY,
+    SNEK8_EXECOUT_EXIT,
+    SNEK8_EXECOUT_INVALID_ARG,
+};
+
+/**
+* @brief Controls why a batched emulation run (see `snek8_cpuRun`) returned.
+*/
+enum Snek8RunStop{
+    SNEK8_RUNSTOP_CYCLES,
+    SNEK8_RUNSTOP_ERROR,
+    SNEK8_RUNSTOP_DRAW,
+    SNEK8_RUNSTOP_KEY_WAIT,
+    SNEK8_RUNSTOP_BREAKPOINT,   ///< Only returned by the debugger's run (see `debug.h`).
+    SNEK8_RUNSTOP_WATCHPOINT,   ///< Only returned by the debugger's run (see `debug.h`).
 };
 
+/**
+* @def SNEK8_RUN_BREAK_ON_DRAW
+* @brief A flag that will tell a batched run to return right after a DRW instruction.
+*/
+#define SNEK8_RUN_BREAK_ON_DRAW          1
+
+/**
+* @def SNEK8_RUN_BREAK_ON_KEY_WAIT
+* @brief A flag that will tell a batched run to return as soon as the LD V{0xX}, K
+*        instruction blocks waiting for a key.
+*/
+#define SNEK8_RUN_BREAK_ON_KEY_WAIT      2
+
 /*
 * Opcode emulations methods.
 *
@@ -348,35 +444,212 @@ snek8_stackPush(Snek8Stack* stack, uint16_t* pc, uint16_t opcode);
 enum Snek8ExecutionOutput
 snek8_stackPop(Snek8Stack* stack, uint16_t* pc);
 
+/**
+* @brief Identifies the family of an instruction, i.e. which of the instructions
+* below the opcode decodes to; invalid opcodes belong to the `NOP` family.
+*/
+enum Snek8InstructionFamily{
+    SNEK8_INSTRUC_NOP,
+    SNEK8_INSTRUC_CLS,
+    SNEK8_INSTRUC_RET,
+    SNEK8_INSTRUC_JMP_ADDR,
+    SNEK8_INSTRUC_CALL,
+    SNEK8_INSTRUC_SE_VX_BYTE,
+    SNEK8_INSTRUC_SNE_VX_BYTE,
+    SNEK8_INSTRUC_SE_VX_VY,
+    SNEK8_INSTRUC_LD_VX_BYTE,
+    SNEK8_INSTRUC_ADD_VX_BYTE,
+    SNEK8_INSTRUC_LD_VX_VY,
+    SNEK8_INSTRUC_OR_VX_VY,
+    SNEK8_INSTRUC_AND_VX_VY,
+    SNEK8_INSTRUC_XOR_VX_VY,
+    SNEK8_INSTRUC_ADD_VX_VY,
+    SNEK8_INSTRUC_SUB_VX_VY,
+    SNEK8_INSTRUC_SHR_VX_VY,
+    SNEK8_INSTRUC_SUBN_VX_VY,
+    SNEK8_INSTRUC_SHL_VX_VY,
+    SNEK8_INSTRUC_SNE_VX_VY,
+    SNEK8_INSTRUC_LD_I_ADDR,
+    SNEK8_INSTRUC_JP_V0_ADDR,
+    SNEK8_INSTRUC_RND_VX_BYTE,
+    SNEK8_INSTRUC_DRW_VX_VY_N,
+    SNEK8_INSTRUC_SKP_VX,
+    SNEK8_INSTRUC_SKNP_VX,
+    SNEK8_INSTRUC_LD_VX_DT,
+    SNEK8_INSTRUC_LD_VX_K,
+    SNEK8_INSTRUC_LD_DT_VX,
+    SNEK8_INSTRUC_LD_ST_VX,
+    SNEK8_INSTRUC_ADD_I_VX,
+    SNEK8_INSTRUC_LD_F_VX,
+    SNEK8_INSTRUC_LD_B_VX,
+    SNEK8_INSTRUC_LD_I_V0_VX,
+    SNEK8_INSTRUC_LD_VX_V0_I,
+    SNEK8_INSTRUC_COUNT,
+};
+
+/**
+* @def SNEK8_STATS
+* @brief Whether the CPUs collect execution statistics (see `Snek8Stats`). Off by
+* default, in which case the instrumentation compiles to nothing; build with
+* `-DSNEK8_STATS=1` to turn it on.
+*/
+#ifndef SNEK8_STATS
+    #define SNEK8_STATS 0
+#endif
+
+/**
+* @brief Execution statistics of a CPU, collected by every engine when `SNEK8_STATS`
+* is on.
+*
+* @param `families` The number of instructions of each family executed.
+* @param `cycles` The number of instructions retired.
+* @param `drw_pixels` The number of sprite pixels drawn by DRW.
+* @param `drw_collisions` The number of DRW that erased a pixel (set VF).
+* @param `skipped_cycles` The number of instructions of idle loops retired without
+*        being executed (see `snek8_cpuIdleLoop`). They count in `cycles`, not in
+*        `families`.
+* @param `wait_cycles` The number of idle cycles retired while LD V{0xX}, K waited for
+*        a key. They count in `cycles`, not in `families`, so that `cycles` is the sum
+*        of `families`, `skipped_cycles` and `wait_cycles`.
+*/
+typedef struct{
+    uint64_t families[SNEK8_INSTRUC_COUNT];
+    uint64_t cycles;
+    uint64_t drw_pixels;
+    uint64_t drw_collisions;
+    uint64_t skipped_cycles;
+    uint64_t wait_cycles;
+} Snek8Stats;
+
+#if SNEK8_STATS
+    #define SNEK8_STATS_INSTRUC(cpu, family)        ((cpu)->stats.families[(family)]++)
+    #define SNEK8_STATS_CYCLES(cpu, n)              ((cpu)->stats.cycles += (n))
+    #define SNEK8_STATS_DRAW(cpu, sprite, n, hit)   snek8_statsDraw(&(cpu)->stats, (sprite), (n), (hit))
+    #define SNEK8_STATS_IDLE(cpu, n)                ((cpu)->stats.wait_cycles += (n))
+    #define SNEK8_STATS_SKIPPED(cpu, n)             ((cpu)->stats.skipped_cycles += (n))
+#else
+    #define SNEK8_STATS_INSTRUC(cpu, family)        ((void) 0)
+    #define SNEK8_STATS_CYCLES(cpu, n)              ((void) 0)
+    #define SNEK8_STATS_DRAW(cpu, sprite, n, hit)   ((void) 0)
+    #define SNEK8_STATS_IDLE(cpu, n)                ((void) 0)
+    #define SNEK8_STATS_SKIPPED(cpu, n)             ((void) 0)
+#endif
+
+/**
+* @brief Cache of pre-decoded basic blocks used by the block engine.
+*
+* @see block.h.
+*/
+typedef struct Snek8BlockCache Snek8BlockCache;
+
+typedef struct Snek8CPU Snek8CPU;
+
+/*
+* @brief Function pointer representation the action of a given instruction.
+*/
+typedef enum Snek8ExecutionOutput (*Snek8InstructionExec)(Snek8CPU* cpu, uint16_t opcode);
+
 /**
 * @brief Implementation of the Chip8's CPU.
 *
+* The memory comes first, so that the engines index it from the CPU itself; the
+* fields they touch on every instruction follow, from `registers` to `graphics_dirty`,
+* and fit in one cache line (`SNEK8_CPU_SIZE_HOT` bytes) since the memory size is a
+* multiple of it. The colder fields, the stack and the screen come last. The
+* emulators of a pool align that line (see core.c).
+*
+* @param `memory` Array representation of Chip8's memory.
 * @param `registers` Chip8's 16 8-bit registers ranging from 0x0 to 0xF.
 * @param `pc` Chip8's program counter.
-* @param `sp` Chip8's stack pointer.
 * @param `ir` Chip8's 16-bit index register.
-* @param `st` Chip8's 8-bit sound timer register.
-* @param `dt` Chip8's 8-bit delay timer register.
-* @param `stack` Chip8's 16-level 16-bit stack.
-* @param `memory` Array representation of Chip8's memory.
 * @param `keys` Chip8's 16 key set. Each bit represent a key that is either pressed
 *         or released.
-* @param `graphics` Array representation of Chip8's screen.
+* @param `key_armed` The keys pressed since the CPU started waiting: the first of
+*        them to be released completes LD V{0xX}, K.
+* @param `dt` Chip8's 8-bit delay timer register.
+* @param `st` Chip8's 8-bit sound timer register.
 * @param `implm_flags`. Controls which implementation to follow.
-*/
-typedef struct{
+* @param `key_wait` Whether the CPU is suspended on LD V{0xX}, K. The program counter
+*        stays on the instruction until a key is pressed and released (see
+*        `snek8_cpuSetKey`); meanwhile the engines retire idle cycles instead of
+*        executing it again.
+* @param `ips` The number of instructions per emulated second. The timers tick
+*        `SNEK8_TIMER_FREQUENCY` times every `ips` instructions.
+* @param `cycles` The number of instructions executed since the initialization.
+* @param `exec_table` The handlers of the reference engine, by opcode, specialized
+*        for `implm_flags`: none of them tests the flags. Only `snek8_cpuInit` and
+*        `snek8_cpuSetImplmFlags` may change either field.
+* @param `timer_phase` The progress towards the next timer tick, in units of
+*        1 / (`SNEK8_TIMER_FREQUENCY` * `ips`) seconds (always less than `ips`).
+* @param `rng` The state of the CPU's random number generator (never 0), see
+*        `snek8_cpuRand`.
+* @param `graphics_gen` Generation of the screen, incremented whenever an instruction
+*        (CLS or DRW) modifies it, so consumers can detect changes.
+* @param `graphics_dirty` Damage of the screen: the bit y is set when an instruction
+*        touched the row y. Consumers clear it once they have redrawn the rows.
+* @param `dirty_pages` The memory pages written since the CPU was last synchronized
+*        with a snapshot: the bit p is set when the page p was touched.
+* @param `stack` Chip8's 16-level 16-bit stack, with the stack pointer.
+* @param `snapshot_id` The identifier of the snapshot the memory was last synchronized
+*        with (0 if none), see `Snek8Snapshot`.
+* @param `blocks` The block cache attached to the CPU (may be NULL). Memory writes
+*        performed by any engine invalidate it (see `block.h`).
+* @param `graphics` Packed representation of Chip8's screen: one 64-bit word per row,
+*        the pixel at column x being the bit (63 - x) of its row.
+* @param `stats` The execution statistics (only if `SNEK8_STATS` is on). They are not
+*        part of the state: snapshots and resets leave them untouched.
+*/
+struct Snek8CPU{
     uint8_t memory[SNEK8_SIZE_RAM];
-    uint8_t graphics[SNEK8_SIZE_GRAPHICS];
-    Snek8Stack stack;
     uint8_t registers[SNEK8_SIZE_REGISTERS];
-    uint16_t keys;
     uint16_t pc;
     uint16_t ir;
-    uint8_t implm_flags;
-    uint8_t sp;
-    uint8_t st;
+    uint16_t keys;
+    uint16_t key_armed;
     uint8_t dt;
-} Snek8CPU;
+    uint8_t st;
+    uint8_t implm_flags;
+    bool key_wait;
+    uint32_t ips;
+    uint64_t cycles;
+    const Snek8InstructionExec* exec_table;
+    uint32_t timer_phase;
+    uint32_t rng;
+    uint32_t graphics_gen;
+    uint32_t graphics_dirty;
+    uint16_t dirty_pages;
+    Snek8Stack stack;
+    uint64_t snapshot_id;
+    Snek8BlockCache* blocks;
+    uint64_t graphics[SNEK8_GRAPHICS_HEIGTH];
+#if SNEK8_STATS
+    Snek8Stats stats;
+#endif
+};
+
+/**
+* @def SNEK8_CPU_SIZE_HOT
+* @brief The size of the fields of `Snek8CPU` used by every instruction, one cache
+*        line.
+*/
+#define SNEK8_CPU_SIZE_HOT              64
+
+_Static_assert(!(offsetof(Snek8CPU, registers) % SNEK8_CPU_SIZE_HOT)
+               && offsetof(Snek8CPU, graphics_dirty) + sizeof(uint32_t)
+                  <= offsetof(Snek8CPU, registers) + SNEK8_CPU_SIZE_HOT,
+               "The hot fields of the CPU do not fit in a cache line.");
+
+/**
+* @brief CHIP8's hexadecimal font, one 5-byte sprite per digit, loaded at
+* `SNEK8_MEM_ADDR_FONTSET_START`.
+*/
+extern const uint8_t snek8_fontset[SNEK8_SIZE_FONTSET_PIXELS];
+
+/**
+* @brief The decimal digits of every byte, most significant first, as LD B, V{0xX}
+* stores them.
+*/
+extern const uint8_t snek8_bcd[256][SNEK8_SIZE_BCD_DIGITS];
 
 /**
 * @brief Set the CPU's field members to their initial values.
@@ -384,10 +657,46 @@ typedef struct{
 * @param[in, out] `cpu`.
 * @param[in] `mode` Determines which CHIP8 implementation to use.
 * @return SNEK8_EXECOUT_SUCCESS.
+* @note The CPU does not own its block cache: `cpu->blocks` is reset to NULL and any
+* cache previously attached has to be released by the caller.
 */
 enum Snek8ExecutionOutput
 snek8_cpuInit(Snek8CPU* cpu, uint8_t implm_flags);
 
+/**
+* @brief Resets the CPU to an image of a CPU, e.g. one taken right after loading a ROM,
+* with a single copy.
+*
+* @param[in, out] `cpu`.
+* @param[in] `image` The state to restore (its `blocks` is ignored).
+* @return A code representation on whether the execution was sucesseful.
+* @note The CPU keeps its block cache, which is flushed. The screen generation moves
+* forward so that the frontend redraws, and every memory page counts as dirty.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+*/
+enum Snek8ExecutionOutput
+snek8_cpuReset(Snek8CPU* cpu, const Snek8CPU* image);
+
+/**
+* @brief Zeroes execution statistics.
+*
+* @param[out] `stats`.
+*/
+void
+snek8_statsClear(Snek8Stats* stats);
+
+/**
+* @brief Counts a DRW in execution statistics.
+*
+* @param[in, out] `stats`.
+* @param[in] `sprite` The rows of the sprite.
+* @param[in] `n` The number of rows.
+* @param[in] `collision` Whether the DRW erased a pixel.
+*/
+void
+snek8_statsDraw(Snek8Stats* stats, const uint8_t* sprite, size_t n, bool collision);
+
 /**
 * @brief Loads a given program into CHIP8's memory.
 *
@@ -397,22 +706,228 @@ snek8_cpuInit(Snek8CPU* cpu, uint8_t implm_flags);
 * @note The following error codes can be returned by this function:
 * - `SNEK8_EXECOUT_EMPTY_STRUCT`.
 * - `SNEK8_EXECOUT_ROM_FILE_INVALID`.
+* - `SNEK8_EXECOUT_ROM_FILE_NOT_FOUND`.
 * - `SNEK8_EXECOUT_ROM_FILE_FAILED_TO_OPEN`.
 * - `SNEK8_EXECOUT_ROM_FILE_EXCEEDS_MAX_MEM`.
 * - `SNEK8_EXECOUT_ROM_FILE_FAILED_TO_READ`.
+* @note The file is read with `snek8_romRead` (see rom.h).
 */
 enum Snek8ExecutionOutput
 snek8_cpuLoadRom(Snek8CPU* cpu, const char* rom_file_path);
 
+/**
+* @brief Loads a program held in memory into CHIP8's memory.
+*
+* @param[in, out] `cpu`.
+* @param[in] `rom` The program.
+* @param[in] `size` The size of the program in bytes.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - `SNEK8_EXECOUT_ROM_FILE_INVALID`: NULL program of non-zero size.
+* - `SNEK8_EXECOUT_ROM_FILE_EXCEEDS_MAX_MEM`.
+*/
+enum Snek8ExecutionOutput
+snek8_cpuLoadRomBytes(Snek8CPU* cpu, const uint8_t* rom, size_t size);
+
+/**
+* @brief Draws a random byte from a xorshift32 generator.
+*
+* Every CPU owns its generator, so that instances are independent, reproducible from
+* their seed, and free of the global state (and locks) of the C library's `rand`.
+*
+* @param[in, out] `state` The state of the generator (never 0).
+* @return The most significant byte of the new state.
+*/
+static inline uint8_t
+snek8_cpuRand(uint32_t* state){
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return (uint8_t) (x >> 24);
+}
+
+/**
+* @brief Derives the state of a random number generator from a seed.
+*
+* @param[in] `seed`.
+* @return A nonzero state; nearby seeds give unrelated states (Knuth's multiplicative
+* hash).
+*/
+static inline uint32_t
+snek8_cpuSeedState(uint32_t seed){
+    uint32_t state = seed * UINT32_C(2654435761) ^ UINT32_C(0x9E3779B9);
+    return state? state: 1;
+}
+
+/**
+* @brief Seeds the CPU's random number generator, used by RND V{0xX}, 0xKK.
+*
+* @param[in, out] `cpu`.
+* @param[in] `seed`.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+*/
+enum Snek8ExecutionOutput
+snek8_cpuSeed(Snek8CPU* cpu, uint32_t seed);
+
+/**
+* @brief Sets the number of instructions the CPU executes per emulated second.
+*
+* The timers are driven by the executed instructions rather than by the wall clock,
+* so the emulation stays deterministic at any host speed.
+*
+* @param[in, out] `cpu`.
+* @param[in] `ips` The new rate (1 <= ips <= `SNEK8_CPU_MAX_IPS`).
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - `SNEK8_EXECOUT_INDEX_OUT_RANGE`.
+*/
+enum Snek8ExecutionOutput
+snek8_cpuSetIPS(Snek8CPU* cpu, uint32_t ips);
+
+/**
+* @brief Sets the implementation flags and selects the handlers specialized for them.
+*
+* The engines run the instructions that depend on a flag through a handler compiled
+* for each of its values, chosen from the flags once (here for the reference engine,
+* at the start of a run for the threaded and block engines), so that executing them
+* never tests the flags. The reference engine looks the handler of every opcode up in
+* a table of 64K entries per combination of flags, built the first time a CPU selects
+* it.
+*
+* @param[in, out] `cpu`.
+* @param[in] `implm_flags` A bitwise or combination of `SNEK8_IMPLM_MODE_*`.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+*/
+enum Snek8ExecutionOutput
+snek8_cpuSetImplmFlags(Snek8CPU* cpu, uint8_t implm_flags);
+
+/**
+* @brief A snapshot of the state of a CPU.
+*
+* `data` holds the state in the versioned, little-endian binary format below, so that
+* it can be stored or sent as is:
+*
+*         Offset | Size | Field
+*         -------|------|----------------------------------------
+*            0   |   4  | magic "S8ST"
+*            4   |   2  | version (`SNEK8_SNAPSHOT_VERSION`)
+*            6   |   1  | implementation flags
+*            7   |   1  | stack pointer
+*            8   |   2  | program counter
+*           10   |   2  | index register
+*           12   |   2  | keys
+*           14   |   1  | delay timer
+*           15   |   1  | sound timer
+*           16   |   8  | cycles
+*           24   |   4  | instructions per second
+*           28   |   4  | timers' clock phase
+*           32   |   4  | screen generation
+*           36   |   4  | screen damage
+*           40   |   4  | random number generator
+*           44   |  16  | registers V{0x0} to V{0xF}
+*           60   |  32  | stack
+*           92   | 256  | screen rows
+*          348   | 4096 | memory
+*         4444   |   1  | waiting for a key (0 or 1)
+*         4445   |   1  | reserved (0)
+*         4446   |   2  | keys pressed while waiting
+*
+* Snapshots are copy-on-write with respect to the CPU memory: the CPU tracks the
+* pages it writes (`Snek8CPU.dirty_pages`) and remembers the snapshot it was last
+* synchronized with. Saving into or restoring from that same snapshot only copies the
+* dirty pages; any other snapshot falls back to copying the whole memory.
+*
+* @param `id` Identifier of the current contents (0 if they were not written by
+*        `snek8_cpuSnapshot`, in which case restores copy everything).
+* @param `data` The serialized state.
+*/
+typedef struct{
+    uint64_t id;
+    uint8_t data[SNEK8_SIZE_SNAPSHOT];
+} Snek8Snapshot;
+
+/**
+* @brief Saves the state of the CPU into a snapshot. Of the implementation flags, only
+* the ones of `SNEK8_IMPLM_MODE_MASK` are saved.
+*
+* @param[in, out] `cpu`. Its memory becomes synchronized with the snapshot.
+* @param[in, out] `snapshot`.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+*/
+enum Snek8ExecutionOutput
+snek8_cpuSnapshot(Snek8CPU* cpu, Snek8Snapshot* snapshot);
+
+/**
+* @brief Serializes the state of the CPU in the snapshot format, without taking part
+* in the copy-on-write synchronization (the CPU is left untouched).
+*
+* @param[in] `cpu`.
+* @param[out] `data` A buffer of `SNEK8_SIZE_SNAPSHOT` bytes.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+*/
+enum Snek8ExecutionOutput
+snek8_cpuSerialize(const Snek8CPU* cpu, uint8_t* data);
+
+/**
+* @brief Validates a serialized snapshot.
+*
+* @param[in] `data`.
+* @param[in] `size` The size of `data` in bytes.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - `SNEK8_EXECOUT_SNAPSHOT_INVALID`: wrong size, magic or version, implementation
+*   flags out of `SNEK8_IMPLM_MODE_MASK`, or a field holds a value the CPU cannot be
+*   in.
+*/
+enum Snek8ExecutionOutput
+snek8_snapshotValidate(const uint8_t* data, size_t size);
+
+/**
+* @brief Restores the state of the CPU from a snapshot.
+*
+* The blocks decoded from the restored memory pages are invalidated. As on a reset,
+* the screen generation of the CPU is incremented and its whole screen marked as
+* damaged, whatever the snapshot holds, so that the consumers redraw the restored
+* screen. The CPU is left untouched if the snapshot is invalid.
+*
+* @param[in, out] `cpu`. Its memory becomes synchronized with the snapshot.
+* @param[in] `snapshot`.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - `SNEK8_EXECOUT_SNAPSHOT_INVALID`.
+*/
+enum Snek8ExecutionOutput
+snek8_cpuRestore(Snek8CPU* cpu, const Snek8Snapshot* snapshot);
+
 /**
 * @brief Toggle on/off a particular key.
 *
+* While the CPU waits on LD V{0xX}, K, the edges of the keys drive the instruction,
+* as on the COSMAC VIP: pressing a key arms it, and releasing an armed key loads it
+* into V{0xX} and resumes the execution past the instruction. Keys held before the
+* wait began do not count until they are pressed again.
+*
 * @param[in, out] `cpu`.
 * @param[in] `key`.
 * @param[in] `value`.
 * @return A code representation on whether the execution was sucesseful.
 * @note The following error codes can be returned by this function:
 * - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - `SNEK8_EXECOUT_INDEX_OUT_RANGE`: `key` is not a key.
 */
 enum Snek8ExecutionOutput
 snek8_cpuSetKey(Snek8CPU* cpu, size_t key, bool value);
@@ -420,29 +935,26 @@ snek8_cpuSetKey(Snek8CPU* cpu, size_t key, bool value);
 /**
 * @brief Retrieves the current value of the given key.
 *
-* @param[in, out] `cpu`.
+* @param[in] `cpu`.
 * @param[in] `key`.
 * @return The value of the key.
 */
 static inline bool
-snek8_cpuGetKeyVal(Snek8CPU cpu, size_t key){
-    return (cpu.keys & (1u << key))? true: false;
+snek8_cpuGetKeyVal(const Snek8CPU* cpu, size_t key){
+    return (key < SNEK8_SIZE_KEYSET && (cpu->keys & (1u << key)))? true: false;
 }
 
-/*
-* @brief Function pointer representation the action of a given instruction.
-*/
-typedef enum Snek8ExecutionOutput (*Snek8InstructionExec)(Snek8CPU* cpu, uint16_t opcode);
-
 /*
 * @brief Representation of a Chip8's instruction.
 *
-* @param `code` The string representation of the instruction.
+* @param `code` The string representation of the instruction (a static string).
 * @param `exec` The function pointer that executes the instruction on the cpu.
+* @param `family` The family of the instruction.
 */
 typedef struct{
-    char code[30];
+    const char* code;
     Snek8InstructionExec exec;
+    enum Snek8InstructionFamily family;
 } Snek8Instruction;
 
 /**
@@ -454,6 +966,54 @@ typedef struct{
 Snek8Instruction
 snek8_opcodeDecode(uint16_t opcode);
 
+/**
+* @brief Retrieves the name of an instruction family, e.g. "DRW_VX_VY_N".
+*
+* @param[in] `family`.
+* @return The name, or NULL if `family` is not a family.
+*/
+const char*
+snek8_familyName(enum Snek8InstructionFamily family);
+
+/**
+* @def SNEK8_SIZE_OPCODE_TABLE
+* @brief The number of entries of the opcode dispatch table (one per 16-bit opcode).
+*/
+#define SNEK8_SIZE_OPCODE_TABLE          65536
+
+/**
+* @brief Build the opcode dispatch table.
+*
+* The table caches, for every 16-bit opcode, the function pointer and the family
+* returned by `snek8_opcodeDecode`. The table is built once, even by concurrent calls;
+* subsequent calls return immediately.
+*
+* @note `snek8_cpuInit` calls this function, so it only has to be called explicitly
+* by code that executes instructions on a CPU that was not initialized by it.
+*/
+void
+snek8_opcodeTableInit(void);
+
+/**
+* @brief Retrieves the function pointer that executes the given opcode.
+*
+* @param[in] `opcode`.
+* @return The cached `exec` member of `snek8_opcodeDecode(opcode)`.
+* @note `snek8_opcodeTableInit` must have been called beforehand.
+*/
+Snek8InstructionExec
+snek8_opcodeLookup(uint16_t opcode);
+
+/**
+* @brief Retrieves the instruction family of an opcode.
+*
+* @param[in] `opcode`.
+* @return The cached `family` member of `snek8_opcodeDecode(opcode)`.
+* @note `snek8_opcodeTableInit` must have been called beforehand.
+*/
+enum Snek8InstructionFamily
+snek8_opcodeFamily(uint16_t opcode);
+
 /**
 * @brief Execute a step in the emulation process.
 * 
@@ -461,13 +1021,211 @@ snek8_opcodeDecode(uint16_t opcode);
 * the update of the respective registers.
 *
 * @param[in, out] cpu
-* @param[out] instruction
+* @param[out] instruction The decoded instruction (may be NULL). When NULL, the
+*             instruction is executed through the dispatch table and no decoding
+*             takes place.
+* @note A CPU waiting on LD V{0xX}, K retires an idle cycle instead; `instruction`
+* still receives LD V{0xX}, K.
 * @return A code representation on whether the execution was sucesseful indicating,
 * if not, the problem ocurred.
 */
 enum Snek8ExecutionOutput
 snek8_cpuStep(Snek8CPU* cpu, Snek8Instruction* instruction);
 
+/**
+* @brief Execute up to `max_cycles` steps in a single call.
+*
+* The run returns early if an instruction fails, and, depending on `break_flags`,
+* right after a DRW instruction or once LD V{0xX}, K blocks waiting for a key.
+* Without `SNEK8_RUN_BREAK_ON_KEY_WAIT`, a CPU waiting for a key spends the remaining
+* cycles idle in one go (see `snek8_cpuRunWaiting`).
+*
+* @param[in, out] `cpu`.
+* @param[in] `max_cycles` The maximum number of instructions to execute.
+* @param[in] `break_flags` A bitwise or combination of `SNEK8_RUN_BREAK_ON_DRAW`
+*            and `SNEK8_RUN_BREAK_ON_KEY_WAIT`.
+* @param[out] `cycles` The number of instructions executed (may be NULL).
+* @param[out] `stop` Why the run returned (may be NULL).
+* @return The execution output of the last executed instruction.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - Any error code returned by an instruction.
+*/
+enum Snek8ExecutionOutput
+snek8_cpuRun(Snek8CPU* cpu, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+             enum Snek8RunStop* stop);
+
+/**
+* @brief Runs a CPU waiting on LD V{0xX}, K (`cpu->key_wait`).
+*
+* Nothing executes until a key completes the instruction, so the cycles are retired
+* at once: the clock and the timers advance as if LD V{0xX}, K had been executed
+* again on every cycle. With `SNEK8_RUN_BREAK_ON_KEY_WAIT`, a single cycle is retired
+* and the run stops with `SNEK8_RUNSTOP_KEY_WAIT`; otherwise all the `max_cycles` are.
+* The engines call this function for their waiting CPUs. Parameters and results are
+* the same as the ones of `snek8_cpuRun`.
+*/
+enum Snek8ExecutionOutput
+snek8_cpuRunWaiting(Snek8CPU* cpu, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+                    enum Snek8RunStop* stop);
+
+/**
+* @def SNEK8_IDLE_LOOP_MAX
+* @brief The number of instructions of the longest idle loop `snek8_cpuIdleLoop`
+* recognizes.
+*/
+#define SNEK8_IDLE_LOOP_MAX              16
+
+/**
+* @def SNEK8_IDLE_BACKOFF_MAX
+* @brief The largest number of backward jumps to a loop skipped by `Snek8IdleWatch`
+* between two searches.
+*/
+#define SNEK8_IDLE_BACKOFF_MAX           64
+
+/**
+* @brief Rate limits the searches for idle loops of a run, so that the loops that are
+* not idle (a counter, say) are only looked at now and then.
+*
+* @param `head` The target of the last backward jump.
+* @param `backoff` The number of jumps to `head` to skip after a failed search; it
+*        doubles at each failure.
+* @param `wait` The number of jumps to `head` still to skip.
+*/
+typedef struct{
+    uint16_t head;
+    uint8_t backoff;
+    uint8_t wait;
+} Snek8IdleWatch;
+
+/**
+* @def SNEK8_IDLE_WATCH_INIT
+* @brief The initializer of a `Snek8IdleWatch`.
+*/
+#define SNEK8_IDLE_WATCH_INIT            {.head = UINT16_MAX, .backoff = 0, .wait = 0}
+
+/**
+* @brief Decides whether to look for an idle loop at the target of a backward jump.
+*
+* @param[in, out] `watch`.
+* @param[in] `head` The target of the jump.
+*/
+static inline bool
+snek8_idleWatchDue(Snek8IdleWatch* watch, uint16_t head){
+    if (head != watch->head){
+        watch->head = head;
+        watch->backoff = 0;
+        watch->wait = 0;
+        return true;
+    }
+    if (watch->wait){
+        watch->wait--;
+        return false;
+    }
+    return true;
+}
+
+/**
+* @brief Records the outcome of a search for an idle loop at `watch->head`.
+*
+* @param[in, out] `watch`.
+* @param[in] `found`.
+*/
+static inline void
+snek8_idleWatchUpdate(Snek8IdleWatch* watch, bool found){
+    if (found){
+        watch->backoff = 0;
+    }
+    else if (watch->backoff < SNEK8_IDLE_BACKOFF_MAX){
+        watch->backoff = watch->backoff? 2 * watch->backoff: 1;
+    }
+    watch->wait = watch->backoff;
+}
+
+/**
+* @brief Finds out whether the program spins in an idle loop starting at `pc`.
+*
+* An idle loop only reads the registers, the delay timer and the keys, only writes
+* the registers, and comes back to `pc` with the registers it started with, e.g.
+* LD V{0x0}, DT; SE V{0x0}, 0x00; JP back, once V{0x0} holds the delay timer. Since
+* the keys only change between runs, every iteration then does the same until the
+* delay timer ticks (if the loop reads it), so the engines retire whole iterations
+* at once instead of executing them (see `snek8_cpuIdleCycles`). They look for idle
+* loops at the targets of the backward jumps. The loop is found by executing one
+* iteration on a copy of the registers.
+*
+* @param[in] `memory` The CPU's memory.
+* @param[in] `pc` The address where the loop would start.
+* @param[in] `registers` The CPU's registers.
+* @param[in] `dt` The CPU's delay timer.
+* @param[in] `keys` The CPU's key set.
+* @param[in] `implm_flags` The CPU's implementation flags.
+* @param[out] `reads_dt` Whether the loop reads the delay timer.
+* @return The number of instructions of an iteration, at most `SNEK8_IDLE_LOOP_MAX`,
+* or 0 if `pc` does not start an idle loop.
+*/
+size_t
+snek8_cpuIdleLoop(const uint8_t* memory, uint16_t pc, const uint8_t* registers, uint8_t dt,
+                  uint16_t keys, uint8_t implm_flags, bool* reads_dt);
+
+/**
+* @brief Retires at once the iterations of the idle loop starting at the CPU's program
+* counter, if any (see `snek8_cpuIdleLoop` and `snek8_cpuIdleCycles`).
+*
+* The timers' clock and the timers advance, but the instructions are left for the
+* caller to count in `cpu->cycles`, as the engines count theirs. The engines call this
+* function at the targets of the backward jumps, when `watch` lets them.
+*
+* @param[in, out] `cpu`.
+* @param[in, out] `watch` The rate limiter of the run, updated with the outcome.
+* @param[in] `budget` The number of instructions left to the run.
+* @return The number of instructions retired.
+*/
+size_t
+snek8_cpuIdleSkip(Snek8CPU* cpu, Snek8IdleWatch* watch, size_t budget);
+
+/**
+* @brief Threaded-code alternative to `snek8_cpuRun`.
+*
+* All instructions are inlined into a single loop that keeps the program counter,
+* the index register, the timers and the registers in local variables, and that
+* dispatches through computed gotos when the compiler supports them (GCC, Clang),
+* falling back to a `switch` otherwise. Parameters, results and semantics are the
+* same as the ones of `snek8_cpuRun`.
+*/
+enum Snek8ExecutionOutput
+snek8_cpuRunThreaded(Snek8CPU* cpu, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+                     enum Snek8RunStop* stop);
+
+/**
+* @brief Identifies an execution engine, i.e. an implementation of a batched run.
+*
+* @note `SNEK8_ENGINE_BLOCK` requires a block cache attached to the CPU (see
+* `block.h`).
+*/
+enum Snek8Engine{
+    SNEK8_ENGINE_REFERENCE,
+    SNEK8_ENGINE_THREADED,
+    SNEK8_ENGINE_BLOCK,
+    SNEK8_ENGINE_COUNT,
+};
+
+/*
+* @brief Function pointer representation of an execution engine.
+*/
+typedef enum Snek8ExecutionOutput (*Snek8RunEngine)(Snek8CPU* cpu, size_t max_cycles,
+                                                    uint8_t break_flags, size_t* cycles,
+                                                    enum Snek8RunStop* stop);
+
+/**
+* @brief Retrieves the batched run implemented by the given engine.
+*
+* @param[in] `engine`.
+* @return The engine's run function, or NULL if `engine` is not a valid engine.
+*/
+Snek8RunEngine
+snek8_cpuGetRunEngine(enum Snek8Engine engine);
+
 /**
 * @brief The instruction representation of any instruction given by an invalid opcode.
 *
@@ -747,7 +1505,8 @@ snek8_cpuJP_V0_ADDR(Snek8CPU* cpu, uint16_t opcode);
 
 /**
 * @brief Generate a random 8-bit integer and performs a bitwise and operation with the
-* given byte; the result is stored into the register V{0xX}.
+* given byte; the result is stored into the register V{0xX}. The random byte comes
+* from the CPU's own generator (see `snek8_cpuRand`).
 *
 * Opcode: 0xCXKK.
 * Code: RND V{0xX}, 0xKK
@@ -757,11 +1516,176 @@ snek8_cpuJP_V0_ADDR(Snek8CPU* cpu, uint16_t opcode);
 enum Snek8ExecutionOutput
 snek8_cpuRND_VX_BYTE(Snek8CPU* cpu, uint16_t opcode);
 
-static inline uint8_t*
-snek8_cpuGetPixel(Snek8CPU* cpu, size_t x, size_t y){
-    size_t idx_x = x & 63;
-    size_t idx_y = y & 31;
-    return &cpu->graphics[idx_y * SNEK8_GRAPHICS_WIDTH + idx_x];
+/**
+* @brief Advances the timers' clock by `n` instructions.
+*
+* The clock is a Bresenham accumulator: each instruction adds `SNEK8_TIMER_FREQUENCY`
+* to the phase and the timers tick once for each `ips` accumulated, so exactly
+* `SNEK8_TIMER_FREQUENCY` ticks happen every `ips` instructions, evenly spaced.
+*
+* @param[in, out] `phase` The clock's phase (less than `ips`).
+* @param[in] `ips` The number of instructions per emulated second.
+* @param[in] `n` The number of instructions executed, at most
+*        (`UINT32_MAX` - `ips`) / `SNEK8_TIMER_FREQUENCY`, i.e. about 70 millions at
+*        `SNEK8_CPU_MAX_IPS`, so that the phase does not overflow (see
+*        `snek8_cpuClockIdle` for longer runs).
+* @return The number of timer ticks due.
+*/
+static inline uint32_t
+snek8_cpuClockTicks(uint32_t* phase, uint32_t ips, uint32_t n){
+    *phase += SNEK8_TIMER_FREQUENCY * n;
+    if (*phase < ips){
+        return 0;
+    }
+    uint32_t ticks = *phase / ips;
+    *phase -= ticks * ips;
+    return ticks;
+}
+
+/**
+* @brief Advances the timers' clock by `n` idle instructions and ticks the timers.
+*
+* Unlike `snek8_cpuClockTicks`, `n` may be arbitrarily large: the instructions are
+* split in whole emulated seconds so that no product overflows, and past 5 seconds
+* the timers are 0 whatever their value.
+*
+* @param[in, out] `phase` The clock's phase (less than `ips`).
+* @param[in] `ips` The number of instructions per emulated second.
+* @param[in, out] `dt` The delay timer.
+* @param[in, out] `st` The sound timer.
+* @param[in] `n` The number of instructions.
+*/
+static inline void
+snek8_cpuClockIdle(uint32_t* phase, uint32_t ips, uint8_t* dt, uint8_t* st, uint64_t n){
+    uint64_t seconds = n / ips;
+    uint64_t total = *phase + (uint64_t) SNEK8_TIMER_FREQUENCY * (n % ips);
+    uint64_t ticks = (seconds > UINT8_MAX / SNEK8_TIMER_FREQUENCY)?
+                     UINT8_MAX: SNEK8_TIMER_FREQUENCY * seconds + total / ips;
+    *phase = (uint32_t) (total % ips);
+    *dt = (*dt > ticks)? (uint8_t) (*dt - ticks): 0;
+    *st = (*st > ticks)? (uint8_t) (*st - ticks): 0;
+}
+
+/**
+* @brief Computes the number of instructions left before the next timer tick, i.e.
+* until the end of the current 60 Hz frame.
+*
+* @param[in] `cpu`.
+*/
+static inline size_t
+snek8_cpuCyclesToFrame(const Snek8CPU* cpu){
+    return (cpu->ips - cpu->timer_phase + SNEK8_TIMER_FREQUENCY - 1) / SNEK8_TIMER_FREQUENCY;
+}
+
+/**
+* @brief Computes how many instructions of an idle loop can be retired at once:
+* whole iterations, at most `budget` instructions, and none past the next timer tick
+* if the loop reads a running delay timer, since the iterations after it differ.
+*
+* @param[in] `length` The number of instructions of an iteration (see
+*            `snek8_cpuIdleLoop`).
+* @param[in] `reads_dt` Whether the loop reads the delay timer.
+* @param[in] `dt` The delay timer.
+* @param[in] `phase` The timers' clock phase.
+* @param[in] `ips` The number of instructions per emulated second.
+* @param[in] `budget` The number of instructions left to the run.
+*/
+static inline size_t
+snek8_cpuIdleCycles(size_t length, bool reads_dt, uint8_t dt, uint32_t phase, uint32_t ips,
+                    size_t budget){
+    if (reads_dt && dt){
+        // The tick happens as the frame's last instruction retires, so that one still
+        // reads the old delay timer.
+        size_t frame = (ips - phase + SNEK8_TIMER_FREQUENCY - 1) / SNEK8_TIMER_FREQUENCY;
+        budget = (frame < budget)? frame: budget;
+    }
+    return budget - budget % length;
+}
+
+/**
+* @brief Retrieves whether the pixel at (`x`, `y`) is active. Coordinates wrap around
+* the screen.
+*
+* @param[in] `cpu`.
+* @param[in] `x`.
+* @param[in] `y`.
+*/
+static inline bool
+snek8_cpuGetPixel(const Snek8CPU* cpu, size_t x, size_t y){
+    return (cpu->graphics[y & 31] >> (63u - (x & 63))) & 0x1u;
+}
+
+/**
+* @brief Places a sprite byte on a screen row, with its most significant bit at
+* column `x` and wrapping around the right edge of the screen.
+*
+* @param[in] `byte` The sprite byte.
+* @param[in] `x` The column of the sprite's leftmost pixel (0 <= x < 64).
+* @return The row mask of the sprite's pixels.
+*/
+static inline uint64_t
+snek8_cpuSpriteRow(uint8_t byte, uint8_t x){
+    uint64_t row = (uint64_t) byte << 56;
+    return (row >> x) | (row << ((64u - x) & 63u));
+}
+
+/**
+* @brief Computes the rows touched by a sprite, wrapping around the bottom edge of
+* the screen.
+*
+* @param[in] `y` The row of the sprite's top line.
+* @param[in] `n` The number of lines of the sprite (0 <= n <= 15).
+* @return The mask of the rows, the bit y standing for the row y.
+*/
+static inline uint32_t
+snek8_cpuSpriteRows(uint8_t y, uint8_t n){
+    uint32_t rows = (UINT32_C(1) << n) - 1u;
+    uint8_t shift = y & 31u;
+    return (rows << shift) | (rows >> ((32u - shift) & 31u));
+}
+
+/**
+* @brief Computes the memory pages spanned by a write.
+*
+* @param[in] `addr` The first address written to.
+* @param[in] `len` The number of bytes written (1 <= len, `addr` + `len` <= 4096).
+* @return The mask of the pages, the bit p standing for the page p.
+*/
+static inline uint16_t
+snek8_cpuPagesMask(uint16_t addr, size_t len){
+    unsigned first = addr / SNEK8_SIZE_PAGE;
+    unsigned last = (unsigned) (addr + len - 1) / SNEK8_SIZE_PAGE;
+    return (uint16_t) (((2u << last) - 1u) & ~((1u << first) - 1u));
+}
+
+/**
+* @brief Copies between the registers and the memory, as LD [I], V{0xX} and
+* LD V{0xX}, [I] do.
+*
+* The copy takes two fixed-size moves that overlap as needed, instead of a call to
+* `memcpy` or a loop over the bytes, and touches no byte past `len`.
+*
+* @param[out] `dst`.
+* @param[in] `src` Not overlapping `dst`.
+* @param[in] `len` The number of bytes (1 <= len <= `SNEK8_SIZE_REGISTERS`).
+*/
+static inline void
+snek8_cpuCopyRegisters(uint8_t* restrict dst, const uint8_t* restrict src, size_t len){
+    if (len >= 8){
+        (void) memcpy(dst, src, 8);
+        (void) memcpy(dst + len - 8, src + len - 8, 8);
+    }
+    else if (len >= 4){
+        (void) memcpy(dst, src, 4);
+        (void) memcpy(dst + len - 4, src + len - 4, 4);
+    }
+    else if (len >= 2){
+        (void) memcpy(dst, src, 2);
+        (void) memcpy(dst + len - 2, src + len - 2, 2);
+    }
+    else{
+        *dst = *src;
+    }
 }
 
 /**
@@ -773,8 +1697,10 @@ snek8_cpuGetPixel(Snek8CPU* cpu, size_t x, size_t y){
 * @return Always returns `SNEK8_EXECOUT_SUCCESS`.
 *
 * @note The Chip8's original screen has 32x64 pixels. In our implementation, we represent
-* the screen as a contiguous block of 8-bit integers that can either be activated (1)
+* each row of the screen as a 64-bit integer whose bits can either be activated (1)
 * or deactivated (0), representing thus the black-white color scheme dealt by CHIP8.
+* Each byte of the sprite is placed on its row with `snek8_cpuSpriteRow`, so drawing
+* it takes a single XOR, and the collision a single AND.
 *
 * A sprite is an array of 8-bit integers whose length ranges from 1 to 16. The 
 * begining of the sprite is determined by the index register while its length is
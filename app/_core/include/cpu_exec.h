@@ -0,0 +1,405 @@
+/**
+* @file cpu_exec.h
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Engine-independent bodies of the Chip8's instructions.
+*
+* The reference engine executes every instruction through its own function (see
+* `cpu.h`). The faster engines instead inline all instructions into a single loop and
+* keep the hot CPU state in local variables. So that those engines share a single
+* copy of the instructions' semantics, each instruction body is defined here as a
+* macro written against the following accessors, which the including engine must
+* define beforehand:
+*
+*     - SNEK8_X_R(i)            lvalue of the register V{i}.
+*     - SNEK8_X_R_STORE(p, n)   copy the registers V0 to V{n - 1} to `p` (uint8_t*).
+*     - SNEK8_X_R_LOAD(p, n)    copy `n` bytes from `p` (const uint8_t*) to the
+*                               registers V0 to V{n - 1}.
+*     - SNEK8_X_PC              lvalue of the program counter.
+*     - SNEK8_X_IR              lvalue of the index register.
+*     - SNEK8_X_DT              lvalue of the delay timer.
+*     - SNEK8_X_ST              lvalue of the sound timer.
+*     - SNEK8_X_CLOCK           lvalue of the timers' clock phase.
+*     - SNEK8_X_IPS             the number of instructions per emulated second.
+*     - SNEK8_X_KEYS            value of the key set.
+*     - SNEK8_X_KEY_WAIT        lvalue (bool) of the waiting for a key state.
+*     - SNEK8_X_KEY_ARMED       lvalue of the keys pressed while waiting.
+*     - SNEK8_X_MEM             pointer (uint8_t*) to the memory.
+*     - SNEK8_X_MEM_END         the last address of the memory.
+*     - SNEK8_X_GFX             pointer (uint64_t*) to the packed screen rows.
+*     - SNEK8_X_GFX_GEN         lvalue of the screen's generation.
+*     - SNEK8_X_GFX_DIRTY       lvalue of the screen's dirty rows mask.
+*     - SNEK8_X_STACK           pointer to the Snek8Stack.
+*     - SNEK8_X_RAND()          a random integer.
+*     - SNEK8_X_FAIL(out)       abort the instruction with the execution output `out`.
+*     - SNEK8_X_ON_KEY_WAIT()   called when LD V{0xX}, K suspends the CPU.
+*     - SNEK8_X_ON_WRITE(a, n)  called after the `n` bytes starting at the address `a`
+*                               of the memory were written.
+*     - SNEK8_X_ON_DRAW(s, n, c) called after DRW drew the `n` rows of the sprite `s`
+*                               (uint8_t*), `c` telling whether it erased a pixel.
+*
+* Operands are passed already extracted from the opcode: `x` and `y` are the
+* registers' nibbles, `n` is the lsq, `kk` is the rightmost byte and `nnn` is the
+* address. The program counter is expected to point past the instruction, as in the
+* reference engine. The instructions that depend on an implementation flag take its
+* value as their last operand: the engines pass constants, from handlers specialized
+* for each value (see `SNEK8_EXEC_HANDLER_SETS`), so that the test folds away.
+*
+* @note The semantics must match the ones of the reference instructions in `cpu.c`.
+*/
+#ifndef SNEK8_CPU_EXEC_H
+    #define SNEK8_CPU_EXEC_H
+
+#include "cpu.h"
+
+/**
+* @def SNEK8_COMPUTED_GOTO
+* @brief Whether the compiler supports computed gotos (labels as values), which the
+* inlined engines use to give every instruction its own indirect branch.
+*/
+#if defined(__GNUC__) || defined(__clang__)
+    #define SNEK8_COMPUTED_GOTO 1
+#else
+    #define SNEK8_COMPUTED_GOTO 0
+#endif
+
+/**
+* @def SNEK8_OWN_BRANCHES
+* @brief Keeps GCC from merging the identical indirect branches of an engine into a
+* single one (cross-jumping), which would take back what the computed gotos give.
+*/
+#if defined(__GNUC__) && !defined(__clang__)
+    #define SNEK8_OWN_BRANCHES __attribute__((optimize("no-crossjumping")))
+#else
+    #define SNEK8_OWN_BRANCHES
+#endif
+
+/*
+* Retires `n` instructions: advances the timers' clock and ticks the timers as many
+* times as due (see `snek8_cpuClockTicks`).
+*/
+#define SNEK8_EXEC_CLOCK(n)                                                         \
+    do{                                                                             \
+        uint32_t _ticks = snek8_cpuClockTicks(&SNEK8_X_CLOCK, SNEK8_X_IPS,          \
+                                              (uint32_t) (n));                      \
+        if (_ticks){                                                                \
+            SNEK8_X_DT = (SNEK8_X_DT > _ticks)? SNEK8_X_DT - _ticks: 0;             \
+            SNEK8_X_ST = (SNEK8_X_ST > _ticks)? SNEK8_X_ST - _ticks: 0;             \
+        }                                                                           \
+    }while (0)
+
+#define SNEK8_EXEC_NOP()                                                            \
+    SNEK8_X_FAIL(SNEK8_EXECOUT_INVALID_OPCODE)
+
+#define SNEK8_EXEC_CLS()                                                            \
+    do{                                                                             \
+        (void) memset(SNEK8_X_GFX, 0, SNEK8_SIZE_GRAPHICS_BYTES);                   \
+        SNEK8_X_GFX_GEN++;                                                          \
+        SNEK8_X_GFX_DIRTY = UINT32_MAX;                                             \
+    }while (0)
+
+#define SNEK8_EXEC_RET()                                                            \
+    do{                                                                             \
+        if (0 == SNEK8_X_STACK->sp){                                                \
+            SNEK8_X_FAIL(SNEK8_EXECOUT_STACK_EMPTY);                                \
+        }                                                                           \
+        SNEK8_X_STACK->sp--;                                                        \
+        SNEK8_X_PC = SNEK8_X_STACK->buffer[SNEK8_X_STACK->sp];                      \
+    }while (0)
+
+#define SNEK8_EXEC_CALL(nnn)                                                        \
+    do{                                                                             \
+        if (SNEK8_SIZE_STACK == SNEK8_X_STACK->sp){                                 \
+            SNEK8_X_FAIL(SNEK8_EXECOUT_STACK_OVERFLOW);                             \
+        }                                                                           \
+        SNEK8_X_STACK->buffer[SNEK8_X_STACK->sp] = SNEK8_X_PC;                      \
+        SNEK8_X_STACK->sp++;                                                        \
+        SNEK8_X_PC = (nnn);                                                         \
+    }while (0)
+
+#define SNEK8_EXEC_JMP_ADDR(nnn)                                                    \
+    SNEK8_X_PC = (nnn)
+
+#define SNEK8_EXEC_SE_VX_BYTE(x, kk)                                                \
+    SNEK8_X_PC += (SNEK8_X_R(x) == (kk))? 2: 0
+
+#define SNEK8_EXEC_SNE_VX_BYTE(x, kk)                                               \
+    SNEK8_X_PC += (SNEK8_X_R(x) != (kk))? 2: 0
+
+#define SNEK8_EXEC_SE_VX_VY(x, y)                                                   \
+    SNEK8_X_PC += (SNEK8_X_R(x) == SNEK8_X_R(y))? 2: 0
+
+#define SNEK8_EXEC_SNE_VX_VY(x, y)                                                  \
+    SNEK8_X_PC += (SNEK8_X_R(x) != SNEK8_X_R(y))? 2: 0
+
+#define SNEK8_EXEC_LD_VX_BYTE(x, kk)                                                \
+    SNEK8_X_R(x) = (kk)
+
+#define SNEK8_EXEC_ADD_VX_BYTE(x, kk)                                               \
+    SNEK8_X_R(x) += (kk)
+
+#define SNEK8_EXEC_LD_VX_VY(x, y)                                                   \
+    SNEK8_X_R(x) = SNEK8_X_R(y)
+
+#define SNEK8_EXEC_OR_VX_VY(x, y)                                                   \
+    SNEK8_X_R(x) |= SNEK8_X_R(y)
+
+#define SNEK8_EXEC_AND_VX_VY(x, y)                                                  \
+    SNEK8_X_R(x) &= SNEK8_X_R(y)
+
+#define SNEK8_EXEC_XOR_VX_VY(x, y)                                                  \
+    SNEK8_X_R(x) ^= SNEK8_X_R(y)
+
+#define SNEK8_EXEC_ADD_VX_VY(x, y)                                                  \
+    do{                                                                             \
+        uint8_t _carry = (UINT8_MAX - SNEK8_X_R(x)) < SNEK8_X_R(y)? 1: 0;           \
+        SNEK8_X_R(x) += SNEK8_X_R(y);                                               \
+        SNEK8_X_R(0xF) = _carry;                                                    \
+    }while (0)
+
+#define SNEK8_EXEC_SUB_VX_VY(x, y)                                                  \
+    do{                                                                             \
+        uint8_t _not_borrow = SNEK8_X_R(x) >= SNEK8_X_R(y)? 1: 0;                   \
+        SNEK8_X_R(x) -= SNEK8_X_R(y);                                               \
+        SNEK8_X_R(0xF) = _not_borrow;                                               \
+    }while (0)
+
+#define SNEK8_EXEC_SUBN_VX_VY(x, y)                                                 \
+    do{                                                                             \
+        uint8_t _not_borrow = SNEK8_X_R(y) >= SNEK8_X_R(x)? 1: 0;                   \
+        SNEK8_X_R(x) = SNEK8_X_R(y) - SNEK8_X_R(x);                                 \
+        SNEK8_X_R(0xF) = _not_borrow;                                               \
+    }while (0)
+
+#define SNEK8_EXEC_SHR_VX_VY(x, y, use_vy)                                          \
+    do{                                                                             \
+        uint8_t _underflow = SNEK8_X_R(x) & 0x1;                                    \
+        if (use_vy){                                                                \
+            SNEK8_X_R(x) = SNEK8_X_R(y);                                            \
+        }                                                                           \
+        SNEK8_X_R(x) >>= 1;                                                         \
+        SNEK8_X_R(0xF) = _underflow;                                                \
+    }while (0)
+
+#define SNEK8_EXEC_SHL_VX_VY(x, y, use_vy)                                          \
+    do{                                                                             \
+        uint8_t _overflow = (SNEK8_X_R(x) & 0x80) >> 7u;                            \
+        if (use_vy){                                                                \
+            SNEK8_X_R(x) = SNEK8_X_R(y);                                            \
+        }                                                                           \
+        SNEK8_X_R(x) <<= 1;                                                         \
+        SNEK8_X_R(0xF) = _overflow;                                                 \
+    }while (0)
+
+#define SNEK8_EXEC_LD_I_ADDR(nnn)                                                   \
+    SNEK8_X_IR = (nnn)
+
+#define SNEK8_EXEC_JP_V0_ADDR(x, nnn, uses_vx)                                      \
+    SNEK8_X_PC = (nnn) + SNEK8_X_R((uses_vx)? (x): 0)
+
+#define SNEK8_EXEC_RND_VX_BYTE(x, kk)                                               \
+    SNEK8_X_R(x) = SNEK8_X_RAND() & (kk)
+
+#define SNEK8_EXEC_DRW_VX_VY_N(x, y, n)                                             \
+    do{                                                                             \
+        SNEK8_X_R(0xF) = 0;                                                         \
+        if (SNEK8_X_IR + (n) > SNEK8_X_MEM_END){                                    \
+            SNEK8_X_FAIL(SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS);                     \
+        }                                                                           \
+        uint8_t _px = SNEK8_X_R(x) & 63;                                            \
+        uint8_t _py = SNEK8_X_R(y);                                                 \
+        uint64_t _collision = 0;                                                    \
+        for (uint8_t _col = 0; _col < (n); _col++){                                 \
+            uint64_t _sprite = snek8_cpuSpriteRow(SNEK8_X_MEM[SNEK8_X_IR + _col], _px); \
+            uint64_t* _line = SNEK8_X_GFX + ((_py + _col) & 31);                    \
+            _collision |= *_line & _sprite;                                         \
+            *_line ^= _sprite;                                                      \
+        }                                                                           \
+        SNEK8_X_R(0xF) = _collision? 1: 0;                                          \
+        SNEK8_X_GFX_GEN++;                                                          \
+        SNEK8_X_GFX_DIRTY |= snek8_cpuSpriteRows(_py, (n));                         \
+        SNEK8_X_ON_DRAW(SNEK8_X_MEM + SNEK8_X_IR, (n), 0 != _collision);            \
+    }while (0)
+
+#define SNEK8_EXEC_KEY_DOWN(key)                                                    \
+    ((key) < SNEK8_SIZE_KEYSET && ((SNEK8_X_KEYS >> (key)) & 0x1u))
+
+#define SNEK8_EXEC_SKP_VX(x)                                                        \
+    SNEK8_X_PC += SNEK8_EXEC_KEY_DOWN(SNEK8_X_R(x))? 2: 0
+
+#define SNEK8_EXEC_SKNP_VX(x)                                                       \
+    SNEK8_X_PC += SNEK8_EXEC_KEY_DOWN(SNEK8_X_R(x))? 0: 2
+
+#define SNEK8_EXEC_LD_VX_DT(x)                                                      \
+    SNEK8_X_R(x) = SNEK8_X_DT
+
+/*
+* V{0xX} is loaded once a key is pressed and released, by `snek8_cpuSetKey`; until
+* then the program counter stays on the instruction.
+*/
+#define SNEK8_EXEC_LD_VX_K(x)                                                       \
+    do{                                                                             \
+        (void) (x);                                                                 \
+        if (!SNEK8_X_KEY_WAIT){                                                     \
+            SNEK8_X_KEY_WAIT = true;                                                \
+            SNEK8_X_KEY_ARMED = 0;                                                  \
+        }                                                                           \
+        SNEK8_X_PC -= 2;                                                            \
+        SNEK8_X_ON_KEY_WAIT();                                                      \
+    }while (0)
+
+#define SNEK8_EXEC_LD_DT_VX(x)                                                      \
+    SNEK8_X_DT = SNEK8_X_R(x)
+
+#define SNEK8_EXEC_LD_ST_VX(x)                                                      \
+    SNEK8_X_ST = SNEK8_X_R(x)
+
+#define SNEK8_EXEC_ADD_I_VX(x)                                                      \
+    SNEK8_X_IR = (SNEK8_X_IR + SNEK8_X_R(x)) & SNEK8_X_MEM_END
+
+#define SNEK8_EXEC_LD_F_VX(x)                                                       \
+    SNEK8_X_IR = SNEK8_MEM_ADDR_FONTSET_START + (SNEK8_SIZE_FONTSET_PIXEL_PER_SPRITE * SNEK8_X_R(x))
+
+#define SNEK8_EXEC_LD_B_VX(x)                                                       \
+    do{                                                                             \
+        if (SNEK8_X_IR + 2 > SNEK8_X_MEM_END){                                      \
+            SNEK8_X_FAIL(SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS);                     \
+        }                                                                           \
+        (void) memcpy(SNEK8_X_MEM + SNEK8_X_IR, snek8_bcd[SNEK8_X_R(x)],            \
+                      SNEK8_SIZE_BCD_DIGITS);                                       \
+        SNEK8_X_ON_WRITE(SNEK8_X_IR, SNEK8_SIZE_BCD_DIGITS);                        \
+    }while (0)
+
+#define SNEK8_EXEC_LD_I_V0_VX(x, changes_i)                                         \
+    do{                                                                             \
+        if (SNEK8_X_IR + (x) > SNEK8_X_MEM_END){                                    \
+            SNEK8_X_FAIL(SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS);                     \
+        }                                                                           \
+        SNEK8_X_R_STORE(SNEK8_X_MEM + SNEK8_X_IR, (x) + 1);                         \
+        SNEK8_X_ON_WRITE(SNEK8_X_IR, (x) + 1);                                      \
+        if (changes_i){                                                             \
+            SNEK8_X_IR += (x) + 1;                                                  \
+        }                                                                           \
+    }while (0)
+
+#define SNEK8_EXEC_LD_VX_V0_I(x, changes_i)                                         \
+    do{                                                                             \
+        if (SNEK8_X_IR + (x) > SNEK8_X_MEM_END){                                    \
+            SNEK8_X_FAIL(SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS);                     \
+        }                                                                           \
+        SNEK8_X_R_LOAD(SNEK8_X_MEM + SNEK8_X_IR, (x) + 1);                          \
+        if (changes_i){                                                             \
+            SNEK8_X_IR += (x) + 1;                                                  \
+        }                                                                           \
+    }while (0)
+
+/*
+* Handler sets.
+*
+* An engine gives each instruction family a handler, except the families that depend
+* on an implementation flag, which get one handler per value of the flag. A handler
+* set maps every family to the handler matching one combination of flags, so that
+* the engine selects the set once from the flags and dispatches the families through
+* it. The sets are built, as designated initializers, by:
+*
+*     - SNEK8_EXEC_HANDLERS(q, H, HQ)   the set of the flags `q`.
+*     - SNEK8_EXEC_HANDLER_SETS(H, HQ)  the `SNEK8_SIZE_QUIRK_SETS` sets, indexed by the
+*                                       flags.
+*
+* where the engine's `H(family)` names the handler of a family and `HQ(family, b)`
+* the one of a family depending on a flag, for the value `b` (0 or 1) of the flag.
+* A new quirk only needs a flag, an operand in the macros above and an entry below.
+*/
+
+/*
+* The value (0 or 1) of the flag `flag` in the flags `q`.
+*/
+#define SNEK8_EXEC_QUIRK(q, flag)   (((q) & (flag))? 1: 0)
+
+/*
+* The handler of the family `family`, depending on the flag `flag`, for the flags
+* `q`. Label addresses are not arithmetic constants, hence the conditional.
+*/
+#define SNEK8_EXEC_HQ(q, flag, HQ, family)                                          \
+    (((q) & (flag))? HQ(family, 1): HQ(family, 0))
+
+#define SNEK8_EXEC_HANDLERS(q, H, HQ)                                               \
+    {                                                                               \
+        [SNEK8_INSTRUC_NOP] = H(NOP),                                               \
+        [SNEK8_INSTRUC_CLS] = H(CLS),                                               \
+        [SNEK8_INSTRUC_RET] = H(RET),                                               \
+        [SNEK8_INSTRUC_JMP_ADDR] = H(JMP_ADDR),                                     \
+        [SNEK8_INSTRUC_CALL] = H(CALL),                                             \
+        [SNEK8_INSTRUC_SE_VX_BYTE] = H(SE_VX_BYTE),                                 \
+        [SNEK8_INSTRUC_SNE_VX_BYTE] = H(SNE_VX_BYTE),                               \
+        [SNEK8_INSTRUC_SE_VX_VY] = H(SE_VX_VY),                                     \
+        [SNEK8_INSTRUC_LD_VX_BYTE] = H(LD_VX_BYTE),                                 \
+        [SNEK8_INSTRUC_ADD_VX_BYTE] = H(ADD_VX_BYTE),                               \
+        [SNEK8_INSTRUC_LD_VX_VY] = H(LD_VX_VY),                                     \
+        [SNEK8_INSTRUC_OR_VX_VY] = H(OR_VX_VY),                                     \
+        [SNEK8_INSTRUC_AND_VX_VY] = H(AND_VX_VY),                                   \
+        [SNEK8_INSTRUC_XOR_VX_VY] = H(XOR_VX_VY),                                   \
+        [SNEK8_INSTRUC_ADD_VX_VY] = H(ADD_VX_VY),                                   \
+        [SNEK8_INSTRUC_SUB_VX_VY] = H(SUB_VX_VY),                                   \
+        [SNEK8_INSTRUC_SHR_VX_VY] = SNEK8_EXEC_HQ(q, SNEK8_IMPLM_MODE_SHIFTS_USE_VY, HQ, SHR_VX_VY), \
+        [SNEK8_INSTRUC_SUBN_VX_VY] = H(SUBN_VX_VY),                                 \
+        [SNEK8_INSTRUC_SHL_VX_VY] = SNEK8_EXEC_HQ(q, SNEK8_IMPLM_MODE_SHIFTS_USE_VY, HQ, SHL_VX_VY), \
+        [SNEK8_INSTRUC_SNE_VX_VY] = H(SNE_VX_VY),                                   \
+        [SNEK8_INSTRUC_LD_I_ADDR] = H(LD_I_ADDR),                                   \
+        [SNEK8_INSTRUC_JP_V0_ADDR] = SNEK8_EXEC_HQ(q, SNEK8_IMPLM_MODE_BNNN_USES_VX, HQ, JP_V0_ADDR), \
+        [SNEK8_INSTRUC_RND_VX_BYTE] = H(RND_VX_BYTE),                               \
+        [SNEK8_INSTRUC_DRW_VX_VY_N] = H(DRW_VX_VY_N),                               \
+        [SNEK8_INSTRUC_SKP_VX] = H(SKP_VX),                                         \
+        [SNEK8_INSTRUC_SKNP_VX] = H(SKNP_VX),                                       \
+        [SNEK8_INSTRUC_LD_VX_DT] = H(LD_VX_DT),                                     \
+        [SNEK8_INSTRUC_LD_VX_K] = H(LD_VX_K),                                       \
+        [SNEK8_INSTRUC_LD_DT_VX] = H(LD_DT_VX),                                     \
+        [SNEK8_INSTRUC_LD_ST_VX] = H(LD_ST_VX),                                     \
+        [SNEK8_INSTRUC_ADD_I_VX] = H(ADD_I_VX),                                     \
+        [SNEK8_INSTRUC_LD_F_VX] = H(LD_F_VX),                                       \
+        [SNEK8_INSTRUC_LD_B_VX] = H(LD_B_VX),                                       \
+        [SNEK8_INSTRUC_LD_I_V0_VX] = SNEK8_EXEC_HQ(q, SNEK8_IMPLM_MODE_FX_CHANGES_I, HQ, LD_I_V0_VX), \
+        [SNEK8_INSTRUC_LD_VX_V0_I] = SNEK8_EXEC_HQ(q, SNEK8_IMPLM_MODE_FX_CHANGES_I, HQ, LD_VX_V0_I), \
+    }
+
+#define SNEK8_EXEC_HANDLER_SETS(H, HQ)                                              \
+    {                                                                               \
+        SNEK8_EXEC_HANDLERS(0, H, HQ),                                              \
+        SNEK8_EXEC_HANDLERS(1, H, HQ),                                              \
+        SNEK8_EXEC_HANDLERS(2, H, HQ),                                              \
+        SNEK8_EXEC_HANDLERS(3, H, HQ),                                              \
+        SNEK8_EXEC_HANDLERS(4, H, HQ),                                              \
+        SNEK8_EXEC_HANDLERS(5, H, HQ),                                              \
+        SNEK8_EXEC_HANDLERS(6, H, HQ),                                              \
+        SNEK8_EXEC_HANDLERS(7, H, HQ),                                              \
+    }
+
+_Static_assert(8 == SNEK8_SIZE_QUIRK_SETS, "SNEK8_EXEC_HANDLER_SETS lists every combination of flags.");
+
+/*
+* The identifiers of the handlers of the families depending on a flag, when it is
+* set, for the engines that dispatch with a `switch` (their other handlers are
+* identified by their families).
+*/
+enum{
+    SNEK8_EXEC_ID_SHR_VX_VY_1 = SNEK8_INSTRUC_COUNT,
+    SNEK8_EXEC_ID_SHL_VX_VY_1,
+    SNEK8_EXEC_ID_JP_V0_ADDR_1,
+    SNEK8_EXEC_ID_LD_I_V0_VX_1,
+    SNEK8_EXEC_ID_LD_VX_V0_I_1,
+    SNEK8_EXEC_ID_COUNT,
+};
+
+#define SNEK8_EXEC_ID_SHR_VX_VY_0   SNEK8_INSTRUC_SHR_VX_VY
+#define SNEK8_EXEC_ID_SHL_VX_VY_0   SNEK8_INSTRUC_SHL_VX_VY
+#define SNEK8_EXEC_ID_JP_V0_ADDR_0  SNEK8_INSTRUC_JP_V0_ADDR
+#define SNEK8_EXEC_ID_LD_I_V0_VX_0  SNEK8_INSTRUC_LD_I_V0_VX
+#define SNEK8_EXEC_ID_LD_VX_V0_I_0  SNEK8_INSTRUC_LD_VX_V0_I
+
+/*
+* `H` and `HQ` naming the handlers by their identifiers.
+*/
+#define SNEK8_EXEC_ID(family)       SNEK8_INSTRUC_##family
+#define SNEK8_EXEC_ID_Q(family, b)  SNEK8_EXEC_ID_##family##_##b
+
+#endif // SNEK8_CPU_EXEC_H
@@ -0,0 +1,229 @@
+/**
+* @file debug.h
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Declaration of the debugger.
+*
+* The debugger stops a run at breakpoints, i.e. before the instruction at a given
+* address executes, optionally only when a register satisfies a condition, and at
+* watchpoints, i.e. right after an instruction read or wrote a watched byte of the
+* memory through the index register (DRW, LD B, V{0xX}, LD [I], V{0xX} and
+* LD V{0xX}, [I]).
+*
+* The breakpoints and watchpoints are flags in a bitmap of the addresses, checked by
+* a run of its own, `snek8_debugRun`, that executes one instruction at a time with the
+* reference handlers. The engines themselves know nothing about the debugger: its
+* owner runs the CPU with `snek8_debugRun` while breakpoints or watchpoints are set,
+* and with its engine otherwise, so that the engines pay nothing for it.
+*/
+#ifndef SNEK8_DEBUG_H
+    #define SNEK8_DEBUG_H
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include "cpu.h"
+
+/**
+* @def SNEK8_DEBUG_BREAK
+* @brief The address has an unconditional breakpoint.
+*/
+#define SNEK8_DEBUG_BREAK                0x01
+
+/**
+* @def SNEK8_DEBUG_CONDITION
+* @brief The address has conditional breakpoints.
+*/
+#define SNEK8_DEBUG_CONDITION            0x02
+
+/**
+* @def SNEK8_DEBUG_WATCH_READ
+* @brief The byte is watched for reads.
+*/
+#define SNEK8_DEBUG_WATCH_READ           0x04
+
+/**
+* @def SNEK8_DEBUG_WATCH_WRITE
+* @brief The byte is watched for writes.
+*/
+#define SNEK8_DEBUG_WATCH_WRITE          0x08
+
+/**
+* @def SNEK8_DEBUG_WATCH
+* @brief The watchpoint flags.
+*/
+#define SNEK8_DEBUG_WATCH                (SNEK8_DEBUG_WATCH_READ | SNEK8_DEBUG_WATCH_WRITE)
+
+/**
+* @def SNEK8_DEBUG_MAX_CONDITIONS
+* @brief The largest number of conditional breakpoints.
+*/
+#define SNEK8_DEBUG_MAX_CONDITIONS       64
+
+/**
+* @def SNEK8_DEBUG_REG_I
+* @brief The register operand of a condition on the index register; 0x0 to 0xF stand
+*        for V{0x0} to V{0xF}.
+*/
+#define SNEK8_DEBUG_REG_I                16
+
+/**
+* @brief The comparison of a conditional breakpoint, between a register (left) and a
+* value (right).
+*/
+enum Snek8DebugCompare{
+    SNEK8_DEBUG_EQ,
+    SNEK8_DEBUG_NE,
+    SNEK8_DEBUG_LT,
+    SNEK8_DEBUG_LE,
+    SNEK8_DEBUG_GT,
+    SNEK8_DEBUG_GE,
+    SNEK8_DEBUG_COMPARE_COUNT,
+};
+
+/**
+* @brief A conditional breakpoint.
+*
+* @param `address` The address of the instruction.
+* @param `reg` The register (see `SNEK8_DEBUG_REG_I`).
+* @param `compare` The comparison (`enum Snek8DebugCompare`).
+* @param `value` The value compared with the register.
+*/
+typedef struct{
+    uint16_t address;
+    uint8_t reg;
+    uint8_t compare;
+    uint16_t value;
+} Snek8DebugCondition;
+
+/**
+* @brief Why and where the last run of the debugger stopped.
+*
+* @param `stop` `SNEK8_RUNSTOP_BREAKPOINT`, `SNEK8_RUNSTOP_WATCHPOINT`, or
+*        `SNEK8_RUNSTOP_CYCLES` if the run did not stop at any.
+* @param `pc` The address of the instruction: the one about to execute at a breakpoint,
+*        the one that accessed the memory at a watchpoint.
+* @param `address` The first watched byte accessed (the `pc` at a breakpoint).
+* @param `access` `SNEK8_DEBUG_WATCH_READ` or `SNEK8_DEBUG_WATCH_WRITE` at a
+*        watchpoint, 0 at a breakpoint.
+*/
+typedef struct{
+    uint8_t stop;
+    uint16_t pc;
+    uint16_t address;
+    uint8_t access;
+} Snek8DebugHit;
+
+/**
+* @brief Implementation of the debugger.
+*
+* @param `flags` The `SNEK8_DEBUG_*` flags of every address.
+* @param `breakpoints` The number of addresses with a breakpoint (conditional or not).
+* @param `watched` The number of watched bytes.
+* @param `conditions_count`.
+* @param `conditions` The conditional breakpoints.
+* @param `resume` Whether the next run starts at the breakpoint it stopped at, which
+*        then does not stop it again.
+* @param `hit` Why the last run stopped.
+*/
+typedef struct{
+    uint8_t flags[SNEK8_SIZE_RAM];
+    size_t breakpoints;
+    size_t watched;
+    size_t conditions_count;
+    Snek8DebugCondition conditions[SNEK8_DEBUG_MAX_CONDITIONS];
+    bool resume;
+    Snek8DebugHit hit;
+} Snek8Debugger;
+
+/**
+* @brief Allocates a debugger without breakpoints.
+*
+* @return The new debugger, or NULL if the allocation failed.
+* @note The debugger must be released with `snek8_debugDel`.
+*/
+Snek8Debugger*
+snek8_debugNew(void);
+
+/**
+* @brief Releases a debugger.
+*
+* @param[in, out] `debugger` (may be NULL).
+*/
+void
+snek8_debugDel(Snek8Debugger* debugger);
+
+/**
+* @brief Whether a debugger has breakpoints or watchpoints, i.e. whether its owner has
+* to run the CPU with `snek8_debugRun`.
+*
+* @param[in] `debugger` (may be NULL).
+*/
+static inline bool
+snek8_debugActive(const Snek8Debugger* debugger){
+    return debugger && (debugger->breakpoints || debugger->watched);
+}
+
+/**
+* @brief Sets a breakpoint.
+*
+* @param[in, out] `debugger`.
+* @param[in] `address`.
+* @param[in] `condition` The condition, whose `address` is ignored, or NULL for an
+*            unconditional breakpoint. A breakpoint stops the run when it has no
+*            condition or any of its conditions holds.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS`: invalid address.
+* - `SNEK8_EXECOUT_INDEX_OUT_RANGE`: invalid register, comparison or value.
+* - `SNEK8_EXECOUT_OUT_OF_MEMORY`: `SNEK8_DEBUG_MAX_CONDITIONS` conditions are set.
+*/
+enum Snek8ExecutionOutput
+snek8_debugSetBreakpoint(Snek8Debugger* debugger, uint16_t address,
+                         const Snek8DebugCondition* condition);
+
+/**
+* @brief Removes the breakpoints of an address, with their conditions.
+*
+* @param[in, out] `debugger`.
+* @param[in] `address`.
+* @return Whether the address had breakpoints.
+*/
+bool
+snek8_debugClearBreakpoint(Snek8Debugger* debugger, uint16_t address);
+
+/**
+* @brief Watches a range of the memory, or stops watching it.
+*
+* @param[in, out] `debugger`.
+* @param[in] `start`.
+* @param[in] `size`.
+* @param[in] `access` The watchpoint flags to set, or to clear if `watch` is false.
+* @param[in] `watch`.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS`: the range does not fit the memory.
+* - `SNEK8_EXECOUT_INDEX_OUT_RANGE`: `access` holds other flags.
+*/
+enum Snek8ExecutionOutput
+snek8_debugWatch(Snek8Debugger* debugger, uint16_t start, size_t size, uint8_t access,
+                 bool watch);
+
+/**
+* @brief The debugger's alternative to `snek8_cpuRun`: the run also stops with
+* `SNEK8_RUNSTOP_BREAKPOINT` before executing an instruction at a breakpoint (except
+* the one the previous run stopped at, if it starts there) and with
+* `SNEK8_RUNSTOP_WATCHPOINT` right after an instruction accessed a watched byte. The
+* other parameters, results and semantics are the ones of `snek8_cpuRun`; the run
+* retires the same cycles and leaves the CPU in the same state as the engines would.
+*
+* @param[in, out] `debugger` Its `hit` tells where the run stopped.
+*/
+enum Snek8ExecutionOutput
+snek8_debugRun(Snek8Debugger* debugger, Snek8CPU* cpu, size_t max_cycles, uint8_t break_flags,
+               size_t* cycles, enum Snek8RunStop* stop);
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_DEBUG_H
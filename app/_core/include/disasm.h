@@ -0,0 +1,183 @@
+/**
+* @file disasm.h
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Declaration of the disassembler and of the static analysis of the programs.
+*
+* The analysis walks the code reachable from `SNEK8_MEM_ADDR_PROG_START` without
+* executing it, following the jumps, the calls (and what follows them, where RET
+* comes back), and both outcomes of the skips. It then splits that code into basic
+* blocks, the straight-line runs of instructions that are only entered at their first
+* instruction, and links them into a control-flow graph.
+*
+* Along the way, it tracks the index register inside each block, from LD I, 0x0NNN,
+* to find out which bytes the program reads (DRW, LD V{0xX}, [I]) and writes
+* (LD B, V{0xX}, LD [I], V{0xX}). The code bytes the program may write are the
+* self-modifying targets. The bytes of the ROM that are not code are data. Writes
+* through an index register the analysis cannot follow (set by ADD I, V{0xX}, LD F,
+* V{0xX} or in another block) are only counted.
+*
+* The analysis is conservative about the code: what it reaches is reachable with the
+* right register values, but JP V{0x0}, 0x0NNN jumps to addresses it does not know;
+* those instructions are marked as indirect so that the callers can tell.
+*/
+#ifndef SNEK8_DISASM_H
+    #define SNEK8_DISASM_H
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include "cpu.h"
+
+/**
+* @def SNEK8_DISASM_SIZE_TEXT
+* @brief A size that fits the text of any instruction, with its terminator.
+*/
+#define SNEK8_DISASM_SIZE_TEXT           24
+
+/**
+* @def SNEK8_ANALYSIS_INSTRUC
+* @brief The address starts a reachable instruction.
+*/
+#define SNEK8_ANALYSIS_INSTRUC           0x01
+
+/**
+* @def SNEK8_ANALYSIS_CODE
+* @brief The byte belongs to a reachable instruction.
+*/
+#define SNEK8_ANALYSIS_CODE              0x02
+
+/**
+* @def SNEK8_ANALYSIS_LEADER
+* @brief The address starts a basic block.
+*/
+#define SNEK8_ANALYSIS_LEADER            0x04
+
+/**
+* @def SNEK8_ANALYSIS_READ
+* @brief The byte is read through the index register.
+*/
+#define SNEK8_ANALYSIS_READ              0x08
+
+/**
+* @def SNEK8_ANALYSIS_WRITTEN
+* @brief The byte is written through the index register.
+*/
+#define SNEK8_ANALYSIS_WRITTEN           0x10
+
+/**
+* @def SNEK8_ANALYSIS_DATA
+* @brief The byte belongs to the ROM but not to its reachable code.
+*/
+#define SNEK8_ANALYSIS_DATA              0x20
+
+/**
+* @def SNEK8_ANALYSIS_INVALID
+* @brief The address starts a reachable invalid instruction, which fails with
+*        `SNEK8_EXECOUT_INVALID_OPCODE` when executed.
+*/
+#define SNEK8_ANALYSIS_INVALID           0x40
+
+/**
+* @def SNEK8_ANALYSIS_INDIRECT
+* @brief The address starts a reachable JP V{0x0}, 0x0NNN.
+*/
+#define SNEK8_ANALYSIS_INDIRECT          0x80
+
+/**
+* @brief How a basic block ends.
+*/
+enum Snek8AnalysisExit{
+    SNEK8_ANALYSIS_EXIT_FALLTHROUGH,
+    SNEK8_ANALYSIS_EXIT_JUMP,
+    SNEK8_ANALYSIS_EXIT_CALL,
+    SNEK8_ANALYSIS_EXIT_RETURN,
+    SNEK8_ANALYSIS_EXIT_SKIP,
+    SNEK8_ANALYSIS_EXIT_INDIRECT,
+    SNEK8_ANALYSIS_EXIT_INVALID,
+    SNEK8_ANALYSIS_EXIT_COUNT,
+};
+
+/**
+* @brief A basic block.
+*
+* @param `start` The address of the first instruction.
+* @param `length` The number of instructions.
+* @param `exit` How the block ends (`enum Snek8AnalysisExit`).
+* @param `successors_count`.
+* @param `successors` The addresses of the blocks executed next: the next block for
+*        the fall-throughs, the target for the jumps, the target and the return
+*        address for the calls, the next instruction and the skipped-to one for the
+*        skips, none otherwise.
+*/
+typedef struct{
+    uint16_t start;
+    uint16_t length;
+    uint8_t exit;
+    uint8_t successors_count;
+    uint16_t successors[2];
+} Snek8AnalysisBlock;
+
+/**
+* @brief The result of an analysis.
+*
+* @param `flags` The `SNEK8_ANALYSIS_*` flags of every address.
+* @param `rom_end` The address past the last byte of the ROM.
+* @param `instructions` The number of reachable instructions.
+* @param `self_modifying` The number of code bytes the program writes.
+* @param `unresolved_writes` The number of reachable writes through an index register
+*        the analysis could not follow.
+* @param `blocks_count`.
+* @param `blocks` The basic blocks, by increasing address.
+*/
+typedef struct{
+    uint8_t flags[SNEK8_SIZE_RAM];
+    uint16_t rom_end;
+    size_t instructions;
+    size_t self_modifying;
+    size_t unresolved_writes;
+    size_t blocks_count;
+    Snek8AnalysisBlock blocks[SNEK8_SIZE_RAM];
+} Snek8Analysis;
+
+/**
+* @brief Write the text of an instruction, e.g. "DRW V1, VA, 0x5" for 0xD1A5. Invalid
+* instructions are written as a data word, e.g. "DW 0x0123".
+*
+* @param[in] `opcode`.
+* @param[out] `text`.
+* @param[in] `size` The size of `text`; `SNEK8_DISASM_SIZE_TEXT` always suffices.
+* @return The length of the text, as `snprintf` does.
+*/
+size_t
+snek8_disasmFormat(uint16_t opcode, char* text, size_t size);
+
+/**
+* @brief Analyze the program loaded in a memory.
+*
+* @param[out] `analysis`.
+* @param[in] `memory` `SNEK8_SIZE_RAM` bytes.
+* @param[in] `rom_size` The size of the ROM loaded at `SNEK8_MEM_ADDR_PROG_START`.
+* @param[in] `implm_flags` The implementation flags the program runs with.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - `SNEK8_EXECOUT_ROM_FILE_EXCEEDS_MAX_MEM`.
+*/
+enum Snek8ExecutionOutput
+snek8_disasmAnalyze(Snek8Analysis* analysis, const uint8_t* memory, size_t rom_size,
+                    uint8_t implm_flags);
+
+/**
+* @brief Retrieves the name of a block's exit, e.g. "SKIP".
+*
+* @param[in] `exit`.
+* @return The name, or NULL if `exit` is not an exit.
+*/
+const char*
+snek8_analysisExitName(enum Snek8AnalysisExit exit);
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_DISASM_H
@@ -0,0 +1,228 @@
+/**
+* @file ext.h
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Declaration of the extended CPU profiles: SUPER-CHIP and XO-CHIP.
+*
+* The extended dialects need more state than the CHIP8 (a 128x64 screen, up to 64 KB
+* of memory, a second bit plane, the RPL flags), so they run on their own CPU,
+* `Snek8ExtCPU`, and `Snek8CPU` keeps its compact layout. Each profile is served by its
+* own core: `ext_core.h` holds the interpreter loop once, parameterized by macros
+* describing the dialect, and `ext.c` includes it once per profile, so that every
+* dialect test folds into a constant and each core only contains its own extensions.
+* The CHIP8 instructions come from `cpu_exec.h`, as in the other engines.
+*
+* The profiles extend the CHIP8 as follows:
+*
+*     - Both: the hi-res mode (00FF, 00FE back to lo-res), in which the screen is
+*       128x64 instead of 64x32; the scrolls down (00CN), right (00FB) and
+*       left (00FC); EXIT (00FD), which stops the CPU with `SNEK8_EXECOUT_EXIT`;
+*       16x16 sprites (DXY0); the big font (FX30); the RPL flags (FX75, FX85).
+*     - SUPER-CHIP (1.1): scrolls move by hi-res pixels whatever the mode; sprites are
+*       clipped at the edges of the screen; in hi-res, DRW stores in VF the number of
+*       sprite rows that collided or were clipped; 8 RPL flags; 4 KB of memory.
+*     - XO-CHIP: 64 KB of memory and the I := NNNN long load (F000 NNNN), which the
+*       skips jump over; two bit planes selected by FN01, every drawing instruction
+*       (CLS, DRW, the scrolls) acting on the selected planes; the scroll up (00DN);
+*       scrolls move by lo-res pixels in lo-res; sprites wrap around the screen;
+*       switching modes clears the screen; registers ranges saved and loaded without
+*       touching I (5XY2, 5XY3); the audio pattern (F002) and pitch (FX3A); 16 RPL
+*       flags.
+*
+* The screen is always stored at the hi-res resolution, each row of a plane as two
+* 64-bit words (the pixel at column x being the bit (63 - x % 64) of the word x / 64),
+* so that the scrolls are shifts and moves of whole words. In lo-res, every pixel
+* covers 2x2 physical pixels.
+*/
+#ifndef SNEK8_EXT_H
+    #define SNEK8_EXT_H
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include "cpu.h"
+
+/**
+* @brief The extended dialects.
+*/
+enum Snek8Profile{
+    SNEK8_PROFILE_SCHIP,
+    SNEK8_PROFILE_XOCHIP,
+    SNEK8_PROFILE_COUNT,
+};
+
+/**
+* @def SNEK8_EXT_WIDTH
+* @brief The width of the physical (hi-res) screen.
+*/
+#define SNEK8_EXT_WIDTH                 128
+
+/**
+* @def SNEK8_EXT_HEIGHT
+* @brief The height of the physical (hi-res) screen.
+*/
+#define SNEK8_EXT_HEIGHT                64
+
+/**
+* @def SNEK8_EXT_PLANES
+* @brief The number of bit planes of the screen.
+*/
+#define SNEK8_EXT_PLANES                2
+
+/**
+* @def SNEK8_EXT_SIZE_RAM
+* @brief The size of the largest memory (XO-CHIP).
+*/
+#define SNEK8_EXT_SIZE_RAM              65536
+
+/**
+* @def SNEK8_EXT_SIZE_FLAGS
+* @brief The number of RPL flags of the largest dialect (XO-CHIP).
+*/
+#define SNEK8_EXT_SIZE_FLAGS            16
+
+/**
+* @def SNEK8_EXT_SIZE_AUDIO
+* @brief The size of the XO-CHIP audio pattern, in bytes.
+*/
+#define SNEK8_EXT_SIZE_AUDIO            16
+
+/**
+* @def SNEK8_EXT_MEM_ADDR_BIGFONT_START
+* @brief The address of the big font (10 bytes per digit), right after the small one.
+*/
+#define SNEK8_EXT_MEM_ADDR_BIGFONT_START 0xA0
+
+/**
+* @def SNEK8_EXT_SIZE_BIGFONT
+* @brief The size of the big font, in bytes.
+*/
+#define SNEK8_EXT_SIZE_BIGFONT          160
+
+/**
+* @brief Implementation of the CPU of the extended dialects.
+*
+* The fields shared with `Snek8CPU` have the same meaning; the others are:
+*
+* @param `profile` The dialect (`enum Snek8Profile`).
+* @param `mem_end` The last address of the profile's memory.
+* @param `graphics` The bit planes, `SNEK8_EXT_HEIGHT` rows of two words each.
+* @param `graphics_dirty` Damage of the screen: the bit y is set when an instruction
+*        touched the physical row y.
+* @param `hires` Whether the screen is in hi-res mode.
+* @param `planes` The planes the drawing instructions act on (bit p for the plane p).
+* @param `flags` The RPL flags.
+* @param `audio` The audio pattern.
+* @param `pitch` The pitch of the audio pattern.
+*/
+typedef struct{
+    uint8_t memory[SNEK8_EXT_SIZE_RAM];
+    uint64_t graphics[SNEK8_EXT_PLANES][SNEK8_EXT_HEIGHT][2];
+    uint64_t graphics_dirty;
+    uint32_t graphics_gen;
+    Snek8Stack stack;
+    uint8_t registers[SNEK8_SIZE_REGISTERS];
+    uint8_t flags[SNEK8_EXT_SIZE_FLAGS];
+    uint8_t audio[SNEK8_EXT_SIZE_AUDIO];
+    uint16_t keys;
+    uint16_t key_armed;
+    bool key_wait;
+    bool hires;
+    uint8_t planes;
+    uint8_t pitch;
+    uint16_t pc;
+    uint16_t ir;
+    uint16_t mem_end;
+    uint8_t profile;
+    uint8_t implm_flags;
+    uint8_t dt;
+    uint8_t st;
+    uint64_t cycles;
+    uint32_t ips;
+    uint32_t timer_phase;
+    uint32_t rng;
+} Snek8ExtCPU;
+
+/**
+* @brief Set the CPU's field members to their initial values.
+*
+* @param[out] `cpu`.
+* @param[in] `profile`.
+* @param[in] `implm_flags` The quirks of the CHIP8 instructions (see `Snek8CPU`).
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - `SNEK8_EXECOUT_INDEX_OUT_RANGE`: not a profile.
+*/
+enum Snek8ExecutionOutput
+snek8_extInit(Snek8ExtCPU* cpu, enum Snek8Profile profile, uint8_t implm_flags);
+
+/**
+* @brief Sets the number of instructions executed per emulated second.
+*
+* @see `snek8_cpuSetIPS`.
+*/
+enum Snek8ExecutionOutput
+snek8_extSetIPS(Snek8ExtCPU* cpu, uint32_t ips);
+
+/**
+* @brief Seeds the CPU's random number generator.
+*
+* @see `snek8_cpuSeed`.
+*/
+enum Snek8ExecutionOutput
+snek8_extSeed(Snek8ExtCPU* cpu, uint32_t seed);
+
+/**
+* @brief Reset the CPU, keeping its profile, quirks, rate and random number generator,
+* and load a program at `SNEK8_MEM_ADDR_PROG_START`.
+*
+* @param[in, out] `cpu`.
+* @param[in] `rom`.
+* @param[in] `size` At most the profile's memory past `SNEK8_MEM_ADDR_PROG_START`.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - `SNEK8_EXECOUT_ROM_FILE_INVALID`: NULL program of non-zero size.
+* - `SNEK8_EXECOUT_ROM_FILE_EXCEEDS_MAX_MEM`.
+*/
+enum Snek8ExecutionOutput
+snek8_extLoadRomBytes(Snek8ExtCPU* cpu, const uint8_t* rom, size_t size);
+
+/**
+* @brief Toggle on/off a particular key.
+*
+* @see `snek8_cpuSetKey`, whose semantics for LD V{0xX}, K are the same.
+*/
+enum Snek8ExecutionOutput
+snek8_extSetKey(Snek8ExtCPU* cpu, size_t key, bool value);
+
+/**
+* @brief Execute up to `max_cycles` steps in a single call, with the core of the
+* CPU's profile.
+*
+* Parameters, results and semantics are the same as the ones of `snek8_cpuRun`;
+* EXIT stops the run with `SNEK8_EXECOUT_EXIT`.
+*/
+enum Snek8ExecutionOutput
+snek8_extRun(Snek8ExtCPU* cpu, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+             enum Snek8RunStop* stop);
+
+/**
+* @brief The SUPER-CHIP core (see `snek8_extRun`).
+*/
+enum Snek8ExecutionOutput
+snek8_extRunSCHIP(Snek8ExtCPU* cpu, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+                  enum Snek8RunStop* stop);
+
+/**
+* @brief The XO-CHIP core (see `snek8_extRun`).
+*/
+enum Snek8ExecutionOutput
+snek8_extRunXOCHIP(Snek8ExtCPU* cpu, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+                   enum Snek8RunStop* stop);
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_EXT_H
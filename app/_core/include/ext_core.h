@@ -0,0 +1,335 @@
+/**
+* @file ext_core.h
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Interpreter loop of the extended profiles, specialized per dialect.
+*
+* This file has no include guard: `ext.c` includes it once per profile, after
+* defining the following parameters, which it undefines at its end:
+*
+*     - SNEK8_E_NAME            the name of the generated run function.
+*     - SNEK8_E_XO              whether the XO-CHIP instructions are compiled in.
+*     - SNEK8_E_PLANES          the number of bit planes the core draws on (1 or 2).
+*     - SNEK8_E_MEM_END         the last address of the memory.
+*     - SNEK8_E_FLAGS           the number of RPL flags.
+*     - SNEK8_E_WRAP            whether sprites wrap around the screen (else clipped).
+*     - SNEK8_E_ROW_HITS        whether DRW stores the number of rows hit in hi-res.
+*     - SNEK8_E_LORES_SCROLL    the physical pixels scrolled per pixel in lo-res.
+*     - SNEK8_E_MODE_CLEARS     whether switching between hi-res and lo-res clears
+*                               the screen.
+*
+* Every parameter is a constant, so the dialect tests fold away and each core only
+* carries its own extensions. The CHIP8 instructions come from `cpu_exec.h`, through
+* the `SNEK8_X_*` accessors and the `SNEK8_T_*` operands defined by `ext.c`; the
+* screen instructions are the extended ones, whatever the mode.
+*/
+
+/*
+* The planes drawn on: always the first one on the cores with a single plane.
+*/
+#define SNEK8_E_SELECTED        ((SNEK8_E_PLANES > 1)? cpu->planes: 1u)
+
+/*
+* The physical pixels covered by a scrolled pixel.
+*/
+#define SNEK8_E_SCROLL_SCALE    (cpu->hires? 1u: (unsigned) SNEK8_E_LORES_SCROLL)
+
+/*
+* Executes a skip; on XO-CHIP, skipping I := NNNN skips its 4 bytes.
+*/
+#if SNEK8_E_XO
+    #define SNEK8_E_SKIP(skip)                                                      \
+        do{                                                                         \
+            uint16_t _from = pc;                                                    \
+            skip;                                                                   \
+            if (pc != _from && 0xF0 == mem[_from & SNEK8_E_MEM_END]                 \
+                && 0x00 == mem[(_from + 1) & SNEK8_E_MEM_END]){                     \
+                pc += 2;                                                            \
+            }                                                                       \
+        }while (0)
+#else
+    #define SNEK8_E_SKIP(skip)  skip
+#endif
+
+enum Snek8ExecutionOutput
+SNEK8_E_NAME(Snek8ExtCPU* cpu, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+             enum Snek8RunStop* stop){
+    if (!cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (cpu->key_wait){
+        return _snek8_extRunWaiting(cpu, max_cycles, break_flags, cycles, stop);
+    }
+    enum Snek8ExecutionOutput out = SNEK8_EXECOUT_SUCCESS;
+    enum Snek8RunStop reason = SNEK8_RUNSTOP_CYCLES;
+    size_t executed = 0;
+    uint8_t v[SNEK8_SIZE_REGISTERS];
+    (void) memcpy(v, cpu->registers, SNEK8_SIZE_REGISTERS);
+    uint16_t pc = cpu->pc;
+    uint16_t ir = cpu->ir;
+    uint8_t dt = cpu->dt;
+    uint8_t st = cpu->st;
+    uint32_t phase = cpu->timer_phase;
+    const uint32_t ips = cpu->ips;
+    uint8_t* const mem = cpu->memory;
+    const uint8_t quirks = cpu->implm_flags;
+    uint16_t opcode = 0;
+    for (;;){
+        if (executed >= max_cycles){
+            goto _snek8_exit;
+        }
+        opcode = (uint16_t) (mem[pc & SNEK8_E_MEM_END] << 8) | mem[(pc + 1) & SNEK8_E_MEM_END];
+        pc += 2;
+        switch (opcode >> 12){
+            case 0x0:
+                if (0x00E0 == opcode){
+                    _snek8_extClear(cpu, SNEK8_E_SELECTED);
+                }else if (0x00EE == opcode){
+                    SNEK8_EXEC_RET();
+                }else if (0x00C0 == (opcode & 0xFFF0u)){
+                    _snek8_extScrollDown(cpu, SNEK8_E_SELECTED, SNEK8_T_N * SNEK8_E_SCROLL_SCALE);
+#if SNEK8_E_XO
+                }else if (0x00D0 == (opcode & 0xFFF0u)){
+                    _snek8_extScrollUp(cpu, SNEK8_E_SELECTED, SNEK8_T_N * SNEK8_E_SCROLL_SCALE);
+#endif
+                }else if (0x00FB == opcode){
+                    _snek8_extScrollRight(cpu, SNEK8_E_SELECTED, 4 * SNEK8_E_SCROLL_SCALE);
+                }else if (0x00FC == opcode){
+                    _snek8_extScrollLeft(cpu, SNEK8_E_SELECTED, 4 * SNEK8_E_SCROLL_SCALE);
+                }else if (0x00FD == opcode){
+                    SNEK8_X_FAIL(SNEK8_EXECOUT_EXIT);
+                }else if (0x00FE == opcode || 0x00FF == opcode){
+                    cpu->hires = (0x00FF == opcode);
+                    if (SNEK8_E_MODE_CLEARS){
+                        _snek8_extClear(cpu, (1u << SNEK8_EXT_PLANES) - 1);
+                    }
+                }else{
+                    SNEK8_EXEC_NOP();
+                }
+                break;
+            case 0x1:
+                SNEK8_EXEC_JMP_ADDR(SNEK8_T_NNN);
+                break;
+            case 0x2:
+                SNEK8_EXEC_CALL(SNEK8_T_NNN);
+                break;
+            case 0x3:
+                SNEK8_E_SKIP(SNEK8_EXEC_SE_VX_BYTE(SNEK8_T_X, SNEK8_T_KK));
+                break;
+            case 0x4:
+                SNEK8_E_SKIP(SNEK8_EXEC_SNE_VX_BYTE(SNEK8_T_X, SNEK8_T_KK));
+                break;
+            case 0x5:
+                if (0 == SNEK8_T_N){
+                    SNEK8_E_SKIP(SNEK8_EXEC_SE_VX_VY(SNEK8_T_X, SNEK8_T_Y));
+#if SNEK8_E_XO
+                }else if (2 == SNEK8_T_N || 3 == SNEK8_T_N){
+                    // Registers V{0xX} to V{0xY}, in either direction; I is left as is.
+                    unsigned x = SNEK8_T_X, y = SNEK8_T_Y;
+                    unsigned count = ((x > y)? x - y: y - x) + 1;
+                    if (ir + count - 1 > SNEK8_E_MEM_END){
+                        SNEK8_X_FAIL(SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS);
+                    }
+                    for (unsigned i = 0; i < count; i++){
+                        unsigned r = (x > y)? x - i: x + i;
+                        if (2 == SNEK8_T_N){
+                            mem[ir + i] = v[r];
+                        }else{
+                            v[r] = mem[ir + i];
+                        }
+                    }
+#endif
+                }else{
+                    SNEK8_EXEC_NOP();
+                }
+                break;
+            case 0x6:
+                SNEK8_EXEC_LD_VX_BYTE(SNEK8_T_X, SNEK8_T_KK);
+                break;
+            case 0x7:
+                SNEK8_EXEC_ADD_VX_BYTE(SNEK8_T_X, SNEK8_T_KK);
+                break;
+            case 0x8:
+                switch (SNEK8_T_N){
+                    case 0x0:
+                        SNEK8_EXEC_LD_VX_VY(SNEK8_T_X, SNEK8_T_Y);
+                        break;
+                    case 0x1:
+                        SNEK8_EXEC_OR_VX_VY(SNEK8_T_X, SNEK8_T_Y);
+                        break;
+                    case 0x2:
+                        SNEK8_EXEC_AND_VX_VY(SNEK8_T_X, SNEK8_T_Y);
+                        break;
+                    case 0x3:
+                        SNEK8_EXEC_XOR_VX_VY(SNEK8_T_X, SNEK8_T_Y);
+                        break;
+                    case 0x4:
+                        SNEK8_EXEC_ADD_VX_VY(SNEK8_T_X, SNEK8_T_Y);
+                        break;
+                    case 0x5:
+                        SNEK8_EXEC_SUB_VX_VY(SNEK8_T_X, SNEK8_T_Y);
+                        break;
+                    case 0x6:
+                        SNEK8_EXEC_SHR_VX_VY(SNEK8_T_X, SNEK8_T_Y, SNEK8_EXEC_QUIRK(quirks, SNEK8_IMPLM_MODE_SHIFTS_USE_VY));
+                        break;
+                    case 0x7:
+                        SNEK8_EXEC_SUBN_VX_VY(SNEK8_T_X, SNEK8_T_Y);
+                        break;
+                    case 0xE:
+                        SNEK8_EXEC_SHL_VX_VY(SNEK8_T_X, SNEK8_T_Y, SNEK8_EXEC_QUIRK(quirks, SNEK8_IMPLM_MODE_SHIFTS_USE_VY));
+                        break;
+                    default:
+                        SNEK8_EXEC_NOP();
+                }
+                break;
+            case 0x9:
+                if (SNEK8_T_N){
+                    SNEK8_EXEC_NOP();
+                }
+                SNEK8_E_SKIP(SNEK8_EXEC_SNE_VX_VY(SNEK8_T_X, SNEK8_T_Y));
+                break;
+            case 0xA:
+                SNEK8_EXEC_LD_I_ADDR(SNEK8_T_NNN);
+                break;
+            case 0xB:
+                SNEK8_EXEC_JP_V0_ADDR(SNEK8_T_X, SNEK8_T_NNN, SNEK8_EXEC_QUIRK(quirks, SNEK8_IMPLM_MODE_BNNN_USES_VX));
+                break;
+            case 0xC:
+                SNEK8_EXEC_RND_VX_BYTE(SNEK8_T_X, SNEK8_T_KK);
+                break;
+            case 0xD:{
+                unsigned planes = SNEK8_E_SELECTED;
+                unsigned size = (SNEK8_T_N? SNEK8_T_N: 32u) * ((planes & 1u) + ((planes >> 1) & 1u));
+                if (size && ir + size - 1 > SNEK8_E_MEM_END){
+                    SNEK8_X_FAIL(SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS);
+                }
+                v[0xF] = _snek8_extDraw(cpu, planes, mem + ir, v[SNEK8_T_X], v[SNEK8_T_Y], SNEK8_T_N,
+                                        SNEK8_E_WRAP, SNEK8_E_ROW_HITS);
+                if (break_flags & SNEK8_RUN_BREAK_ON_DRAW){
+                    reason = SNEK8_RUNSTOP_DRAW;
+                    goto _snek8_retire_and_exit;
+                }
+                break;
+            }
+            case 0xE:
+                if (0x9E == SNEK8_T_KK){
+                    SNEK8_E_SKIP(SNEK8_EXEC_SKP_VX(SNEK8_T_X));
+                }else if (0xA1 == SNEK8_T_KK){
+                    SNEK8_E_SKIP(SNEK8_EXEC_SKNP_VX(SNEK8_T_X));
+                }else{
+                    SNEK8_EXEC_NOP();
+                }
+                break;
+            case 0xF:
+                switch (SNEK8_T_KK){
+#if SNEK8_E_XO
+                    case 0x00:
+                        if (SNEK8_T_X){
+                            SNEK8_EXEC_NOP();
+                        }
+                        // I := NNNN, the address being the next word.
+                        ir = (uint16_t) (mem[pc & SNEK8_E_MEM_END] << 8) | mem[(pc + 1) & SNEK8_E_MEM_END];
+                        pc += 2;
+                        break;
+                    case 0x01:
+                        cpu->planes = SNEK8_T_X & 0x3u;
+                        break;
+                    case 0x02:
+                        if (SNEK8_T_X){
+                            SNEK8_EXEC_NOP();
+                        }
+                        if (ir + SNEK8_EXT_SIZE_AUDIO - 1 > SNEK8_E_MEM_END){
+                            SNEK8_X_FAIL(SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS);
+                        }
+                        (void) memcpy(cpu->audio, mem + ir, SNEK8_EXT_SIZE_AUDIO);
+                        break;
+                    case 0x3A:
+                        cpu->pitch = v[SNEK8_T_X];
+                        break;
+#endif
+                    case 0x07:
+                        SNEK8_EXEC_LD_VX_DT(SNEK8_T_X);
+                        break;
+                    case 0x0A:
+                        SNEK8_EXEC_LD_VX_K(SNEK8_T_X);
+                        break;
+                    case 0x15:
+                        SNEK8_EXEC_LD_DT_VX(SNEK8_T_X);
+                        break;
+                    case 0x18:
+                        SNEK8_EXEC_LD_ST_VX(SNEK8_T_X);
+                        break;
+                    case 0x1E:
+                        SNEK8_EXEC_ADD_I_VX(SNEK8_T_X);
+                        break;
+                    case 0x29:
+                        SNEK8_EXEC_LD_F_VX(SNEK8_T_X);
+                        break;
+                    case 0x30:
+                        ir = SNEK8_EXT_MEM_ADDR_BIGFONT_START + 10 * (v[SNEK8_T_X] & 0xFu);
+                        break;
+                    case 0x33:
+                        SNEK8_EXEC_LD_B_VX(SNEK8_T_X);
+                        break;
+                    case 0x55:
+                        SNEK8_EXEC_LD_I_V0_VX(SNEK8_T_X, SNEK8_EXEC_QUIRK(quirks, SNEK8_IMPLM_MODE_FX_CHANGES_I));
+                        break;
+                    case 0x65:
+                        SNEK8_EXEC_LD_VX_V0_I(SNEK8_T_X, SNEK8_EXEC_QUIRK(quirks, SNEK8_IMPLM_MODE_FX_CHANGES_I));
+                        break;
+                    case 0x75:
+                    case 0x85:
+                        if (SNEK8_T_X >= SNEK8_E_FLAGS){
+                            SNEK8_EXEC_NOP();
+                        }
+                        if (0x75 == SNEK8_T_KK){
+                            (void) memcpy(cpu->flags, v, SNEK8_T_X + 1);
+                        }else{
+                            (void) memcpy(v, cpu->flags, SNEK8_T_X + 1);
+                        }
+                        break;
+                    default:
+                        SNEK8_EXEC_NOP();
+                }
+                break;
+        }
+        executed++;
+        SNEK8_EXEC_CLOCK(1);
+    }
+_snek8_retire_and_exit:
+    executed++;
+    SNEK8_EXEC_CLOCK(1);
+_snek8_exit:
+    (void) memcpy(cpu->registers, v, SNEK8_SIZE_REGISTERS);
+    cpu->pc = pc;
+    cpu->ir = ir;
+    cpu->dt = dt;
+    cpu->st = st;
+    cpu->timer_phase = phase;
+    cpu->cycles += executed;
+    if (SNEK8_RUNSTOP_KEY_WAIT == reason && !(break_flags & SNEK8_RUN_BREAK_ON_KEY_WAIT)){
+        size_t idle = 0;
+        (void) _snek8_extRunWaiting(cpu, max_cycles - executed, break_flags, &idle, &reason);
+        executed += idle;
+    }
+    if (cycles){
+        *cycles = executed;
+    }
+    if (stop){
+        *stop = reason;
+    }
+    return out;
+}
+
+#undef SNEK8_E_SKIP
+#undef SNEK8_E_SCROLL_SCALE
+#undef SNEK8_E_SELECTED
+#undef SNEK8_E_MODE_CLEARS
+#undef SNEK8_E_LORES_SCROLL
+#undef SNEK8_E_ROW_HITS
+#undef SNEK8_E_WRAP
+#undef SNEK8_E_FLAGS
+#undef SNEK8_E_MEM_END
+#undef SNEK8_E_PLANES
+#undef SNEK8_E_XO
+#undef SNEK8_E_NAME
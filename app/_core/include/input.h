@@ -0,0 +1,112 @@
+/**
+* @file input.h
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Declaration of the key event queue.
+*
+* The frontend posts the presses and releases of the keys from its own thread while
+* the CPU runs on another one (see the emulator's worker). The queue carries them as
+* a single-producer, single-consumer ring: the producer only writes `tail` and the
+* consumer only writes `head`, each publishing its slots with release stores, so that
+* neither side ever waits on the other. The owner of the CPU drains the queue between
+* two runs and applies the events in order with `snek8_cpuSetKey`, so that a press
+* and a release in quick succession both reach LD V{0xX}, K instead of being merged
+* into the level of the key.
+*
+* Each event is a byte holding the key in its low nibble and its new value in bit 4,
+* as in the replays.
+*/
+#ifndef SNEK8_INPUT_H
+    #define SNEK8_INPUT_H
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include <stdatomic.h>
+#include "cpu.h"
+
+/**
+* @def SNEK8_KEY_QUEUE_SIZE
+* @brief The number of events a key queue holds (a power of 2).
+*/
+#define SNEK8_KEY_QUEUE_SIZE            64
+
+_Static_assert(!(SNEK8_KEY_QUEUE_SIZE & (SNEK8_KEY_QUEUE_SIZE - 1)),
+               "The key queue size must be a power of 2.");
+
+/**
+* @brief Lock-free queue of key events.
+*
+* @param `head` The number of events popped, written by the consumer only.
+* @param `tail` The number of events pushed, written by the producer only.
+* @param `lost` Set by the producer when an event did not fit: the consumer has to
+*        resynchronize the keys with their levels.
+* @param `events` The ring of events.
+* @note A zero-filled queue is empty.
+*/
+typedef struct{
+    atomic_uint_least32_t head;
+    atomic_uint_least32_t tail;
+    atomic_bool lost;
+    uint8_t events[SNEK8_KEY_QUEUE_SIZE];
+} Snek8KeyQueue;
+
+/**
+* @brief Posts an event. Only the producer may call this function.
+*
+* @param[in, out] `queue`.
+* @param[in] `key`.
+* @param[in] `value`.
+* @return Whether the event was queued; if not, the queue is marked as lossy.
+*/
+static inline bool
+snek8_keyQueuePush(Snek8KeyQueue* queue, uint8_t key, bool value){
+    uint_least32_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    uint_least32_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    if (tail - head >= SNEK8_KEY_QUEUE_SIZE){
+        atomic_store_explicit(&queue->lost, true, memory_order_release);
+        return false;
+    }
+    queue->events[tail & (SNEK8_KEY_QUEUE_SIZE - 1)] = (uint8_t) ((key & 0x0Fu) | (value << 4));
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+/**
+* @brief Takes the oldest event. Only the consumer may call this function.
+*
+* @param[in, out] `queue`.
+* @param[out] `key`.
+* @param[out] `value`.
+* @return Whether there was an event.
+*/
+static inline bool
+snek8_keyQueuePop(Snek8KeyQueue* queue, uint8_t* key, bool* value){
+    uint_least32_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    uint_least32_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    if (head == tail){
+        return false;
+    }
+    uint8_t event = queue->events[head & (SNEK8_KEY_QUEUE_SIZE - 1)];
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    *key = event & 0x0Fu;
+    *value = (event >> 4) & 0x1u;
+    return true;
+}
+
+/**
+* @brief Clears the mark left by a lost event, returning it. Only the consumer may
+* call this function.
+*
+* @param[in, out] `queue`.
+* @return Whether events were lost since the last call.
+*/
+static inline bool
+snek8_keyQueueTakeLost(Snek8KeyQueue* queue){
+    return atomic_exchange_explicit(&queue->lost, false, memory_order_acquire);
+}
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_INPUT_H
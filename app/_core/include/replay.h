@@ -0,0 +1,170 @@
+/**
+* @file replay.h
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Declaration of the input replays.
+*
+* Since every source of nondeterminism of a CPU is part of its state (the random
+* number generator included), a session is fully determined by its initial state
+* and by the key changes, timestamped with the cycle at which the CPU saw them. A
+* replay holds exactly that, so that playing it back with any engine, at any speed,
+* reproduces the session bit for bit.
+*
+* The serialized format is little-endian:
+*
+*         Offset | Size | Field
+*         -------|------|----------------------------------------
+*            0   |   4  | magic "S8RP"
+*            4   |   2  | version (`SNEK8_REPLAY_VERSION`)
+*            6   |   2  | the execution output that ended the session (0 if none)
+*            8   |   4  | number of events
+*           12   |   8  | the cycle at which the recording ended
+*           20   | 4448 | initial state (see `Snek8Snapshot`)
+*         4468   |  ... | events
+*
+* where each event is the number of cycles since the previous event (or since the
+* initial state) as a LEB128 integer, followed by a byte holding the key in its low
+* nibble and its new value in bit 4.
+*/
+#ifndef SNEK8_REPLAY_H
+    #define SNEK8_REPLAY_H
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include "cpu.h"
+
+/**
+* @def SNEK8_REPLAY_VERSION
+* @brief The version of the replay format.
+*/
+#define SNEK8_REPLAY_VERSION            2
+
+/**
+* @def SNEK8_SIZE_REPLAY_HEADER
+* @brief The size of the serialized replay before its events.
+*/
+#define SNEK8_SIZE_REPLAY_HEADER        (20 + SNEK8_SIZE_SNAPSHOT)
+
+/**
+* @brief A change of a key.
+*
+* @param `cycle` The value of `Snek8CPU.cycles` when the CPU saw the change.
+* @param `key` The key.
+* @param `value` Whether the key is pressed.
+*/
+typedef struct{
+    uint64_t cycle;
+    uint8_t key;
+    bool value;
+} Snek8ReplayEvent;
+
+/**
+* @brief Implementation of a replay.
+*
+* @param `start` The initial state.
+* @param `end_cycle` The cycle at which the recording ended.
+* @param `keys` The key set after the last event.
+* @param `out` The error that ended the session, `SNEK8_EXECOUT_SUCCESS` if none. A
+*        failing instruction does not retire, so that the CPU stays right before it
+*        and keeps failing on it: playing back such a session runs it once more.
+* @param `failed` Whether an event could not be recorded for lack of memory.
+* @param `count` The number of events.
+* @param `capacity` The number of events `events` can hold.
+* @param `events` The events, by nondecreasing cycle.
+*/
+typedef struct{
+    Snek8Snapshot start;
+    uint64_t end_cycle;
+    uint16_t keys;
+    enum Snek8ExecutionOutput out;
+    bool failed;
+    size_t count;
+    size_t capacity;
+    Snek8ReplayEvent* events;
+} Snek8Replay;
+
+/**
+* @brief Starts recording a replay from the current state of a CPU.
+*
+* @param[in] `cpu`.
+* @return The new replay, or NULL if the allocation failed.
+* @note The replay must be released with `snek8_replayDel`.
+*/
+Snek8Replay*
+snek8_replayNew(const Snek8CPU* cpu);
+
+/**
+* @brief Releases a replay.
+*
+* @param[in, out] `replay` (may be NULL).
+*/
+void
+snek8_replayDel(Snek8Replay* replay);
+
+/**
+* @brief Records the key set a CPU sees from a given cycle on, as one event per
+* changed key.
+*
+* @param[in, out] `replay`.
+* @param[in] `cycle` The CPU's cycle counter (not less than the previous one).
+* @param[in] `keys` The key set.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - `SNEK8_EXECOUT_OUT_OF_MEMORY`: the replay is then marked as failed.
+*/
+enum Snek8ExecutionOutput
+snek8_replayRecord(Snek8Replay* replay, uint64_t cycle, uint16_t keys);
+
+/**
+* @brief Computes the size of the serialized replay.
+*
+* @param[in] `replay`.
+* @return The size in bytes.
+*/
+size_t
+snek8_replaySize(const Snek8Replay* replay);
+
+/**
+* @brief Serializes a replay.
+*
+* @param[in] `replay`.
+* @param[out] `data` A buffer of `snek8_replaySize(replay)` bytes.
+*/
+void
+snek8_replayWrite(const Snek8Replay* replay, uint8_t* data);
+
+/**
+* @brief Parses a serialized replay.
+*
+* @param[in] `data`.
+* @param[in] `size` The size of `data` in bytes.
+* @param[out] `replay` The new replay, to be released with `snek8_replayDel`.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - `SNEK8_EXECOUT_REPLAY_INVALID`: malformed data or invalid initial state.
+* - `SNEK8_EXECOUT_OUT_OF_MEMORY`.
+*/
+enum Snek8ExecutionOutput
+snek8_replayRead(const uint8_t* data, size_t size, Snek8Replay** replay);
+
+/**
+* @brief Plays a replay back as fast as possible: the CPU is restored to the initial
+* state and run up to the end of the recording, each key change being applied with
+* `snek8_cpuSetKey` right at its cycle.
+*
+* @param[in] `replay`.
+* @param[in, out] `cpu`.
+* @param[in] `run` The engine to run the CPU with (see `snek8_cpuGetRunEngine`).
+* @return The execution output of the session: `SNEK8_EXECOUT_SUCCESS`, or the error
+* of the instruction that ended it (see `Snek8Replay.out`).
+*/
+enum Snek8ExecutionOutput
+snek8_replayPlay(const Snek8Replay* replay, Snek8CPU* cpu, Snek8RunEngine run);
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_REPLAY_H
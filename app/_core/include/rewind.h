@@ -0,0 +1,130 @@
+/**
+* @file rewind.h
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Declaration of the rewind buffer.
+*
+* The rewind buffer records the state of a CPU once per frame, within a fixed memory
+* budget. Only the most recent state is kept in full (in the snapshot format, see
+* `Snek8Snapshot`); every older frame is stored as the XOR of its state with the
+* state of the following frame, run-length encoded. Between two frames, a program
+* typically changes a few registers, the program counter, the timers and a handful
+* of memory and screen bytes, so the XOR is almost only zeros and an entry takes
+* tens of bytes instead of the ~4 KB of a full state.
+*
+* Rewinding undoes the entries from the most recent one, applying each of them to
+* the full state. When the budget is exhausted, recording drops the oldest entries.
+*
+* The entries are stored back to back in a byte ring as follows:
+*
+*         +------+-------------------------------------+------+
+*         | size | (zeros, literals, bytes[literals])* | size |
+*         +------+-------------------------------------+------+
+*
+* where each size is the 16-bit little-endian size of the payload, so that the ring
+* can be walked from both ends, and zeros and literals are LEB128 integers: the
+* number of bytes left untouched and the number of bytes XOR-ed with the literals.
+*/
+#ifndef SNEK8_REWIND_H
+    #define SNEK8_REWIND_H
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include "cpu.h"
+
+/**
+* @def SNEK8_REWIND_MAX_ENTRY
+* @brief An upper bound of the size of an entry, header and trailer included.
+*/
+#define SNEK8_REWIND_MAX_ENTRY          (2 * SNEK8_SIZE_SNAPSHOT + 8)
+
+/**
+* @def SNEK8_REWIND_MIN_BUDGET
+* @brief The smallest memory budget of a rewind buffer, in bytes.
+*/
+#define SNEK8_REWIND_MIN_BUDGET         (4 * SNEK8_REWIND_MAX_ENTRY)
+
+/**
+* @brief Implementation of the rewind buffer.
+*
+* @param `ring` The storage of the entries.
+* @param `budget` The size of `ring` in bytes.
+* @param `head` The offset at which the next entry will be written.
+* @param `used` The number of bytes of `ring` taken by the entries.
+* @param `frames` The number of entries, i.e. of frames that can be rewound.
+* @param `primed` Whether `latest` holds a recorded state.
+* @param `latest` The most recently recorded state.
+* @param `current` Scratch buffer for the state being recorded.
+* @param `entry` Scratch buffer for the entry being written or undone.
+*/
+typedef struct{
+    uint8_t* ring;
+    size_t budget;
+    size_t head;
+    size_t used;
+    size_t frames;
+    bool primed;
+    Snek8Snapshot latest;
+    uint8_t current[SNEK8_SIZE_SNAPSHOT];
+    uint8_t entry[SNEK8_REWIND_MAX_ENTRY];
+} Snek8Rewind;
+
+/**
+* @brief Allocates an empty rewind buffer.
+*
+* @param[in] `budget` The memory, in bytes, the entries may take
+*            (at least `SNEK8_REWIND_MIN_BUDGET`).
+* @return The new rewind buffer, or NULL if the budget is too small or the
+* allocation failed.
+* @note The buffer must be released with `snek8_rewindDel`.
+*/
+Snek8Rewind*
+snek8_rewindNew(size_t budget);
+
+/**
+* @brief Releases a rewind buffer.
+*
+* @param[in, out] `rewind` (may be NULL).
+*/
+void
+snek8_rewindDel(Snek8Rewind* rewind);
+
+/**
+* @brief Drops every recorded frame.
+*
+* @param[in, out] `rewind`.
+*/
+void
+snek8_rewindClear(Snek8Rewind* rewind);
+
+/**
+* @brief Records the state of the CPU as a new frame.
+*
+* @param[in, out] `rewind`.
+* @param[in] `cpu`.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+*/
+enum Snek8ExecutionOutput
+snek8_rewindRecord(Snek8Rewind* rewind, const Snek8CPU* cpu);
+
+/**
+* @brief Restores the CPU to the state recorded `frames` frames before the most
+* recent one, which then becomes the most recent one.
+*
+* @param[in, out] `rewind`.
+* @param[in, out] `cpu`.
+* @param[in] `frames` The number of frames to go back; 0 restores the most recent
+*            state, and it is clamped to the number of recorded frames.
+* @return The number of frames gone back. The CPU is left untouched if nothing was
+* recorded.
+*/
+size_t
+snek8_rewindRewind(Snek8Rewind* rewind, Snek8CPU* cpu, size_t frames);
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_REWIND_H
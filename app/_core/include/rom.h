@@ -0,0 +1,107 @@
+/**
+* @file rom.h
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Declaration of the ROM files reading and of the ROM cache.
+*
+* ROM files are memory-mapped and copied once into a `Snek8Rom`. The cache keeps the
+* most recently used ROMs, keyed by path and validated against the file's size and
+* modification time, so that loading the same ROM into many CPUs costs a `stat` and a
+* copy instead of opening and reading the file every time.
+*/
+#ifndef SNEK8_ROM_H
+    #define SNEK8_ROM_H
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include "cpu.h"
+
+/**
+* @def SNEK8_ROM_CACHE_SIZE
+* @brief The number of ROMs a cache holds.
+*/
+#define SNEK8_ROM_CACHE_SIZE            32
+
+/**
+* @brief A ROM read from a file.
+*
+* @param `mtime` The modification time of the file, in nanoseconds.
+* @param `size` The size of the ROM in bytes.
+* @param `data` The ROM.
+*/
+typedef struct{
+    int64_t mtime;
+    size_t size;
+    uint8_t data[SNEK8_SIZE_MAX_ROM_FILE];
+} Snek8Rom;
+
+/**
+* @brief An entry of the ROM cache.
+*
+* @param `path` The path of the file (owned by the entry), or NULL if the entry is free.
+* @param `used` The value of the cache's clock when the entry was last used.
+* @param `rom`.
+*/
+typedef struct{
+    char* path;
+    uint64_t used;
+    Snek8Rom rom;
+} Snek8RomCacheEntry;
+
+/**
+* @brief Implementation of the ROM cache. The least recently used entry is replaced
+* when the cache is full.
+*
+* @param `clock` Counts the lookups.
+* @param `entries`.
+* @note The cache is not thread-safe: the caller has to serialize its use.
+*/
+typedef struct{
+    uint64_t clock;
+    Snek8RomCacheEntry entries[SNEK8_ROM_CACHE_SIZE];
+} Snek8RomCache;
+
+/**
+* @brief Reads a ROM file.
+*
+* @param[in] `rom_file_path`.
+* @param[out] `rom`.
+* @return A code representation on whether the execution was sucesseful.
+* @note The following error codes can be returned by this function:
+* - `SNEK8_EXECOUT_EMPTY_STRUCT`.
+* - `SNEK8_EXECOUT_ROM_FILE_INVALID`: NULL path, or not a regular file.
+* - `SNEK8_EXECOUT_ROM_FILE_NOT_FOUND`.
+* - `SNEK8_EXECOUT_ROM_FILE_FAILED_TO_OPEN`.
+* - `SNEK8_EXECOUT_ROM_FILE_EXCEEDS_MAX_MEM`.
+* - `SNEK8_EXECOUT_ROM_FILE_FAILED_TO_READ`.
+*/
+enum Snek8ExecutionOutput
+snek8_romRead(const char* rom_file_path, Snek8Rom* rom);
+
+/**
+* @brief Looks a ROM file up in the cache, reading it if it is not cached or if it
+* changed since it was cached.
+*
+* @param[in, out] `cache`.
+* @param[in] `rom_file_path`.
+* @param[out] `rom` The cached ROM, valid until the next call on the cache.
+* @return A code representation on whether the execution was sucesseful.
+* @note The error codes are those of `snek8_romRead`. A file that cannot be read is
+* dropped from the cache.
+*/
+enum Snek8ExecutionOutput
+snek8_romCacheGet(Snek8RomCache* cache, const char* rom_file_path, const Snek8Rom** rom);
+
+/**
+* @brief Drops every ROM of the cache.
+*
+* @param[in, out] `cache`.
+*/
+void
+snek8_romCacheClear(Snek8RomCache* cache);
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_ROM_H
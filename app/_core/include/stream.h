@@ -0,0 +1,194 @@
+/**
+* @file stream.h
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Declaration of the frame stream.
+*
+* The frame stream encodes the screen for remote viewers as a sequence of compact
+* frames. Each frame is the XOR of the screen with the previously encoded one, row by
+* row, and only the rows that changed are stored; a keyframe is the XOR with a blank
+* screen, i.e. the rows that are lit, and lets a viewer start decoding (or resume
+* after a lost frame) from scratch. Between two frames, a program typically draws or
+* erases a few sprites, so a frame takes a few dozen bytes instead of the 256 of the
+* screen.
+*
+* The frames are stored back to back in a bounded byte queue as follows:
+*
+*         +----------+------+------+------+-------------------------------+
+*         | sequence | size | kind | rows | (row, mask, bytes[mask])*rows |
+*         +----------+------+------+------+-------------------------------+
+*
+* where sequence is the 32-bit little-endian number of the frame (which skips the
+* frames that did not fit in the queue), size is the 16-bit little-endian size of the
+* whole frame, kind is `SNEK8_STREAM_KEYFRAME` or `SNEK8_STREAM_DELTA` and rows is the
+* number of rows that follow. Each row holds its index, a mask whose bit i is set
+* when the byte i of the row changed, and the XOR of those bytes, the byte i covering
+* the pixels 8i to 8i + 7 from its most significant bit.
+*
+* The queue is a single-producer, single-consumer ring: the owner of the CPU pushes
+* the frames and a single consumer, which may run on another thread, reads them, each
+* side publishing its progress with release stores. A frame that does not fit is
+* dropped and the next one is a keyframe, so that a slow consumer loses frames
+* instead of stalling the emulation.
+*/
+#ifndef SNEK8_STREAM_H
+    #define SNEK8_STREAM_H
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include <stdatomic.h>
+#include "cpu.h"
+
+/**
+* @def SNEK8_STREAM_SIZE_HEADER
+* @brief The size of the header of a frame.
+*/
+#define SNEK8_STREAM_SIZE_HEADER        8
+
+/**
+* @def SNEK8_STREAM_MAX_FRAME
+* @brief The size of the largest frame: every row changed in every byte.
+*/
+#define SNEK8_STREAM_MAX_FRAME          (SNEK8_STREAM_SIZE_HEADER + SNEK8_GRAPHICS_HEIGTH * 10)
+
+/**
+* @def SNEK8_STREAM_DEFAULT_CAPACITY
+* @brief The default size of the queue, in bytes.
+*/
+#define SNEK8_STREAM_DEFAULT_CAPACITY   16384
+
+/**
+* @def SNEK8_STREAM_DEFAULT_KEYFRAME_INTERVAL
+* @brief The default number of frames from a keyframe to the next.
+*/
+#define SNEK8_STREAM_DEFAULT_KEYFRAME_INTERVAL 60
+
+/**
+* @def SNEK8_STREAM_KEYFRAME
+* @brief The kind of a frame encoded against a blank screen.
+*/
+#define SNEK8_STREAM_KEYFRAME           0
+
+/**
+* @def SNEK8_STREAM_DELTA
+* @brief The kind of a frame encoded against the previous frame.
+*/
+#define SNEK8_STREAM_DELTA              1
+
+/**
+* @brief Implementation of the frame stream.
+*
+* @param `ring` The storage of the queue.
+* @param `capacity` The size of `ring` in bytes.
+* @param `head` The number of bytes pushed, written by the producer only.
+* @param `tail` The number of bytes read, written by the consumer only.
+* @param `requested` Set by anyone to make the next frame a keyframe.
+* @param `dropped` The number of frames that did not fit in the queue.
+* @param `sequence` The number of the next frame.
+* @param `keyframe_interval` The largest number of frames from a keyframe to the next.
+* @param `since_keyframe` The number of frames pushed since the last keyframe.
+* @param `resync` Whether the next frame has to be a keyframe, because the previous
+*        one was dropped or none was pushed yet.
+* @param `rows` The screen of the last encoded frame.
+* @param `entry` Scratch buffer for the frame being encoded.
+*/
+typedef struct{
+    uint8_t* ring;
+    size_t capacity;
+    atomic_uint_least64_t head;
+    atomic_uint_least64_t tail;
+    atomic_bool requested;
+    atomic_uint_least64_t dropped;
+    uint32_t sequence;
+    uint32_t keyframe_interval;
+    uint32_t since_keyframe;
+    bool resync;
+    uint64_t rows[SNEK8_GRAPHICS_HEIGTH];
+    uint8_t entry[SNEK8_STREAM_MAX_FRAME];
+} Snek8Stream;
+
+/**
+* @brief Allocates an empty frame stream.
+*
+* @param[in] `capacity` The size of the queue, in bytes (at least
+*            `SNEK8_STREAM_MAX_FRAME`).
+* @param[in] `keyframe_interval` The largest number of frames from a keyframe to the
+*            next (at least 1; 1 makes every frame a keyframe).
+* @return The new stream, or NULL if an argument is invalid or the allocation failed.
+* @note The stream must be released with `snek8_streamDel`.
+*/
+Snek8Stream*
+snek8_streamNew(size_t capacity, uint32_t keyframe_interval);
+
+/**
+* @brief Releases a frame stream.
+*
+* @param[in, out] `stream` (may be NULL).
+*/
+void
+snek8_streamDel(Snek8Stream* stream);
+
+/**
+* @brief Encodes the screen and queues the frame, unless it did not change since the
+* last frame and no keyframe is due. Only the producer may call this function.
+*
+* @param[in, out] `stream`.
+* @param[in] `graphics` The packed screen (see `Snek8CPU`).
+* @return Whether a frame was queued.
+*/
+bool
+snek8_streamPush(Snek8Stream* stream, const uint64_t* graphics);
+
+/**
+* @brief Makes the next frame a keyframe, e.g. for a viewer that just joined. Anyone
+* may call this function.
+*
+* @param[in, out] `stream`.
+*/
+static inline void
+snek8_streamRequestKeyframe(Snek8Stream* stream){
+    atomic_store_explicit(&stream->requested, true, memory_order_relaxed);
+}
+
+/**
+* @brief Retrieves the number of bytes queued.
+*
+* @param[in] `stream`.
+*/
+static inline size_t
+snek8_streamPending(Snek8Stream* stream){
+    uint64_t tail = atomic_load_explicit(&stream->tail, memory_order_relaxed);
+    return (size_t) (atomic_load_explicit(&stream->head, memory_order_acquire) - tail);
+}
+
+/**
+* @brief Moves whole frames out of the queue, in order. Only the consumer may call this
+* function.
+*
+* @param[in, out] `stream`.
+* @param[out] `data`.
+* @param[in] `size` The size of `data`; `SNEK8_STREAM_MAX_FRAME` bytes always fit a
+*            frame.
+* @return The number of bytes written to `data`.
+*/
+size_t
+snek8_streamRead(Snek8Stream* stream, uint8_t* data, size_t size);
+
+/**
+* @brief Applies a frame to a screen.
+*
+* @param[in, out] `graphics` The packed screen the previous frames were applied to. A
+*                 keyframe replaces it.
+* @param[in] `data` The frame.
+* @param[in] `size` The number of bytes available at `data`.
+* @return The size of the frame, or 0 (leaving `graphics` untouched) if `data` does not
+* start with a whole, valid frame.
+*/
+size_t
+snek8_streamDecode(uint64_t* graphics, const uint8_t* data, size_t size);
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_STREAM_H
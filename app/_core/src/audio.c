@@ -0,0 +1,132 @@
+/**
+* @file audio.c
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Implementation of the audio generator.
+*/
+#ifndef SNEK8_AUDIO_C
+    #define SNEK8_AUDIO_C
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include <math.h>
+#include "audio.h"
+
+enum Snek8ExecutionOutput
+snek8_audioInit(Snek8Audio* audio, int16_t* samples, size_t capacity, uint32_t rate,
+                uint32_t tone, int32_t volume){
+    if (!audio || !samples){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (rate < SNEK8_TIMER_FREQUENCY || rate > SNEK8_AUDIO_MAX_RATE || !tone || tone >= rate / 2
+        || volume < 0 || volume > INT16_MAX || capacity < snek8_audioFrameSize(rate)){
+        return SNEK8_EXECOUT_INDEX_OUT_RANGE;
+    }
+    audio->samples = samples;
+    audio->capacity = capacity;
+    atomic_store_explicit(&audio->written, 0, memory_order_relaxed);
+    audio->rate = rate;
+    audio->tone = tone;
+    audio->volume = volume;
+    audio->envelope = 0;
+    audio->frame_phase = 0;
+    audio->wave_phase = 0;
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+/**
+* @brief The progress of the waveform per sample, 2^32 being a whole period.
+*/
+static inline uint32_t
+_snek8_audioStep(const Snek8Audio* audio, const uint8_t* pattern, uint8_t pitch){
+    if (!pattern){
+        return (uint32_t) (((uint64_t) audio->tone << 32) / audio->rate);
+    }
+    double bits = SNEK8_AUDIO_PATTERN_RATE * exp2((pitch - 64) / 48.0);
+    double step = bits * (4294967296.0 / SNEK8_AUDIO_PATTERN_BITS) / audio->rate;
+    // Past the Nyquist rate of the pattern, there is no point in going faster.
+    return (step < 2147483648.0)? (uint32_t) step: UINT32_C(2147483648);
+}
+
+/**
+* @brief Writes `n` samples of the buzzer into the ring. Only the last `capacity` of
+* them are synthesized.
+*/
+static void
+_snek8_audioWrite(Snek8Audio* audio, uint64_t n, bool on, const uint8_t* pattern, uint8_t pitch){
+    uint32_t step = _snek8_audioStep(audio, pattern, pitch);
+    uint64_t written = atomic_load_explicit(&audio->written, memory_order_relaxed);
+    if (n > audio->capacity){
+        uint64_t skipped = n - audio->capacity;
+        audio->wave_phase += (uint32_t) (step * skipped);
+        audio->envelope = on? audio->volume: 0;
+        written += skipped;
+        n = audio->capacity;
+    }
+    int32_t target = on? audio->volume: 0;
+    int32_t delta = audio->volume / SNEK8_AUDIO_RAMP + 1;
+    int32_t envelope = audio->envelope;
+    uint32_t phase = audio->wave_phase;
+    size_t at = (size_t) (written % audio->capacity);
+    for (uint64_t i = 0; i < n; i++){
+        if (envelope < target){
+            envelope = (target - envelope > delta)? envelope + delta: target;
+        }else if (envelope > target){
+            envelope = (envelope - target > delta)? envelope - delta: target;
+        }
+        bool high;
+        if (pattern){
+            uint32_t bit = phase >> 25;
+            high = (pattern[bit >> 3] >> (7 - (bit & 0x7u))) & 0x1u;
+        }else{
+            high = !(phase >> 31);
+        }
+        audio->samples[at] = (int16_t) (high? envelope: -envelope);
+        phase += step;
+        if (++at == audio->capacity){
+            at = 0;
+        }
+    }
+    audio->envelope = envelope;
+    audio->wave_phase = phase;
+    atomic_store_explicit(&audio->written, written + n, memory_order_release);
+}
+
+/**
+* @brief Advances the frame clock by `frames` frames.
+*
+* @return The number of samples of those frames.
+*/
+static inline uint64_t
+_snek8_audioFrames(Snek8Audio* audio, uint64_t frames){
+    uint64_t total = audio->frame_phase + frames * audio->rate;
+    audio->frame_phase = (uint32_t) (total % SNEK8_TIMER_FREQUENCY);
+    return total / SNEK8_TIMER_FREQUENCY;
+}
+
+void
+snek8_audioFrame(Snek8Audio* audio, bool on, const uint8_t* pattern, uint8_t pitch){
+    _snek8_audioWrite(audio, _snek8_audioFrames(audio, 1), on, pattern, pitch);
+}
+
+void
+snek8_audioTicks(Snek8Audio* audio, uint64_t ticks, uint8_t st_before, uint8_t st_after,
+                 const uint8_t* pattern, uint8_t pitch){
+    if (!ticks){
+        return;
+    }
+    uint64_t sounding = (ticks - 1 < st_before)? ticks - 1: st_before;
+    for (uint64_t j = 0; j < sounding; j++){
+        snek8_audioFrame(audio, true, pattern, pitch);
+    }
+    if (ticks - 1 > sounding){
+        _snek8_audioWrite(audio, _snek8_audioFrames(audio, ticks - 1 - sounding), false, pattern, pitch);
+    }
+    snek8_audioFrame(audio, st_before >= ticks || st_after, pattern, pitch);
+}
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_AUDIO_C
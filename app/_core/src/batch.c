@@ -0,0 +1,517 @@
+/**
+* @file batch.c
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Implementation of the lockstep batch of CPUs.
+*/
+#ifndef SNEK8_BATCH_C
+    #define SNEK8_BATCH_C
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include <stdlib.h>
+#include "batch.h"
+#include "cpu_exec.h"
+
+Snek8Batch*
+snek8_batchNew(size_t lanes, uint8_t implm_flags){
+    if (!lanes){
+        return NULL;
+    }
+    Snek8Batch* batch = calloc(1, sizeof(Snek8Batch));
+    if (!batch){
+        return NULL;
+    }
+    batch->lanes = lanes;
+    batch->implm_flags = implm_flags;
+    batch->ips = SNEK8_CPU_DEFAULT_IPS;
+    batch->memory = calloc(lanes, SNEK8_SIZE_RAM * sizeof(uint8_t));
+    batch->graphics = calloc(lanes, SNEK8_SIZE_GRAPHICS_BYTES);
+    batch->graphics_gen = calloc(lanes, sizeof(uint32_t));
+    batch->graphics_dirty = calloc(lanes, sizeof(uint32_t));
+    batch->stacks = calloc(lanes, sizeof(Snek8Stack));
+    batch->registers = calloc(lanes, SNEK8_SIZE_REGISTERS * sizeof(uint8_t));
+    batch->keys = calloc(lanes, sizeof(uint16_t));
+    batch->key_wait = calloc(lanes, sizeof(uint8_t));
+    batch->key_armed = calloc(lanes, sizeof(uint16_t));
+    batch->pc = calloc(lanes, sizeof(uint16_t));
+    batch->ir = calloc(lanes, sizeof(uint16_t));
+    batch->dt = calloc(lanes, sizeof(uint8_t));
+    batch->st = calloc(lanes, sizeof(uint8_t));
+    batch->rng = calloc(lanes, sizeof(uint32_t));
+    batch->status = calloc(lanes, sizeof(uint8_t));
+    batch->halt_cycles = calloc(lanes, sizeof(uint64_t));
+    batch->opcodes = calloc(lanes, sizeof(uint16_t));
+    if (!batch->memory || !batch->graphics || !batch->graphics_gen || !batch->graphics_dirty
+        || !batch->stacks || !batch->registers || !batch->keys || !batch->key_wait
+        || !batch->key_armed || !batch->pc || !batch->ir || !batch->dt || !batch->st
+        || !batch->rng || !batch->status || !batch->halt_cycles || !batch->opcodes){
+        snek8_batchDel(batch);
+        return NULL;
+    }
+    Snek8CPU cpu;
+    (void) snek8_cpuInit(&cpu, implm_flags);
+    for (size_t lane = 0; lane < lanes; lane++){
+        (void) snek8_batchLoadLane(batch, lane, &cpu);
+    }
+    snek8_batchSeed(batch, 0);
+    return batch;
+}
+
+void
+snek8_batchDel(Snek8Batch* batch){
+    if (!batch){
+        return;
+    }
+    free(batch->memory);
+    free(batch->graphics);
+    free(batch->graphics_gen);
+    free(batch->graphics_dirty);
+    free(batch->stacks);
+    free(batch->registers);
+    free(batch->keys);
+    free(batch->key_wait);
+    free(batch->key_armed);
+    free(batch->pc);
+    free(batch->ir);
+    free(batch->dt);
+    free(batch->st);
+    free(batch->rng);
+    free(batch->status);
+    free(batch->halt_cycles);
+    free(batch->opcodes);
+    free(batch);
+}
+
+enum Snek8ExecutionOutput
+snek8_batchLoadLane(Snek8Batch* batch, size_t lane, const Snek8CPU* cpu){
+    if (!batch || !cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (lane >= batch->lanes){
+        return SNEK8_EXECOUT_INDEX_OUT_RANGE;
+    }
+    if (cpu->implm_flags != batch->implm_flags){
+        return SNEK8_EXECOUT_INVALID_ARG;
+    }
+    (void) memcpy(batch->memory + lane * SNEK8_SIZE_RAM, cpu->memory, SNEK8_SIZE_RAM);
+    (void) memcpy(batch->graphics + lane * SNEK8_GRAPHICS_HEIGTH, cpu->graphics,
+                  SNEK8_SIZE_GRAPHICS_BYTES);
+    batch->graphics_gen[lane] = cpu->graphics_gen;
+    batch->graphics_dirty[lane] = cpu->graphics_dirty;
+    batch->stacks[lane] = cpu->stack;
+    for (size_t i = 0; i < SNEK8_SIZE_REGISTERS; i++){
+        batch->registers[i * batch->lanes + lane] = cpu->registers[i];
+    }
+    batch->keys[lane] = cpu->keys;
+    batch->key_wait[lane] = cpu->key_wait;
+    batch->key_armed[lane] = cpu->key_armed;
+    batch->pc[lane] = cpu->pc;
+    batch->ir[lane] = cpu->ir;
+    batch->dt[lane] = cpu->dt;
+    batch->st[lane] = cpu->st;
+    batch->rng[lane] = cpu->rng;
+    if (batch->status[lane] != SNEK8_EXECOUT_SUCCESS){
+        batch->status[lane] = SNEK8_EXECOUT_SUCCESS;
+        batch->halted--;
+    }
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+enum Snek8ExecutionOutput
+snek8_batchStoreLane(const Snek8Batch* batch, size_t lane, Snek8CPU* cpu){
+    if (!batch || !cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (lane >= batch->lanes){
+        return SNEK8_EXECOUT_INDEX_OUT_RANGE;
+    }
+    (void) memcpy(cpu->memory, batch->memory + lane * SNEK8_SIZE_RAM, SNEK8_SIZE_RAM);
+    cpu->dirty_pages = UINT16_MAX;
+    (void) memcpy(cpu->graphics, batch->graphics + lane * SNEK8_GRAPHICS_HEIGTH,
+                  SNEK8_SIZE_GRAPHICS_BYTES);
+    cpu->graphics_gen = batch->graphics_gen[lane];
+    cpu->graphics_dirty = batch->graphics_dirty[lane];
+    cpu->stack = batch->stacks[lane];
+    for (size_t i = 0; i < SNEK8_SIZE_REGISTERS; i++){
+        cpu->registers[i] = batch->registers[i * batch->lanes + lane];
+    }
+    cpu->keys = batch->keys[lane];
+    cpu->key_wait = batch->key_wait[lane];
+    cpu->key_armed = batch->key_armed[lane];
+    cpu->pc = batch->pc[lane];
+    cpu->ir = batch->ir[lane];
+    cpu->dt = batch->dt[lane];
+    cpu->st = batch->st[lane];
+    (void) snek8_cpuSetImplmFlags(cpu, batch->implm_flags);
+    cpu->cycles = (batch->status[lane] != SNEK8_EXECOUT_SUCCESS)? batch->halt_cycles[lane]: batch->cycles;
+    cpu->ips = batch->ips;
+    cpu->timer_phase = batch->timer_phase;
+    cpu->rng = batch->rng[lane];
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+void
+snek8_batchSeed(Snek8Batch* batch, uint32_t seed){
+    for (size_t lane = 0; lane < batch->lanes; lane++){
+        batch->rng[lane] = snek8_cpuSeedState(seed + (uint32_t) lane);
+    }
+}
+
+enum Snek8ExecutionOutput
+snek8_batchSetIPS(Snek8Batch* batch, uint32_t ips){
+    if (!batch){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (ips < 1 || ips > SNEK8_CPU_MAX_IPS){
+        return SNEK8_EXECOUT_INDEX_OUT_RANGE;
+    }
+    batch->timer_phase = (uint32_t) ((uint64_t) batch->timer_phase * ips / batch->ips);
+    batch->ips = ips;
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+enum Snek8ExecutionOutput
+snek8_batchSetKeys(Snek8Batch* batch, size_t lane, uint16_t keys){
+    if (!batch){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (lane >= batch->lanes){
+        return SNEK8_EXECOUT_INDEX_OUT_RANGE;
+    }
+    uint16_t pressed = (uint16_t) (keys & ~batch->keys[lane]);
+    uint16_t released = (uint16_t) (batch->keys[lane] & ~keys);
+    batch->keys[lane] = keys;
+    if (!batch->key_wait[lane]){
+        return SNEK8_EXECOUT_SUCCESS;
+    }
+    batch->key_armed[lane] |= pressed;
+    uint16_t done = released & batch->key_armed[lane];
+    if (done){
+        uint8_t key = 0;
+        while (!(done & 0x1u)){
+            done >>= 1;
+            key++;
+        }
+        // The program counter is still on LD V{0xX}, K.
+        uint16_t pc = batch->pc[lane];
+        uint8_t x = batch->memory[lane * SNEK8_SIZE_RAM + (pc & SNEK8_MEM_ADDR_RAM_END)] & 0x0Fu;
+        batch->registers[x * batch->lanes + lane] = key;
+        batch->pc[lane] = (uint16_t) (pc + 2);
+        batch->key_wait[lane] = false;
+        batch->key_armed[lane] = 0;
+    }
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+/**
+* @brief The batch's arrays, copied by value into the instructions so that the
+* compiler keeps them in registers while looping over the lanes.
+*/
+typedef struct{
+    size_t lanes;
+    uint8_t quirks;
+    uint64_t cycles;
+    size_t* halted;
+    uint8_t* memory;
+    uint64_t* graphics;
+    uint32_t* graphics_gen;
+    uint32_t* graphics_dirty;
+    Snek8Stack* stacks;
+    uint8_t* registers;
+    const uint16_t* keys;
+    uint8_t* key_wait;
+    uint16_t* key_armed;
+    uint16_t* pc;
+    uint16_t* ir;
+    uint8_t* dt;
+    uint8_t* st;
+    uint32_t* rng;
+    uint8_t* status;
+    uint64_t* halt_cycles;
+} Snek8BatchView;
+
+#define SNEK8_X_R(i)            b.registers[(size_t) (i) * b.lanes + l]
+#define SNEK8_X_R_STORE(p, n)                                                       \
+    do{                                                                             \
+        uint8_t* const _dst = (p);                                                  \
+        for (uint8_t _i = 0; _i < (n); _i++){                                       \
+            _dst[_i] = SNEK8_X_R(_i);                                               \
+        }                                                                           \
+    }while (0)
+#define SNEK8_X_R_LOAD(p, n)                                                        \
+    do{                                                                             \
+        const uint8_t* const _src = (p);                                            \
+        for (uint8_t _i = 0; _i < (n); _i++){                                       \
+            SNEK8_X_R(_i) = _src[_i];                                               \
+        }                                                                           \
+    }while (0)
+#define SNEK8_X_PC              b.pc[l]
+#define SNEK8_X_IR              b.ir[l]
+#define SNEK8_X_DT              b.dt[l]
+#define SNEK8_X_ST              b.st[l]
+#define SNEK8_X_KEYS            b.keys[l]
+#define SNEK8_X_KEY_WAIT        b.key_wait[l]
+#define SNEK8_X_KEY_ARMED       b.key_armed[l]
+#define SNEK8_X_MEM             (b.memory + l * SNEK8_SIZE_RAM)
+#define SNEK8_X_MEM_END         SNEK8_MEM_ADDR_RAM_END
+#define SNEK8_X_GFX             (b.graphics + l * SNEK8_GRAPHICS_HEIGTH)
+#define SNEK8_X_GFX_GEN         b.graphics_gen[l]
+#define SNEK8_X_GFX_DIRTY       b.graphics_dirty[l]
+#define SNEK8_X_STACK           (&b.stacks[l])
+#define SNEK8_X_RAND()          snek8_cpuRand(&b.rng[l])
+#define SNEK8_X_FAIL(code)                                                          \
+    do{                                                                             \
+        b.status[l] = (uint8_t) (code);                                             \
+        b.halt_cycles[l] = b.cycles + 1;                                            \
+        (*b.halted)++;                                                              \
+        return;                                                                     \
+    }while (0)
+#define SNEK8_X_ON_KEY_WAIT()   ((void) 0)
+#define SNEK8_X_ON_WRITE(addr, len) ((void) 0)
+#define SNEK8_X_ON_DRAW(sprite, n, hit) ((void) 0)
+
+/*
+* The instructions, as (family, body) pairs whose bodies read the operands `x`, `y`,
+* `n`, `kk` and `nnn`.
+*/
+#define SNEK8_BATCH_INSTRUCTIONS(OP)                                                \
+    OP(NOP, SNEK8_EXEC_NOP())                                                       \
+    OP(CLS, SNEK8_EXEC_CLS())                                                       \
+    OP(RET, SNEK8_EXEC_RET())                                                       \
+    OP(JMP_ADDR, SNEK8_EXEC_JMP_ADDR(nnn))                                          \
+    OP(CALL, SNEK8_EXEC_CALL(nnn))                                                  \
+    OP(SE_VX_BYTE, SNEK8_EXEC_SE_VX_BYTE(x, kk))                                    \
+    OP(SNE_VX_BYTE, SNEK8_EXEC_SNE_VX_BYTE(x, kk))                                  \
+    OP(SE_VX_VY, SNEK8_EXEC_SE_VX_VY(x, y))                                         \
+    OP(LD_VX_BYTE, SNEK8_EXEC_LD_VX_BYTE(x, kk))                                    \
+    OP(ADD_VX_BYTE, SNEK8_EXEC_ADD_VX_BYTE(x, kk))                                  \
+    OP(LD_VX_VY, SNEK8_EXEC_LD_VX_VY(x, y))                                         \
+    OP(OR_VX_VY, SNEK8_EXEC_OR_VX_VY(x, y))                                         \
+    OP(AND_VX_VY, SNEK8_EXEC_AND_VX_VY(x, y))                                       \
+    OP(XOR_VX_VY, SNEK8_EXEC_XOR_VX_VY(x, y))                                       \
+    OP(ADD_VX_VY, SNEK8_EXEC_ADD_VX_VY(x, y))                                       \
+    OP(SUB_VX_VY, SNEK8_EXEC_SUB_VX_VY(x, y))                                       \
+    OP(SHR_VX_VY, SNEK8_EXEC_SHR_VX_VY(x, y, SNEK8_EXEC_QUIRK(b.quirks, SNEK8_IMPLM_MODE_SHIFTS_USE_VY))) \
+    OP(SUBN_VX_VY, SNEK8_EXEC_SUBN_VX_VY(x, y))                                     \
+    OP(SHL_VX_VY, SNEK8_EXEC_SHL_VX_VY(x, y, SNEK8_EXEC_QUIRK(b.quirks, SNEK8_IMPLM_MODE_SHIFTS_USE_VY))) \
+    OP(SNE_VX_VY, SNEK8_EXEC_SNE_VX_VY(x, y))                                       \
+    OP(LD_I_ADDR, SNEK8_EXEC_LD_I_ADDR(nnn))                                        \
+    OP(JP_V0_ADDR, SNEK8_EXEC_JP_V0_ADDR(x, nnn, SNEK8_EXEC_QUIRK(b.quirks, SNEK8_IMPLM_MODE_BNNN_USES_VX))) \
+    OP(RND_VX_BYTE, SNEK8_EXEC_RND_VX_BYTE(x, kk))                                  \
+    OP(DRW_VX_VY_N, SNEK8_EXEC_DRW_VX_VY_N(x, y, n))                                \
+    OP(SKP_VX, SNEK8_EXEC_SKP_VX(x))                                                \
+    OP(SKNP_VX, SNEK8_EXEC_SKNP_VX(x))                                              \
+    OP(LD_VX_DT, SNEK8_EXEC_LD_VX_DT(x))                                            \
+    OP(LD_VX_K, SNEK8_EXEC_LD_VX_K(x))                                              \
+    OP(LD_DT_VX, SNEK8_EXEC_LD_DT_VX(x))                                            \
+    OP(LD_ST_VX, SNEK8_EXEC_LD_ST_VX(x))                                            \
+    OP(ADD_I_VX, SNEK8_EXEC_ADD_I_VX(x))                                            \
+    OP(LD_F_VX, SNEK8_EXEC_LD_F_VX(x))                                              \
+    OP(LD_B_VX, SNEK8_EXEC_LD_B_VX(x))                                              \
+    OP(LD_I_V0_VX, SNEK8_EXEC_LD_I_V0_VX(x, SNEK8_EXEC_QUIRK(b.quirks, SNEK8_IMPLM_MODE_FX_CHANGES_I))) \
+    OP(LD_VX_V0_I, SNEK8_EXEC_LD_VX_V0_I(x, SNEK8_EXEC_QUIRK(b.quirks, SNEK8_IMPLM_MODE_FX_CHANGES_I)))
+
+/*
+* Every instruction executes on a single lane `l`; a failure halts the lane and
+* returns. Once inlined into a loop over the lanes, the bodies without control flow
+* are vectorized.
+*/
+#define SNEK8_BATCH_DEFINE_LANE_OP(family, body)                                    \
+    static inline void                                                              \
+    _snek8_batch_##family(Snek8BatchView b, size_t l, uint8_t x, uint8_t y,         \
+                          uint8_t n, uint8_t kk, uint16_t nnn){                     \
+        UNUSED x;                                                                   \
+        UNUSED y;                                                                   \
+        UNUSED n;                                                                   \
+        UNUSED kk;                                                                  \
+        UNUSED nnn;                                                                 \
+        SNEK8_X_PC += 2;                                                            \
+        body;                                                                       \
+    }
+
+SNEK8_BATCH_INSTRUCTIONS(SNEK8_BATCH_DEFINE_LANE_OP)
+
+#define SNEK8_BATCH_LOCKSTEP_CASE(family, body)                                     \
+    case SNEK8_INSTRUC_##family:                                                    \
+        for (size_t l = 0; l < b.lanes; l++){                                       \
+            _snek8_batch_##family(b, l, x, y, n, kk, nnn);                          \
+        }                                                                           \
+        break;
+
+#define SNEK8_BATCH_LANE_CASE(family, body)                                         \
+    case SNEK8_INSTRUC_##family:                                                    \
+        _snek8_batch_##family(b, l, x, y, n, kk, nnn);                              \
+        break;
+
+/**
+* @brief Fetches the opcode of a lane.
+*
+* @param `memory` The lane's memory.
+* @param `pc` The lane's program counter.
+*/
+static inline uint16_t
+_snek8_batchFetch(const uint8_t* memory, uint16_t pc){
+    return (uint16_t) (memory[pc & SNEK8_MEM_ADDR_RAM_END] << 8)
+         | memory[(pc + 1) & SNEK8_MEM_ADDR_RAM_END];
+}
+
+/**
+* @brief Retires at once the steps of the batch within `budget` during which every
+* running lane spins in an idle loop or waits for a key.
+*
+* @param `batch`.
+* @param `watch` The rate limiter of the run.
+* @param `budget` The number of steps left to the run.
+* @return The number of steps retired.
+*/
+static size_t
+_snek8_batchIdle(Snek8Batch* batch, Snek8IdleWatch* watch, size_t budget){
+    if (!snek8_idleWatchDue(watch, batch->pc[0])){
+        return 0;
+    }
+    // The lengths of the loops are kept in the scratch buffer of the opcodes, which
+    // is only used within a step.
+    uint16_t* const lengths = batch->opcodes;
+    size_t idle = budget;
+    for (size_t l = 0; l < batch->lanes; l++){
+        lengths[l] = 1;
+        if (batch->status[l] != SNEK8_EXECOUT_SUCCESS || batch->key_wait[l]){
+            continue;
+        }
+        uint8_t registers[SNEK8_SIZE_REGISTERS];
+        for (size_t i = 0; i < SNEK8_SIZE_REGISTERS; i++){
+            registers[i] = batch->registers[i * batch->lanes + l];
+        }
+        bool reads_dt = false;
+        size_t length = snek8_cpuIdleLoop(batch->memory + l * SNEK8_SIZE_RAM, batch->pc[l],
+                                          registers, batch->dt[l], batch->keys[l],
+                                          batch->implm_flags, &reads_dt);
+        if (!length){
+            snek8_idleWatchUpdate(watch, false);
+            return 0;
+        }
+        lengths[l] = (uint16_t) length;
+        idle = snek8_cpuIdleCycles(length, reads_dt, batch->dt[l], batch->timer_phase,
+                                   batch->ips, idle);
+    }
+    snek8_idleWatchUpdate(watch, true);
+    // Every lane must be back at the start of its loop once the steps are retired.
+    for (bool aligned = false; idle && !aligned;){
+        aligned = true;
+        for (size_t l = 0; l < batch->lanes; l++){
+            if (idle % lengths[l]){
+                idle -= idle % lengths[l];
+                aligned = false;
+            }
+        }
+    }
+    if (!idle){
+        return 0;
+    }
+    for (size_t l = 0; l < batch->lanes; l++){
+        if (batch->status[l] == SNEK8_EXECOUT_SUCCESS){
+            uint32_t phase = batch->timer_phase;
+            snek8_cpuClockIdle(&phase, batch->ips, batch->dt + l, batch->st + l, idle);
+        }
+    }
+    uint8_t dt = 0;
+    uint8_t st = 0;
+    snek8_cpuClockIdle(&batch->timer_phase, batch->ips, &dt, &st, idle);
+    batch->cycles += idle;
+    batch->skipped_cycles += idle;
+    return idle;
+}
+
+size_t
+snek8_batchRun(Snek8Batch* batch, size_t max_cycles){
+    if (!batch){
+        return 0;
+    }
+    Snek8BatchView b = {
+        .lanes = batch->lanes,
+        .quirks = batch->implm_flags,
+        .halted = &batch->halted,
+        .memory = batch->memory,
+        .graphics = batch->graphics,
+        .graphics_gen = batch->graphics_gen,
+        .graphics_dirty = batch->graphics_dirty,
+        .stacks = batch->stacks,
+        .registers = batch->registers,
+        .keys = batch->keys,
+        .key_wait = batch->key_wait,
+        .key_armed = batch->key_armed,
+        .pc = batch->pc,
+        .ir = batch->ir,
+        .dt = batch->dt,
+        .st = batch->st,
+        .rng = batch->rng,
+        .status = batch->status,
+        .halt_cycles = batch->halt_cycles,
+    };
+    uint16_t* const opcodes = batch->opcodes;
+    Snek8IdleWatch watch = SNEK8_IDLE_WATCH_INIT;
+    size_t step = 0;
+    for (; step < max_cycles && batch->halted < b.lanes; step++){
+        b.cycles = batch->cycles;
+        bool lockstep = !batch->halted;
+        bool backward = false;
+        for (size_t l = 0; l < b.lanes; l++){
+            opcodes[l] = _snek8_batchFetch(b.memory + l * SNEK8_SIZE_RAM, b.pc[l]);
+            lockstep &= (opcodes[l] == opcodes[0]);
+        }
+        if (lockstep){
+            uint16_t opcode = opcodes[0];
+            uint8_t x = (opcode >> 8) & 0xFu;
+            uint8_t y = (opcode >> 4) & 0xFu;
+            uint8_t n = opcode & 0xFu;
+            uint8_t kk = (uint8_t) (opcode & 0x00FFu);
+            uint16_t nnn = (uint16_t) (opcode & 0x0FFFu);
+            // A backward jump of every lane, which may close idle loops.
+            backward = (opcode & 0xF000u) == 0x1000u && nnn <= b.pc[0];
+            switch (snek8_opcodeFamily(opcode)){
+                SNEK8_BATCH_INSTRUCTIONS(SNEK8_BATCH_LOCKSTEP_CASE)
+                default:
+                    break;
+            }
+        }else{
+            for (size_t l = 0; l < b.lanes; l++){
+                if (b.status[l] != SNEK8_EXECOUT_SUCCESS){
+                    continue;
+                }
+                uint16_t opcode = opcodes[l];
+                uint8_t x = (opcode >> 8) & 0xFu;
+                uint8_t y = (opcode >> 4) & 0xFu;
+                uint8_t n = opcode & 0xFu;
+                uint8_t kk = (uint8_t) (opcode & 0x00FFu);
+                uint16_t nnn = (uint16_t) (opcode & 0x0FFFu);
+                switch (snek8_opcodeFamily(opcode)){
+                    SNEK8_BATCH_INSTRUCTIONS(SNEK8_BATCH_LANE_CASE)
+                    default:
+                        break;
+                }
+            }
+        }
+        batch->cycles++;
+        uint32_t ticks = snek8_cpuClockTicks(&batch->timer_phase, batch->ips, 1);
+        if (ticks){
+            // The lanes halted by this step retire their failing instruction too.
+            for (size_t l = 0; l < b.lanes; l++){
+                if (b.status[l] == SNEK8_EXECOUT_SUCCESS || b.halt_cycles[l] == batch->cycles){
+                    b.dt[l] = (b.dt[l] > ticks)? b.dt[l] - ticks: 0;
+                    b.st[l] = (b.st[l] > ticks)? b.st[l] - ticks: 0;
+                }
+            }
+        }
+        if (backward){
+            step += _snek8_batchIdle(batch, &watch, max_cycles - step - 1);
+        }
+    }
+    return step;
+}
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_BATCH_C
@@ -0,0 +1,107 @@
+/**
+* @file blit.c
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Implementation of the screen blitter.
+*/
+#ifndef SNEK8_BLIT_C
+    #define SNEK8_BLIT_C
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include "blit.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SNEK8_BLIT_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define SNEK8_BLIT_SSE2 0
+#endif
+
+/**
+* @brief Renders the first line of a screen row with plain stores.
+*/
+static inline void
+_snek8_blitLineScalar(uint64_t row, uint32_t* line, size_t scale, uint32_t foreground,
+                      uint32_t background){
+    for (size_t x = 0; x < SNEK8_GRAPHICS_WIDTH; x++, row <<= 1){
+        uint32_t colour = (row >> 63)? foreground: background;
+        for (size_t i = 0; i < scale; i++){
+            *line++ = colour;
+        }
+    }
+}
+
+#if SNEK8_BLIT_SSE2
+/**
+* @brief Renders the first line of a screen row with SSE2, 4 pixels per store.
+*/
+static inline void
+_snek8_blitLineSSE2(uint64_t row, uint32_t* line, size_t scale, uint32_t foreground,
+                    uint32_t background){
+    const __m128i bg = _mm_set1_epi32((int) background);
+    const __m128i diff = _mm_set1_epi32((int) (foreground ^ background));
+    if (1 == scale){
+        // The lane i holds the pixel of the bit 3 - i of the nibble.
+        const __m128i bits = _mm_set_epi32(1, 2, 4, 8);
+        for (size_t x = 0; x < SNEK8_GRAPHICS_WIDTH; x += 4){
+            __m128i nibble = _mm_set1_epi32((int) ((row >> (60 - x)) & 0xFu));
+            __m128i mask = _mm_cmpeq_epi32(_mm_and_si128(nibble, bits), bits);
+            _mm_storeu_si128((__m128i*) (line + x), _mm_xor_si128(bg, _mm_and_si128(diff, mask)));
+        }
+    }else if (2 == scale){
+        const __m128i bits = _mm_set_epi32(1, 1, 2, 2);
+        for (size_t x = 0; x < SNEK8_GRAPHICS_WIDTH; x += 2){
+            __m128i pair = _mm_set1_epi32((int) ((row >> (62 - x)) & 0x3u));
+            __m128i mask = _mm_cmpeq_epi32(_mm_and_si128(pair, bits), bits);
+            _mm_storeu_si128((__m128i*) (line + 2 * x), _mm_xor_si128(bg, _mm_and_si128(diff, mask)));
+        }
+    }else if (4 <= scale){
+        // Every pixel spans at least one vector; the last store of a pixel overlaps
+        // the previous one instead of spilling into the next pixel.
+        for (size_t x = 0; x < SNEK8_GRAPHICS_WIDTH; x++, row <<= 1, line += scale){
+            __m128i mask = _mm_set1_epi32(-(int) (row >> 63));
+            __m128i colour = _mm_xor_si128(bg, _mm_and_si128(diff, mask));
+            for (size_t i = 0; i + 4 < scale; i += 4){
+                _mm_storeu_si128((__m128i*) (line + i), colour);
+            }
+            _mm_storeu_si128((__m128i*) (line + scale - 4), colour);
+        }
+    }else{
+        _snek8_blitLineScalar(row, line, scale, foreground, background);
+    }
+}
+#endif
+
+enum Snek8ExecutionOutput
+snek8_blit(const uint64_t* rows, uint32_t mask, uint32_t* image, size_t stride, size_t scale,
+           uint32_t foreground, uint32_t background){
+    if (!rows || !image){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    size_t width = SNEK8_GRAPHICS_WIDTH * scale;
+    if (!scale || scale > SNEK8_BLIT_MAX_SCALE || stride < width){
+        return SNEK8_EXECOUT_INDEX_OUT_RANGE;
+    }
+    for (size_t y = 0; mask; y++, mask >>= 1){
+        if (!(mask & 1u)){
+            continue;
+        }
+        uint32_t* line = image + y * scale * stride;
+#if SNEK8_BLIT_SSE2
+        _snek8_blitLineSSE2(rows[y], line, scale, foreground, background);
+#else
+        _snek8_blitLineScalar(rows[y], line, scale, foreground, background);
+#endif
+        for (size_t i = 1; i < scale; i++){
+            (void) memcpy(line + i * stride, line, width * sizeof(uint32_t));
+        }
+    }
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_BLIT_C
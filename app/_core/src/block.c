@@ -0,0 +1,596 @@
+/**
+* @file block.c
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Implementation of the block cache and of the block engine.
+*/
+#ifndef SNEK8_BLOCK_C
+    #define SNEK8_BLOCK_C
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include <stdlib.h>
+#include "block.h"
+#include "cpu_exec.h"
+
+Snek8BlockCache*
+snek8_blockCacheNew(void){
+    return calloc(1, sizeof(Snek8BlockCache));
+}
+
+void
+snek8_blockCacheDel(Snek8BlockCache* cache){
+    free(cache);
+}
+
+void
+snek8_blockFlush(Snek8BlockCache* cache){
+    (void) memset(cache->entries, 0, sizeof(cache->entries));
+    (void) memset(cache->coverage, 0, sizeof(cache->coverage));
+    cache->code_pages = 0;
+    cache->used = 0;
+}
+
+/**
+* @brief Marks the given memory byte as belonging to a block.
+*
+* @param `cache`.
+* @param `addr`.
+*/
+static inline void
+_snek8_blockCover(Snek8BlockCache* cache, uint16_t addr){
+    addr &= SNEK8_MEM_ADDR_RAM_END;
+    cache->coverage[addr >> 6] |= UINT64_C(1) << (addr & 63u);
+    cache->code_pages |= (uint16_t) (1u << (addr / SNEK8_SIZE_PAGE));
+}
+
+/**
+* @brief Whether any byte of the memory range [`addr`, `addr` + `len`) belongs to a
+* block.
+*
+* @param `cache`.
+* @param `addr`.
+* @param `len`.
+*/
+static inline bool
+_snek8_blockCovers(const Snek8BlockCache* cache, uint16_t addr, size_t len){
+    // Most writes land on data pages, away from the code.
+    if (addr + len <= SNEK8_SIZE_RAM && !(snek8_cpuPagesMask(addr, len) & cache->code_pages)){
+        return false;
+    }
+    for (size_t i = 0; i < len; i++){
+        uint16_t byte = (addr + i) & SNEK8_MEM_ADDR_RAM_END;
+        if ((cache->coverage[byte >> 6] >> (byte & 63u)) & 0x1u){
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+snek8_blockInvalidate(Snek8BlockCache* cache, uint16_t addr, size_t len){
+    if (_snek8_blockCovers(cache, addr, len)){
+        snek8_blockFlush(cache);
+    }
+}
+
+/**
+* @brief Whether an instruction of the given family ends a block.
+*
+* @param `family`.
+*/
+static inline bool
+_snek8_blockEndsWith(enum Snek8InstructionFamily family){
+    switch (family){
+        case SNEK8_INSTRUC_NOP:
+        case SNEK8_INSTRUC_RET:
+        case SNEK8_INSTRUC_JMP_ADDR:
+        case SNEK8_INSTRUC_CALL:
+        case SNEK8_INSTRUC_JP_V0_ADDR:
+        case SNEK8_INSTRUC_DRW_VX_VY_N:
+        case SNEK8_INSTRUC_LD_VX_DT:
+        case SNEK8_INSTRUC_LD_VX_K:
+        case SNEK8_INSTRUC_LD_DT_VX:
+        case SNEK8_INSTRUC_LD_ST_VX:
+        case SNEK8_INSTRUC_LD_B_VX:
+        case SNEK8_INSTRUC_LD_I_V0_VX:
+            return true;
+        default:
+            return false;
+    }
+}
+
+const Snek8BlockEntry*
+snek8_blockBuild(Snek8BlockCache* cache, const uint8_t* memory, uint16_t pc){
+    Snek8BlockEntry* entry = &cache->entries[pc & SNEK8_MEM_ADDR_RAM_END];
+    if (entry->length){
+        return entry;
+    }
+    if (cache->used + SNEK8_BLOCK_MAX_OPS > SNEK8_BLOCK_POOL_OPS){
+        snek8_blockFlush(cache);
+    }
+    entry->first = cache->used;
+    enum Snek8InstructionFamily family;
+    do{
+        uint16_t opcode = (uint16_t) (memory[pc & SNEK8_MEM_ADDR_RAM_END] << 8)
+                        | memory[(pc + 1) & SNEK8_MEM_ADDR_RAM_END];
+        family = snek8_opcodeFamily(opcode);
+        cache->ops[cache->used + entry->length] = (Snek8BlockOp){
+            .family = (uint8_t) family,
+            .x = (opcode >> 8) & 0xFu,
+            .y = (opcode >> 4) & 0xFu,
+            .n = opcode & 0xFu,
+            .kk = (uint8_t) (opcode & 0x00FFu),
+            .nnn = (uint16_t) (opcode & 0x0FFFu),
+        };
+        _snek8_blockCover(cache, pc);
+        _snek8_blockCover(cache, pc + 1);
+        entry->length++;
+        // The block carries on at the target of the forward jumps and calls.
+        bool follows = (SNEK8_INSTRUC_JMP_ADDR == family || SNEK8_INSTRUC_CALL == family)
+                       && (opcode & 0x0FFFu) > pc;
+        pc = follows? (uint16_t) (opcode & 0x0FFFu): pc + 2;
+        if (!follows && _snek8_blockEndsWith(family)){
+            break;
+        }
+    }while (entry->length < SNEK8_BLOCK_MAX_OPS);
+    cache->used += entry->length;
+    return entry;
+}
+
+#define SNEK8_X_R(i)            v[(i)]
+#define SNEK8_X_R_STORE(p, n)   snek8_cpuCopyRegisters((p), v, (n))
+#define SNEK8_X_R_LOAD(p, n)    snek8_cpuCopyRegisters(v, (p), (n))
+#define SNEK8_X_PC              pc
+#define SNEK8_X_IR              ir
+#define SNEK8_X_DT              dt
+#define SNEK8_X_ST              st
+#define SNEK8_X_CLOCK           phase
+#define SNEK8_X_IPS             ips
+#define SNEK8_X_KEYS            cpu->keys
+#define SNEK8_X_KEY_WAIT        cpu->key_wait
+#define SNEK8_X_KEY_ARMED       cpu->key_armed
+#define SNEK8_X_MEM             mem
+#define SNEK8_X_MEM_END         SNEK8_MEM_ADDR_RAM_END
+#define SNEK8_X_GFX             cpu->graphics
+#define SNEK8_X_GFX_GEN         cpu->graphics_gen
+#define SNEK8_X_GFX_DIRTY       cpu->graphics_dirty
+#define SNEK8_X_STACK           (&cpu->stack)
+#define SNEK8_X_RAND()          snek8_cpuRand(&cpu->rng)
+#define SNEK8_X_FAIL(code)                                                          \
+    do{                                                                             \
+        out = (code);                                                               \
+        reason = SNEK8_RUNSTOP_ERROR;                                               \
+        goto _snek8_fail;                                                           \
+    }while (0)
+#define SNEK8_X_ON_KEY_WAIT()                                                       \
+    do{                                                                             \
+        reason = SNEK8_RUNSTOP_KEY_WAIT;                                            \
+        goto _snek8_tick_and_exit;                                                  \
+    }while (0)
+#define SNEK8_X_ON_DRAW(sprite, n, hit)                                             \
+    SNEK8_STATS_DRAW(cpu, (sprite), (n), (hit))
+#define SNEK8_X_ON_WRITE(addr, len)                                                 \
+    do{                                                                             \
+        cpu->dirty_pages |= snek8_cpuPagesMask((addr), (len));                      \
+        if (_snek8_blockCovers(cache, (addr), (len))){                              \
+            snek8_blockFlush(cache);                                                \
+        }                                                                           \
+    }while (0)
+
+/*
+* The timers' clock lags behind the instructions: `clocked` instructions went through
+* it so far, and it only catches up with the others when the timers are read, i.e. by
+* the instructions that access them (which end their blocks), by the search for idle
+* loops and on leaving the engine. The blocks are only chained for
+* `SNEK8_B_CLOCK_LAG` instructions at most, past which the clock catches up between
+* two blocks, so that its arithmetic never overflows.
+*/
+#define SNEK8_B_CLOCK_LAG       (1u << 20)
+
+_Static_assert(SNEK8_B_CLOCK_LAG <= (UINT32_MAX - SNEK8_CPU_MAX_IPS) / SNEK8_TIMER_FREQUENCY,
+               "The clock of the block engine lags further than snek8_cpuClockTicks advances it at once.");
+
+#define SNEK8_B_CLOCK(upto)                                                         \
+    do{                                                                             \
+        SNEK8_EXEC_CLOCK((upto) - clocked);                                         \
+        clocked = (upto);                                                           \
+    }while (0)
+
+// The instructions executed before `op`.
+#define SNEK8_B_BEFORE()        (executed - (size_t) (end - op))
+
+#define SNEK8_B_SYNC_TIMERS()                                                       \
+    SNEK8_B_CLOCK(SNEK8_B_BEFORE())
+
+#if SNEK8_COMPUTED_GOTO
+    #define SNEK8_B_OP(family)  _snek8_op_##family: SNEK8_STATS_INSTRUC(cpu, SNEK8_INSTRUC_##family);
+    #define SNEK8_B_OP_Q(family, b)                                                 \
+        _snek8_op_##family##_##b: SNEK8_STATS_INSTRUC(cpu, SNEK8_INSTRUC_##family);
+    #define SNEK8_B_LABEL(family)         &&_snek8_op_##family
+    #define SNEK8_B_LABEL_Q(family, b)    &&_snek8_op_##family##_##b
+    #define SNEK8_B_DISPATCH()                                                      \
+        do{                                                                         \
+            if (op == end){                                                         \
+                SNEK8_B_CHAIN();                                                    \
+            }                                                                       \
+            goto *op->handler;                                                      \
+        }while (0)
+    /*
+    * Enters the next block right from the end of the current one when it is cached
+    * and fits in `chained`, so that the first instruction of every block is
+    * dispatched from the handler that ended the previous one, like the instructions
+    * within the blocks, rather than from the same jump for all the blocks, which
+    * mispredicts whenever the blocks are short.
+    */
+    #define SNEK8_B_CHAIN()                                                         \
+        do{                                                                         \
+            const Snek8BlockEntry* _next = &cache->entries[pc & SNEK8_MEM_ADDR_RAM_END]; \
+            if (!_next->length || executed + _next->length > chained){              \
+                goto _snek8_next_block;                                             \
+            }                                                                       \
+            op = cache->ops + _next->first;                                         \
+            end = op + _next->length;                                               \
+            pc += 2 * _next->length;                                                \
+            executed += _next->length;                                              \
+        }while (0)
+    /*
+    * The bound of the chaining: never past `max_cycles`, nor `SNEK8_B_CLOCK_LAG`
+    * instructions past `executed`, which moves ahead by the cycles that the search for
+    * idle loops skips as well.
+    */
+    #define SNEK8_B_BOUND()                                                         \
+        chained = (max_cycles - executed > SNEK8_B_CLOCK_LAG)?                      \
+            executed + SNEK8_B_CLOCK_LAG: max_cycles
+    #define SNEK8_B_NEXT()                                                          \
+        op++;                                                                       \
+        SNEK8_B_DISPATCH()
+#else
+    #define SNEK8_B_BOUND()     ((void) 0)
+    #define SNEK8_B_OP(family)  case SNEK8_INSTRUC_##family: SNEK8_STATS_INSTRUC(cpu, SNEK8_INSTRUC_##family);
+    #define SNEK8_B_OP_Q(family, b)                                                 \
+        case SNEK8_EXEC_ID_Q(family, b): SNEK8_STATS_INSTRUC(cpu, SNEK8_INSTRUC_##family);
+    #define SNEK8_B_NEXT()                                                          \
+        op++;                                                                       \
+        continue
+#endif
+
+/*
+* The skips do not end their blocks: the instructions past a skip are the ones executed
+* when it does not skip. A skip that does skips the next instruction of the block, and
+* goes on with the one after, unless the block carries on elsewhere past the skipped
+* instruction, which then is a forward jump or call: the skip leaves the block there, as
+* if it were its last instruction.
+*/
+#define SNEK8_B_SKIP(exec)                                                          \
+    do{                                                                             \
+        const uint16_t _pc = pc;                                                    \
+        exec;                                                                       \
+        if (pc == _pc){                                                             \
+            break;                                                                  \
+        }                                                                           \
+        if (op + 2 == end || (op + 2 < end && SNEK8_INSTRUC_JMP_ADDR != op[1].family  \
+                              && SNEK8_INSTRUC_CALL != op[1].family)){              \
+            pc = _pc;                                                               \
+            executed--;                                                             \
+            op++;                                                                   \
+        }else{                                                                      \
+            executed -= (size_t) (end - op - 1);                                    \
+            pc -= 2 * (end - op - 1);                                               \
+            end = op + 1;                                                           \
+        }                                                                           \
+    }while (0)
+
+/*
+* The forward jumps and calls do not end their blocks either, which carry on at their
+* target. The program counter, moved past the instructions of a block up front, is
+* moved as well past the instructions that follow them there, and a call runs as the
+* last instruction of its block, so that it pushes its own return address.
+*/
+#define SNEK8_B_FOLLOWING()     (2 * (uint16_t) (end - op - 1))
+
+#define SNEK8_B_CALL(nnn)                                                           \
+    do{                                                                             \
+        const Snek8BlockOp* const _end = end;                                       \
+        const uint16_t _following = SNEK8_B_FOLLOWING();                            \
+        executed -= _following / 2;                                                 \
+        pc -= _following;                                                           \
+        end = op + 1;                                                               \
+        SNEK8_EXEC_CALL(nnn);                                                       \
+        executed += _following / 2;                                                 \
+        pc += _following;                                                           \
+        end = _end;                                                                 \
+    }while (0)
+
+/*
+* The search for idle loops runs on the CPU, which the locals are synchronized with
+* (the loops found leave the registers as they are) once the clock caught up, and
+* clocks the cycles it skips.
+*/
+#define SNEK8_B_IDLE()                                                              \
+    do{                                                                             \
+        if (snek8_idleWatchDue(&watch, pc)){                                        \
+            SNEK8_B_CLOCK(executed);                                                \
+            (void) memcpy(cpu->registers, v, SNEK8_SIZE_REGISTERS * sizeof(uint8_t)); \
+            cpu->pc = pc;                                                           \
+            cpu->dt = dt;                                                           \
+            cpu->st = st;                                                           \
+            cpu->timer_phase = phase;                                               \
+            executed += snek8_cpuIdleSkip(cpu, &watch, max_cycles - executed);      \
+            clocked = executed;                                                     \
+            SNEK8_B_BOUND();                                                        \
+            dt = cpu->dt;                                                           \
+            st = cpu->st;                                                           \
+            phase = cpu->timer_phase;                                               \
+        }                                                                           \
+    }while (0)
+
+#if SNEK8_COMPUTED_GOTO
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+
+SNEK8_OWN_BRANCHES enum Snek8ExecutionOutput
+snek8_cpuRunBlocks(Snek8CPU* cpu, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+                   enum Snek8RunStop* stop){
+    if (!cpu || !cpu->blocks){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (cpu->key_wait){
+        return snek8_cpuRunWaiting(cpu, max_cycles, break_flags, cycles, stop);
+    }
+    Snek8BlockCache* const cache = cpu->blocks;
+    enum Snek8ExecutionOutput out = SNEK8_EXECOUT_SUCCESS;
+    enum Snek8RunStop reason = SNEK8_RUNSTOP_CYCLES;
+    size_t executed = 0;
+    uint8_t v[SNEK8_SIZE_REGISTERS];
+    (void) memcpy(v, cpu->registers, SNEK8_SIZE_REGISTERS * sizeof(uint8_t));
+    uint16_t pc = cpu->pc;
+    uint16_t ir = cpu->ir;
+    uint8_t dt = cpu->dt;
+    uint8_t st = cpu->st;
+    uint32_t phase = cpu->timer_phase;
+    const uint32_t ips = cpu->ips;
+    uint8_t* const mem = cpu->memory;
+    size_t clocked = 0;
+#if SNEK8_COMPUTED_GOTO
+    size_t chained = 0;
+#endif
+    const Snek8BlockOp* op = NULL;
+    const Snek8BlockOp* end = NULL;
+    Snek8IdleWatch watch = SNEK8_IDLE_WATCH_INIT;
+#if SNEK8_COMPUTED_GOTO
+    static const void* const labels[SNEK8_SIZE_QUIRK_SETS][SNEK8_INSTRUC_COUNT] =
+        SNEK8_EXEC_HANDLER_SETS(SNEK8_B_LABEL, SNEK8_B_LABEL_Q);
+    const void* const* const table = labels[cpu->implm_flags & SNEK8_IMPLM_MODE_MASK];
+#else
+    static const uint8_t ids[SNEK8_SIZE_QUIRK_SETS][SNEK8_INSTRUC_COUNT] =
+        SNEK8_EXEC_HANDLER_SETS(SNEK8_EXEC_ID, SNEK8_EXEC_ID_Q);
+    const uint8_t* const table = ids[cpu->implm_flags & SNEK8_IMPLM_MODE_MASK];
+#endif
+    if (cache->quirks != (cpu->implm_flags & SNEK8_IMPLM_MODE_MASK)){
+        snek8_blockFlush(cache);
+        cache->quirks = cpu->implm_flags & SNEK8_IMPLM_MODE_MASK;
+    }
+    for (;;){
+#if SNEK8_COMPUTED_GOTO
+_snek8_next_block:
+#endif
+        SNEK8_B_CLOCK(executed);
+        if (executed >= max_cycles){
+            goto _snek8_exit;
+        }
+        SNEK8_B_BOUND();
+        const Snek8BlockEntry* entry = &cache->entries[pc & SNEK8_MEM_ADDR_RAM_END];
+        if (!entry->length){
+            entry = snek8_blockBuild(cache, mem, pc);
+#if SNEK8_COMPUTED_GOTO
+            for (Snek8BlockOp* built = cache->ops + entry->first; built < cache->ops + entry->first + entry->length;
+                 built++){
+                built->handler = table[built->family];
+            }
+#endif
+        }
+        size_t length = entry->length;
+        if (length > max_cycles - executed){
+            length = max_cycles - executed;
+        }
+        // Every instruction that reads or writes the program counter ends its block,
+        // but for the skips and the forward jumps and calls, which correct it when they
+        // skip or follow, so the program counter can be moved past the whole block up
+        // front.
+        // Likewise, only the last instruction of a block may write to the memory, so
+        // flushing the cache never invalidates the instructions still to be executed
+        // here.
+        op = cache->ops + entry->first;
+        end = op + length;
+        pc += 2 * length;
+        executed += length;
+#if SNEK8_COMPUTED_GOTO
+        SNEK8_B_DISPATCH();
+        {
+#else
+        while (op < end){
+            switch (table[op->family]){
+#endif
+            SNEK8_B_OP(NOP)
+                SNEK8_EXEC_NOP();
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(CLS)
+                SNEK8_EXEC_CLS();
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(RET)
+                SNEK8_EXEC_RET();
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(JMP_ADDR)
+                if (op->nnn < pc && op + 1 == end){
+                    // A backward jump, which may close an idle loop.
+                    SNEK8_EXEC_JMP_ADDR(op->nnn);
+                    SNEK8_B_IDLE();
+                    SNEK8_B_NEXT();
+                }
+                SNEK8_EXEC_JMP_ADDR(op->nnn + SNEK8_B_FOLLOWING());
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(CALL)
+                SNEK8_B_CALL(op->nnn);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(SE_VX_BYTE)
+                SNEK8_B_SKIP(SNEK8_EXEC_SE_VX_BYTE(op->x, op->kk));
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(SNE_VX_BYTE)
+                SNEK8_B_SKIP(SNEK8_EXEC_SNE_VX_BYTE(op->x, op->kk));
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(SE_VX_VY)
+                SNEK8_B_SKIP(SNEK8_EXEC_SE_VX_VY(op->x, op->y));
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(LD_VX_BYTE)
+                SNEK8_EXEC_LD_VX_BYTE(op->x, op->kk);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(ADD_VX_BYTE)
+                SNEK8_EXEC_ADD_VX_BYTE(op->x, op->kk);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(LD_VX_VY)
+                SNEK8_EXEC_LD_VX_VY(op->x, op->y);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(OR_VX_VY)
+                SNEK8_EXEC_OR_VX_VY(op->x, op->y);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(AND_VX_VY)
+                SNEK8_EXEC_AND_VX_VY(op->x, op->y);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(XOR_VX_VY)
+                SNEK8_EXEC_XOR_VX_VY(op->x, op->y);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(ADD_VX_VY)
+                SNEK8_EXEC_ADD_VX_VY(op->x, op->y);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(SUB_VX_VY)
+                SNEK8_EXEC_SUB_VX_VY(op->x, op->y);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP_Q(SHR_VX_VY, 0)
+                SNEK8_EXEC_SHR_VX_VY(op->x, op->y, 0);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP_Q(SHR_VX_VY, 1)
+                SNEK8_EXEC_SHR_VX_VY(op->x, op->y, 1);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(SUBN_VX_VY)
+                SNEK8_EXEC_SUBN_VX_VY(op->x, op->y);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP_Q(SHL_VX_VY, 0)
+                SNEK8_EXEC_SHL_VX_VY(op->x, op->y, 0);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP_Q(SHL_VX_VY, 1)
+                SNEK8_EXEC_SHL_VX_VY(op->x, op->y, 1);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(SNE_VX_VY)
+                SNEK8_B_SKIP(SNEK8_EXEC_SNE_VX_VY(op->x, op->y));
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(LD_I_ADDR)
+                SNEK8_EXEC_LD_I_ADDR(op->nnn);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP_Q(JP_V0_ADDR, 0)
+                SNEK8_EXEC_JP_V0_ADDR(op->x, op->nnn, 0);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP_Q(JP_V0_ADDR, 1)
+                SNEK8_EXEC_JP_V0_ADDR(op->x, op->nnn, 1);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(RND_VX_BYTE)
+                SNEK8_EXEC_RND_VX_BYTE(op->x, op->kk);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(DRW_VX_VY_N)
+                SNEK8_EXEC_DRW_VX_VY_N(op->x, op->y, op->n);
+                if (break_flags & SNEK8_RUN_BREAK_ON_DRAW){
+                    reason = SNEK8_RUNSTOP_DRAW;
+                    goto _snek8_tick_and_exit;
+                }
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(SKP_VX)
+                SNEK8_B_SKIP(SNEK8_EXEC_SKP_VX(op->x));
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(SKNP_VX)
+                SNEK8_B_SKIP(SNEK8_EXEC_SKNP_VX(op->x));
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(LD_VX_DT)
+                SNEK8_B_SYNC_TIMERS();
+                SNEK8_EXEC_LD_VX_DT(op->x);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(LD_VX_K)
+                SNEK8_EXEC_LD_VX_K(op->x);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(LD_DT_VX)
+                SNEK8_B_SYNC_TIMERS();
+                SNEK8_EXEC_LD_DT_VX(op->x);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(LD_ST_VX)
+                SNEK8_B_SYNC_TIMERS();
+                SNEK8_EXEC_LD_ST_VX(op->x);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(ADD_I_VX)
+                SNEK8_EXEC_ADD_I_VX(op->x);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(LD_F_VX)
+                SNEK8_EXEC_LD_F_VX(op->x);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP(LD_B_VX)
+                SNEK8_EXEC_LD_B_VX(op->x);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP_Q(LD_I_V0_VX, 0)
+                SNEK8_EXEC_LD_I_V0_VX(op->x, 0);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP_Q(LD_I_V0_VX, 1)
+                SNEK8_EXEC_LD_I_V0_VX(op->x, 1);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP_Q(LD_VX_V0_I, 0)
+                SNEK8_EXEC_LD_VX_V0_I(op->x, 0);
+                SNEK8_B_NEXT();
+            SNEK8_B_OP_Q(LD_VX_V0_I, 1)
+                SNEK8_EXEC_LD_VX_V0_I(op->x, 1);
+                SNEK8_B_NEXT();
+#if !SNEK8_COMPUTED_GOTO
+                default:
+                    op++;
+                    continue;
+            }
+        }
+#else
+        }
+#endif
+    }
+_snek8_fail:
+    // The instructions of the block past the failing one were not executed.
+    executed -= (size_t) (end - op - 1);
+    pc -= 2 * (end - op - 1);
+_snek8_tick_and_exit:
+    SNEK8_B_CLOCK(executed);
+_snek8_exit:
+    (void) memcpy(cpu->registers, v, SNEK8_SIZE_REGISTERS * sizeof(uint8_t));
+    cpu->pc = pc;
+    cpu->ir = ir;
+    cpu->dt = dt;
+    cpu->st = st;
+    cpu->timer_phase = phase;
+    cpu->cycles += executed;
+    SNEK8_STATS_CYCLES(cpu, executed);
+    if (SNEK8_RUNSTOP_KEY_WAIT == reason && !(break_flags & SNEK8_RUN_BREAK_ON_KEY_WAIT)){
+        size_t idle = 0;
+        (void) snek8_cpuRunWaiting(cpu, max_cycles - executed, break_flags, &idle, &reason);
+        executed += idle;
+    }
+    if (cycles){
+        *cycles = executed;
+    }
+    if (stop){
+        *stop = reason;
+    }
+    return out;
+}
+
+#if SNEK8_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#endif
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_BLOCK_C
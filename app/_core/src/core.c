@@ -13,24 +13,188 @@
     extern "C"{
 #endif
 #include <Python.h>
+#include <stdatomic.h>
+#ifdef _WIN32
+    #include <malloc.h>
+#endif
 #include "cpu.h"
+#include "block.h"
+#include "batch.h"
+#include "rewind.h"
+#include "replay.h"
+#include "rom.h"
+#include "blit.h"
+#include "input.h"
+#include "ext.h"
+#include "disasm.h"
+#include "audio.h"
+#include "stream.h"
+#include "debug.h"
+
+/*
+* MSVC has no C11 aligned_alloc: its aligned blocks come from _aligned_malloc and must
+* go back through _aligned_free.
+*/
+#if defined(_WIN32)
+    #define SNEK8_ALIGNED_ALLOC(alignment, size)    _aligned_malloc((size), (alignment))
+    #define SNEK8_ALIGNED_FREE(memory)              _aligned_free(memory)
+#else
+    #define SNEK8_ALIGNED_ALLOC(alignment, size)    aligned_alloc((alignment), (size))
+    #define SNEK8_ALIGNED_FREE(memory)              free(memory)
+#endif
+
+/**
+* @brief Who currently owns the emulator's CPU.
+*/
+enum Snek8EmulatorState{
+    SNEK8_EMULATOR_IDLE,        ///< Nobody: any method may use the CPU.
+    SNEK8_EMULATOR_BUSY,        ///< A method that released the GIL is running the CPU.
+    SNEK8_EMULATOR_WORKER,      ///< The worker thread is running the CPU.
+    SNEK8_EMULATOR_STOPPING,    ///< The worker thread was asked to stop.
+};
+
+/**
+* @brief The native worker thread of an emulator and the state it shares with Python.
+*
+* @param `done` Held while the worker runs; acquiring it joins the worker.
+* @param `wake` Held by the owner of the emulator; the paced worker sleeps by waiting
+*        on it, so that releasing it wakes the worker up immediately.
+* @param `alive` Whether the worker thread is executing its loop.
+* @param `paced` Whether the worker runs in real time (60 frames per second) or as
+*        fast as possible.
+* @param `out` The execution output that ended the worker's loop.
+* @param `frame_seq` Sequence counter of the published frame (odd while writing).
+* @param `frame_rows` The published screen, as packed rows.
+* @param `frame_gen` The screen generation of the published frame.
+* @param `frame_st` The sound timer at the published frame.
+*/
+typedef struct{
+    PyThread_type_lock done;
+    PyThread_type_lock wake;
+    atomic_bool alive;
+    bool paced;
+    enum Snek8ExecutionOutput out;
+    atomic_uint_least32_t frame_seq;
+    _Atomic uint64_t frame_rows[SNEK8_GRAPHICS_HEIGTH];
+    atomic_uint_least32_t frame_gen;
+    atomic_uint_least8_t frame_st;
+} Snek8Worker;
+
+/**
+* @brief The image an emulator's `reset` restores, i.e. its CPU right after `__init__`
+* and the last ROM load. The emulators of a pool share theirs; an emulator that
+* changes a shared image first takes a copy of its own (see `snek8_emulatorOwnBoot`).
+*
+* @param `refs` The number of emulators holding the image, guarded by the GIL.
+* @param `rom` Whether a ROM was loaded into the image.
+* @param `size` The size of that ROM.
+* @param `cpu` The image. Its `rng` is not used: every emulator keeps its own.
+*/
+typedef struct{
+    Py_ssize_t refs;
+    bool rom;
+    size_t size;
+    Snek8CPU cpu;
+} Snek8Boot;
+
+/**
+* @brief The memory of the emulators of a pool, allocated at once and released along
+* with the last of them (see `Snek8EmulatorPool`).
+*
+* @param `live` The number of emulators of the slab still alive, guarded by the GIL.
+* @param `memory` The allocation.
+*/
+typedef struct{
+    size_t live;
+    void* memory;
+} Snek8Slab;
+
+/**
+* @brief The frame stream of an emulator, and the means for its consumer to wait on it.
+*
+* @param `stream` The encoder and its queue.
+* @param `signal` Held while no frame was queued since a consumer last took it: the
+*        producer releases it (once, see `signalled`) to wake up a waiting consumer.
+* @param `signalled` Whether `signal` was released and not taken back yet.
+* @param `users` The number of consumers using the stream without the GIL, guarded by
+*        the GIL: the stream is neither replaced nor released while there are any.
+* @param `reading` Whether a consumer is reading the queue, guarded by the GIL: the
+*        queue only has room for one.
+*/
+typedef struct{
+    Snek8Stream* stream;
+    PyThread_type_lock signal;
+    atomic_bool signalled;
+    int users;
+    bool reading;
+} Snek8FrameStream;
 
 typedef struct{
     PyObject_HEAD
     Snek8CPU ob_cpu;
     bool ob_is_running;
-    char ob_last_instruc[30];
+    const char* ob_last_instruc;
+    enum Snek8Engine ob_engine;
+    Snek8RunEngine ob_run;
+    atomic_int ob_state;
+    atomic_uint_least16_t ob_keys;
+    Snek8KeyQueue ob_key_queue;
+    Snek8Worker ob_worker;
+    Snek8Audio ob_audio;
+    Py_buffer ob_audio_view;
+    Snek8FrameStream* ob_stream;
+    Snek8Debugger* ob_debugger;
+    Snek8Rewind* ob_rewind;
+    Snek8Replay* ob_replay;
+    Snek8Boot* ob_boot;
+    uint32_t ob_boot_rng;
+    Snek8Slab* ob_slab;
+#if SNEK8_STATS
+    uint64_t ob_fetches;
+    PyTime_t ob_fetch_ns;
+#endif
 } Snek8Emulator;
 
+/**
+* @brief The ROM cache shared by every emulator and batch, guarded by the GIL.
+*/
+static Snek8RomCache snek8_rom_cache;
+
+#if SNEK8_STATS
+/**
+* @brief Account a screen fetch started at `start` (see `SNEK8_FETCH_BEGIN`).
+*/
+static inline void
+snek8_emulatorFetched(Snek8Emulator* self, PyTime_t start){
+    PyTime_t now = start;
+    (void) PyTime_PerfCounterRaw(&now);
+    self->ob_fetches++;
+    self->ob_fetch_ns += now - start;
+}
+
+/**
+* @brief Time the screen fetches made by the frontend, i.e. the methods and the
+* buffer exports that read the screen.
+*/
+    #define SNEK8_FETCH_BEGIN()                                                     \
+        PyTime_t _fetch_start = 0;                                                  \
+        (void) PyTime_PerfCounterRaw(&_fetch_start)
+    #define SNEK8_FETCH_END(self)   snek8_emulatorFetched(CAST_PTR(Snek8Emulator, self), _fetch_start)
+#else
+    #define SNEK8_FETCH_BEGIN()     ((void) 0)
+    #define SNEK8_FETCH_END(self)   ((void) 0)
+#endif
+
 PyDoc_STRVAR(SNEK8_STR_DOC_SNEK8_EMULATOR,
-             "Snek8Emulator(implm_flags: int = 0)\n\n"
+             "Snek8Emulator(implm_flags: int = 0, engine: int = ENGINE_REFERENCE,\n"
+             "              ips: int = DEFAULT_IPS, seed: int | None = None)\n\n"
              "Chip8's emulator.\n\n"
              "Attributes\n"
              "----------\n"
              "is_running: bool\n"
              "\tControls whether the emulation process is running.\n"
-             "last_instruc: str\n"
-             "\tThe last executed instruction\n"
+             "last_instruc: str | None\n"
+             "\tThe family of the instruction executed by the last emulationStep.\n"
              "\n\n"
              "Parameters\n"
              "----------\n"
@@ -41,6 +205,27 @@ PyDoc_STRVAR(SNEK8_STR_DOC_SNEK8_EMULATOR,
              "\t\t-0: IMPLM_MODE_BNNN_USE_VX.\n"
              "\t\t-1: IMPLM_MODE_SHIFTS_USE_VY.\n"
              "\t\t-2: IMPLM_MODE_FX_CHANGE_I.\n"
+             "engine: int\n"
+             "\tThe execution engine used by emulationRun. One of ENGINE_REFERENCE,\n"
+             "\tENGINE_THREADED or ENGINE_BLOCK.\n"
+             "ips: int\n"
+             "\tThe number of instructions executed per emulated second (see setIPS).\n"
+             "seed: int | None\n"
+             "\tThe seed of the emulator's own random number generator, used by RND (only\n"
+             "\tits 32 least significant bits matter). Emulators with the same seed draw the\n"
+             "\tsame numbers; if None, the seed is taken from the clock.\n"
+             "\n"
+             "Note\n"
+             "----\n"
+             "The emulator supports the buffer protocol: memoryview(emulator) is a read-only,\n"
+             "zero-copy view of the screen as SIZE_GRAPHICS_HEIGHT unsigned 64-bit rows (format\n"
+             "'Q'), the pixel at column x being the bit (63 - x) of its row. The view reflects the\n"
+             "emulation as it runs; use getGraphicsGeneration to detect changes.\n"
+             "\n"
+             "The emulation can also run on a native worker thread (see start), which never\n"
+             "holds the GIL. While it runs, the methods that modify the CPU raise RuntimeError,\n"
+             "the keys can still be set with setKeyValue and the screen should be read with\n"
+             "getFrame.\n"
 );
 
 PyDoc_STRVAR(SNEK8_STR_DOC_EMULATOR_SNEK8_EMULATOR_IS_RUNNING,
@@ -52,8 +237,9 @@ PyDoc_STRVAR(SNEK8_STR_DOC_EMULATOR_SNEK8_EMULATOR_IS_RUNNING,
 );
 
 PyDoc_STRVAR(SNEK8_STR_DOC_EMULATOR_SNEK8_EMULATOR_LAST_INSTRUC,
-    "last_instrc: int\n"
-    "\nThe last executed instruction."
+    "last_instruc: str | None\n"
+    "\tThe family of the instruction executed by the last emulationStep (e.g. \"JMP_ADDR\"),\n"
+    "\tNone if the last run of the emulation was not a step.\n"
     "Note\n"
     "----\n"
     "This is a read-only attribute that can only be modified by the emulation process.\n"
@@ -80,257 +266,881 @@ static PyMemberDef snek8_emulator_members[] = {
     {NULL},
 };
 
-/*
-* INIT and DENIT METHODS
-* ----------------------
+/**
+* @brief Apply a change of a key to the CPU and record it in the replay being
+* recorded, if any.
 */
+static inline void
+snek8_emulatorApplyKey(Snek8Emulator* self, uint8_t key, bool value){
+    (void) snek8_cpuSetKey(&self->ob_cpu, key, value);
+    if (self->ob_replay){
+        (void) snek8_replayRecord(self->ob_replay, self->ob_cpu.cycles, self->ob_cpu.keys);
+    }
+}
 
 /**
-* @brief C interface for the __del__ method.
+* @brief Apply to the CPU, in order, the key events posted from Python since the last
+* call.
+*
+* @note Only the owner of the CPU may call this function.
 */
 static void
-snek8_emulatorDel(PyObject* self){
-    Py_TYPE(self)->tp_free(self);
+snek8_emulatorDrainKeys(Snek8Emulator* self){
+    uint8_t key;
+    bool value;
+    while (snek8_keyQueuePop(&self->ob_key_queue, &key, &value)){
+        snek8_emulatorApplyKey(self, key, value);
+    }
+    if (snek8_keyQueueTakeLost(&self->ob_key_queue)){
+        // Some edges are gone; at least catch up with the levels of the keys.
+        uint16_t keys = (uint16_t) atomic_load(&self->ob_keys);
+        for (uint8_t k = 0; k < SNEK8_SIZE_KEYSET; k++){
+            value = (keys >> k) & 0x1u;
+            if (snek8_cpuGetKeyVal(&self->ob_cpu, k) != value){
+                snek8_emulatorApplyKey(self, k, value);
+            }
+        }
+    }
 }
 
 /**
-* @brief C interface for the __new__ method.
+* @brief Drop the pending key events and publish the keys of the CPU, whose state was
+* just replaced, as the keys set from Python.
+*
+* @note Only the owner of the CPU may call this function.
 */
-static PyObject*
-snek8_emulatorNew(PyTypeObject* subtype, PyObject* args, PyObject* kwargs){
-    UNUSED(args);
-    UNUSED(kwargs);
-    PyObject* self = subtype->tp_alloc(subtype, 0);
-    if (!self){
-        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for a new emulator");
-        return NULL;
+static void
+snek8_emulatorSyncKeys(Snek8Emulator* self){
+    uint8_t key;
+    bool value;
+    while (snek8_keyQueuePop(&self->ob_key_queue, &key, &value)){
+        continue;
     }
-    return self;
+    (void) snek8_keyQueueTakeLost(&self->ob_key_queue);
+    atomic_store(&self->ob_keys, self->ob_cpu.keys);
 }
 
 /**
-* @brief C interface for the __init__ method.
+* @brief Take the ownership of the CPU for the calling method, applying the key
+* events posted from Python to the CPU.
+*
+* @return 0 on success, -1 with a RuntimeError set if the CPU is in use.
 */
 static int
-snek8_emulatorInit(PyObject* self, PyObject* args, PyObject* kwargs){
-    int implm_flags = 0;
-    char* kwlist[] = {
-        "implm_flags",
-        NULL,
-    };
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|i", kwlist, &implm_flags)){
-        return -1;
-    }
-    CAST_PTR(Snek8Emulator, self)->ob_is_running = false;
-    if (implm_flags < 0 || implm_flags >= 255){
-        PyErr_Format(PyExc_ValueError, "Value %d is invalid for implementation.", implm_flags);
+snek8_emulatorAcquire(Snek8Emulator* self){
+    int expected = SNEK8_EMULATOR_IDLE;
+    if (!atomic_compare_exchange_strong(&self->ob_state, &expected, SNEK8_EMULATOR_BUSY)){
+        PyErr_SetString(PyExc_RuntimeError, (SNEK8_EMULATOR_BUSY == expected)?
+                        "The emulator is already running on another thread.":
+                        "The emulator is running on its worker thread; call stop() first.");
         return -1;
     }
-    (void) snek8_cpuInit(&CAST_PTR(Snek8Emulator, self)->ob_cpu, (uint8_t) implm_flags);
+    snek8_emulatorDrainKeys(self);
     return 0;
 }
 
-/*
-* CONSTANT METHODS
-* ------------------
+/**
+* @brief Give back the ownership of the CPU taken by `snek8_emulatorAcquire`.
 */
+static void
+snek8_emulatorRelease(Snek8Emulator* self){
+    atomic_store(&self->ob_state, SNEK8_EMULATOR_IDLE);
+}
 
 /**
-* @brief Retrieve the implementation flags.
+* @brief Take the ownership of the CPU for a method that replaces its state, which
+* would break the replay being recorded.
+*
+* @return 0 on success, -1 with a RuntimeError set if the CPU is in use or a replay
+* is being recorded.
 */
-static PyObject*
-snek8_emulatorGetFlags(PyObject* self, PyObject* args){
-    UNUSED(args);
-    return PyLong_FromLong((long) CAST_PTR(Snek8Emulator, self)->ob_cpu.implm_flags);
+static int
+snek8_emulatorAcquireState(Snek8Emulator* self){
+    if (snek8_emulatorAcquire(self) < 0){
+        return -1;
+    }
+    if (self->ob_replay){
+        snek8_emulatorRelease(self);
+        PyErr_SetString(PyExc_RuntimeError,
+                        "The emulator is recording a replay; call stopRecording() first.");
+        return -1;
+    }
+    return 0;
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_FLAGS,
-             "getFlags() -> int\n\n"
-             "Retrieve the implementation flags.\n"
-             "Returns\n"
-             "-------\n"
-             "int\n"
-             "\tThe current value of the implementation flags."
-);
-
 /**
-* @brief Retrieve the program counter.
+* @brief Record in the replay being recorded, if any, the error that ended a run.
+*
+* @note The caller must own the CPU.
 */
-static PyObject*
-snek8_emulatorGetPC(PyObject* self, PyObject* args){
-    UNUSED(args);
-    return Py_BuildValue("i", CAST_PTR(Snek8Emulator, self)->ob_cpu.pc);
+static void
+snek8_emulatorRecordOutput(Snek8Emulator* self, enum Snek8ExecutionOutput out){
+    if (self->ob_replay && SNEK8_EXECOUT_SUCCESS != out){
+        self->ob_replay->out = out;
+    }
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_PC,
-             "getPC() -> int\n\n"
-             "Retrieve the program counter.\n"
-             "Returns\n"
-             "-------\n"
-             "int\n"
-             "\tThe current value of the program counter."
-);
-
 /**
-* @brief Retrieve the delay timer register.
+* @brief Ask the worker thread to stop and wait until it exits. The GIL is released
+* while waiting.
 */
-static PyObject*
-snek8_emulatorGetDT(PyObject* self, PyObject* args){
-    UNUSED(args);
-    return Py_BuildValue("i", CAST_PTR(Snek8Emulator, self)->ob_cpu.dt);
+static void
+snek8_emulatorJoinWorker(Snek8Emulator* self){
+    atomic_store(&self->ob_state, SNEK8_EMULATOR_STOPPING);
+    PyThread_release_lock(self->ob_worker.wake);
+    Py_BEGIN_ALLOW_THREADS
+    (void) PyThread_acquire_lock(self->ob_worker.done, WAIT_LOCK);
+    Py_END_ALLOW_THREADS
+    PyThread_release_lock(self->ob_worker.done);
+    atomic_store(&self->ob_state, SNEK8_EMULATOR_IDLE);
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_DT,
-             "getDT() -> int\n\n"
-             "Retrieve the delay timer register.\n"
-             "Returns\n"
-             "-------\n"
-             "int\n"
-             "\tThe current value of the delay timer."
-);
-
 /**
-* @brief Retrieve the sound timer register.
+* @brief Parse the arguments of setAudioBuffer.
+*
+* @return 0 on success, -1 with a Python exception set on failure.
 */
-static PyObject*
-snek8_emulatorGetST(PyObject* self, PyObject* args){
-    UNUSED(args);
-    return Py_BuildValue("i", CAST_PTR(Snek8Emulator, self)->ob_cpu.st);
+static int
+snek8_audioParseArgs(PyObject* args, PyObject* kwargs, PyObject** buffer, unsigned int* rate,
+                     unsigned int* tone, int* volume){
+    char* kwlist[] = {
+        "buffer",
+        "rate",
+        "tone",
+        "volume",
+        NULL,
+    };
+    return PyArg_ParseTupleAndKeywords(args, kwargs, "O|IIi", kwlist, buffer, rate, tone, volume)? 0: -1;
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_ST,
-             "getST() -> int\n\n"
-             "Retrieve the sound timer register.\n"
-             "Returns\n"
-             "-------\n"
-             "int\n"
-             "\tThe current value of the sount timer."
-);
-
 /**
-* @brief Retrieve the index register.
+* @brief Replace the ring of an audio generator by a writable buffer (or by none if
+* `buffer` is None), keeping a view on the buffer while it is used.
+*
+* @return 0 on success, -1 with a Python exception set on failure (the former ring is
+* then kept).
+* @note The caller must own the CPU.
 */
-static PyObject*
-snek8_emulatorGetIR(PyObject* self, PyObject* args){
-    UNUSED(args);
-    return Py_BuildValue("i", CAST_PTR(Snek8Emulator, self)->ob_cpu.ir);
+static int
+snek8_audioSetBuffer(Snek8Audio* audio, Py_buffer* view, PyObject* buffer, unsigned int rate,
+                     unsigned int tone, int volume){
+    Py_buffer ring = {.obj = NULL};
+    if (Py_None != buffer){
+        if (PyObject_GetBuffer(buffer, &ring, PyBUF_WRITABLE) < 0){
+            return -1;
+        }
+        Snek8Audio next;
+        if ((uintptr_t) ring.buf % _Alignof(int16_t)
+            || SNEK8_EXECOUT_SUCCESS != snek8_audioInit(&next, ring.buf, (size_t) ring.len / sizeof(int16_t),
+                                                        rate, tone, volume)){
+            PyErr_Format(PyExc_ValueError,
+                         "The audio buffer must be aligned and hold at least one frame (%zu samples "
+                         "at %u Hz), with %d <= rate <= %d, 0 < tone < rate / 2 and 0 <= volume <= %d.",
+                         snek8_audioFrameSize(rate), rate, SNEK8_TIMER_FREQUENCY, SNEK8_AUDIO_MAX_RATE,
+                         INT16_MAX);
+            PyBuffer_Release(&ring);
+            return -1;
+        }
+        *audio = next;
+    }else{
+        audio->samples = NULL;
+    }
+    if (view->obj){
+        PyBuffer_Release(view);
+    }
+    *view = ring;
+    return 0;
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_IR,
-             "getIR() -> int\n\n"
-             "Retrieve the index register.\n"
-             "Returns\n"
-             "-------\n"
-             "int\n"
-             "\tThe current value of the index register."
-);
-
 /**
-* @brief Retrieve the stack pointer.
+* @brief Synthesize the audio of a run, if the emulator has an audio ring.
+*
+* @param `phase` The clock's phase before the run.
+* @param `ips` The number of instructions per emulated second.
+* @param `cycles` The number of instructions of the run, idle cycles included.
+* @param `st` The sound timer before the run.
+* @param `cpu_st` The sound timer after the run.
 */
-static PyObject*
-snek8_emulatorGetSP(PyObject* self, PyObject* args){
-    UNUSED(args);
-    return Py_BuildValue("i", CAST_PTR(Snek8Emulator, self)->ob_cpu.sp);
+static inline void
+snek8_audioRun(Snek8Audio* audio, uint32_t phase, uint32_t ips, uint64_t cycles, uint8_t st,
+               uint8_t cpu_st, const uint8_t* pattern, uint8_t pitch){
+    if (audio->samples){
+        uint64_t ticks = (phase + (uint64_t) SNEK8_TIMER_FREQUENCY * cycles) / ips;
+        snek8_audioTicks(audio, ticks, st, cpu_st, pattern, pitch);
+    }
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_SP,
-             "getSP() -> int\n\n"
-             "Retrieve the stack pointer.\n"
-             "Returns\n"
-             "-------\n"
-             "int\n"
-             "\tThe current value of the stack pointer."
-);
-
 /**
-* @brief Retrieve the current value of a given V-register.
+* @brief Allocate a frame stream whose first frame, a keyframe of `graphics`, is queued.
+*
+* @return The stream, or NULL with a MemoryError set on failure.
 */
-static PyObject*
-snek8_emulatorGetRegister(PyObject* self, PyObject* args, PyObject* kwargs){
-    int index;
-    char* kwlist[] = {
-        "index",
-        NULL,
-    };
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i", kwlist, &index)){
+static Snek8FrameStream*
+snek8_frameStreamNew(size_t capacity, uint32_t keyframe_interval, const uint64_t* graphics){
+    Snek8FrameStream* stream = PyMem_Malloc(sizeof(Snek8FrameStream));
+    if (!stream){
+        PyErr_NoMemory();
         return NULL;
     }
-    if (index < 0 || index >= 16){
-        PyErr_Format(PyExc_IndexError, "Chip8 register's index ranges from 0 to 15 (inclusive).");
+    stream->stream = snek8_streamNew(capacity, keyframe_interval);
+    stream->signal = PyThread_allocate_lock();
+    if (!stream->stream || !stream->signal){
+        snek8_streamDel(stream->stream);
+        if (stream->signal){
+            PyThread_free_lock(stream->signal);
+        }
+        PyMem_Free(stream);
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for the frame stream");
         return NULL;
     }
-    return Py_BuildValue("i", CAST_PTR(Snek8Emulator, self)->ob_cpu.registers[index]);
+    (void) PyThread_acquire_lock(stream->signal, WAIT_LOCK);
+    atomic_init(&stream->signalled, false);
+    stream->users = 0;
+    stream->reading = false;
+    (void) snek8_streamPush(stream->stream, graphics);
+    return stream;
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_REGISTER,
-             "getRegister(index: int) -> int\n\n"
-             "Retrieve the value of a particular all purpose register.\n\n"
-             "Parameters\n"
-             "----------\n"
-             "index: int\n"
-             "\tThe index of the register to retrieve. I must be 0 <= index <= 15.\n"
-             "Returns\n"
-             "-------\n"
-             "int\n"
-             "\tThe current value of the register.\n"
-             "Raises\n"
-             "------\n"
-             "IndexError\n"
-             "\tIf the register index is not valid, i.e. index < 0 or index => 16."
-);
-
 /**
-* @brief Retrieve the current values of all V-registers.
+* @brief Release a frame stream (may be NULL) that no consumer uses.
 */
-static PyObject*
-snek8_emulatorGetRegisters(PyObject* self, PyObject* args){
-    UNUSED(args);
-    PyObject* register_list = PyList_New(SNEK8_SIZE_REGISTERS);
-    if (!register_list){
-        PyErr_SetString(PyExc_MemoryError, "Failed to create register list.");
-        return NULL;
-    }
-    for (size_t i = 0; i < SNEK8_SIZE_REGISTERS; i++){
-        PyObject* value = Py_BuildValue("i", CAST_PTR(Snek8Emulator, self)->ob_cpu.registers[i]);
-        if (!value){
-            PyErr_SetString(PyExc_MemoryError, "Failed to create register list element.");
-            Py_DECREF(register_list);
-            return NULL;
-        }
-        PyList_SET_ITEM(register_list, i, value);
+static void
+snek8_frameStreamDel(Snek8FrameStream* stream){
+    if (!stream){
+        return;
     }
-    return register_list;
+    snek8_streamDel(stream->stream);
+    PyThread_free_lock(stream->signal);
+    PyMem_Free(stream);
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_REGISTERS,
-             "getRegisters() -> Annotated[List[int], 16]\n\n"
-             "Retrieve all values of the all porpuse registers.\n"
-             "Returns\n"
-             "-------\n"
-             "Annotated[List[int], 16]\n"
-             "\tThe current value of the registers."
-);
-
 /**
-* @brief Retrieve the current values array representation of the screen.
+* @brief Queue the frame of a run, if the emulator streams its screen, and wake up the
+* consumer. Only the owner of the CPU may call this function; it does not need the GIL.
 */
-static PyObject*
-snek8_emulatorGetGraphics(PyObject* self, PyObject* args){
-    UNUSED(args);
-    PyObject* graphics_list = PyList_New(SNEK8_SIZE_GRAPHICS);
-    if (!graphics_list){
-        PyErr_SetString(PyExc_MemoryError, "Failed to create graphics list.");
-        return NULL;
-    }
-    for (size_t i = 0; i < SNEK8_SIZE_GRAPHICS; i++){
-        if (CAST_PTR(Snek8Emulator, self)->ob_cpu.graphics[i]){
-            PyList_SET_ITEM(graphics_list, i, Py_True);
-        }else{
-            PyList_SET_ITEM(graphics_list, i, Py_False);
-        }
+static inline void
+snek8_frameStreamPush(Snek8FrameStream* stream, const uint64_t* graphics){
+    if (stream && snek8_streamPush(stream->stream, graphics)
+        && !atomic_exchange_explicit(&stream->signalled, true, memory_order_release)){
+        PyThread_release_lock(stream->signal);
     }
-    return graphics_list;
+}
+
+/**
+* @brief Wait for frames to be queued, without the GIL.
+*
+* @param `timeout` The longest wait in nanoseconds, negative to wait indefinitely.
+* @return Whether frames are queued.
+*/
+static bool
+snek8_frameStreamWait(Snek8FrameStream* stream, PyTime_t timeout){
+    PyTime_t deadline = 0;
+    if (timeout >= 0){
+        (void) PyTime_MonotonicRaw(&deadline);
+        deadline += timeout;
+    }
+    while (!snek8_streamPending(stream->stream)){
+        PY_TIMEOUT_T wait = -1;
+        if (timeout >= 0){
+            PyTime_t now = 0;
+            (void) PyTime_MonotonicRaw(&now);
+            if (now >= deadline){
+                return false;
+            }
+            wait = (PY_TIMEOUT_T) ((deadline - now) / 1000);
+        }
+        if (PY_LOCK_ACQUIRED == PyThread_acquire_lock_timed(stream->signal, wait, 0)){
+            atomic_store_explicit(&stream->signalled, false, memory_order_relaxed);
+        }
+    }
+    return true;
+}
+
+/*
+* STATE TYPE
+* ----------
+*/
+
+typedef struct{
+    PyObject_HEAD
+    Snek8Snapshot ob_snapshot;
+    Py_ssize_t ob_exports;
+} Snek8State;
+
+PyDoc_STRVAR(SNEK8_STR_DOC_SNEK8_STATE,
+             "Snek8State(data: Buffer | None = None)\n\n"
+             "A saved state of a Snek8Emulator (see Snek8Emulator.saveState).\n\n"
+             "The state is a bytes-like object: bytes(state) is its serialized form, a\n"
+             "versioned little-endian format of SIZE_STATE bytes that can be written to a\n"
+             "file and passed back to Snek8State or to Snek8Emulator.loadState.\n\n"
+             "Parameters\n"
+             "----------\n"
+             "data: Buffer | None\n"
+             "\tA serialized state to copy. If None, the state is empty and cannot be loaded\n"
+             "\tuntil an emulator saves into it.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf data is not a valid serialized state."
+);
+
+static int
+snek8_stateInit(PyObject* self, PyObject* args, PyObject* kwargs){
+    PyObject* data = Py_None;
+    char* kwlist[] = {
+        "data",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", kwlist, &data)){
+        return -1;
+    }
+    Snek8State* state = CAST_PTR(Snek8State, self);
+    if (state->ob_exports){
+        PyErr_SetString(PyExc_BufferError, "The state cannot be reinitialized while it is exported.");
+        return -1;
+    }
+    state->ob_snapshot.id = 0;
+    if (Py_None == data){
+        (void) memset(state->ob_snapshot.data, 0, SNEK8_SIZE_SNAPSHOT);
+        return 0;
+    }
+    Py_buffer buffer;
+    if (PyObject_GetBuffer(data, &buffer, PyBUF_SIMPLE) < 0){
+        return -1;
+    }
+    if (SNEK8_EXECOUT_SUCCESS != snek8_snapshotValidate(buffer.buf, (size_t) buffer.len)){
+        PyBuffer_Release(&buffer);
+        PyErr_SetString(PyExc_ValueError, "The data is not a valid Snek8 state.");
+        return -1;
+    }
+    (void) memcpy(state->ob_snapshot.data, buffer.buf, SNEK8_SIZE_SNAPSHOT);
+    PyBuffer_Release(&buffer);
+    return 0;
+}
+
+static int
+snek8_stateGetBuffer(PyObject* self, Py_buffer* view, int flags){
+    Snek8State* state = CAST_PTR(Snek8State, self);
+    if (PyBuffer_FillInfo(view, self, state->ob_snapshot.data, SNEK8_SIZE_SNAPSHOT, 1, flags) < 0){
+        return -1;
+    }
+    state->ob_exports++;
+    return 0;
+}
+
+static void
+snek8_stateReleaseBuffer(PyObject* self, Py_buffer* view){
+    UNUSED(view);
+    CAST_PTR(Snek8State, self)->ob_exports--;
+}
+
+static PyBufferProcs snek8_state_as_buffer = {
+    .bf_getbuffer = snek8_stateGetBuffer,
+    .bf_releasebuffer = snek8_stateReleaseBuffer,
+};
+
+static PyTypeObject Snek8StateType = {
+     .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
+     .tp_name = "snek8.core.Snek8State",
+     .tp_basicsize = sizeof(Snek8State),
+     .tp_itemsize = 0,
+     .tp_doc = SNEK8_STR_DOC_SNEK8_STATE,
+     .tp_flags = Py_TPFLAGS_DEFAULT,
+     .tp_new = PyType_GenericNew,
+     .tp_init = (initproc) snek8_stateInit,
+     .tp_as_buffer = &snek8_state_as_buffer,
+};
+
+/*
+* INIT and DENIT METHODS
+* ----------------------
+*/
+
+/**
+* @brief Drop a reference to a boot image, releasing it with the last one.
+*/
+static void
+snek8_bootDrop(Snek8Boot* boot){
+    if (boot && !--boot->refs){
+        PyMem_Free(boot);
+    }
+}
+
+/**
+* @brief Make sure that the emulator holds a boot image of its own, copying the shared
+* one (or allocating one, before the first `__init__`) so that it can be changed.
+*
+* @return 0 on success, -1 with a MemoryError set on failure.
+*/
+static int
+snek8_emulatorOwnBoot(Snek8Emulator* self){
+    if (self->ob_boot && 1 == self->ob_boot->refs){
+        return 0;
+    }
+    Snek8Boot* boot = PyMem_Malloc(sizeof(Snek8Boot));
+    if (!boot){
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for the boot image");
+        return -1;
+    }
+    if (self->ob_boot){
+        *boot = *self->ob_boot;
+        snek8_bootDrop(self->ob_boot);
+    }else{
+        boot->rom = false;
+        boot->size = 0;
+        boot->cpu = self->ob_cpu;
+    }
+    boot->refs = 1;
+    self->ob_boot = boot;
+    return 0;
+}
+
+/**
+* @brief Give a reference to a slab back, releasing it with the last one.
+*/
+static void
+snek8_slabDrop(Snek8Slab* slab){
+    if (!--slab->live){
+        SNEK8_ALIGNED_FREE(slab->memory);
+        PyMem_Free(slab);
+    }
+}
+
+/**
+* @brief C interface for the tp_free slot: the emulators of a pool are given back to
+* their slab, the others to the Python allocator.
+*/
+static void
+snek8_emulatorFree(void* self){
+    Snek8Slab* slab = CAST_PTR(Snek8Emulator, self)->ob_slab;
+    if (slab){
+        snek8_slabDrop(slab);
+    }else{
+        PyObject_Free(self);
+    }
+}
+
+/**
+* @brief C interface for the __del__ method.
+*/
+static void
+snek8_emulatorDel(PyObject* self){
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    int state = atomic_load(&emulator->ob_state);
+    if (SNEK8_EMULATOR_WORKER == state || SNEK8_EMULATOR_STOPPING == state){
+        snek8_emulatorJoinWorker(emulator);
+    }
+    if (emulator->ob_worker.done){
+        PyThread_free_lock(emulator->ob_worker.done);
+    }
+    if (emulator->ob_worker.wake){
+        PyThread_free_lock(emulator->ob_worker.wake);
+    }
+    snek8_blockCacheDel(emulator->ob_cpu.blocks);
+    snek8_rewindDel(emulator->ob_rewind);
+    snek8_replayDel(emulator->ob_replay);
+    snek8_bootDrop(emulator->ob_boot);
+    if (emulator->ob_audio_view.obj){
+        PyBuffer_Release(&emulator->ob_audio_view);
+    }
+    snek8_frameStreamDel(emulator->ob_stream);
+    snek8_debugDel(emulator->ob_debugger);
+    Py_TYPE(self)->tp_free(self);
+}
+
+/**
+* @brief Allocate the locks of a new emulator, whose memory was just zeroed.
+*
+* @return `self` on success, NULL with a MemoryError set on failure (`self` is then
+* released).
+*/
+static PyObject*
+snek8_emulatorSetUp(PyObject* self){
+    Snek8Worker* worker = &CAST_PTR(Snek8Emulator, self)->ob_worker;
+    worker->done = PyThread_allocate_lock();
+    worker->wake = PyThread_allocate_lock();
+    if (!worker->done || !worker->wake){
+        Py_DECREF(self);
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate the locks of a new emulator");
+        return NULL;
+    }
+    return self;
+}
+
+/**
+* @brief C interface for the __new__ method.
+*/
+static PyObject*
+snek8_emulatorNew(PyTypeObject* subtype, PyObject* args, PyObject* kwargs){
+    UNUSED(args);
+    UNUSED(kwargs);
+    PyObject* self = subtype->tp_alloc(subtype, 0);
+    if (!self){
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for a new emulator");
+        return NULL;
+    }
+    return snek8_emulatorSetUp(self);
+}
+
+/**
+* @brief Select the engine used by emulationRun, attaching a block cache to the CPU
+* if the engine needs one and releasing it otherwise.
+*
+* @return 0 on success, -1 with a Python exception set on failure.
+*/
+static int
+snek8_emulatorSelectEngine(Snek8Emulator* self, int engine){
+    Snek8RunEngine run = snek8_cpuGetRunEngine((enum Snek8Engine) engine);
+    if (!run){
+        PyErr_Format(PyExc_ValueError, "Value %d is not a valid engine.", engine);
+        return -1;
+    }
+    if (SNEK8_ENGINE_BLOCK == engine && !self->ob_cpu.blocks){
+        self->ob_cpu.blocks = snek8_blockCacheNew();
+        if (!self->ob_cpu.blocks){
+            PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for the block cache");
+            return -1;
+        }
+    }else if (SNEK8_ENGINE_BLOCK != engine && self->ob_cpu.blocks){
+        snek8_blockCacheDel(self->ob_cpu.blocks);
+        self->ob_cpu.blocks = NULL;
+    }
+    self->ob_engine = (enum Snek8Engine) engine;
+    self->ob_run = run;
+    return 0;
+}
+
+/**
+* @brief Set an emulator to its state right after `__init__`, from valid arguments.
+*
+* @param `boot` A boot image without ROM to share, taken from a CPU initialized with
+*        the same implementation flags and IPS, or NULL for an image of its own.
+* @return 0 on success, -1 with a Python exception set on failure.
+*/
+static int
+snek8_emulatorConfigure(Snek8Emulator* self, uint8_t implm_flags, int engine, uint32_t ips,
+                        uint32_t rng_seed, Snek8Boot* boot){
+    if (snek8_emulatorAcquireState(self) < 0){
+        return -1;
+    }
+    snek8_blockCacheDel(self->ob_cpu.blocks);
+    (void) snek8_cpuInit(&self->ob_cpu, implm_flags);
+    (void) snek8_cpuSetIPS(&self->ob_cpu, ips);
+    (void) snek8_cpuSeed(&self->ob_cpu, rng_seed);
+    self->ob_boot_rng = self->ob_cpu.rng;
+    if (boot){
+        boot->refs++;
+        snek8_bootDrop(self->ob_boot);
+        self->ob_boot = boot;
+    }else if (snek8_emulatorOwnBoot(self) < 0){
+        snek8_emulatorRelease(self);
+        return -1;
+    }else{
+        self->ob_boot->rom = false;
+        self->ob_boot->size = 0;
+        self->ob_boot->cpu = self->ob_cpu;
+    }
+    self->ob_last_instruc = NULL;
+#if SNEK8_STATS
+    self->ob_fetches = 0;
+    self->ob_fetch_ns = 0;
+#endif
+    snek8_emulatorSyncKeys(self);
+    if (self->ob_rewind){
+        snek8_rewindClear(self->ob_rewind);
+    }
+    int result = snek8_emulatorSelectEngine(self, engine);
+    snek8_emulatorRelease(self);
+    return result;
+}
+
+/**
+* @brief C interface for the __init__ method.
+*/
+static int
+snek8_emulatorInit(PyObject* self, PyObject* args, PyObject* kwargs){
+    int implm_flags = 0;
+    int engine = SNEK8_ENGINE_REFERENCE;
+    long ips = SNEK8_CPU_DEFAULT_IPS;
+    PyObject* seed = Py_None;
+    char* kwlist[] = {
+        "implm_flags",
+        "engine",
+        "ips",
+        "seed",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|iilO", kwlist, &implm_flags, &engine, &ips, &seed)){
+        return -1;
+    }
+    CAST_PTR(Snek8Emulator, self)->ob_is_running = false;
+    if (implm_flags < 0 || (implm_flags & ~SNEK8_IMPLM_MODE_MASK)){
+        PyErr_Format(PyExc_ValueError, "Value %d is invalid for implementation.", implm_flags);
+        return -1;
+    }
+    if (!snek8_cpuGetRunEngine((enum Snek8Engine) engine)){
+        PyErr_Format(PyExc_ValueError, "Value %d is not a valid engine.", engine);
+        return -1;
+    }
+    if (ips < 1 || ips > SNEK8_CPU_MAX_IPS){
+        PyErr_Format(PyExc_ValueError, "Value %ld is not a valid number of instructions per second.", ips);
+        return -1;
+    }
+    uint32_t rng_seed;
+    if (Py_None == seed){
+        PyTime_t now = 0;
+        (void) PyTime_Time(&now);
+        rng_seed = (uint32_t) now ^ (uint32_t) ((uint64_t) now >> 32) ^ (uint32_t) (uintptr_t) self;
+    }else if (PyLong_Check(seed)){
+        rng_seed = (uint32_t) PyLong_AsUnsignedLongLongMask(seed);
+    }else{
+        PyErr_SetString(PyExc_TypeError, "seed must be an int or None.");
+        return -1;
+    }
+    return snek8_emulatorConfigure(CAST_PTR(Snek8Emulator, self), (uint8_t) implm_flags, engine,
+                                   (uint32_t) ips, rng_seed, NULL);
+}
+
+/*
+* CONSTANT METHODS
+* ------------------
+*/
+
+/**
+* @brief Retrieve the implementation flags.
+*/
+static PyObject*
+snek8_emulatorGetFlags(PyObject* self, PyObject* args){
+    UNUSED(args);
+    return PyLong_FromLong((long) CAST_PTR(Snek8Emulator, self)->ob_cpu.implm_flags);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_FLAGS,
+             "getFlags() -> int\n\n"
+             "Retrieve the implementation flags.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe current value of the implementation flags."
+);
+
+/**
+* @brief Retrieve the program counter.
+*/
+static PyObject*
+snek8_emulatorGetPC(PyObject* self, PyObject* args){
+    UNUSED(args);
+    return Py_BuildValue("i", CAST_PTR(Snek8Emulator, self)->ob_cpu.pc);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_PC,
+             "getPC() -> int\n\n"
+             "Retrieve the program counter.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe current value of the program counter."
+);
+
+/**
+* @brief Retrieve the delay timer register.
+*/
+static PyObject*
+snek8_emulatorGetDT(PyObject* self, PyObject* args){
+    UNUSED(args);
+    return Py_BuildValue("i", CAST_PTR(Snek8Emulator, self)->ob_cpu.dt);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_DT,
+             "getDT() -> int\n\n"
+             "Retrieve the delay timer register.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe current value of the delay timer."
+);
+
+/**
+* @brief Retrieve the number of executed instructions.
+*/
+static PyObject*
+snek8_emulatorGetCycles(PyObject* self, PyObject* args){
+    UNUSED(args);
+    return PyLong_FromUnsignedLongLong((unsigned long long) CAST_PTR(Snek8Emulator, self)->ob_cpu.cycles);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_CYCLES,
+             "getCycles() -> int\n\n"
+             "Retrieve the number of instructions executed since the initialization.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe value of the cycle counter."
+);
+
+/**
+* @brief Retrieve the number of instructions per emulated second.
+*/
+static PyObject*
+snek8_emulatorGetIPS(PyObject* self, PyObject* args){
+    UNUSED(args);
+    return PyLong_FromUnsignedLong((unsigned long) CAST_PTR(Snek8Emulator, self)->ob_cpu.ips);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_IPS,
+             "getIPS() -> int\n\n"
+             "Retrieve the number of instructions executed per emulated second.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe current rate."
+);
+
+/**
+* @brief Retrieve the sound timer register.
+*/
+static PyObject*
+snek8_emulatorGetST(PyObject* self, PyObject* args){
+    UNUSED(args);
+    return Py_BuildValue("i", CAST_PTR(Snek8Emulator, self)->ob_cpu.st);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_ST,
+             "getST() -> int\n\n"
+             "Retrieve the sound timer register.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe current value of the sount timer."
+);
+
+/**
+* @brief Retrieve the index register.
+*/
+static PyObject*
+snek8_emulatorGetIR(PyObject* self, PyObject* args){
+    UNUSED(args);
+    return Py_BuildValue("i", CAST_PTR(Snek8Emulator, self)->ob_cpu.ir);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_IR,
+             "getIR() -> int\n\n"
+             "Retrieve the index register.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe current value of the index register."
+);
+
+/**
+* @brief Retrieve the stack pointer.
+*/
+static PyObject*
+snek8_emulatorGetSP(PyObject* self, PyObject* args){
+    UNUSED(args);
+    return Py_BuildValue("i", CAST_PTR(Snek8Emulator, self)->ob_cpu.stack.sp);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_SP,
+             "getSP() -> int\n\n"
+             "Retrieve the stack pointer.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe current value of the stack pointer."
+);
+
+/**
+* @brief Retrieve the current value of a given V-register.
+*/
+static PyObject*
+snek8_emulatorGetRegister(PyObject* self, PyObject* args, PyObject* kwargs){
+    int index;
+    char* kwlist[] = {
+        "index",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i", kwlist, &index)){
+        return NULL;
+    }
+    if (index < 0 || index >= 16){
+        PyErr_Format(PyExc_IndexError, "Chip8 register's index ranges from 0 to 15 (inclusive).");
+        return NULL;
+    }
+    return Py_BuildValue("i", CAST_PTR(Snek8Emulator, self)->ob_cpu.registers[index]);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_REGISTER,
+             "getRegister(index: int) -> int\n\n"
+             "Retrieve the value of a particular all purpose register.\n\n"
+             "Parameters\n"
+             "----------\n"
+             "index: int\n"
+             "\tThe index of the register to retrieve. I must be 0 <= index <= 15.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe current value of the register.\n"
+             "Raises\n"
+             "------\n"
+             "IndexError\n"
+             "\tIf the register index is not valid, i.e. index < 0 or index => 16."
+);
+
+/**
+* @brief Retrieve the current values of all V-registers.
+*/
+static PyObject*
+snek8_emulatorGetRegisters(PyObject* self, PyObject* args){
+    UNUSED(args);
+    PyObject* register_list = PyList_New(SNEK8_SIZE_REGISTERS);
+    if (!register_list){
+        PyErr_SetString(PyExc_MemoryError, "Failed to create register list.");
+        return NULL;
+    }
+    for (size_t i = 0; i < SNEK8_SIZE_REGISTERS; i++){
+        PyObject* value = Py_BuildValue("i", CAST_PTR(Snek8Emulator, self)->ob_cpu.registers[i]);
+        if (!value){
+            PyErr_SetString(PyExc_MemoryError, "Failed to create register list element.");
+            Py_DECREF(register_list);
+            return NULL;
+        }
+        PyList_SET_ITEM(register_list, i, value);
+    }
+    return register_list;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_REGISTERS,
+             "getRegisters() -> Annotated[List[int], 16]\n\n"
+             "Retrieve all values of the all porpuse registers.\n"
+             "Returns\n"
+             "-------\n"
+             "Annotated[List[int], 16]\n"
+             "\tThe current value of the registers."
+);
+
+/**
+* @brief Retrieve the current values array representation of the screen.
+*/
+static PyObject*
+snek8_emulatorGetGraphics(PyObject* self, PyObject* args){
+    UNUSED(args);
+    SNEK8_FETCH_BEGIN();
+    PyObject* graphics_list = PyList_New(SNEK8_SIZE_GRAPHICS);
+    if (!graphics_list){
+        PyErr_SetString(PyExc_MemoryError, "Failed to create graphics list.");
+        return NULL;
+    }
+    for (size_t i = 0; i < SNEK8_SIZE_GRAPHICS; i++){
+        if (snek8_cpuGetPixel(&CAST_PTR(Snek8Emulator, self)->ob_cpu, i % SNEK8_GRAPHICS_WIDTH,
+                              i / SNEK8_GRAPHICS_WIDTH)){
+            PyList_SET_ITEM(graphics_list, i, Py_True);
+        }else{
+            PyList_SET_ITEM(graphics_list, i, Py_False);
+        }
+    }
+    SNEK8_FETCH_END(self);
+    return graphics_list;
 }
 
 PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_GRAPHICS,
@@ -338,472 +1148,4722 @@ PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_GRAPHICS,
              "Retrieve the graphics list representation.\n"
              "Returns\n"
              "-------\n"
-             "Annotated[List[bool], 2048]\n"
-             "\tThe current values of pixels."
+             "Annotated[List[bool], 2048]\n"
+             "\tThe current values of pixels."
+);
+
+/**
+* @brief Retrieve the generation of the screen.
+*/
+static PyObject*
+snek8_emulatorGetGraphicsGeneration(PyObject* self, PyObject* args){
+    UNUSED(args);
+    return PyLong_FromUnsignedLong((unsigned long) CAST_PTR(Snek8Emulator, self)->ob_cpu.graphics_gen);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_GRAPHICS_GEN,
+             "getGraphicsGeneration() -> int\n\n"
+             "Retrieve the generation of the screen, which changes whenever an instruction\n"
+             "modifies the screen.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe current generation (a 32-bit counter that wraps around)."
+);
+
+/**
+* @brief Retrieve and clear the damage of the screen.
+*/
+static PyObject*
+snek8_emulatorGetDamage(PyObject* self, PyObject* args){
+    UNUSED(args);
+    if (snek8_emulatorAcquire(CAST_PTR(Snek8Emulator, self)) < 0){
+        return NULL;
+    }
+    SNEK8_FETCH_BEGIN();
+    Snek8CPU* cpu = &CAST_PTR(Snek8Emulator, self)->ob_cpu;
+    uint32_t damage = cpu->graphics_dirty;
+    cpu->graphics_dirty = 0;
+    SNEK8_FETCH_END(self);
+    snek8_emulatorRelease(CAST_PTR(Snek8Emulator, self));
+    return PyLong_FromUnsignedLong((unsigned long) damage);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_DAMAGE,
+             "getDamage() -> int\n\n"
+             "Retrieve the rows of the screen modified since the last call and mark them\n"
+             "as clean. A freshly initialized emulator reports the whole screen.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe mask of the damaged rows: the bit y is set if the row y changed."
+);
+
+static PyObject*
+snek8_emulatorIsPixelActive(PyObject* self, PyObject* args, PyObject* kwargs){
+    int pos_x;
+    int pos_y;
+    char* kw_list[] = {
+        "pox_x",
+        "pos_y",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ii", kw_list, &pos_x, &pos_y)){
+        return NULL;
+    }
+    SNEK8_FETCH_BEGIN();
+    bool active = snek8_cpuGetPixel(&CAST_PTR(Snek8Emulator, self)->ob_cpu, pos_x, pos_y);
+    SNEK8_FETCH_END(self);
+    if (active){
+        Py_RETURN_TRUE;
+    }else{
+        Py_RETURN_FALSE;
+    }
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_IS_PIXEL_ACT,
+             "isPixelActive(pos_x: int, pos_y: int) -> bool\n\n"
+             "Retrieve whether the pixel at (pos_x, pos_y) is active.\n"
+             "An active (True) pixel is a white pixel and an innactive (False)\n"
+             "is a black pixel."
+             "Attributes\n"
+             "----------\n"
+             "pos_x: int\n"
+             "\tThe x-coordinate. 0 <= pos_x < 64\n"
+             "pos_y: int\n"
+             "\tThe y-coordinate. 0 <= pos_y < 32\n"
+             "Returns\n"
+             "-------\n"
+             "bool\n"
+             "\tThe current value of the requested pixel.\n"
+);
+
+static PyObject*
+snek8_emulatorGetStack(PyObject* self, PyObject* args){
+    UNUSED(args);
+    PyObject* stack_list = PyList_New(SNEK8_SIZE_STACK);
+    if (!stack_list){
+        PyErr_SetString(PyExc_MemoryError, "Failed to create stack list.");
+        return NULL;
+    }
+    for (size_t i = 0; i < SNEK8_SIZE_STACK; i++){
+        PyObject* value = Py_BuildValue("i", CAST_PTR(Snek8Emulator, self)->ob_cpu.stack.buffer[i]);
+        if (!value){
+            PyErr_SetString(PyExc_MemoryError, "Failed to create register list element.");
+            Py_DECREF(stack_list);
+            return NULL;
+        }
+        PyList_SET_ITEM(stack_list, i, value);
+    }
+    return stack_list;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_STACK,
+             "getStack() -> Annotated[List[int],16]\n\n"
+             "Retrieve the stack list representation.\n"
+             "Returns\n"
+             "-------\n"
+             "Annotated[List[int],16]\n"
+             "\tThe current values of the stack."
+);
+
+static PyObject*
+snek8_emulatorGetKeyValue(PyObject* self, PyObject* args, PyObject* kwargs){
+    int key;
+    char* kwlist[] = {
+        "index",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i", kwlist, &key)){
+        return NULL;
+    }
+    if (key < 0 || key >= SNEK8_SIZE_KEYSET){
+        PyErr_Format(PyExc_IndexError, "Index must be between 0 and 15 (incl.). Value recieved: %d.", key);
+        return NULL;
+    }
+    bool value = (atomic_load(&CAST_PTR(Snek8Emulator, self)->ob_keys) >> key) & 0x1u;
+    return PyBool_FromLong(value);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_KEY_VALUE,
+             "getKeyValue(key: int) -> bool\n\n"
+             "Retrieve the graphics list representation.\n"
+             "Attributes\n"
+             "----------\n"
+             "key: int\n"
+             "\tThe key index to be retrieved. 0 <= key <= 15\n"
+             "Returns\n"
+             "-------\n"
+             "bool\n"
+             "\tThe current value of the requested key.\n"
+             "Raises\n"
+             "------\n"
+             "IndexError\n"
+             "\tIf key is not a valid index, i.e. key < 0 or key >= 16."
+);
+
+/*
+* EMULATION METHODS
+* ------------------
+*/
+
+static PyObject*
+snek8_emulatorTurnFlagsOn(PyObject* self, PyObject* args, PyObject* kwargs){
+    int flags;
+    char* kwlist[] = {
+        "flags",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i", kwlist, &flags)){
+        return NULL;
+    }
+    if (flags < 0 || (flags & ~SNEK8_IMPLM_MODE_MASK)){
+        PyErr_Format(PyExc_ValueError, "Value %d is invalid for implementation.", flags);
+        return NULL;
+    }
+    if (snek8_emulatorAcquireState(CAST_PTR(Snek8Emulator, self)) < 0){
+        return NULL;
+    }
+    Snek8CPU* cpu = &CAST_PTR(Snek8Emulator, self)->ob_cpu;
+    (void) snek8_cpuSetImplmFlags(cpu, cpu->implm_flags | ((uint8_t) flags));
+    snek8_emulatorRelease(CAST_PTR(Snek8Emulator, self));
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_TURN_FLAGS_ON,
+             "turnFlagsOn(flags: int) -> None\n\n"
+             "Modify the emulator's implementation mode.\n\n"
+             "Attributes\n"
+             "----------\n"
+             "flags: int\n"
+             "\tWhich implementation to toggle on. Possible values has to be a "
+             "bitwise or combination of the following:\n"
+             "\t\t-0: IMPLM_MODE_BNNN_USE_VX.\n"
+             "\t\t-1: IMPLM_MODE_SHIFTS_USE_VY.\n"
+             "\t\t-2: IMPLM_MODE_FX_CHANGE_I.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf the implm is not a valid value."
+);
+
+static PyObject*
+snek8_emulatorTurnFlagsOff(PyObject* self, PyObject* args, PyObject* kwargs){
+    int flags;
+    char* kwlist[] = {
+        "flags",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i", kwlist, &flags)){
+        return NULL;
+    }
+    if (flags < 0 || (flags & ~SNEK8_IMPLM_MODE_MASK)){
+        PyErr_Format(PyExc_ValueError, "Value %d is invalid for implementation.", flags);
+        return NULL;
+    }
+    if (snek8_emulatorAcquireState(CAST_PTR(Snek8Emulator, self)) < 0){
+        return NULL;
+    }
+    Snek8CPU* cpu = &CAST_PTR(Snek8Emulator, self)->ob_cpu;
+    (void) snek8_cpuSetImplmFlags(cpu, cpu->implm_flags & ~((uint8_t) flags));
+    snek8_emulatorRelease(CAST_PTR(Snek8Emulator, self));
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_TURN_FLAGS_OFF,
+             "turnFlagsOff(flags: int) -> None\n\n"
+             "Turn the selected implementation flags off.\n\n"
+             "Attributes\n"
+             "----------\n"
+             "flags: int\n"
+             "\tWhich implementation to turn off; the flags already off stay off. Possible values has to be a "
+             "bitwise or combination of the following:\n"
+             "\t\t-0: IMPLM_MODE_BNNN_USE_VX.\n"
+             "\t\t-1: IMPLM_MODE_SHIFTS_USE_VY.\n"
+             "\t\t-2: IMPLM_MODE_FX_CHANGE_I.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf the implm is not a valid value."
+);
+
+static PyObject*
+snek8_emulatorSetRunning(PyObject* self, PyObject* args, PyObject* kwargs){
+    bool is_running;
+    char* kwlist[] = {
+        "is_running",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "b", kwlist, &is_running)){
+        return NULL;
+    }
+    CAST_PTR(Snek8Emulator, self)->ob_is_running = is_running;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_SET_RUNNING,
+             "setRunning(is_running: bool) -> None\n\n"
+             "Determine wether the CPU is running.\n\n"
+             "Attributes\n"
+             "----------\n"
+             "is_running: bool\n"
+             "\tDetermine if the CPU should run."
+);
+
+static PyObject*
+snek8_emulatorGetEngine(PyObject* self, PyObject* args){
+    UNUSED(args);
+    return PyLong_FromLong((long) CAST_PTR(Snek8Emulator, self)->ob_engine);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_ENGINE,
+             "getEngine() -> int\n\n"
+             "Retrieve the execution engine used by emulationRun.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe current engine, one of the ENGINE constants."
+);
+
+static PyObject*
+snek8_emulatorSetEngine(PyObject* self, PyObject* args, PyObject* kwargs){
+    int engine;
+    char* kwlist[] = {
+        "engine",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i", kwlist, &engine)){
+        return NULL;
+    }
+    if (snek8_emulatorAcquire(CAST_PTR(Snek8Emulator, self)) < 0){
+        return NULL;
+    }
+    int result = snek8_emulatorSelectEngine(CAST_PTR(Snek8Emulator, self), engine);
+    snek8_emulatorRelease(CAST_PTR(Snek8Emulator, self));
+    if (result < 0){
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_SET_ENGINE,
+             "setEngine(engine: int) -> None\n\n"
+             "Select the execution engine used by emulationRun.\n"
+             "Attributes\n"
+             "----------\n"
+             "engine: int\n"
+             "\tOne of the ENGINE constants.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf engine is not a valid engine.\n"
+             "MemoryError\n"
+             "\tIf the block cache required by ENGINE_BLOCK could not be allocated."
+);
+
+static PyObject*
+snek8_emulatorSetIPS(PyObject* self, PyObject* args, PyObject* kwargs){
+    long ips;
+    char* kwlist[] = {
+        "ips",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "l", kwlist, &ips)){
+        return NULL;
+    }
+    if (ips < 1 || ips > SNEK8_CPU_MAX_IPS){
+        PyErr_Format(PyExc_ValueError, "Value %ld is not a valid number of instructions per second.", ips);
+        return NULL;
+    }
+    if (snek8_emulatorAcquireState(CAST_PTR(Snek8Emulator, self)) < 0){
+        return NULL;
+    }
+    (void) snek8_cpuSetIPS(&CAST_PTR(Snek8Emulator, self)->ob_cpu, (uint32_t) ips);
+    snek8_emulatorRelease(CAST_PTR(Snek8Emulator, self));
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_SET_IPS,
+             "setIPS(ips: int) -> None\n\n"
+             "Set the number of instructions executed per emulated second. The delay and\n"
+             "sound timers tick TIMER_FREQUENCY times every `ips` instructions, regardless of\n"
+             "the wall clock, so the emulation is deterministic at any speed.\n"
+             "Attributes\n"
+             "----------\n"
+             "ips: int\n"
+             "\tThe new rate, between 1 and MAX_IPS.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf ips is out of range."
+);
+
+static PyObject*
+snek8_emulatorSetKeyValue(PyObject* self, PyObject* args, PyObject* kwargs){
+    int index;
+    bool value;
+    char* kwlist[] = {
+        "key",
+        "value",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ib", kwlist, &index, &value)){
+        return NULL;
+    }
+    if (index < 0 || index >= SNEK8_SIZE_KEYSET){
+        PyErr_Format(PyExc_IndexError, "Key index must be between 0 and 15 (incl.). Value recieved: %d.", index);
+        return NULL;
+    }
+    // The events reach the CPU when a method or the worker thread runs it next.
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    uint_least16_t bit = (uint_least16_t) (1u << index);
+    uint_least16_t keys = value? atomic_fetch_or(&emulator->ob_keys, bit):
+                                 atomic_fetch_and(&emulator->ob_keys, (uint_least16_t) ~bit);
+    if (((keys & bit)? true: false) != value){
+        (void) snek8_keyQueuePush(&emulator->ob_key_queue, (uint8_t) index, value);
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_SET_KEY_VALUE,
+             "setKeyValue(key: int, value: bool) -> None\n\n"
+             "Modifies a given key. The change is queued and reaches the CPU, in order\n"
+             "with the other changes, the next time it runs: a press and a release made\n"
+             "between two frames both count. LD VX, K completes when a key is pressed\n"
+             "and then released.\n"
+             "Attributes\n"
+             "----------\n"
+             "key: int\n"
+             "\tThe index to be modified.\n"
+             "value: bool\n"
+             "\tThe new value of the key..\n\n"
+             "Raises\n"
+             "------\n"
+             "IndexError\n"
+             "\tIf the key index is not a valid index, i.e. key < 0 or key >= 16."
+);
+
+static PyObject*
+_snek8_emulatorExecOpc(PyObject* self, PyObject* args, PyObject* kwargs){
+    int code = 0;
+    char* kwlist[] = {
+        "opcode",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i", kwlist, &code)){
+        return NULL;
+    }
+    if (code < 0 || code >= UINT16_MAX){
+        PyErr_Format(PyExc_ValueError, "The opcode must be a valid 16-bit unsigned integer.");
+        return NULL;
+    }
+    if (snek8_emulatorAcquireState(CAST_PTR(Snek8Emulator, self)) < 0){
+        return NULL;
+    }
+    Snek8Instruction instruction = snek8_opcodeDecode((uint16_t) code);
+    enum Snek8ExecutionOutput out = instruction.exec(&CAST_PTR(Snek8Emulator, self)->ob_cpu, code);
+    snek8_emulatorRelease(CAST_PTR(Snek8Emulator, self));
+    return PyLong_FromLong((long) out);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_EXEC_OPT,
+             "_execOpc(opcode: int) -> int\n\n"
+             "Execute a step in the emulation process determined by the opcode.\n"
+             "This function should only be used to test CPU functionallities.\n"
+             "Attributes\n"
+             "----------\n"
+             "opc: int\n"
+             "\tThe opcode to be executed.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe execution output code representing whether the execution was successeful.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf the opcode is not a valid 16-bit unsigned integer."
+);
+
+/**
+* @brief Set the ROM of the image `reset` restores.
+*
+* @param `rom` The ROM, or NULL to clear the program memory of the image.
+* @param `size` The size of the ROM, at most `SNEK8_SIZE_MAX_ROM_FILE`.
+* @note The caller must own the CPU and its boot image (see `snek8_emulatorOwnBoot`).
+*/
+static void
+snek8_emulatorSetBootRom(Snek8Emulator* self, const uint8_t* rom, size_t size){
+    Snek8Boot* boot = self->ob_boot;
+    (void) memset(boot->cpu.memory + SNEK8_MEM_ADDR_PROG_START, 0, SNEK8_SIZE_MAX_ROM_FILE);
+    if (rom && size){
+        (void) memcpy(boot->cpu.memory + SNEK8_MEM_ADDR_PROG_START, rom, size);
+    }
+    boot->rom = (NULL != rom);
+    boot->size = rom? size: 0;
+}
+
+static PyObject*
+snek8_emulatorLoadRom(PyObject* self, PyObject* args, PyObject* kwargs){
+    const char* rom_filepath = NULL;
+    char* kwlist[] = {
+        "rom_filepath",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s", kwlist, &rom_filepath)){
+        return NULL;
+    }
+    if (!rom_filepath){
+        return NULL;
+    }
+    const Snek8Rom* rom = NULL;
+    enum Snek8ExecutionOutput out = snek8_romCacheGet(&snek8_rom_cache, rom_filepath, &rom);
+    if (SNEK8_EXECOUT_SUCCESS != out){
+        return PyLong_FromLong((long) out);
+    }
+    if (snek8_emulatorAcquireState(CAST_PTR(Snek8Emulator, self)) < 0){
+        return NULL;
+    }
+    if (snek8_emulatorOwnBoot(CAST_PTR(Snek8Emulator, self)) < 0){
+        snek8_emulatorRelease(CAST_PTR(Snek8Emulator, self));
+        return NULL;
+    }
+    out = snek8_cpuLoadRomBytes(&CAST_PTR(Snek8Emulator, self)->ob_cpu, rom->data, rom->size);
+    if (SNEK8_EXECOUT_SUCCESS == out){
+        snek8_emulatorSetBootRom(CAST_PTR(Snek8Emulator, self), rom->data, rom->size);
+    }
+    snek8_emulatorRelease(CAST_PTR(Snek8Emulator, self));
+    if (out == SNEK8_EXECOUT_SUCCESS){
+        CAST_PTR(Snek8Emulator, self)->ob_is_running = true;
+    }
+    return PyLong_FromLong((long) out);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_LOAD_ROM,
+             "loadRom(rom_filepath: str) -> int\n\n"
+             "Load a Chip8's ROM into memory. The file is read through the module's ROM\n"
+             "cache: loading a ROM that is cached and did not change since (same size and\n"
+             "modification time) does not read the file again (see clearRomCache).\n"
+             "Attributes\n"
+             "----------\n"
+             "rom_filepath: str\n"
+             "\tThe filepath to the ROM file.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe execution output code representing whether the execution was successeful."
+);
+
+static PyObject*
+snek8_emulatorLoadRomBytes(PyObject* self, PyObject* args, PyObject* kwargs){
+    PyObject* data;
+    char* kwlist[] = {
+        "rom",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwlist, &data)){
+        return NULL;
+    }
+    Py_buffer buffer;
+    if (PyObject_GetBuffer(data, &buffer, PyBUF_SIMPLE) < 0){
+        return NULL;
+    }
+    if (snek8_emulatorAcquireState(CAST_PTR(Snek8Emulator, self)) < 0){
+        PyBuffer_Release(&buffer);
+        return NULL;
+    }
+    if (snek8_emulatorOwnBoot(CAST_PTR(Snek8Emulator, self)) < 0){
+        snek8_emulatorRelease(CAST_PTR(Snek8Emulator, self));
+        PyBuffer_Release(&buffer);
+        return NULL;
+    }
+    enum Snek8ExecutionOutput out = snek8_cpuLoadRomBytes(&CAST_PTR(Snek8Emulator, self)->ob_cpu,
+                                                           buffer.buf, (size_t) buffer.len);
+    if (SNEK8_EXECOUT_SUCCESS == out){
+        snek8_emulatorSetBootRom(CAST_PTR(Snek8Emulator, self), buffer.buf, (size_t) buffer.len);
+    }
+    snek8_emulatorRelease(CAST_PTR(Snek8Emulator, self));
+    PyBuffer_Release(&buffer);
+    if (out == SNEK8_EXECOUT_SUCCESS){
+        CAST_PTR(Snek8Emulator, self)->ob_is_running = true;
+    }
+    return PyLong_FromLong((long) out);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_LOAD_ROM_BYTES,
+             "loadRomBytes(rom: Buffer) -> int\n\n"
+             "Load a Chip8's ROM held in memory, e.g. bytes or a memoryview of a mapped file.\n"
+             "Attributes\n"
+             "----------\n"
+             "rom: Buffer\n"
+             "\tThe ROM, at most SIZE_MAX_ROM_FILE bytes.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe execution output code representing whether the execution was successeful.\n"
+             "Raises\n"
+             "------\n"
+             "TypeError\n"
+             "\tIf rom does not support the buffer protocol."
+);
+
+static PyObject*
+snek8_emulatorReset(PyObject* self, PyObject* args, PyObject* kwargs){
+    int keep_rom = true;
+    PyObject* seed = Py_None;
+    char* kwlist[] = {
+        "keep_rom",
+        "seed",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|pO", kwlist, &keep_rom, &seed)){
+        return NULL;
+    }
+    if (Py_None != seed && !PyLong_Check(seed)){
+        PyErr_SetString(PyExc_TypeError, "seed must be an int or None.");
+        return NULL;
+    }
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (snek8_emulatorAcquireState(emulator) < 0){
+        return NULL;
+    }
+    // The configuration is not part of the image: the latest one is kept.
+    uint8_t implm_flags = emulator->ob_cpu.implm_flags;
+    uint32_t ips = emulator->ob_cpu.ips;
+    if (!keep_rom || !emulator->ob_boot){
+        if (snek8_emulatorOwnBoot(emulator) < 0){
+            snek8_emulatorRelease(emulator);
+            return NULL;
+        }
+        snek8_emulatorSetBootRom(emulator, NULL, 0);
+    }
+    (void) snek8_cpuReset(&emulator->ob_cpu, &emulator->ob_boot->cpu);
+    (void) snek8_cpuSetImplmFlags(&emulator->ob_cpu, implm_flags);
+    (void) snek8_cpuSetIPS(&emulator->ob_cpu, ips);
+    emulator->ob_cpu.rng = emulator->ob_boot_rng;
+    if (Py_None != seed){
+        (void) snek8_cpuSeed(&emulator->ob_cpu, (uint32_t) PyLong_AsUnsignedLongLongMask(seed));
+    }
+    emulator->ob_cpu.keys = (uint16_t) atomic_load(&emulator->ob_keys);
+    if (emulator->ob_rewind){
+        snek8_rewindClear(emulator->ob_rewind);
+    }
+    emulator->ob_last_instruc = NULL;
+    emulator->ob_is_running = emulator->ob_boot->rom;
+    snek8_emulatorRelease(emulator);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_RESET,
+             "reset(keep_rom: bool = True, seed: int | None = None) -> None\n\n"
+             "Reset the emulator in place to its state right after __init__ and the last\n"
+             "loadRom or loadRomBytes, without reading the ROM again. The implementation flags,\n"
+             "the IPS, the engine, the pressed keys and the rewind budget are kept; the rewind\n"
+             "buffer is emptied.\n"
+             "Attributes\n"
+             "----------\n"
+             "keep_rom: bool\n"
+             "\tWhether the ROM stays loaded. If False, the program memory is cleared and the\n"
+             "\temulator is no longer running until a ROM is loaded.\n"
+             "seed: int | None\n"
+             "\tA new seed for the random number generator. If None, the generator restarts\n"
+             "\tfrom where it was after __init__, so that every episode draws the same numbers.\n"
+             "Raises\n"
+             "------\n"
+             "TypeError\n"
+             "\tIf seed is neither an int nor None.\n"
+             "RuntimeError\n"
+             "\tIf the emulator is running on another thread or recording a replay."
+);
+
+static PyObject*
+snek8_emulatorEmulationStep(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (snek8_emulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+    Snek8CPU* cpu = &emulator->ob_cpu;
+    uint16_t opcode = (uint16_t) ((cpu->memory[cpu->pc & SNEK8_MEM_ADDR_RAM_END] << 8)
+                                  | cpu->memory[(cpu->pc + 1) & SNEK8_MEM_ADDR_RAM_END]);
+    uint32_t phase = cpu->timer_phase;
+    uint8_t st = cpu->st;
+    uint64_t start = cpu->cycles;
+    size_t cycles = 1;
+    enum Snek8ExecutionOutput out;
+    if (snek8_debugActive(emulator->ob_debugger)){
+        // A breakpoint stops the step before the instruction, as it stops the runs.
+        out = snek8_debugRun(emulator->ob_debugger, cpu, 1, 0, &cycles, NULL);
+    }else{
+        out = snek8_cpuStep(cpu, NULL);
+    }
+    snek8_audioRun(&emulator->ob_audio, phase, cpu->ips, cpu->cycles - start, st, cpu->st, NULL, 0);
+    snek8_frameStreamPush(emulator->ob_stream, cpu->graphics);
+    emulator->ob_last_instruc = cycles? snek8_opcodeDecode(opcode).code: NULL;
+    snek8_emulatorRecordOutput(emulator, out);
+    snek8_emulatorRelease(emulator);
+    if (out != SNEK8_EXECOUT_SUCCESS){
+        emulator->ob_is_running = false;
+    }
+    return Py_BuildValue("i", out);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_EMU_STEP,
+             "emulationStep() -> int\n\n"
+             "Execute one step in the emulation process. While breakpoints or watchpoints are\n"
+             "set, the step stops at them as emulationRun does: a breakpoint at the program\n"
+             "counter is reported by getBreak and the instruction is not executed until the\n"
+             "next step.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe execution output code of the instruction. Any code but EXECOUT_SUCCESS\n"
+             "\tends the emulation, as for emulationRun: is_running becomes False (until the\n"
+             "\tnext reset or loadRom) and the error is recorded in the replay being recorded."
+);
+
+/**
+* @brief Run the CPU with the emulator's engine or, while breakpoints or watchpoints are
+* set, with the debugger's run (see `snek8_cpuRun` for the parameters and results).
+*/
+static inline enum Snek8ExecutionOutput
+snek8_emulatorRunCPU(Snek8Emulator* self, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+                     enum Snek8RunStop* stop){
+    if (snek8_debugActive(self->ob_debugger)){
+        return snek8_debugRun(self->ob_debugger, &self->ob_cpu, max_cycles, break_flags, cycles, stop);
+    }
+    return self->ob_run(&self->ob_cpu, max_cycles, break_flags, cycles, stop);
+}
+
+/**
+* @brief Execute up to `max_cycles` instructions with the emulator's engine. The GIL
+* is released during the execution, so that emulators run by distinct threads run
+* in parallel.
+*
+* @param `max_cycles` The maximum number of instructions, or 0 to run up to the
+*        end of the current 60 Hz frame.
+* @return The (cycles, stop, output) tuple returned by emulationRun.
+*/
+static PyObject*
+snek8_emulatorRunEngine(Snek8Emulator* self, size_t max_cycles, uint8_t break_flags){
+    size_t cycles = 0;
+    enum Snek8RunStop stop = SNEK8_RUNSTOP_CYCLES;
+    enum Snek8ExecutionOutput out;
+    if (snek8_emulatorAcquire(self) < 0){
+        return NULL;
+    }
+    bool frame = !max_cycles;
+    if (frame){
+        max_cycles = snek8_cpuCyclesToFrame(&self->ob_cpu);
+    }
+    self->ob_last_instruc = NULL;
+    uint32_t phase = self->ob_cpu.timer_phase;
+    uint8_t st = self->ob_cpu.st;
+    uint64_t start = self->ob_cpu.cycles;
+    Py_BEGIN_ALLOW_THREADS
+    out = snek8_emulatorRunCPU(self, max_cycles, break_flags, &cycles, &stop);
+    snek8_audioRun(&self->ob_audio, phase, self->ob_cpu.ips, self->ob_cpu.cycles - start, st,
+                   self->ob_cpu.st, NULL, 0);
+    snek8_frameStreamPush(self->ob_stream, self->ob_cpu.graphics);
+    if (frame && self->ob_rewind && SNEK8_EXECOUT_SUCCESS == out && SNEK8_RUNSTOP_CYCLES == stop){
+        (void) snek8_rewindRecord(self->ob_rewind, &self->ob_cpu);
+    }
+    Py_END_ALLOW_THREADS
+    snek8_emulatorRecordOutput(self, out);
+    snek8_emulatorRelease(self);
+    if (out != SNEK8_EXECOUT_SUCCESS){
+        self->ob_is_running = false;
+    }
+    return Py_BuildValue("(nii)", (Py_ssize_t) cycles, stop, out);
+}
+
+static PyObject*
+snek8_emulatorEmulationRun(PyObject* self, PyObject* args, PyObject* kwargs){
+    Py_ssize_t max_cycles;
+    int break_flags = SNEK8_RUN_BREAK_ON_DRAW | SNEK8_RUN_BREAK_ON_KEY_WAIT;
+    char* kwlist[] = {
+        "cycles",
+        "break_on",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n|i", kwlist, &max_cycles, &break_flags)){
+        return NULL;
+    }
+    if (max_cycles < 0){
+        PyErr_Format(PyExc_ValueError, "The number of cycles must be non-negative.");
+        return NULL;
+    }
+    if (!max_cycles){
+        return Py_BuildValue("(nii)", (Py_ssize_t) 0, SNEK8_RUNSTOP_CYCLES, SNEK8_EXECOUT_SUCCESS);
+    }
+    return snek8_emulatorRunEngine(CAST_PTR(Snek8Emulator, self), (size_t) max_cycles,
+                                   (uint8_t) break_flags);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_EMU_RUN,
+             "emulationRun(cycles: int, break_on: int = RUN_BREAK_ON_DRAW | RUN_BREAK_ON_KEY_WAIT)"
+             " -> Tuple[int, int, int]\n\n"
+             "Execute up to `cycles` steps of the emulation process in a single call,\n"
+             "using the emulator's execution engine.\n"
+             "Attributes\n"
+             "----------\n"
+             "cycles: int\n"
+             "\tThe maximum number of instructions to execute.\n"
+             "break_on: int\n"
+             "\tA bitwise or combination of RUN_BREAK_ON_DRAW (return right after a DRW)\n"
+             "\tand RUN_BREAK_ON_KEY_WAIT (return once LD VX, K waits for a key). Without\n"
+             "\tthe latter, the cycles left while waiting for a key are spent idle at once.\n"
+             "\tBreakpoints and watchpoints (see addBreakpoint and addWatchpoint) stop the\n"
+             "\trun whatever break_on is.\n"
+             "Returns\n"
+             "-------\n"
+             "Tuple[int, int, int]\n"
+             "\tThe number of executed instructions, the RUNSTOP constant telling why the run\n"
+             "\treturned (RUNSTOP_BREAKPOINT and RUNSTOP_WATCHPOINT being detailed by\n"
+             "\tgetBreak) and the execution output code of the last instruction.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf cycles is negative."
+);
+
+static PyObject*
+snek8_emulatorEmulationFrame(PyObject* self, PyObject* args, PyObject* kwargs){
+    int break_flags = 0;
+    char* kwlist[] = {
+        "break_on",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|i", kwlist, &break_flags)){
+        return NULL;
+    }
+    return snek8_emulatorRunEngine(CAST_PTR(Snek8Emulator, self), 0, (uint8_t) break_flags);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_EMU_FRAME,
+             "emulationFrame(break_on: int = 0) -> Tuple[int, int, int]\n\n"
+             "Execute the instructions left in the current 60 Hz frame, i.e. up to and\n"
+             "including the next tick of the timers, using the emulator's execution engine.\n"
+             "If the frame completes and rewinding is enabled (see setRewindBudget), its final\n"
+             "state is recorded.\n"
+             "Attributes\n"
+             "----------\n"
+             "break_on: int\n"
+             "\tSame as in emulationRun.\n"
+             "Returns\n"
+             "-------\n"
+             "Tuple[int, int, int]\n"
+             "\tSame as in emulationRun."
+);
+
+static PyObject*
+snek8_emulatorSaveState(PyObject* self, PyObject* args, PyObject* kwargs){
+    PyObject* into = Py_None;
+    char* kwlist[] = {
+        "into",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", kwlist, &into)){
+        return NULL;
+    }
+    Snek8State* state;
+    if (Py_None == into){
+        state = PyObject_New(Snek8State, &Snek8StateType);
+        if (!state){
+            return NULL;
+        }
+        state->ob_snapshot.id = 0;
+        state->ob_exports = 0;
+    }else if (PyObject_TypeCheck(into, &Snek8StateType)){
+        state = CAST_PTR(Snek8State, Py_NewRef(into));
+        if (state->ob_exports){
+            Py_DECREF(state);
+            PyErr_SetString(PyExc_BufferError, "The state cannot be overwritten while it is exported.");
+            return NULL;
+        }
+    }else{
+        PyErr_SetString(PyExc_TypeError, "into must be a Snek8State or None.");
+        return NULL;
+    }
+    if (snek8_emulatorAcquire(CAST_PTR(Snek8Emulator, self)) < 0){
+        Py_DECREF(state);
+        return NULL;
+    }
+    (void) snek8_cpuSnapshot(&CAST_PTR(Snek8Emulator, self)->ob_cpu, &state->ob_snapshot);
+    snek8_emulatorRelease(CAST_PTR(Snek8Emulator, self));
+    return (PyObject*) state;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_SAVE_STATE,
+             "saveState(into: Snek8State | None = None) -> Snek8State\n\n"
+             "Save the state of the CPU.\n"
+             "Saving into, or loading, the state the emulator last saved or loaded only copies\n"
+             "the memory pages written in the meantime, so keeping a state around and saving\n"
+             "into it repeatedly is much cheaper than creating new ones.\n"
+             "Attributes\n"
+             "----------\n"
+             "into: Snek8State | None\n"
+             "\tThe state to overwrite. If None, a new state is created.\n"
+             "Returns\n"
+             "-------\n"
+             "Snek8State\n"
+             "\tThe saved state (`into` if given).\n"
+             "Raises\n"
+             "------\n"
+             "TypeError\n"
+             "\tIf into is neither a Snek8State nor None.\n"
+             "BufferError\n"
+             "\tIf into is exported (e.g. by a memoryview)."
+);
+
+static PyObject*
+snek8_emulatorLoadState(PyObject* self, PyObject* args, PyObject* kwargs){
+    PyObject* data;
+    char* kwlist[] = {
+        "state",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwlist, &data)){
+        return NULL;
+    }
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    enum Snek8ExecutionOutput out;
+    if (PyObject_TypeCheck(data, &Snek8StateType)){
+        if (snek8_emulatorAcquireState(emulator) < 0){
+            return NULL;
+        }
+        out = snek8_cpuRestore(&emulator->ob_cpu, &CAST_PTR(Snek8State, data)->ob_snapshot);
+    }else{
+        Py_buffer buffer;
+        if (PyObject_GetBuffer(data, &buffer, PyBUF_SIMPLE) < 0){
+            return NULL;
+        }
+        out = snek8_snapshotValidate(buffer.buf, (size_t) buffer.len);
+        if (SNEK8_EXECOUT_SUCCESS != out){
+            PyBuffer_Release(&buffer);
+            return PyLong_FromLong((long) out);
+        }
+        if (snek8_emulatorAcquireState(emulator) < 0){
+            PyBuffer_Release(&buffer);
+            return NULL;
+        }
+        Snek8Snapshot snapshot = {.id = 0};
+        (void) memcpy(snapshot.data, buffer.buf, SNEK8_SIZE_SNAPSHOT);
+        PyBuffer_Release(&buffer);
+        out = snek8_cpuRestore(&emulator->ob_cpu, &snapshot);
+    }
+    if (SNEK8_EXECOUT_SUCCESS == out){
+        snek8_emulatorSyncKeys(emulator);
+        emulator->ob_is_running = true;
+    }
+    snek8_emulatorRelease(emulator);
+    return PyLong_FromLong((long) out);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_LOAD_STATE,
+             "loadState(state: Buffer) -> int\n\n"
+             "Restore the state of the CPU, including its keys, implementation flags and\n"
+             "number of instructions per second. The emulator is running afterwards.\n"
+             "Attributes\n"
+             "----------\n"
+             "state: Buffer\n"
+             "\tA Snek8State or any bytes-like object holding a serialized state.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tEXECOUT_SUCCESS, or EXECOUT_SNAPSHOT_INVALID if the state is not valid (the\n"
+             "\tCPU is then left untouched)."
+);
+
+/*
+* REWIND
+* ------
+*/
+
+static PyObject*
+snek8_emulatorSetRewindBudget(PyObject* self, PyObject* args, PyObject* kwargs){
+    Py_ssize_t budget;
+    char* kwlist[] = {
+        "budget",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n", kwlist, &budget)){
+        return NULL;
+    }
+    if (budget && budget < SNEK8_REWIND_MIN_BUDGET){
+        PyErr_Format(PyExc_ValueError, "The rewind budget must be 0 or at least %d bytes. Value recieved: %zd.",
+                     SNEK8_REWIND_MIN_BUDGET, budget);
+        return NULL;
+    }
+    Snek8Rewind* rewind = NULL;
+    if (budget){
+        rewind = snek8_rewindNew((size_t) budget);
+        if (!rewind){
+            PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for the rewind buffer");
+            return NULL;
+        }
+    }
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (snek8_emulatorAcquire(emulator) < 0){
+        snek8_rewindDel(rewind);
+        return NULL;
+    }
+    snek8_rewindDel(emulator->ob_rewind);
+    emulator->ob_rewind = rewind;
+    snek8_emulatorRelease(emulator);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_SET_REWIND_BUDGET,
+             "setRewindBudget(budget: int) -> None\n\n"
+             "Enable, resize or disable the rewind buffer, dropping the recorded frames.\n"
+             "While enabled, the state at the end of every 60 Hz frame completed by\n"
+             "emulationFrame or by the worker thread is recorded. The frames are stored as\n"
+             "compressed differences, typically tens of bytes each; the oldest ones are\n"
+             "dropped once the budget is exhausted.\n"
+             "Attributes\n"
+             "----------\n"
+             "budget: int\n"
+             "\tThe memory, in bytes, dedicated to the recorded frames: 0 to disable the\n"
+             "\trewind buffer, or at least REWIND_MIN_BUDGET.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf budget is neither 0 nor at least REWIND_MIN_BUDGET.\n"
+             "MemoryError\n"
+             "\tIf the rewind buffer could not be allocated."
+);
+
+static PyObject*
+snek8_emulatorGetRewindFrames(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (snek8_emulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+    size_t frames = emulator->ob_rewind? emulator->ob_rewind->frames: 0;
+    snek8_emulatorRelease(emulator);
+    return PyLong_FromSize_t(frames);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_REWIND_FRAMES,
+             "getRewindFrames() -> int\n\n"
+             "Retrieve how many frames can currently be rewound.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe number of recorded frames before the most recent one (0 when the rewind\n"
+             "\tbuffer is disabled)."
+);
+
+static PyObject*
+snek8_emulatorRewind(PyObject* self, PyObject* args, PyObject* kwargs){
+    Py_ssize_t frames = 1;
+    char* kwlist[] = {
+        "frames",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|n", kwlist, &frames)){
+        return NULL;
+    }
+    if (frames < 0){
+        PyErr_Format(PyExc_ValueError, "The number of frames must be non-negative.");
+        return NULL;
+    }
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (snek8_emulatorAcquireState(emulator) < 0){
+        return NULL;
+    }
+    size_t done = 0;
+    if (emulator->ob_rewind && emulator->ob_rewind->primed){
+        done = snek8_rewindRewind(emulator->ob_rewind, &emulator->ob_cpu, (size_t) frames);
+        // The keys follow the user, not the recording.
+        emulator->ob_cpu.keys = (uint16_t) atomic_load(&emulator->ob_keys);
+        emulator->ob_is_running = true;
+    }
+    snek8_emulatorRelease(emulator);
+    return PyLong_FromSize_t(done);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_REWIND,
+             "rewind(frames: int = 1) -> int\n\n"
+             "Go back to the state recorded `frames` frames before the most recent one, which\n"
+             "becomes the most recent one: the frames in between are discarded. The pressed\n"
+             "keys are kept.\n"
+             "Attributes\n"
+             "----------\n"
+             "frames: int\n"
+             "\tThe number of frames to go back, clamped to getRewindFrames(). 0 returns to\n"
+             "\tthe most recent recorded state.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe number of frames gone back. Nothing happens if no frame was recorded.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf frames is negative."
+);
+
+/*
+* REPLAY
+* ------
+*/
+
+static PyObject*
+snek8_emulatorStartRecording(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (snek8_emulatorAcquireState(emulator) < 0){
+        return NULL;
+    }
+    emulator->ob_replay = snek8_replayNew(&emulator->ob_cpu);
+    snek8_emulatorRelease(emulator);
+    if (!emulator->ob_replay){
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for the replay");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_START_RECORDING,
+             "startRecording() -> None\n\n"
+             "Start recording a replay: the current state, then every change of the keys,\n"
+             "timestamped with the cycle at which the CPU saw it. The emulation may run in any\n"
+             "way meanwhile (worker thread included), but the methods that replace the state\n"
+             "(loadRom, loadRomBytes, loadState, reset, rewind, setIPS, turnFlagsOn/Off,\n"
+             "_execOpc, __init__ and playReplay) raise RuntimeError until stopRecording is called.\n"
+             "Raises\n"
+             "------\n"
+             "RuntimeError\n"
+             "\tIf a replay is already being recorded.\n"
+             "MemoryError\n"
+             "\tIf the replay could not be allocated."
+);
+
+static PyObject*
+snek8_emulatorIsRecording(PyObject* self, PyObject* args){
+    UNUSED(args);
+    return PyBool_FromLong((long) (NULL != CAST_PTR(Snek8Emulator, self)->ob_replay));
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_IS_RECORDING,
+             "isRecording() -> bool\n\n"
+             "Determine whether a replay is being recorded.\n"
+             "Returns\n"
+             "-------\n"
+             "bool\n"
+             "\tTrue between startRecording and stopRecording."
+);
+
+static PyObject*
+snek8_emulatorStopRecording(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (!emulator->ob_replay){
+        PyErr_SetString(PyExc_RuntimeError, "The emulator is not recording a replay.");
+        return NULL;
+    }
+    // Acquiring records the pending key events; the current cycle ends the replay.
+    if (snek8_emulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+    Snek8Replay* replay = emulator->ob_replay;
+    (void) snek8_replayRecord(replay, emulator->ob_cpu.cycles, emulator->ob_cpu.keys);
+    emulator->ob_replay = NULL;
+    snek8_emulatorRelease(emulator);
+    if (replay->failed){
+        snek8_replayDel(replay);
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for the replay's events");
+        return NULL;
+    }
+    PyObject* data = PyBytes_FromStringAndSize(NULL, (Py_ssize_t) snek8_replaySize(replay));
+    if (data){
+        snek8_replayWrite(replay, CAST_PTR(uint8_t, PyBytes_AS_STRING(data)));
+    }
+    snek8_replayDel(replay);
+    return data;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_STOP_RECORDING,
+             "stopRecording() -> bytes\n\n"
+             "Stop recording the replay and serialize it.\n"
+             "Returns\n"
+             "-------\n"
+             "bytes\n"
+             "\tThe replay, to be played back with playReplay (SIZE_REPLAY_HEADER bytes plus\n"
+             "\ta couple of bytes per key change).\n"
+             "Raises\n"
+             "------\n"
+             "RuntimeError\n"
+             "\tIf no replay is being recorded, or the emulator is running on another thread.\n"
+             "MemoryError\n"
+             "\tIf some key change could not be recorded; the replay is then discarded."
+);
+
+static PyObject*
+snek8_emulatorPlayReplay(PyObject* self, PyObject* args, PyObject* kwargs){
+    PyObject* data;
+    char* kwlist[] = {
+        "replay",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwlist, &data)){
+        return NULL;
+    }
+    Py_buffer buffer;
+    if (PyObject_GetBuffer(data, &buffer, PyBUF_SIMPLE) < 0){
+        return NULL;
+    }
+    Snek8Replay* replay = NULL;
+    enum Snek8ExecutionOutput out = snek8_replayRead(buffer.buf, (size_t) buffer.len, &replay);
+    PyBuffer_Release(&buffer);
+    if (SNEK8_EXECOUT_OUT_OF_MEMORY == out){
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for the replay");
+        return NULL;
+    }
+    if (SNEK8_EXECOUT_SUCCESS != out){
+        return PyLong_FromLong((long) out);
+    }
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (snek8_emulatorAcquireState(emulator) < 0){
+        snek8_replayDel(replay);
+        return NULL;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    out = snek8_replayPlay(replay, &emulator->ob_cpu, emulator->ob_run);
+    Py_END_ALLOW_THREADS
+    snek8_emulatorSyncKeys(emulator);
+    emulator->ob_is_running = (SNEK8_EXECOUT_SUCCESS == out);
+    snek8_emulatorRelease(emulator);
+    snek8_replayDel(replay);
+    return PyLong_FromLong((long) out);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_PLAY_REPLAY,
+             "playReplay(replay: Buffer) -> int\n\n"
+             "Play a replay back as fast as possible, without the GIL, with the emulator's\n"
+             "engine: the emulator is restored to the recorded state and run up to the end of\n"
+             "the recording, each key change being applied right at its cycle. The emulator\n"
+             "then is in exactly the state the recording one was in when stopRecording was\n"
+             "called, and its keys are the recorded ones.\n"
+             "Attributes\n"
+             "----------\n"
+             "replay: Buffer\n"
+             "\tA replay returned by stopRecording.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tEXECOUT_SUCCESS, EXECOUT_REPLAY_INVALID if the replay is not valid (the\n"
+             "\temulator is then left untouched), or the error of the instruction that ended\n"
+             "\tthe recorded session.\n"
+             "Raises\n"
+             "------\n"
+             "TypeError\n"
+             "\tIf replay does not support the buffer protocol.\n"
+             "RuntimeError\n"
+             "\tIf the emulator is running on another thread or recording a replay.\n"
+             "MemoryError\n"
+             "\tIf the replay could not be parsed for lack of memory."
+);
+
+/*
+* WORKER THREAD
+* -------------
+*/
+
+/**
+* @def SNEK8_WORKER_MAX_LAG_NS
+* @brief How far, in nanoseconds, a paced worker may fall behind the wall clock before
+* it gives up catching up and restarts its schedule from the current time.
+*/
+#define SNEK8_WORKER_MAX_LAG_NS          250000000
+
+/**
+* @brief Publish the CPU's screen and sound timer as the worker's current frame.
+*
+* The frame is protected by a seqlock: the sequence counter is odd while the frame is
+* being written, so readers retry until they copy it between two equal, even values.
+*/
+static void
+snek8_workerPublish(Snek8Worker* worker, const Snek8CPU* cpu){
+    uint_least32_t seq = atomic_load_explicit(&worker->frame_seq, memory_order_relaxed);
+    atomic_store_explicit(&worker->frame_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    for (size_t row = 0; row < SNEK8_GRAPHICS_HEIGTH; row++){
+        atomic_store_explicit(&worker->frame_rows[row], cpu->graphics[row], memory_order_relaxed);
+    }
+    atomic_store_explicit(&worker->frame_gen, cpu->graphics_gen, memory_order_relaxed);
+    atomic_store_explicit(&worker->frame_st, cpu->st, memory_order_relaxed);
+    atomic_store_explicit(&worker->frame_seq, seq + 2, memory_order_release);
+}
+
+/**
+* @brief Body of the worker thread.
+*
+* The worker runs the CPU one 60 Hz frame at a time with the emulator's engine,
+* applying the key events posted from Python before each frame and publishing the
+* frame whenever the screen or the sound timer changed. A paced worker then sleeps
+* until the frame is due on the wall clock. The loop ends when the worker is asked to
+* stop, an instruction fails or the CPU reaches a breakpoint or a watchpoint.
+*
+* @note The worker never takes the GIL: it only uses the CPU, which it owns while
+* running, and the atomics and locks of `Snek8Worker`.
+*/
+static void
+snek8_workerMain(void* arg){
+    Snek8Emulator* self = CAST_PTR(Snek8Emulator, arg);
+    Snek8Worker* worker = &self->ob_worker;
+    Snek8CPU* cpu = &self->ob_cpu;
+    enum Snek8ExecutionOutput out = SNEK8_EXECOUT_SUCCESS;
+    uint32_t published_gen = cpu->graphics_gen;
+    uint8_t published_st = cpu->st;
+    snek8_workerPublish(worker, cpu);
+    PyTime_t start = 0;
+    (void) PyTime_MonotonicRaw(&start);
+    int64_t frames = 0;
+    while (SNEK8_EMULATOR_WORKER == atomic_load_explicit(&self->ob_state, memory_order_acquire)){
+        snek8_emulatorDrainKeys(self);
+        uint32_t phase = cpu->timer_phase;
+        uint8_t st = cpu->st;
+        uint64_t cycles = cpu->cycles;
+        enum Snek8RunStop stop = SNEK8_RUNSTOP_CYCLES;
+        out = snek8_emulatorRunCPU(self, snek8_cpuCyclesToFrame(cpu), 0, NULL, &stop);
+        snek8_audioRun(&self->ob_audio, phase, cpu->ips, cpu->cycles - cycles, st, cpu->st, NULL, 0);
+        snek8_frameStreamPush(self->ob_stream, cpu->graphics);
+        if (cpu->graphics_gen != published_gen || cpu->st != published_st){
+            snek8_workerPublish(worker, cpu);
+            published_gen = cpu->graphics_gen;
+            published_st = cpu->st;
+        }
+        if (out != SNEK8_EXECOUT_SUCCESS){
+            snek8_emulatorRecordOutput(self, out);
+            break;
+        }
+        if (SNEK8_RUNSTOP_BREAKPOINT == stop || SNEK8_RUNSTOP_WATCHPOINT == stop){
+            break;
+        }
+        if (self->ob_rewind){
+            (void) snek8_rewindRecord(self->ob_rewind, cpu);
+        }
+        // A CPU waiting for a key has nothing to do until the next event: even an
+        // unpaced worker sleeps instead of spinning through idle frames.
+        if (!worker->paced && !cpu->key_wait){
+            continue;
+        }
+        frames++;
+        PyTime_t now = 0;
+        (void) PyTime_MonotonicRaw(&now);
+        PyTime_t deadline = start + (PyTime_t) (frames * 1000000000 / SNEK8_TIMER_FREQUENCY);
+        if (deadline > now){
+            // Stopping releases `wake`, which cuts the sleep short.
+            if (PY_LOCK_ACQUIRED == PyThread_acquire_lock_timed(worker->wake, (deadline - now) / 1000, 0)){
+                PyThread_release_lock(worker->wake);
+            }
+        }else if (now - deadline > SNEK8_WORKER_MAX_LAG_NS){
+            start = now;
+            frames = 0;
+        }
+    }
+    worker->out = out;
+    atomic_store(&worker->alive, false);
+    PyThread_release_lock(worker->done);
+}
+
+static PyObject*
+snek8_emulatorStart(PyObject* self, PyObject* args, PyObject* kwargs){
+    int paced = true;
+    char* kwlist[] = {
+        "paced",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|p", kwlist, &paced)){
+        return NULL;
+    }
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (!emulator->ob_is_running){
+        PyErr_SetString(PyExc_RuntimeError, "The emulator is not running; load a ROM first.");
+        return NULL;
+    }
+    if (snek8_emulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+    Snek8Worker* worker = &emulator->ob_worker;
+    (void) PyThread_acquire_lock(worker->done, WAIT_LOCK);
+    (void) PyThread_acquire_lock(worker->wake, WAIT_LOCK);
+    worker->paced = paced;
+    worker->out = SNEK8_EXECOUT_SUCCESS;
+    emulator->ob_last_instruc = NULL;
+    atomic_store(&worker->alive, true);
+    atomic_store(&emulator->ob_state, SNEK8_EMULATOR_WORKER);
+    if (PYTHREAD_INVALID_THREAD_ID == PyThread_start_new_thread(snek8_workerMain, emulator)){
+        atomic_store(&worker->alive, false);
+        PyThread_release_lock(worker->wake);
+        PyThread_release_lock(worker->done);
+        snek8_emulatorRelease(emulator);
+        PyErr_SetString(PyExc_RuntimeError, "Failed to start the worker thread.");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_START,
+             "start(paced: bool = True) -> None\n\n"
+             "Run the emulation on a native worker thread, one 60 Hz frame (see\n"
+             "emulationFrame) at a time, until stop is called or an instruction fails.\n"
+             "The worker does not hold the GIL, so several emulators run in parallel.\n"
+             "Attributes\n"
+             "----------\n"
+             "paced: bool\n"
+             "\tWhether to run in real time (TIMER_FREQUENCY frames per second) or as fast\n"
+             "\tas possible.\n"
+             "Raises\n"
+             "------\n"
+             "RuntimeError\n"
+             "\tIf no ROM is loaded, the emulator is already running or the thread could\n"
+             "\tnot be started."
+);
+
+static PyObject*
+snek8_emulatorStop(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (SNEK8_EMULATOR_WORKER != atomic_load(&emulator->ob_state)){
+        PyErr_SetString(PyExc_RuntimeError, "The worker thread is not running.");
+        return NULL;
+    }
+    snek8_emulatorJoinWorker(emulator);
+    if (emulator->ob_worker.out != SNEK8_EXECOUT_SUCCESS){
+        emulator->ob_is_running = false;
+    }
+    return PyLong_FromLong((long) emulator->ob_worker.out);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_STOP,
+             "stop() -> int\n\n"
+             "Stop the worker thread and wait for it to exit. This has to be called even\n"
+             "if the worker already exited on its own, after a failing instruction.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe execution output code of the worker's last frame.\n"
+             "Raises\n"
+             "------\n"
+             "RuntimeError\n"
+             "\tIf the worker thread was not started."
+);
+
+static PyObject*
+snek8_emulatorIsWorkerRunning(PyObject* self, PyObject* args){
+    UNUSED(args);
+    return PyBool_FromLong((long) atomic_load(&CAST_PTR(Snek8Emulator, self)->ob_worker.alive));
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_IS_WORKER_RUNNING,
+             "isWorkerRunning() -> bool\n\n"
+             "Retrieve whether the worker thread is running the emulation.\n"
+             "Returns\n"
+             "-------\n"
+             "bool\n"
+             "\tFalse if the worker was not started, was stopped or exited after a failing\n"
+             "\tinstruction."
+);
+
+/**
+* @brief Copy a consistent snapshot of the screen: the CPU's one, or the last frame
+* published by the worker thread while it runs.
+*/
+static void
+snek8_emulatorCopyFrame(Snek8Emulator* emulator, uint64_t* rows, uint32_t* gen, uint8_t* st){
+    Snek8Worker* worker = &emulator->ob_worker;
+    int state = atomic_load(&emulator->ob_state);
+    if (SNEK8_EMULATOR_WORKER != state && SNEK8_EMULATOR_STOPPING != state){
+        (void) memcpy(rows, emulator->ob_cpu.graphics, SNEK8_SIZE_GRAPHICS_BYTES);
+        *gen = emulator->ob_cpu.graphics_gen;
+        *st = emulator->ob_cpu.st;
+        return;
+    }
+    uint_least32_t seq;
+    do{
+        seq = atomic_load_explicit(&worker->frame_seq, memory_order_acquire);
+        for (size_t row = 0; row < SNEK8_GRAPHICS_HEIGTH; row++){
+            rows[row] = atomic_load_explicit(&worker->frame_rows[row], memory_order_relaxed);
+        }
+        *gen = (uint32_t) atomic_load_explicit(&worker->frame_gen, memory_order_relaxed);
+        *st = (uint8_t) atomic_load_explicit(&worker->frame_st, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+    }while ((seq & 0x1u) || seq != atomic_load_explicit(&worker->frame_seq, memory_order_relaxed));
+}
+
+static PyObject*
+snek8_emulatorGetFrame(PyObject* self, PyObject* args){
+    UNUSED(args);
+    SNEK8_FETCH_BEGIN();
+    uint64_t rows[SNEK8_GRAPHICS_HEIGTH];
+    uint32_t gen;
+    uint8_t st;
+    snek8_emulatorCopyFrame(CAST_PTR(Snek8Emulator, self), rows, &gen, &st);
+    PyObject* frame = Py_BuildValue("(ky#i)", (unsigned long) gen, (const char*) rows,
+                                    (Py_ssize_t) SNEK8_SIZE_GRAPHICS_BYTES, (int) st);
+    SNEK8_FETCH_END(self);
+    return frame;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_FRAME,
+             "getFrame() -> Tuple[int, bytes, int]\n\n"
+             "Retrieve a consistent snapshot of the screen. While the worker thread runs,\n"
+             "the snapshot is the last frame it published.\n"
+             "Returns\n"
+             "-------\n"
+             "Tuple[int, bytes, int]\n"
+             "\tThe screen generation (see getGraphicsGeneration), the screen as\n"
+             "\tSIZE_GRAPHICS_HEIGHT native-endian unsigned 64-bit rows (the layout of the\n"
+             "\tbuffer protocol) and the sound timer."
+);
+
+static PyObject*
+snek8_emulatorBlit(PyObject* self, PyObject* args, PyObject* kwargs){
+    PyObject* data;
+    Py_ssize_t scale = 1;
+    unsigned int foreground = 0xFF4E9A06u;
+    unsigned int background = 0xFF000000u;
+    Py_ssize_t stride = 0;
+    unsigned int mask = UINT32_MAX;
+    char* kwlist[] = {
+        "image",
+        "scale",
+        "foreground",
+        "background",
+        "stride",
+        "rows",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|nIInI", kwlist, &data, &scale, &foreground,
+                                     &background, &stride, &mask)){
+        return NULL;
+    }
+    if (scale < 1 || scale > SNEK8_BLIT_MAX_SCALE){
+        PyErr_Format(PyExc_ValueError, "The scale must be within 1 and %d.", SNEK8_BLIT_MAX_SCALE);
+        return NULL;
+    }
+    Py_ssize_t line = SNEK8_GRAPHICS_WIDTH * scale * (Py_ssize_t) sizeof(uint32_t);
+    if (!stride){
+        stride = line;
+    }
+    if (stride < line || stride % (Py_ssize_t) sizeof(uint32_t)){
+        PyErr_SetString(PyExc_ValueError, "The stride must be a multiple of 4 of at least 256 * scale bytes.");
+        return NULL;
+    }
+    Py_buffer buffer;
+    if (PyObject_GetBuffer(data, &buffer, PyBUF_WRITABLE) < 0){
+        return NULL;
+    }
+    if (buffer.len < stride * (SNEK8_GRAPHICS_HEIGTH * scale - 1) + line
+        || (uintptr_t) buffer.buf % _Alignof(uint32_t)){
+        PyBuffer_Release(&buffer);
+        PyErr_SetString(PyExc_ValueError, "The image is too small for the scale and stride, or misaligned.");
+        return NULL;
+    }
+    SNEK8_FETCH_BEGIN();
+    uint64_t rows[SNEK8_GRAPHICS_HEIGTH];
+    uint32_t gen;
+    uint8_t st;
+    snek8_emulatorCopyFrame(CAST_PTR(Snek8Emulator, self), rows, &gen, &st);
+    Py_BEGIN_ALLOW_THREADS
+    (void) snek8_blit(rows, (uint32_t) mask, buffer.buf, (size_t) stride / sizeof(uint32_t), (size_t) scale,
+                      (uint32_t) foreground, (uint32_t) background);
+    Py_END_ALLOW_THREADS
+    SNEK8_FETCH_END(self);
+    PyBuffer_Release(&buffer);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_BLIT,
+             "blit(image: Buffer, scale: int = 1, foreground: int = 0xFF4E9A06,\n"
+             "     background: int = 0xFF000000, stride: int = 0, rows: int = 0xFFFFFFFF) -> None\n\n"
+             "Render the screen (the same snapshot as getFrame) into a writable 32-bit image\n"
+             "of (SIZE_GRAPHICS_WIDTH * scale) x (SIZE_GRAPHICS_HEIGHT * scale) pixels, such as\n"
+             "the bits of an ARGB32 QImage. Each pixel of the screen becomes a scale x scale\n"
+             "square of the foreground or the background colour.\n"
+             "Attributes\n"
+             "----------\n"
+             "image: Buffer\n"
+             "\tThe image, written as native 32-bit integers.\n"
+             "scale: int\n"
+             "\tThe scale factor, 1 <= scale <= BLIT_MAX_SCALE.\n"
+             "foreground: int\n"
+             "\tThe colour of the active pixels, e.g. 0xAARRGGBB.\n"
+             "background: int\n"
+             "\tThe colour of the inactive pixels.\n"
+             "stride: int\n"
+             "\tThe bytes per line of the image (0 for SIZE_GRAPHICS_WIDTH * scale * 4).\n"
+             "rows: int\n"
+             "\tThe mask of the screen rows to render, e.g. the value of getDamage; the\n"
+             "\tother lines of the image are left untouched.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf the scale or the stride are invalid, or the image is too small."
+);
+
+static PyObject*
+snek8_emulatorSetAudioBuffer(PyObject* self, PyObject* args, PyObject* kwargs){
+    PyObject* buffer;
+    unsigned int rate = SNEK8_AUDIO_DEFAULT_RATE;
+    unsigned int tone = SNEK8_AUDIO_DEFAULT_TONE;
+    int volume = SNEK8_AUDIO_DEFAULT_VOLUME;
+    if (snek8_audioParseArgs(args, kwargs, &buffer, &rate, &tone, &volume) < 0){
+        return NULL;
+    }
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (snek8_emulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+    int result = snek8_audioSetBuffer(&emulator->ob_audio, &emulator->ob_audio_view, buffer, rate, tone, volume);
+    snek8_emulatorRelease(emulator);
+    if (result < 0){
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_SET_AUDIO_BUFFER,
+             "setAudioBuffer(buffer: Buffer | None, rate: int = AUDIO_DEFAULT_RATE,\n"
+             "               tone: int = AUDIO_DEFAULT_TONE, volume: int = AUDIO_DEFAULT_VOLUME)"
+             " -> None\n\n"
+             "Synthesize the buzzer into a ring buffer, e.g. a bytearray or an array('h'), that\n"
+             "the emulator writes in place: native-endian signed 16-bit mono samples, the sample\n"
+             "n being the item n % (len(buffer) // 2). Every tick of the timers, i.e. every 60 Hz\n"
+             "frame emulated by any run (the worker's included), appends one frame of samples, a\n"
+             "square wave while the sound timer is running and silence otherwise. getAudioPosition\n"
+             "tells how many samples were written so far. The emulator keeps a view on the\n"
+             "buffer until it is replaced.\n"
+             "Attributes\n"
+             "----------\n"
+             "buffer: Buffer | None\n"
+             "\tA writable buffer of at least one frame of samples, or None to stop the audio.\n"
+             "rate: int\n"
+             "\tThe number of samples per second.\n"
+             "tone: int\n"
+             "\tThe frequency of the square wave, in Hz.\n"
+             "volume: int\n"
+             "\tThe amplitude of the square wave, at most 32767.\n"
+             "Raises\n"
+             "------\n"
+             "TypeError\n"
+             "\tIf buffer is not a writable buffer.\n"
+             "ValueError\n"
+             "\tIf the buffer is too small or misaligned, or the parameters are invalid.\n"
+             "RuntimeError\n"
+             "\tIf the emulator is running on another thread."
+);
+
+static PyObject*
+snek8_emulatorGetAudioPosition(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    return PyLong_FromUnsignedLongLong(emulator->ob_audio_view.obj? snek8_audioWritten(&emulator->ob_audio): 0);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_AUDIO_POSITION,
+             "getAudioPosition() -> int\n\n"
+             "Retrieve the number of samples written into the audio buffer since it was set (see\n"
+             "setAudioBuffer). The samples before it are in the buffer; those more than\n"
+             "len(buffer) // 2 samples behind it were overwritten. The position can be read while\n"
+             "the worker thread runs.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe number of samples written, 0 without audio buffer."
+);
+
+/**
+* @brief Retrieve the frame stream of an emulator.
+*
+* @return The stream, or NULL with a RuntimeError set if the emulator does not stream.
+*/
+static Snek8FrameStream*
+snek8_emulatorGetStream(Snek8Emulator* emulator){
+    if (!emulator->ob_stream){
+        PyErr_SetString(PyExc_RuntimeError, "The emulator is not streaming; call startStream first.");
+    }
+    return emulator->ob_stream;
+}
+
+/**
+* @brief Take the emulator's CPU to replace or release its frame stream.
+*
+* @return 0 on success, -1 with a RuntimeError set if the CPU or the stream are in use.
+*/
+static int
+snek8_emulatorAcquireStream(Snek8Emulator* emulator){
+    if (emulator->ob_stream && emulator->ob_stream->users){
+        PyErr_SetString(PyExc_RuntimeError, "A consumer is waiting on or reading the frame stream.");
+        return -1;
+    }
+    return snek8_emulatorAcquire(emulator);
+}
+
+static PyObject*
+snek8_emulatorStartStream(PyObject* self, PyObject* args, PyObject* kwargs){
+    unsigned int keyframe_interval = SNEK8_STREAM_DEFAULT_KEYFRAME_INTERVAL;
+    Py_ssize_t capacity = SNEK8_STREAM_DEFAULT_CAPACITY;
+    char* kwlist[] = {
+        "keyframe_interval",
+        "capacity",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|In", kwlist, &keyframe_interval, &capacity)){
+        return NULL;
+    }
+    if (!keyframe_interval || capacity < SNEK8_STREAM_MAX_FRAME){
+        PyErr_Format(PyExc_ValueError, "The keyframe interval must be positive and the capacity at least %d bytes.",
+                     SNEK8_STREAM_MAX_FRAME);
+        return NULL;
+    }
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (snek8_emulatorAcquireStream(emulator) < 0){
+        return NULL;
+    }
+    Snek8FrameStream* stream = snek8_frameStreamNew((size_t) capacity, keyframe_interval, emulator->ob_cpu.graphics);
+    if (stream){
+        snek8_frameStreamDel(emulator->ob_stream);
+        emulator->ob_stream = stream;
+    }
+    snek8_emulatorRelease(emulator);
+    if (!stream){
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_START_STREAM,
+             "startStream(keyframe_interval: int = STREAM_DEFAULT_KEYFRAME_INTERVAL,\n"
+             "            capacity: int = STREAM_DEFAULT_CAPACITY) -> None\n\n"
+             "Stream the screen for remote viewers: after every run (the worker's frames\n"
+             "included) that changed the screen, the emulator queues a frame holding the rows\n"
+             "that changed, XOR-ed with their previous value, a few dozen bytes for a typical\n"
+             "frame. Keyframes hold the whole screen instead; the first frame is one, as is\n"
+             "the frame after a dropped one. The frames are drained with readFrames or\n"
+             "readFramesInto and applied to a screen with decodeFrames; their format is the\n"
+             "following, multi-byte fields being little-endian:\n\n"
+             "\tsequence: u32, size: u16, kind: u8 (STREAM_KEYFRAME or STREAM_DELTA), rows: u8,\n"
+             "\tthen, for each row: index: u8, mask: u8, one byte per bit set in mask,\n"
+             "\tthe byte i covering the pixels 8i to 8i + 7 from its most significant bit.\n\n"
+             "Restarting the stream drops the queued frames.\n"
+             "Attributes\n"
+             "----------\n"
+             "keyframe_interval: int\n"
+             "\tThe largest number of frames from a keyframe to the next.\n"
+             "capacity: int\n"
+             "\tThe size of the queue in bytes, at least STREAM_MAX_FRAME. When the consumer\n"
+             "\tfalls behind and a frame does not fit, it is dropped (see getDroppedFrames).\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf keyframe_interval is not positive or capacity is too small.\n"
+             "RuntimeError\n"
+             "\tIf the emulator is running on another thread or a consumer is waiting on or\n"
+             "\treading the stream."
+);
+
+static PyObject*
+snek8_emulatorStopStream(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (snek8_emulatorAcquireStream(emulator) < 0){
+        return NULL;
+    }
+    snek8_frameStreamDel(emulator->ob_stream);
+    emulator->ob_stream = NULL;
+    snek8_emulatorRelease(emulator);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_STOP_STREAM,
+             "stopStream() -> None\n\n"
+             "Stop streaming the screen, dropping the queued frames.\n"
+             "Raises\n"
+             "------\n"
+             "RuntimeError\n"
+             "\tIf the emulator is running on another thread or a consumer is waiting on or\n"
+             "\treading the stream."
+);
+
+static PyObject*
+snek8_emulatorRequestKeyframe(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8FrameStream* stream = snek8_emulatorGetStream(CAST_PTR(Snek8Emulator, self));
+    if (!stream){
+        return NULL;
+    }
+    snek8_streamRequestKeyframe(stream->stream);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_REQUEST_KEYFRAME,
+             "requestKeyframe() -> None\n\n"
+             "Make the next frame a keyframe, e.g. for a viewer that just joined. It is queued\n"
+             "after the next run, even if the screen does not change. This can be called while\n"
+             "the worker thread runs.\n"
+             "Raises\n"
+             "------\n"
+             "RuntimeError\n"
+             "\tIf the emulator is not streaming."
+);
+
+/**
+* @brief Mark the frame stream as read by the calling consumer.
+*
+* @return The stream, or NULL with a RuntimeError set if there is none or it is
+* already being read.
+*/
+static Snek8FrameStream*
+snek8_emulatorBeginRead(Snek8Emulator* emulator){
+    Snek8FrameStream* stream = snek8_emulatorGetStream(emulator);
+    if (stream && stream->reading){
+        PyErr_SetString(PyExc_RuntimeError, "Another consumer is reading the frame stream.");
+        return NULL;
+    }
+    if (stream){
+        stream->reading = true;
+    }
+    return stream;
+}
+
+static PyObject*
+snek8_emulatorReadFrames(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8FrameStream* stream = snek8_emulatorBeginRead(CAST_PTR(Snek8Emulator, self));
+    if (!stream){
+        return NULL;
+    }
+    // The queue only holds whole frames, so everything pending is read at once.
+    size_t pending = snek8_streamPending(stream->stream);
+    PyObject* frames = PyBytes_FromStringAndSize(NULL, (Py_ssize_t) pending);
+    if (frames){
+        (void) snek8_streamRead(stream->stream, (uint8_t*) PyBytes_AS_STRING(frames), pending);
+    }
+    stream->reading = false;
+    return frames;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_READ_FRAMES,
+             "readFrames() -> bytes\n\n"
+             "Drain the frames queued by the stream (see startStream). This can be called while\n"
+             "the worker thread runs.\n"
+             "Returns\n"
+             "-------\n"
+             "bytes\n"
+             "\tThe frames, back to back, empty if none is queued.\n"
+             "Raises\n"
+             "------\n"
+             "RuntimeError\n"
+             "\tIf the emulator is not streaming or another consumer is reading the stream."
+);
+
+static PyObject*
+snek8_emulatorReadFramesInto(PyObject* self, PyObject* args, PyObject* kwargs){
+    Py_buffer data;
+    char* kwlist[] = {
+        "buffer",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "w*", kwlist, &data)){
+        return NULL;
+    }
+    if (data.len < SNEK8_STREAM_MAX_FRAME){
+        PyErr_Format(PyExc_ValueError, "The buffer must hold at least STREAM_MAX_FRAME (%d) bytes.",
+                     SNEK8_STREAM_MAX_FRAME);
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+    Snek8FrameStream* stream = snek8_emulatorBeginRead(CAST_PTR(Snek8Emulator, self));
+    if (!stream){
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+    size_t size;
+    stream->users++;
+    Py_BEGIN_ALLOW_THREADS
+    size = snek8_streamRead(stream->stream, data.buf, (size_t) data.len);
+    Py_END_ALLOW_THREADS
+    stream->users--;
+    stream->reading = false;
+    PyBuffer_Release(&data);
+    return PyLong_FromSize_t(size);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_READ_FRAMES_INTO,
+             "readFramesInto(buffer: Buffer) -> int\n\n"
+             "Move as many whole frames as fit out of the stream's queue into a writable\n"
+             "buffer, without the GIL, e.g. to send them on a socket. This can be called while\n"
+             "the worker thread runs.\n"
+             "Attributes\n"
+             "----------\n"
+             "buffer: Buffer\n"
+             "\tA writable buffer of at least STREAM_MAX_FRAME bytes.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe number of bytes written at the start of the buffer.\n"
+             "Raises\n"
+             "------\n"
+             "TypeError\n"
+             "\tIf buffer is not a writable buffer.\n"
+             "ValueError\n"
+             "\tIf the buffer is too small.\n"
+             "RuntimeError\n"
+             "\tIf the emulator is not streaming or another consumer is reading the stream."
+);
+
+static PyObject*
+snek8_emulatorWaitFrames(PyObject* self, PyObject* args, PyObject* kwargs){
+    PyObject* timeout = Py_None;
+    char* kwlist[] = {
+        "timeout",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", kwlist, &timeout)){
+        return NULL;
+    }
+    PyTime_t ns = -1;
+    if (Py_None != timeout){
+        double seconds = PyFloat_AsDouble(timeout);
+        if (seconds < 0.0 && PyErr_Occurred()){
+            return NULL;
+        }
+        if (!(seconds >= 0.0 && seconds <= (double) PY_TIMEOUT_MAX / 1e6)){
+            PyErr_SetString(PyExc_ValueError, "The timeout must be None or a non-negative number of seconds.");
+            return NULL;
+        }
+        ns = (PyTime_t) (seconds * 1e9);
+    }
+    Snek8FrameStream* stream = snek8_emulatorGetStream(CAST_PTR(Snek8Emulator, self));
+    if (!stream){
+        return NULL;
+    }
+    bool ready;
+    stream->users++;
+    Py_BEGIN_ALLOW_THREADS
+    ready = snek8_frameStreamWait(stream, ns);
+    Py_END_ALLOW_THREADS
+    stream->users--;
+    return PyBool_FromLong((long) ready);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_WAIT_FRAMES,
+             "waitFrames(timeout: float | None = None) -> bool\n\n"
+             "Wait, without the GIL, until the stream queued frames. An asyncio consumer runs it\n"
+             "in an executor, e.g. await loop.run_in_executor(None, emulator.waitFrames, 0.1),\n"
+             "then drains the queue.\n"
+             "Attributes\n"
+             "----------\n"
+             "timeout: float | None\n"
+             "\tThe longest wait in seconds, None to wait until a frame is queued.\n"
+             "Returns\n"
+             "-------\n"
+             "bool\n"
+             "\tWhether frames are queued.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf timeout is negative.\n"
+             "RuntimeError\n"
+             "\tIf the emulator is not streaming."
+);
+
+static PyObject*
+snek8_emulatorGetDroppedFrames(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8FrameStream* stream = snek8_emulatorGetStream(CAST_PTR(Snek8Emulator, self));
+    if (!stream){
+        return NULL;
+    }
+    return PyLong_FromUnsignedLongLong(atomic_load_explicit(&stream->stream->dropped, memory_order_relaxed));
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_DROPPED_FRAMES,
+             "getDroppedFrames() -> int\n\n"
+             "Retrieve the number of frames the stream dropped because its queue was full.\n"
+             "Their sequence numbers are skipped, and the frame after them is a keyframe.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe number of frames dropped since startStream.\n"
+             "Raises\n"
+             "------\n"
+             "RuntimeError\n"
+             "\tIf the emulator is not streaming."
+);
+
+/**
+* @brief Take the emulator's CPU to change its breakpoints, allocating its debugger if
+* it has none.
+*
+* @return The debugger, or NULL with an exception set on failure (the CPU is then
+* released).
+*/
+static Snek8Debugger*
+snek8_emulatorAcquireDebugger(Snek8Emulator* emulator){
+    if (snek8_emulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+    if (!emulator->ob_debugger){
+        emulator->ob_debugger = snek8_debugNew();
+        if (!emulator->ob_debugger){
+            snek8_emulatorRelease(emulator);
+            PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for the debugger");
+        }
+    }
+    return emulator->ob_debugger;
+}
+
+/**
+* @brief Raise the exception of a failed debugger operation.
+*
+* @return NULL.
+*/
+static PyObject*
+snek8_debugRaise(enum Snek8ExecutionOutput out){
+    switch (out){
+        case SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS:
+            PyErr_Format(PyExc_ValueError, "The addresses must lie within the %d bytes of the memory.",
+                         SNEK8_SIZE_RAM);
+            break;
+        case SNEK8_EXECOUT_OUT_OF_MEMORY:
+            PyErr_Format(PyExc_RuntimeError, "At most %d conditional breakpoints can be set.",
+                         SNEK8_DEBUG_MAX_CONDITIONS);
+            break;
+        default:
+            PyErr_SetString(PyExc_ValueError, "Invalid register, comparison, value or access.");
+            break;
+    }
+    return NULL;
+}
+
+static PyObject*
+snek8_emulatorAddBreakpoint(PyObject* self, PyObject* args, PyObject* kwargs){
+    unsigned int address;
+    PyObject* reg = Py_None;
+    int compare = SNEK8_DEBUG_EQ;
+    unsigned int value = 0;
+    char* kwlist[] = {
+        "address",
+        "register",
+        "compare",
+        "value",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "I|OiI", kwlist, &address, &reg, &compare, &value)){
+        return NULL;
+    }
+    Snek8DebugCondition condition = {.address = 0, .reg = 0, .compare = 0, .value = 0};
+    if (Py_None != reg){
+        long index = PyLong_AsLong(reg);
+        if (index == -1 && PyErr_Occurred()){
+            return NULL;
+        }
+        if (index < 0 || index > SNEK8_DEBUG_REG_I || compare < 0 || compare >= SNEK8_DEBUG_COMPARE_COUNT
+            || value > UINT16_MAX){
+            return snek8_debugRaise(SNEK8_EXECOUT_INDEX_OUT_RANGE);
+        }
+        condition.reg = (uint8_t) index;
+        condition.compare = (uint8_t) compare;
+        condition.value = (uint16_t) value;
+    }
+    if (address > UINT16_MAX){
+        return snek8_debugRaise(SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS);
+    }
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    Snek8Debugger* debugger = snek8_emulatorAcquireDebugger(emulator);
+    if (!debugger){
+        return NULL;
+    }
+    enum Snek8ExecutionOutput out = snek8_debugSetBreakpoint(debugger, (uint16_t) address,
+                                                             (Py_None != reg)? &condition: NULL);
+    snek8_emulatorRelease(emulator);
+    if (SNEK8_EXECOUT_SUCCESS != out){
+        return snek8_debugRaise(out);
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_ADD_BREAKPOINT,
+             "addBreakpoint(address: int, register: int | None = None, compare: int = DEBUG_EQ,\n"
+             "              value: int = 0) -> None\n\n"
+             "Stop the runs before the instruction at an address executes, optionally only\n"
+             "when `register compare value` holds. An address with several breakpoints stops\n"
+             "the runs when any of them does. A run that starts at the breakpoint the previous\n"
+             "run stopped at executes its instruction instead of stopping again.\n\n"
+             "While breakpoints or watchpoints are set, the emulator runs (emulationRun,\n"
+             "emulationFrame and the worker) one instruction at a time with the reference\n"
+             "handlers, checking them; its engine takes over again once they are all removed.\n"
+             "Attributes\n"
+             "----------\n"
+             "address: int\n"
+             "\tThe address of the instruction.\n"
+             "register: int | None\n"
+             "\tThe register of the condition, 0x0 to 0xF for V0 to VF or DEBUG_REG_I, or None\n"
+             "\tfor an unconditional breakpoint.\n"
+             "compare: int\n"
+             "\tDEBUG_EQ, DEBUG_NE, DEBUG_LT, DEBUG_LE, DEBUG_GT or DEBUG_GE.\n"
+             "value: int\n"
+             "\tThe value the register is compared with.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf the address, register, comparison or value is invalid.\n"
+             "RuntimeError\n"
+             "\tIf the emulator is running on another thread or DEBUG_MAX_CONDITIONS\n"
+             "\tconditional breakpoints are set."
+);
+
+static PyObject*
+snek8_emulatorRemoveBreakpoint(PyObject* self, PyObject* args, PyObject* kwargs){
+    unsigned int address;
+    char* kwlist[] = {
+        "address",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "I", kwlist, &address)){
+        return NULL;
+    }
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (snek8_emulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+    bool removed = emulator->ob_debugger && address <= UINT16_MAX
+                   && snek8_debugClearBreakpoint(emulator->ob_debugger, (uint16_t) address);
+    snek8_emulatorRelease(emulator);
+    return PyBool_FromLong((long) removed);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_REMOVE_BREAKPOINT,
+             "removeBreakpoint(address: int) -> bool\n\n"
+             "Remove the breakpoints of an address, conditional or not.\n"
+             "Attributes\n"
+             "----------\n"
+             "address: int\n"
+             "\tThe address of the instruction.\n"
+             "Returns\n"
+             "-------\n"
+             "bool\n"
+             "\tWhether the address had breakpoints.\n"
+             "Raises\n"
+             "------\n"
+             "RuntimeError\n"
+             "\tIf the emulator is running on another thread."
+);
+
+/**
+* @brief Common implementation of addWatchpoint and removeWatchpoint.
+*/
+static PyObject*
+snek8_emulatorWatch(PyObject* self, PyObject* args, PyObject* kwargs, int access, bool watch){
+    unsigned int address;
+    Py_ssize_t size = 1;
+    char* kwlist[] = {
+        "address",
+        "size",
+        "access",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "I|ni", kwlist, &address, &size, &access)){
+        return NULL;
+    }
+    if (address > UINT16_MAX || size < 0){
+        return snek8_debugRaise(SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS);
+    }
+    if (access < 0 || access > UINT8_MAX){
+        return snek8_debugRaise(SNEK8_EXECOUT_INDEX_OUT_RANGE);
+    }
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    Snek8Debugger* debugger = snek8_emulatorAcquireDebugger(emulator);
+    if (!debugger){
+        return NULL;
+    }
+    enum Snek8ExecutionOutput out = snek8_debugWatch(debugger, (uint16_t) address, (size_t) size,
+                                                     (uint8_t) access, watch);
+    snek8_emulatorRelease(emulator);
+    if (SNEK8_EXECOUT_SUCCESS != out){
+        return snek8_debugRaise(out);
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject*
+snek8_emulatorAddWatchpoint(PyObject* self, PyObject* args, PyObject* kwargs){
+    return snek8_emulatorWatch(self, args, kwargs, SNEK8_DEBUG_WATCH_WRITE, true);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_ADD_WATCHPOINT,
+             "addWatchpoint(address: int, size: int = 1, access: int = DEBUG_WATCH_WRITE) -> None\n\n"
+             "Stop the runs right after an instruction accessed a byte of a range of the\n"
+             "memory through the index register: DRW and LD VX, [I] read it, LD B, VX and\n"
+             "LD [I], VX write it. See addBreakpoint for how the emulator runs meanwhile.\n"
+             "Attributes\n"
+             "----------\n"
+             "address: int\n"
+             "\tThe first byte of the range.\n"
+             "size: int\n"
+             "\tThe number of bytes of the range.\n"
+             "access: int\n"
+             "\tA bitwise or combination of DEBUG_WATCH_READ and DEBUG_WATCH_WRITE.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf the range does not fit the memory or access is invalid.\n"
+             "RuntimeError\n"
+             "\tIf the emulator is running on another thread."
+);
+
+static PyObject*
+snek8_emulatorRemoveWatchpoint(PyObject* self, PyObject* args, PyObject* kwargs){
+    return snek8_emulatorWatch(self, args, kwargs, SNEK8_DEBUG_WATCH, false);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_REMOVE_WATCHPOINT,
+             "removeWatchpoint(address: int, size: int = 1,\n"
+             "                 access: int = DEBUG_WATCH_READ | DEBUG_WATCH_WRITE) -> None\n\n"
+             "Stop watching the accesses to a range of the memory.\n"
+             "Attributes\n"
+             "----------\n"
+             "address: int\n"
+             "\tThe first byte of the range.\n"
+             "size: int\n"
+             "\tThe number of bytes of the range.\n"
+             "access: int\n"
+             "\tThe accesses no longer watched.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf the range does not fit the memory or access is invalid.\n"
+             "RuntimeError\n"
+             "\tIf the emulator is running on another thread."
+);
+
+static PyObject*
+snek8_emulatorClearBreakpoints(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (snek8_emulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+    snek8_debugDel(emulator->ob_debugger);
+    emulator->ob_debugger = NULL;
+    snek8_emulatorRelease(emulator);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_CLEAR_BREAKPOINTS,
+             "clearBreakpoints() -> None\n\n"
+             "Remove every breakpoint and watchpoint, and forget the last break.\n"
+             "Raises\n"
+             "------\n"
+             "RuntimeError\n"
+             "\tIf the emulator is running on another thread."
+);
+
+static PyObject*
+snek8_emulatorGetBreak(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (snek8_emulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+    Snek8DebugHit hit = {.stop = SNEK8_RUNSTOP_CYCLES, .pc = 0, .address = 0, .access = 0};
+    if (emulator->ob_debugger){
+        hit = emulator->ob_debugger->hit;
+    }
+    snek8_emulatorRelease(emulator);
+    if (SNEK8_RUNSTOP_CYCLES == hit.stop){
+        Py_RETURN_NONE;
+    }
+    return Py_BuildValue("(iiii)", (int) hit.stop, (int) hit.pc, (int) hit.address, (int) hit.access);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_BREAK,
+             "getBreak() -> Tuple[int, int, int, int] | None\n\n"
+             "Retrieve where the last run stopped at a breakpoint or a watchpoint. A worker\n"
+             "thread that reached one exits its loop (see isWorkerRunning), and has to be\n"
+             "stopped before calling this method.\n"
+             "Returns\n"
+             "-------\n"
+             "Tuple[int, int, int, int] | None\n"
+             "\tRUNSTOP_BREAKPOINT or RUNSTOP_WATCHPOINT, the address of the instruction (the\n"
+             "\tone about to execute at a breakpoint, the one that accessed the memory at a\n"
+             "\twatchpoint), the first watched byte accessed (the same address at a\n"
+             "\tbreakpoint) and DEBUG_WATCH_READ or DEBUG_WATCH_WRITE (0 at a breakpoint);\n"
+             "\tNone if the last run did not stop at any.\n"
+             "Raises\n"
+             "------\n"
+             "RuntimeError\n"
+             "\tIf the emulator is running on another thread."
+);
+
+/**
+* @brief Set `value` as the item `key` of `dict`, stealing the reference to `value`.
+*
+* @return 0 on success, -1 with an exception set otherwise.
+*/
+static int
+snek8_dictSetSteal(PyObject* dict, const char* key, PyObject* value){
+    if (!value){
+        return -1;
+    }
+    int result = PyDict_SetItemString(dict, key, value);
+    Py_DECREF(value);
+    return result;
+}
+
+static PyObject*
+snek8_emulatorStats(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (snek8_emulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+#if SNEK8_STATS
+    Snek8Stats stats = emulator->ob_cpu.stats;
+    uint64_t fetches = emulator->ob_fetches;
+    PyTime_t fetch_ns = emulator->ob_fetch_ns;
+#else
+    Snek8Stats stats = {0};
+    uint64_t fetches = 0;
+    PyTime_t fetch_ns = 0;
+#endif
+    snek8_emulatorRelease(emulator);
+    PyObject* families = PyDict_New();
+    PyObject* dict = PyDict_New();
+    if (!families || !dict){
+        goto error;
+    }
+    for (size_t i = 0; i < SNEK8_INSTRUC_COUNT; i++){
+        if (snek8_dictSetSteal(families, snek8_familyName((enum Snek8InstructionFamily) i),
+                               PyLong_FromUnsignedLongLong(stats.families[i])) < 0){
+            goto error;
+        }
+    }
+    if (snek8_dictSetSteal(dict, "enabled", PyBool_FromLong(SNEK8_STATS)) < 0
+        || PyDict_SetItemString(dict, "families", families) < 0
+        || snek8_dictSetSteal(dict, "cycles", PyLong_FromUnsignedLongLong(stats.cycles)) < 0
+        || snek8_dictSetSteal(dict, "drw_pixels", PyLong_FromUnsignedLongLong(stats.drw_pixels)) < 0
+        || snek8_dictSetSteal(dict, "drw_collisions", PyLong_FromUnsignedLongLong(stats.drw_collisions)) < 0
+        || snek8_dictSetSteal(dict, "skipped_cycles", PyLong_FromUnsignedLongLong(stats.skipped_cycles)) < 0
+        || snek8_dictSetSteal(dict, "wait_cycles", PyLong_FromUnsignedLongLong(stats.wait_cycles)) < 0
+        || snek8_dictSetSteal(dict, "fetches", PyLong_FromUnsignedLongLong(fetches)) < 0
+        || snek8_dictSetSteal(dict, "fetch_ns", PyLong_FromLongLong((long long) fetch_ns)) < 0){
+        goto error;
+    }
+    Py_DECREF(families);
+    return dict;
+error:
+    Py_XDECREF(families);
+    Py_XDECREF(dict);
+    return NULL;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_STATS,
+             "stats() -> Dict[str, Any]\n\n"
+             "Retrieve the execution statistics collected since the emulator was initialized\n"
+             "or resetStats was called. They are only collected if the module was built with\n"
+             "SNEK8_STATS on (see the STATS constant); otherwise every counter is 0.\n"
+             "Returns\n"
+             "-------\n"
+             "Dict[str, Any]\n"
+             "\tenabled: bool, whether the statistics are collected;\n"
+             "\tfamilies: Dict[str, int], the instructions executed per family (e.g. 'DRW_VX_VY_N'),\n"
+             "\tLD_VX_K counting once per wait rather than once per cycle waited;\n"
+             "\tcycles: int, the instructions retired, i.e. the sum of families, skipped_cycles\n"
+             "\tand wait_cycles;\n"
+             "\tdrw_pixels: int, the sprite pixels drawn;\n"
+             "\tdrw_collisions: int, the DRW that erased a pixel;\n"
+             "\tskipped_cycles: int, the instructions of idle loops retired without being\n"
+             "\texecuted, which count in cycles but not in families;\n"
+             "\twait_cycles: int, the idle cycles retired while LD VX, K waited for a key,\n"
+             "\twhich count in cycles but not in families;\n"
+             "\tfetches: int, the screen fetches (getGraphics, getDamage, getFrame, blit,\n"
+             "\tisPixelActive and the buffer exports);\n"
+             "\tfetch_ns: int, the time spent in those fetches, in nanoseconds.\n"
+             "Raises\n"
+             "------\n"
+             "RuntimeError\n"
+             "\tIf the emulator is running on another thread."
+);
+
+static PyObject*
+snek8_emulatorResetStats(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8Emulator* emulator = CAST_PTR(Snek8Emulator, self);
+    if (snek8_emulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+#if SNEK8_STATS
+    snek8_statsClear(&emulator->ob_cpu.stats);
+    emulator->ob_fetches = 0;
+    emulator->ob_fetch_ns = 0;
+#endif
+    snek8_emulatorRelease(emulator);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_RESET_STATS,
+             "resetStats() -> None\n\n"
+             "Zero the execution statistics (see stats).\n"
+             "Raises\n"
+             "------\n"
+             "RuntimeError\n"
+             "\tIf the emulator is running on another thread."
+);
+
+/**
+* @brief Analyze the program in the emulator's memory, copied into `memory`
+* (`SNEK8_SIZE_RAM` bytes) so that the analysis runs without holding the emulator.
+*
+* @return The analysis, to be freed with `PyMem_RawFree`, or NULL with an exception
+* set.
+*/
+static Snek8Analysis*
+snek8_emulatorAnalysis(Snek8Emulator* emulator, uint8_t* memory){
+    Snek8Analysis* analysis = PyMem_RawMalloc(sizeof(Snek8Analysis));
+    if (!analysis){
+        PyErr_NoMemory();
+        return NULL;
+    }
+    if (snek8_emulatorAcquire(emulator) < 0){
+        PyMem_RawFree(analysis);
+        return NULL;
+    }
+    (void) memcpy(memory, emulator->ob_cpu.memory, SNEK8_SIZE_RAM);
+    size_t rom_size = emulator->ob_boot? emulator->ob_boot->size: 0;
+    uint8_t implm_flags = emulator->ob_cpu.implm_flags;
+    snek8_emulatorRelease(emulator);
+    (void) snek8_disasmAnalyze(analysis, memory, rom_size, implm_flags);
+    return analysis;
+}
+
+/**
+* @brief The runs of consecutive addresses having a flag, as (start, end) tuples.
+*/
+static PyObject*
+snek8_analysisRanges(const Snek8Analysis* analysis, uint8_t flag){
+    PyObject* ranges = PyList_New(0);
+    if (!ranges){
+        return NULL;
+    }
+    for (size_t addr = 0; addr < SNEK8_SIZE_RAM; addr++){
+        if (!(analysis->flags[addr] & flag)){
+            continue;
+        }
+        size_t start = addr;
+        while (addr < SNEK8_SIZE_RAM && (analysis->flags[addr] & flag)){
+            addr++;
+        }
+        PyObject* range = Py_BuildValue("(nn)", (Py_ssize_t) start, (Py_ssize_t) addr);
+        if (!range || PyList_Append(ranges, range) < 0){
+            Py_XDECREF(range);
+            Py_DECREF(ranges);
+            return NULL;
+        }
+        Py_DECREF(range);
+    }
+    return ranges;
+}
+
+/**
+* @brief The addresses having every flag of `flags`.
+*/
+static PyObject*
+snek8_analysisAddresses(const Snek8Analysis* analysis, uint8_t flags){
+    PyObject* addresses = PyList_New(0);
+    if (!addresses){
+        return NULL;
+    }
+    for (size_t addr = 0; addr < SNEK8_SIZE_RAM; addr++){
+        if ((analysis->flags[addr] & flags) != flags){
+            continue;
+        }
+        PyObject* value = PyLong_FromSize_t(addr);
+        if (!value || PyList_Append(addresses, value) < 0){
+            Py_XDECREF(value);
+            Py_DECREF(addresses);
+            return NULL;
+        }
+        Py_DECREF(value);
+    }
+    return addresses;
+}
+
+static PyObject*
+snek8_emulatorDisassemble(PyObject* self, PyObject* args){
+    UNUSED(args);
+    uint8_t bytes[SNEK8_SIZE_RAM];
+    Snek8Analysis* analysis = snek8_emulatorAnalysis(CAST_PTR(Snek8Emulator, self), bytes);
+    if (!analysis){
+        return NULL;
+    }
+    PyObject* listing = PyList_New(0);
+    if (!listing){
+        PyMem_RawFree(analysis);
+        return NULL;
+    }
+    char text[SNEK8_DISASM_SIZE_TEXT];
+    size_t addr = 0;
+    while (addr < SNEK8_SIZE_RAM){
+        uint8_t flags = analysis->flags[addr];
+        PyObject* line = NULL;
+        if (flags & SNEK8_ANALYSIS_INSTRUC){
+            uint16_t opcode = (uint16_t) (bytes[addr] << 8) | bytes[(addr + 1) & SNEK8_MEM_ADDR_RAM_END];
+            (void) snek8_disasmFormat(opcode, text, SNEK8_DISASM_SIZE_TEXT);
+            line = Py_BuildValue("(nks)", (Py_ssize_t) addr, (unsigned long) opcode, text);
+            // Instructions overlapping this one are listed too.
+            addr += (analysis->flags[(addr + 1) & SNEK8_MEM_ADDR_RAM_END] & SNEK8_ANALYSIS_INSTRUC)? 1: 2;
+        }
+        else if (flags & SNEK8_ANALYSIS_DATA){
+            (void) snprintf(text, SNEK8_DISASM_SIZE_TEXT, "DB 0x%02X", bytes[addr]);
+            line = Py_BuildValue("(nks)", (Py_ssize_t) addr, (unsigned long) bytes[addr], text);
+            addr++;
+        }
+        else{
+            addr++;
+            continue;
+        }
+        if (!line || PyList_Append(listing, line) < 0){
+            Py_XDECREF(line);
+            Py_DECREF(listing);
+            PyMem_RawFree(analysis);
+            return NULL;
+        }
+        Py_DECREF(line);
+    }
+    PyMem_RawFree(analysis);
+    return listing;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_DISASSEMBLE,
+             "disassemble() -> List[Tuple[int, int, str]]\n\n"
+             "Disassemble the program in the emulator's memory: the instructions reachable\n"
+             "from PROG_START (see analyze), and the other bytes of the ROM as data.\n"
+             "Returns\n"
+             "-------\n"
+             "List[Tuple[int, int, str]]\n"
+             "\tBy increasing address, (address, opcode, text) for the instructions, e.g.\n"
+             "\t(0x200, 0xD1A5, 'DRW V1, VA, 0x5'), and (address, byte, text) for the data,\n"
+             "\te.g. (0x21E, 0x3C, 'DB 0x3C'). Invalid instructions read 'DW 0xNNNN'.\n"
+             "Raises\n"
+             "------\n"
+             "RuntimeError\n"
+             "\tIf the emulator is running on another thread."
+);
+
+static PyObject*
+snek8_emulatorAnalyze(PyObject* self, PyObject* args){
+    UNUSED(args);
+    uint8_t memory[SNEK8_SIZE_RAM];
+    Snek8Analysis* analysis = snek8_emulatorAnalysis(CAST_PTR(Snek8Emulator, self), memory);
+    if (!analysis){
+        return NULL;
+    }
+    PyObject* dict = PyDict_New();
+    PyObject* blocks = PyList_New((Py_ssize_t) analysis->blocks_count);
+    if (!dict || !blocks){
+        goto error;
+    }
+    for (size_t i = 0; i < analysis->blocks_count; i++){
+        const Snek8AnalysisBlock* block = &analysis->blocks[i];
+        PyObject* successors = PyTuple_New(block->successors_count);
+        if (!successors){
+            goto error;
+        }
+        for (uint8_t j = 0; j < block->successors_count; j++){
+            PyObject* successor = PyLong_FromUnsignedLong(block->successors[j]);
+            if (!successor){
+                Py_DECREF(successors);
+                goto error;
+            }
+            PyTuple_SET_ITEM(successors, j, successor);
+        }
+        PyObject* item = Py_BuildValue("(kksN)", (unsigned long) block->start,
+                                       (unsigned long) ((block->start + 2 * block->length) & SNEK8_MEM_ADDR_RAM_END),
+                                       snek8_analysisExitName((enum Snek8AnalysisExit) block->exit),
+                                       successors);
+        if (!item){
+            goto error;
+        }
+        PyList_SET_ITEM(blocks, (Py_ssize_t) i, item);
+    }
+    if (PyDict_SetItemString(dict, "blocks", blocks) < 0
+        || snek8_dictSetSteal(dict, "instructions", PyLong_FromSize_t(analysis->instructions)) < 0
+        || snek8_dictSetSteal(dict, "code", snek8_analysisRanges(analysis, SNEK8_ANALYSIS_CODE)) < 0
+        || snek8_dictSetSteal(dict, "data", snek8_analysisRanges(analysis, SNEK8_ANALYSIS_DATA)) < 0
+        || snek8_dictSetSteal(dict, "reads", snek8_analysisRanges(analysis, SNEK8_ANALYSIS_READ)) < 0
+        || snek8_dictSetSteal(dict, "writes", snek8_analysisRanges(analysis, SNEK8_ANALYSIS_WRITTEN)) < 0
+        || snek8_dictSetSteal(dict, "self_modifying",
+                              snek8_analysisAddresses(analysis, SNEK8_ANALYSIS_CODE | SNEK8_ANALYSIS_WRITTEN)) < 0
+        || snek8_dictSetSteal(dict, "unresolved_writes", PyLong_FromSize_t(analysis->unresolved_writes)) < 0
+        || snek8_dictSetSteal(dict, "invalid", snek8_analysisAddresses(analysis, SNEK8_ANALYSIS_INVALID)) < 0
+        || snek8_dictSetSteal(dict, "indirect", snek8_analysisAddresses(analysis, SNEK8_ANALYSIS_INDIRECT)) < 0){
+        goto error;
+    }
+    Py_DECREF(blocks);
+    PyMem_RawFree(analysis);
+    return dict;
+error:
+    Py_XDECREF(blocks);
+    Py_XDECREF(dict);
+    PyMem_RawFree(analysis);
+    return NULL;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_ANALYZE,
+             "analyze() -> Dict[str, Any]\n\n"
+             "Analyze the program in the emulator's memory without running it: walk the code\n"
+             "reachable from PROG_START through the jumps, calls and skips, split it into\n"
+             "basic blocks and follow the index register inside each block to find the\n"
+             "bytes the program reads and writes. A program whose 'invalid' list is empty\n"
+             "never stops with EXECOUT_INVALID_OPCODE, unless it jumps where the analysis\n"
+             "cannot follow ('indirect') or modifies its code ('self_modifying',\n"
+             "'unresolved_writes').\n"
+             "Returns\n"
+             "-------\n"
+             "Dict[str, Any]\n"
+             "\tblocks: List[Tuple[int, int, str, Tuple[int, ...]]], the basic blocks by\n"
+             "\tincreasing address, as (start, end, exit, successors): exit is one of\n"
+             "\t'FALLTHROUGH', 'JUMP', 'CALL', 'RETURN', 'SKIP', 'INDIRECT' and 'INVALID',\n"
+             "\tthe successors are the addresses of the blocks executed next;\n"
+             "\tinstructions: int, the number of reachable instructions;\n"
+             "\tcode: List[Tuple[int, int]], the (start, end) ranges of the reachable code;\n"
+             "\tdata: List[Tuple[int, int]], the ranges of the ROM that are not code;\n"
+             "\treads: List[Tuple[int, int]], the ranges read by DRW and LD VX, [I];\n"
+             "\twrites: List[Tuple[int, int]], the ranges written by LD B, VX and\n"
+             "\tLD [I], VX;\n"
+             "\tself_modifying: List[int], the code bytes that are written;\n"
+             "\tunresolved_writes: int, the writes whose address the analysis cannot tell;\n"
+             "\tinvalid: List[int], the addresses of the reachable invalid instructions;\n"
+             "\tindirect: List[int], the addresses of the reachable JP V0, NNN.\n"
+             "Raises\n"
+             "------\n"
+             "RuntimeError\n"
+             "\tIf the emulator is running on another thread."
+);
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-function-type"
+
+static struct PyMethodDef snek8_emulator_methods[] = {
+    {
+        .ml_name = "getMode",
+        .ml_meth = snek8_emulatorGetFlags,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_FLAGS,
+    },
+    {
+        .ml_name = "getPC",
+        .ml_meth = snek8_emulatorGetPC,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_PC,
+    },
+    {
+        .ml_name = "getIR",
+        .ml_meth = snek8_emulatorGetIR,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_IR,
+    },
+    {
+        .ml_name = "getDT",
+        .ml_meth = snek8_emulatorGetDT,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_DT,
+    },
+    {
+        .ml_name = "getCycles",
+        .ml_meth = snek8_emulatorGetCycles,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_CYCLES,
+    },
+    {
+        .ml_name = "getIPS",
+        .ml_meth = snek8_emulatorGetIPS,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_IPS,
+    },
+    {
+        .ml_name = "setIPS",
+        .ml_meth = (PyCFunction) snek8_emulatorSetIPS,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_SET_IPS,
+    },
+    {
+        .ml_name = "getST",
+        .ml_meth = snek8_emulatorGetST,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_ST,
+    },
+    {
+        .ml_name = "getSP",
+        .ml_meth = snek8_emulatorGetSP,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_SP,
+    },
+    {
+        .ml_name = "getGraphics",
+        .ml_meth = snek8_emulatorGetGraphics,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_GRAPHICS,
+    },
+    {
+        .ml_name = "getDamage",
+        .ml_meth = snek8_emulatorGetDamage,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_DAMAGE,
+    },
+    {
+        .ml_name = "getGraphicsGeneration",
+        .ml_meth = snek8_emulatorGetGraphicsGeneration,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_GRAPHICS_GEN,
+    },
+    {
+        .ml_name = "isPixelActive",
+        .ml_meth = (PyCFunction) snek8_emulatorIsPixelActive,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_IS_PIXEL_ACT,
+    },
+    {
+        .ml_name = "getStack",
+        .ml_meth = snek8_emulatorGetStack,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_STACK,
+    },
+    {
+        .ml_name = "getRegisters",
+        .ml_meth = snek8_emulatorGetRegisters,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_REGISTERS,
+    },
+    {
+        .ml_name = "getRegister",
+        .ml_meth = (PyCFunction) snek8_emulatorGetRegister,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_REGISTER,
+    },
+    {
+        .ml_name = "loadRom",
+        .ml_meth = (PyCFunction) snek8_emulatorLoadRom,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_LOAD_ROM,
+    },
+    {
+        .ml_name = "loadRomBytes",
+        .ml_meth = (PyCFunction) snek8_emulatorLoadRomBytes,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_LOAD_ROM_BYTES,
+    },
+    {
+        .ml_name = "reset",
+        .ml_meth = (PyCFunction) snek8_emulatorReset,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_RESET,
+    },
+    {
+        .ml_name = "turnFlagsOn",
+        .ml_meth = (PyCFunction) snek8_emulatorTurnFlagsOn,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_TURN_FLAGS_ON,
+    },
+    {
+        .ml_name = "turnFlagsOff",
+        .ml_meth = (PyCFunction) snek8_emulatorTurnFlagsOff,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_TURN_FLAGS_OFF,
+    },
+    {
+        .ml_name = "setRunning",
+        .ml_meth = (PyCFunction) snek8_emulatorSetRunning,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_SET_RUNNING,
+    },
+    {
+        .ml_name = "getKeyValue",
+        .ml_meth = (PyCFunction) snek8_emulatorGetKeyValue,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_KEY_VALUE,
+    },
+    {
+        .ml_name = "setKeyValue",
+        .ml_meth = (PyCFunction) snek8_emulatorSetKeyValue,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_SET_KEY_VALUE,
+    },
+    {
+        .ml_name = "getEngine",
+        .ml_meth = snek8_emulatorGetEngine,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_ENGINE,
+    },
+    {
+        .ml_name = "setEngine",
+        .ml_meth = (PyCFunction) snek8_emulatorSetEngine,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_SET_ENGINE,
+    },
+    {
+        .ml_name = "_execOpc",
+        .ml_meth = (PyCFunction) _snek8_emulatorExecOpc,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_EXEC_OPT,
+    },
+    {
+        .ml_name = "emulationStep",
+        .ml_meth = snek8_emulatorEmulationStep,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_EMU_STEP,
+    },
+    {
+        .ml_name = "emulationRun",
+        .ml_meth = (PyCFunction) snek8_emulatorEmulationRun,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_EMU_RUN,
+    },
+    {
+        .ml_name = "emulationFrame",
+        .ml_meth = (PyCFunction) snek8_emulatorEmulationFrame,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_EMU_FRAME,
+    },
+    {
+        .ml_name = "saveState",
+        .ml_meth = (PyCFunction) snek8_emulatorSaveState,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_SAVE_STATE,
+    },
+    {
+        .ml_name = "loadState",
+        .ml_meth = (PyCFunction) snek8_emulatorLoadState,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_LOAD_STATE,
+    },
+    {
+        .ml_name = "setRewindBudget",
+        .ml_meth = (PyCFunction) snek8_emulatorSetRewindBudget,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_SET_REWIND_BUDGET,
+    },
+    {
+        .ml_name = "getRewindFrames",
+        .ml_meth = snek8_emulatorGetRewindFrames,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_REWIND_FRAMES,
+    },
+    {
+        .ml_name = "rewind",
+        .ml_meth = (PyCFunction) snek8_emulatorRewind,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_REWIND,
+    },
+    {
+        .ml_name = "startRecording",
+        .ml_meth = snek8_emulatorStartRecording,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_START_RECORDING,
+    },
+    {
+        .ml_name = "isRecording",
+        .ml_meth = snek8_emulatorIsRecording,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_IS_RECORDING,
+    },
+    {
+        .ml_name = "stopRecording",
+        .ml_meth = snek8_emulatorStopRecording,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_STOP_RECORDING,
+    },
+    {
+        .ml_name = "playReplay",
+        .ml_meth = (PyCFunction) snek8_emulatorPlayReplay,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_PLAY_REPLAY,
+    },
+    {
+        .ml_name = "start",
+        .ml_meth = (PyCFunction) snek8_emulatorStart,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_START,
+    },
+    {
+        .ml_name = "stop",
+        .ml_meth = snek8_emulatorStop,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_STOP,
+    },
+    {
+        .ml_name = "isWorkerRunning",
+        .ml_meth = snek8_emulatorIsWorkerRunning,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_IS_WORKER_RUNNING,
+    },
+    {
+        .ml_name = "getFrame",
+        .ml_meth = snek8_emulatorGetFrame,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_FRAME,
+    },
+    {
+        .ml_name = "blit",
+        .ml_meth = (PyCFunction) snek8_emulatorBlit,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_BLIT,
+    },
+    {
+        .ml_name = "setAudioBuffer",
+        .ml_meth = (PyCFunction) snek8_emulatorSetAudioBuffer,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_SET_AUDIO_BUFFER,
+    },
+    {
+        .ml_name = "getAudioPosition",
+        .ml_meth = snek8_emulatorGetAudioPosition,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_AUDIO_POSITION,
+    },
+    {
+        .ml_name = "startStream",
+        .ml_meth = (PyCFunction) snek8_emulatorStartStream,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_START_STREAM,
+    },
+    {
+        .ml_name = "stopStream",
+        .ml_meth = snek8_emulatorStopStream,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_STOP_STREAM,
+    },
+    {
+        .ml_name = "requestKeyframe",
+        .ml_meth = snek8_emulatorRequestKeyframe,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_REQUEST_KEYFRAME,
+    },
+    {
+        .ml_name = "readFrames",
+        .ml_meth = snek8_emulatorReadFrames,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_READ_FRAMES,
+    },
+    {
+        .ml_name = "readFramesInto",
+        .ml_meth = (PyCFunction) snek8_emulatorReadFramesInto,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_READ_FRAMES_INTO,
+    },
+    {
+        .ml_name = "waitFrames",
+        .ml_meth = (PyCFunction) snek8_emulatorWaitFrames,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_WAIT_FRAMES,
+    },
+    {
+        .ml_name = "getDroppedFrames",
+        .ml_meth = snek8_emulatorGetDroppedFrames,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_DROPPED_FRAMES,
+    },
+    {
+        .ml_name = "addBreakpoint",
+        .ml_meth = (PyCFunction) snek8_emulatorAddBreakpoint,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_ADD_BREAKPOINT,
+    },
+    {
+        .ml_name = "removeBreakpoint",
+        .ml_meth = (PyCFunction) snek8_emulatorRemoveBreakpoint,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_REMOVE_BREAKPOINT,
+    },
+    {
+        .ml_name = "addWatchpoint",
+        .ml_meth = (PyCFunction) snek8_emulatorAddWatchpoint,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_ADD_WATCHPOINT,
+    },
+    {
+        .ml_name = "removeWatchpoint",
+        .ml_meth = (PyCFunction) snek8_emulatorRemoveWatchpoint,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_REMOVE_WATCHPOINT,
+    },
+    {
+        .ml_name = "clearBreakpoints",
+        .ml_meth = snek8_emulatorClearBreakpoints,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_CLEAR_BREAKPOINTS,
+    },
+    {
+        .ml_name = "getBreak",
+        .ml_meth = snek8_emulatorGetBreak,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_BREAK,
+    },
+    {
+        .ml_name = "stats",
+        .ml_meth = snek8_emulatorStats,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_STATS,
+    },
+    {
+        .ml_name = "resetStats",
+        .ml_meth = snek8_emulatorResetStats,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_RESET_STATS,
+    },
+    {
+        .ml_name = "disassemble",
+        .ml_meth = snek8_emulatorDisassemble,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_DISASSEMBLE,
+    },
+    {
+        .ml_name = "analyze",
+        .ml_meth = snek8_emulatorAnalyze,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_ANALYZE,
+    },
+    {NULL},
+};
+#pragma GCC diagnostic pop
+
+static PyObject*
+snek8_moduleClearRomCache(PyObject* module, PyObject* args){
+    UNUSED(module);
+    UNUSED(args);
+    snek8_romCacheClear(&snek8_rom_cache);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_CLEAR_ROM_CACHE,
+             "clearRomCache() -> None\n\n"
+             "Drop every ROM of the module's ROM cache, which holds the ROM_CACHE_SIZE most\n"
+             "recently loaded ROM files for loadRom.\n"
+);
+
+static PyObject*
+snek8_moduleDecodeFrames(PyObject* module, PyObject* args, PyObject* kwargs){
+    UNUSED(module);
+    Py_buffer frames;
+    Py_buffer screen;
+    char* kwlist[] = {
+        "frames",
+        "screen",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "y*w*", kwlist, &frames, &screen)){
+        return NULL;
+    }
+    PyObject* count = NULL;
+    if (SNEK8_SIZE_GRAPHICS_BYTES != screen.len || (uintptr_t) screen.buf % _Alignof(uint64_t)){
+        PyErr_Format(PyExc_ValueError, "The screen must be an aligned buffer of %d bytes.",
+                     (int) SNEK8_SIZE_GRAPHICS_BYTES);
+        goto end;
+    }
+    const uint8_t* data = frames.buf;
+    size_t left = (size_t) frames.len;
+    size_t decoded = 0;
+    while (left){
+        size_t size = snek8_streamDecode(screen.buf, data, left);
+        if (!size){
+            PyErr_Format(PyExc_ValueError, "The frame at offset %zd is not valid.", frames.len - (Py_ssize_t) left);
+            goto end;
+        }
+        data += size;
+        left -= size;
+        decoded++;
+    }
+    count = PyLong_FromSize_t(decoded);
+end:
+    PyBuffer_Release(&frames);
+    PyBuffer_Release(&screen);
+    return count;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_DECODE_FRAMES,
+             "decodeFrames(frames: Buffer, screen: Buffer) -> int\n\n"
+             "Apply frames read from a stream (see Snek8Emulator.startStream) to a screen, in\n"
+             "order. The frames before the first keyframe only decode correctly if the screen\n"
+             "holds the frame they follow.\n"
+             "Attributes\n"
+             "----------\n"
+             "frames: Buffer\n"
+             "\tWhole frames, back to back.\n"
+             "screen: Buffer\n"
+             "\tA writable buffer of SIZE_GRAPHICS_HEIGHT native-endian unsigned 64-bit rows,\n"
+             "\tthe layout of getFrame, e.g. array('Q', bytes(256)).\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe number of frames applied.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf the screen is misaligned or of the wrong size, or a frame is not valid (the\n"
+             "\tframes before it are applied)."
+);
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-function-type"
+static struct PyMethodDef module_meths[] = {
+    {
+        .ml_name = "clearRomCache",
+        .ml_meth = snek8_moduleClearRomCache,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_CLEAR_ROM_CACHE,
+    },
+    {
+        .ml_name = "decodeFrames",
+        .ml_meth = (PyCFunction) snek8_moduleDecodeFrames,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_DECODE_FRAMES,
+    },
+    // {
+    //     .ml_name = "version",
+    //     .ml_meth = version,
+    //     .ml_flags = METH_NOARGS,
+    //     .ml_doc = "Versioning of the project."
+    // },
+    {NULL},
+};
+#pragma GCC diagnostic pop
+
+/*
+* BUFFER PROTOCOL
+* ---------------
+*/
+
+/**
+* @brief Export the screen as a read-only buffer of 64-bit rows.
+*/
+static int
+snek8_emulatorGetBuffer(PyObject* self, Py_buffer* view, int flags){
+    static Py_ssize_t shape[1] = {SNEK8_GRAPHICS_HEIGTH};
+    static Py_ssize_t strides[1] = {sizeof(uint64_t)};
+    if (flags & PyBUF_WRITABLE){
+        PyErr_SetString(PyExc_BufferError, "The screen buffer is read-only.");
+        return -1;
+    }
+    SNEK8_FETCH_BEGIN();
+    view->obj = Py_NewRef(self);
+    view->buf = CAST_PTR(Snek8Emulator, self)->ob_cpu.graphics;
+    view->len = SNEK8_SIZE_GRAPHICS_BYTES;
+    view->readonly = 1;
+    view->itemsize = sizeof(uint64_t);
+    view->format = (flags & PyBUF_FORMAT)? "Q": NULL;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND)? shape: NULL;
+    view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES)? strides: NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+    SNEK8_FETCH_END(self);
+    return 0;
+}
+
+static PyBufferProcs snek8_emulator_as_buffer = {
+    .bf_getbuffer = snek8_emulatorGetBuffer,
+    .bf_releasebuffer = NULL,
+};
+
+static PyTypeObject Snek8EmulatorType = {
+     .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
+     .tp_name = "snek8.core.Snek8Emulator",
+     .tp_basicsize = sizeof(Snek8Emulator),
+     .tp_itemsize = 0,
+     .tp_doc = SNEK8_STR_DOC_SNEK8_EMULATOR,
+     .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+     .tp_new = (newfunc) snek8_emulatorNew,
+     .tp_init = (initproc) snek8_emulatorInit,
+     .tp_dealloc = (destructor) snek8_emulatorDel,
+     .tp_free = snek8_emulatorFree,
+     .tp_members = snek8_emulator_members,
+     .tp_as_buffer = &snek8_emulator_as_buffer,
+     .tp_methods = snek8_emulator_methods,
+};
+
+/*
+* EMULATOR POOL TYPE
+* ------------------
+*/
+
+/**
+* @brief The emulators of a pool, allocated in a single slab.
+*
+* The emulators are laid out every `ob_stride` bytes (a multiple of
+* `SNEK8_CPU_SIZE_HOT`) so that the hot fields of their CPUs start a cache line, and
+* they share the boot image `reset` restores instead of holding a copy each.
+*
+* @param `ob_count` The number of emulators.
+* @param `ob_emulators` The emulators, owned by the pool.
+* @param `ob_implm_flags` The implementation flags the pool was created with.
+* @param `ob_ips` The IPS the pool was created with.
+*/
+typedef struct{
+    PyObject_HEAD
+    Py_ssize_t ob_count;
+    Snek8Emulator** ob_emulators;
+    uint8_t ob_implm_flags;
+    uint32_t ob_ips;
+} Snek8EmulatorPool;
+
+PyDoc_STRVAR(SNEK8_STR_DOC_SNEK8_EMULATOR_POOL,
+             "Snek8EmulatorPool(count: int, implm_flags: int = 0, engine: int = ENGINE_REFERENCE,\n"
+             "                  ips: int = DEFAULT_IPS, seed: int = 0)\n\n"
+             "A pool of independent Snek8Emulator instances, allocated at once.\n\n"
+             "The pool is a sequence: pool[i] is its i-th emulator, which can be used as any\n"
+             "other and outlives the pool if referenced. The emulators are allocated in a single\n"
+             "block, their CPUs aligned to cache lines, and they share the image reset restores,\n"
+             "so that large populations take about half the memory of separate emulators.\n\n"
+             "Parameters\n"
+             "----------\n"
+             "count: int\n"
+             "\tThe number of emulators (at least 1).\n"
+             "implm_flags: int\n"
+             "\tThe implementation flags of all the emulators (see Snek8Emulator).\n"
+             "engine: int\n"
+             "\tThe execution engine of all the emulators.\n"
+             "ips: int\n"
+             "\tThe number of instructions executed per emulated second.\n"
+             "seed: int\n"
+             "\tThe seed of the emulators' random number generators: the emulator i draws the\n"
+             "\tsame numbers as a Snek8Emulator seeded with seed + i.\n"
+);
+
+static void
+snek8_emulatorPoolDel(PyObject* self){
+    Snek8EmulatorPool* pool = CAST_PTR(Snek8EmulatorPool, self);
+    if (pool->ob_emulators){
+        for (Py_ssize_t i = 0; i < pool->ob_count; i++){
+            Py_XDECREF(pool->ob_emulators[i]);
+        }
+        PyMem_Free(pool->ob_emulators);
+    }
+    Py_TYPE(self)->tp_free(self);
+}
+
+/**
+* @brief Allocate the slab of `count` emulators.
+*
+* @param `stride` The distance between two emulators.
+* @param `lead` The offset of the first emulator in the slab.
+* @return The slab, referenced once by the caller, or NULL with a MemoryError set.
+*/
+static Snek8Slab*
+snek8_slabNew(size_t count, size_t* stride, size_t* lead){
+    *stride = (sizeof(Snek8Emulator) + SNEK8_CPU_SIZE_HOT - 1) / SNEK8_CPU_SIZE_HOT * SNEK8_CPU_SIZE_HOT;
+    size_t hot = offsetof(Snek8Emulator, ob_cpu) + offsetof(Snek8CPU, registers);
+    *lead = (SNEK8_CPU_SIZE_HOT - hot % SNEK8_CPU_SIZE_HOT) % SNEK8_CPU_SIZE_HOT;
+    if (count > (SIZE_MAX - 2 * SNEK8_CPU_SIZE_HOT) / *stride){
+        PyErr_SetString(PyExc_MemoryError, "Too many emulators for a pool");
+        return NULL;
+    }
+    size_t size = (*lead + count * *stride + SNEK8_CPU_SIZE_HOT - 1) / SNEK8_CPU_SIZE_HOT * SNEK8_CPU_SIZE_HOT;
+    Snek8Slab* slab = PyMem_Malloc(sizeof(Snek8Slab));
+    void* memory = SNEK8_ALIGNED_ALLOC(SNEK8_CPU_SIZE_HOT, size);
+    if (!slab || !memory){
+        PyMem_Free(slab);
+        SNEK8_ALIGNED_FREE(memory);
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for the emulators");
+        return NULL;
+    }
+    (void) memset(memory, 0, size);
+    slab->live = 1;
+    slab->memory = memory;
+    return slab;
+}
+
+/**
+* @brief C interface for the __new__ method.
+*/
+static PyObject*
+snek8_emulatorPoolNew(PyTypeObject* subtype, PyObject* args, PyObject* kwargs){
+    Py_ssize_t count;
+    int implm_flags = 0;
+    int engine = SNEK8_ENGINE_REFERENCE;
+    long ips = SNEK8_CPU_DEFAULT_IPS;
+    unsigned int seed = 0;
+    char* kwlist[] = {
+        "count",
+        "implm_flags",
+        "engine",
+        "ips",
+        "seed",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n|iilI", kwlist, &count, &implm_flags, &engine, &ips, &seed)){
+        return NULL;
+    }
+    if (count < 1){
+        PyErr_Format(PyExc_ValueError, "The number of emulators must be positive. Value recieved: %zd.", count);
+        return NULL;
+    }
+    if (implm_flags < 0 || (implm_flags & ~SNEK8_IMPLM_MODE_MASK)){
+        PyErr_Format(PyExc_ValueError, "Value %d is invalid for implementation.", implm_flags);
+        return NULL;
+    }
+    if (!snek8_cpuGetRunEngine((enum Snek8Engine) engine)){
+        PyErr_Format(PyExc_ValueError, "Value %d is not a valid engine.", engine);
+        return NULL;
+    }
+    if (ips < 1 || ips > SNEK8_CPU_MAX_IPS){
+        PyErr_Format(PyExc_ValueError, "Value %ld is not a valid number of instructions per second.", ips);
+        return NULL;
+    }
+    Snek8EmulatorPool* pool = CAST_PTR(Snek8EmulatorPool, subtype->tp_alloc(subtype, 0));
+    if (!pool){
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for a new pool");
+        return NULL;
+    }
+    pool->ob_implm_flags = (uint8_t) implm_flags;
+    pool->ob_ips = (uint32_t) ips;
+    pool->ob_emulators = PyMem_Calloc((size_t) count, sizeof(Snek8Emulator*));
+    Snek8Boot* boot = PyMem_Malloc(sizeof(Snek8Boot));
+    size_t stride, lead;
+    Snek8Slab* slab = (pool->ob_emulators && boot)? snek8_slabNew((size_t) count, &stride, &lead): NULL;
+    if (!slab){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for a new pool");
+        }
+        PyMem_Free(boot);
+        Py_DECREF(pool);
+        return NULL;
+    }
+    pool->ob_count = count;
+    boot->refs = 1;
+    boot->rom = false;
+    boot->size = 0;
+    (void) snek8_cpuInit(&boot->cpu, pool->ob_implm_flags);
+    (void) snek8_cpuSetIPS(&boot->cpu, pool->ob_ips);
+    int result = 0;
+    for (Py_ssize_t i = 0; i < count && !result; i++){
+        PyObject* emulator = (PyObject*) ((uint8_t*) slab->memory + lead + (size_t) i * stride);
+        (void) PyObject_Init(emulator, &Snek8EmulatorType);
+        CAST_PTR(Snek8Emulator, emulator)->ob_slab = slab;
+        slab->live++;
+        if (!snek8_emulatorSetUp(emulator)){
+            result = -1;
+            break;
+        }
+        pool->ob_emulators[i] = CAST_PTR(Snek8Emulator, emulator);
+        result = snek8_emulatorConfigure(pool->ob_emulators[i], pool->ob_implm_flags, engine,
+                                         pool->ob_ips, (uint32_t) (seed + (size_t) i), boot);
+    }
+    snek8_bootDrop(boot);
+    snek8_slabDrop(slab);
+    if (result < 0){
+        Py_DECREF(pool);
+        return NULL;
+    }
+    return (PyObject*) pool;
+}
+
+static Py_ssize_t
+snek8_emulatorPoolLength(PyObject* self){
+    return CAST_PTR(Snek8EmulatorPool, self)->ob_count;
+}
+
+static PyObject*
+snek8_emulatorPoolItem(PyObject* self, Py_ssize_t index){
+    Snek8EmulatorPool* pool = CAST_PTR(Snek8EmulatorPool, self);
+    if (index < 0 || index >= pool->ob_count){
+        PyErr_Format(PyExc_IndexError, "Emulator must be between 0 and %zd (incl.). Value recieved: %zd.",
+                     pool->ob_count - 1, index);
+        return NULL;
+    }
+    return Py_NewRef((PyObject*) pool->ob_emulators[index]);
+}
+
+/**
+* @brief Reset every emulator of the pool to a single boot image holding a ROM.
+*
+* @return The execution output as a Python integer, or NULL with an exception set.
+*/
+static PyObject*
+snek8_emulatorPoolLoad(Snek8EmulatorPool* self, const uint8_t* rom, size_t size){
+    Snek8Boot* boot = PyMem_Malloc(sizeof(Snek8Boot));
+    if (!boot){
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for the boot image");
+        return NULL;
+    }
+    boot->refs = 1;
+    (void) snek8_cpuInit(&boot->cpu, self->ob_implm_flags);
+    (void) snek8_cpuSetIPS(&boot->cpu, self->ob_ips);
+    enum Snek8ExecutionOutput out = snek8_cpuLoadRomBytes(&boot->cpu, rom, size);
+    if (SNEK8_EXECOUT_SUCCESS != out){
+        snek8_bootDrop(boot);
+        return PyLong_FromLong((long) out);
+    }
+    boot->rom = true;
+    boot->size = size;
+    Py_ssize_t acquired = 0;
+    while (acquired < self->ob_count && snek8_emulatorAcquireState(self->ob_emulators[acquired]) == 0){
+        acquired++;
+    }
+    for (Py_ssize_t i = 0; i < acquired; i++){
+        Snek8Emulator* emulator = self->ob_emulators[i];
+        if (acquired == self->ob_count){
+            // As reset does, the configuration of the emulator is kept.
+            uint8_t implm_flags = emulator->ob_cpu.implm_flags;
+            uint32_t ips = emulator->ob_cpu.ips;
+            boot->refs++;
+            snek8_bootDrop(emulator->ob_boot);
+            emulator->ob_boot = boot;
+            (void) snek8_cpuReset(&emulator->ob_cpu, &boot->cpu);
+            (void) snek8_cpuSetImplmFlags(&emulator->ob_cpu, implm_flags);
+            (void) snek8_cpuSetIPS(&emulator->ob_cpu, ips);
+            emulator->ob_cpu.rng = emulator->ob_boot_rng;
+            emulator->ob_cpu.keys = (uint16_t) atomic_load(&emulator->ob_keys);
+            if (emulator->ob_rewind){
+                snek8_rewindClear(emulator->ob_rewind);
+            }
+            emulator->ob_last_instruc = NULL;
+            emulator->ob_is_running = true;
+        }
+        snek8_emulatorRelease(emulator);
+    }
+    snek8_bootDrop(boot);
+    if (acquired < self->ob_count){
+        return NULL;
+    }
+    return PyLong_FromLong((long) out);
+}
+
+static PyObject*
+snek8_emulatorPoolLoadRom(PyObject* self, PyObject* args, PyObject* kwargs){
+    const char* rom_filepath = NULL;
+    char* kwlist[] = {
+        "rom_filepath",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s", kwlist, &rom_filepath)){
+        return NULL;
+    }
+    const Snek8Rom* rom = NULL;
+    enum Snek8ExecutionOutput out = snek8_romCacheGet(&snek8_rom_cache, rom_filepath, &rom);
+    if (SNEK8_EXECOUT_SUCCESS != out){
+        return PyLong_FromLong((long) out);
+    }
+    return snek8_emulatorPoolLoad(CAST_PTR(Snek8EmulatorPool, self), rom->data, rom->size);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_POOL_LOAD_ROM,
+             "loadRom(rom_filepath: str) -> int\n\n"
+             "Reset every emulator of the pool to its state right after __init__ and load a\n"
+             "ROM into all of them, read once through the module's ROM cache. The emulators\n"
+             "keep their implementation flags, IPS and engine, and share the loaded image\n"
+             "until one of them loads another ROM.\n"
+             "Attributes\n"
+             "----------\n"
+             "rom_filepath: str\n"
+             "\tThe filepath to the ROM file.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe execution output code representing whether the execution was successeful.\n"
+             "Raises\n"
+             "------\n"
+             "RuntimeError\n"
+             "\tIf an emulator is running on another thread or recording a replay, in which\n"
+             "\tcase none is reset."
+);
+
+static PyObject*
+snek8_emulatorPoolLoadRomBytes(PyObject* self, PyObject* args, PyObject* kwargs){
+    PyObject* data;
+    char* kwlist[] = {
+        "rom",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwlist, &data)){
+        return NULL;
+    }
+    Py_buffer buffer;
+    if (PyObject_GetBuffer(data, &buffer, PyBUF_SIMPLE) < 0){
+        return NULL;
+    }
+    PyObject* result = snek8_emulatorPoolLoad(CAST_PTR(Snek8EmulatorPool, self), buffer.buf, (size_t) buffer.len);
+    PyBuffer_Release(&buffer);
+    return result;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_POOL_LOAD_ROM_BYTES,
+             "loadRomBytes(rom: Buffer) -> int\n\n"
+             "Reset every emulator of the pool and load a ROM held in memory into all of them\n"
+             "(see loadRom).\n"
+             "Attributes\n"
+             "----------\n"
+             "rom: Buffer\n"
+             "\tThe ROM, at most SIZE_MAX_ROM_FILE bytes.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe execution output code representing whether the execution was successeful.\n"
+             "Raises\n"
+             "------\n"
+             "TypeError\n"
+             "\tIf rom does not support the buffer protocol.\n"
+             "RuntimeError\n"
+             "\tIf an emulator is running on another thread or recording a replay."
+);
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-function-type"
+
+static struct PyMethodDef snek8_emulator_pool_methods[] = {
+    {
+        .ml_name = "loadRom",
+        .ml_meth = (PyCFunction) snek8_emulatorPoolLoadRom,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_POOL_LOAD_ROM,
+    },
+    {
+        .ml_name = "loadRomBytes",
+        .ml_meth = (PyCFunction) snek8_emulatorPoolLoadRomBytes,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_POOL_LOAD_ROM_BYTES,
+    },
+    {NULL},
+};
+
+#pragma GCC diagnostic pop
+
+static PySequenceMethods snek8_emulator_pool_as_sequence = {
+    .sq_length = snek8_emulatorPoolLength,
+    .sq_item = snek8_emulatorPoolItem,
+};
+
+static PyTypeObject Snek8EmulatorPoolType = {
+     .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
+     .tp_name = "snek8.core.Snek8EmulatorPool",
+     .tp_basicsize = sizeof(Snek8EmulatorPool),
+     .tp_itemsize = 0,
+     .tp_doc = SNEK8_STR_DOC_SNEK8_EMULATOR_POOL,
+     .tp_flags = Py_TPFLAGS_DEFAULT,
+     .tp_new = (newfunc) snek8_emulatorPoolNew,
+     .tp_dealloc = (destructor) snek8_emulatorPoolDel,
+     .tp_as_sequence = &snek8_emulator_pool_as_sequence,
+     .tp_methods = snek8_emulator_pool_methods,
+};
+
+/*
+* BATCH TYPE
+* ----------
+*/
+
+typedef struct{
+    PyObject_HEAD
+    Snek8Batch* ob_batch;
+    Py_ssize_t ob_lanes;
+    Py_ssize_t ob_shape[2];
+    Py_ssize_t ob_strides[2];
+    Py_ssize_t ob_exports;
+    atomic_int ob_state;
+} Snek8BatchObject;
+
+PyDoc_STRVAR(SNEK8_STR_DOC_SNEK8_BATCH,
+             "Snek8Batch(lanes: int, implm_flags: int = 0, ips: int = DEFAULT_IPS, seed: int = 0)\n\n"
+             "A batch of Chip8 CPUs (the lanes) that run the same ROM in lockstep.\n\n"
+             "The state of the lanes is stored in structure-of-arrays layout, so the steps\n"
+             "in which all the lanes execute the same opcode run vectorized over the lanes;\n"
+             "diverging lanes execute one by one. A lane whose instruction fails halts.\n\n"
+             "Attributes\n"
+             "----------\n"
+             "lanes: int\n"
+             "\tThe number of CPUs of the batch.\n"
+             "\n"
+             "Parameters\n"
+             "----------\n"
+             "lanes: int\n"
+             "\tThe number of CPUs of the batch (at least 1).\n"
+             "implm_flags: int\n"
+             "\tThe implementation flags of all the lanes (see Snek8Emulator).\n"
+             "ips: int\n"
+             "\tThe number of instructions executed per emulated second.\n"
+             "seed: int\n"
+             "\tThe seed of the lanes' random number generators: the lane l draws the same\n"
+             "\tnumbers as a Snek8Emulator seeded with seed + l.\n"
+             "\n"
+             "Note\n"
+             "----\n"
+             "The batch supports the buffer protocol: memoryview(batch) is a read-only view of\n"
+             "the screens as a (lanes, SIZE_GRAPHICS_HEIGHT) array of unsigned 64-bit rows\n"
+             "(format 'Q'), laid out as in Snek8Emulator.\n"
+);
+
+static PyMemberDef snek8_batch_members[] = {
+    {
+        .name = "lanes",
+        .type = Py_T_PYSSIZET,
+        .offset = offsetof(Snek8BatchObject, ob_lanes),
+        .flags = Py_READONLY,
+        .doc = "lanes: int\n\tThe number of CPUs of the batch.",
+    },
+    {NULL},
+};
+
+/**
+* @brief Take the ownership of the batch for the calling method.
+*
+* @return 0 on success, -1 with a RuntimeError set if the batch is in use.
+*/
+static int
+snek8_batchObjectAcquire(Snek8BatchObject* self){
+    int expected = SNEK8_EMULATOR_IDLE;
+    if (!atomic_compare_exchange_strong(&self->ob_state, &expected, SNEK8_EMULATOR_BUSY)){
+        PyErr_SetString(PyExc_RuntimeError, "The batch is already running on another thread.");
+        return -1;
+    }
+    if (!self->ob_batch){
+        atomic_store(&self->ob_state, SNEK8_EMULATOR_IDLE);
+        PyErr_SetString(PyExc_RuntimeError, "The batch is not initialized.");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+* @brief Give back the ownership of the batch taken by `snek8_batchObjectAcquire`.
+*/
+static void
+snek8_batchObjectRelease(Snek8BatchObject* self){
+    atomic_store(&self->ob_state, SNEK8_EMULATOR_IDLE);
+}
+
+static void
+snek8_batchObjectDel(PyObject* self){
+    snek8_batchDel(CAST_PTR(Snek8BatchObject, self)->ob_batch);
+    Py_TYPE(self)->tp_free(self);
+}
+
+static int
+snek8_batchObjectInit(PyObject* self, PyObject* args, PyObject* kwargs){
+    Py_ssize_t lanes;
+    int implm_flags = 0;
+    long ips = SNEK8_CPU_DEFAULT_IPS;
+    unsigned int seed = 0;
+    char* kwlist[] = {
+        "lanes",
+        "implm_flags",
+        "ips",
+        "seed",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n|ilI", kwlist, &lanes, &implm_flags, &ips, &seed)){
+        return -1;
+    }
+    Snek8BatchObject* batch = CAST_PTR(Snek8BatchObject, self);
+    if (lanes < 1){
+        PyErr_Format(PyExc_ValueError, "The number of lanes must be positive. Value recieved: %zd.", lanes);
+        return -1;
+    }
+    if (implm_flags < 0 || (implm_flags & ~SNEK8_IMPLM_MODE_MASK)){
+        PyErr_Format(PyExc_ValueError, "Value %d is invalid for implementation.", implm_flags);
+        return -1;
+    }
+    if (ips < 1 || ips > SNEK8_CPU_MAX_IPS){
+        PyErr_Format(PyExc_ValueError, "Value %ld is not a valid number of instructions per second.", ips);
+        return -1;
+    }
+    if (batch->ob_exports){
+        PyErr_SetString(PyExc_BufferError, "The batch cannot be reinitialized while its screens are exported.");
+        return -1;
+    }
+    int expected = SNEK8_EMULATOR_IDLE;
+    if (!atomic_compare_exchange_strong(&batch->ob_state, &expected, SNEK8_EMULATOR_BUSY)){
+        PyErr_SetString(PyExc_RuntimeError, "The batch is already running on another thread.");
+        return -1;
+    }
+    snek8_batchDel(batch->ob_batch);
+    batch->ob_batch = snek8_batchNew((size_t) lanes, (uint8_t) implm_flags);
+    snek8_batchObjectRelease(batch);
+    if (!batch->ob_batch){
+        batch->ob_lanes = 0;
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for the batch");
+        return -1;
+    }
+    (void) snek8_batchSetIPS(batch->ob_batch, (uint32_t) ips);
+    snek8_batchSeed(batch->ob_batch, (uint32_t) seed);
+    batch->ob_lanes = lanes;
+    batch->ob_shape[0] = lanes;
+    batch->ob_shape[1] = SNEK8_GRAPHICS_HEIGTH;
+    batch->ob_strides[0] = SNEK8_SIZE_GRAPHICS_BYTES;
+    batch->ob_strides[1] = sizeof(uint64_t);
+    return 0;
+}
+
+/**
+* @brief Retrieve a lane index from a Python integer.
+*
+* @return 0 on success, -1 with an IndexError set if the lane does not exist.
+*/
+static int
+snek8_batchObjectCheckLane(Snek8BatchObject* self, Py_ssize_t lane){
+    if (lane < 0 || lane >= self->ob_lanes){
+        PyErr_Format(PyExc_IndexError, "Lane must be between 0 and %zd (incl.). Value recieved: %zd.",
+                     self->ob_lanes - 1, lane);
+        return -1;
+    }
+    return 0;
+}
+
+static PyObject*
+snek8_batchObjectLoadRom(PyObject* self, PyObject* args, PyObject* kwargs){
+    const char* rom_filepath = NULL;
+    char* kwlist[] = {
+        "rom_filepath",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s", kwlist, &rom_filepath)){
+        return NULL;
+    }
+    Snek8BatchObject* batch = CAST_PTR(Snek8BatchObject, self);
+    if (snek8_batchObjectAcquire(batch) < 0){
+        return NULL;
+    }
+    const Snek8Rom* rom = NULL;
+    Snek8CPU cpu;
+    (void) snek8_cpuInit(&cpu, batch->ob_batch->implm_flags);
+    enum Snek8ExecutionOutput out = snek8_romCacheGet(&snek8_rom_cache, rom_filepath, &rom);
+    if (SNEK8_EXECOUT_SUCCESS == out){
+        out = snek8_cpuLoadRomBytes(&cpu, rom->data, rom->size);
+    }
+    if (SNEK8_EXECOUT_SUCCESS == out){
+        for (size_t lane = 0; lane < batch->ob_batch->lanes; lane++){
+            // Every lane keeps drawing its own random numbers (see the seed of __init__).
+            cpu.rng = batch->ob_batch->rng[lane];
+            (void) snek8_batchLoadLane(batch->ob_batch, lane, &cpu);
+        }
+    }
+    snek8_batchObjectRelease(batch);
+    return PyLong_FromLong((long) out);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_BATCH_LOAD_ROM,
+             "loadRom(rom_filepath: str) -> int\n\n"
+             "Reset every lane and load the same ROM, through the module's ROM cache, into all\n"
+             "of them.\n"
+             "Attributes\n"
+             "----------\n"
+             "rom_filepath: str\n"
+             "\tThe filepath to the ROM file.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe execution output code representing whether the execution was successeful."
+);
+
+static PyObject*
+snek8_batchObjectRun(PyObject* self, PyObject* args, PyObject* kwargs){
+    Py_ssize_t max_cycles;
+    char* kwlist[] = {
+        "cycles",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n", kwlist, &max_cycles)){
+        return NULL;
+    }
+    if (max_cycles < 0){
+        PyErr_Format(PyExc_ValueError, "The number of cycles must be non-negative.");
+        return NULL;
+    }
+    Snek8BatchObject* batch = CAST_PTR(Snek8BatchObject, self);
+    if (snek8_batchObjectAcquire(batch) < 0){
+        return NULL;
+    }
+    size_t steps;
+    Py_BEGIN_ALLOW_THREADS
+    steps = snek8_batchRun(batch->ob_batch, (size_t) max_cycles);
+    Py_END_ALLOW_THREADS
+    snek8_batchObjectRelease(batch);
+    return PyLong_FromSize_t(steps);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_BATCH_RUN,
+             "run(cycles: int) -> int\n\n"
+             "Execute up to `cycles` steps, each one executing an instruction on every\n"
+             "running lane. The GIL is released during the execution.\n"
+             "Attributes\n"
+             "----------\n"
+             "cycles: int\n"
+             "\tThe maximum number of steps to execute.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe number of steps executed, less than `cycles` if every lane halted.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf cycles is negative."
+);
+
+static PyObject*
+snek8_batchObjectSetKeys(PyObject* self, PyObject* args, PyObject* kwargs){
+    Py_buffer keys;
+    char* kwlist[] = {
+        "keys",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "y*", kwlist, &keys)){
+        return NULL;
+    }
+    Snek8BatchObject* batch = CAST_PTR(Snek8BatchObject, self);
+    if (keys.len != batch->ob_lanes * (Py_ssize_t) sizeof(uint16_t)){
+        PyBuffer_Release(&keys);
+        PyErr_Format(PyExc_ValueError, "Expected %zd bytes (one uint16 key set per lane). Value recieved: %zd.",
+                     batch->ob_lanes * (Py_ssize_t) sizeof(uint16_t), keys.len);
+        return NULL;
+    }
+    if (snek8_batchObjectAcquire(batch) < 0){
+        PyBuffer_Release(&keys);
+        return NULL;
+    }
+    // The buffer may be unaligned or be the batch's own keys.
+    for (Py_ssize_t lane = 0; lane < batch->ob_lanes; lane++){
+        uint16_t lane_keys;
+        (void) memcpy(&lane_keys, (const uint8_t*) keys.buf + lane * (Py_ssize_t) sizeof(uint16_t),
+                      sizeof(uint16_t));
+        (void) snek8_batchSetKeys(batch->ob_batch, (size_t) lane, lane_keys);
+    }
+    snek8_batchObjectRelease(batch);
+    PyBuffer_Release(&keys);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_BATCH_SET_KEYS,
+             "setKeys(keys: Buffer) -> None\n\n"
+             "Set the key sets of all the lanes at once. The changed keys complete a\n"
+             "pending LD VX, K as with Snek8Emulator.setKeyValue.\n"
+             "Attributes\n"
+             "----------\n"
+             "keys: Buffer\n"
+             "\tA contiguous buffer of `lanes` native-endian unsigned 16-bit integers (e.g.\n"
+             "\tarray('H') or a uint16 numpy array), the bit k of an integer being the key k\n"
+             "\tof its lane.\n"
+             "Raises\n"
+             "------\n"
+             "ValueError\n"
+             "\tIf the buffer does not have exactly 2 * lanes bytes."
+);
+
+static PyObject*
+snek8_batchObjectSetKeyValue(PyObject* self, PyObject* args, PyObject* kwargs){
+    Py_ssize_t lane;
+    int index;
+    int value;
+    char* kwlist[] = {
+        "lane",
+        "key",
+        "value",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "nip", kwlist, &lane, &index, &value)){
+        return NULL;
+    }
+    Snek8BatchObject* batch = CAST_PTR(Snek8BatchObject, self);
+    if (snek8_batchObjectCheckLane(batch, lane) < 0){
+        return NULL;
+    }
+    if (index < 0 || index >= SNEK8_SIZE_KEYSET){
+        PyErr_Format(PyExc_IndexError, "Key index must be between 0 and 15 (incl.). Value recieved: %d.", index);
+        return NULL;
+    }
+    if (snek8_batchObjectAcquire(batch) < 0){
+        return NULL;
+    }
+    uint16_t keys = batch->ob_batch->keys[lane];
+    keys = value? (uint16_t) (keys | (1u << index)): (uint16_t) (keys & ~(1u << index));
+    (void) snek8_batchSetKeys(batch->ob_batch, (size_t) lane, keys);
+    snek8_batchObjectRelease(batch);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_BATCH_SET_KEY_VALUE,
+             "setKeyValue(lane: int, key: int, value: bool) -> None\n\n"
+             "Modifies a given key of a lane.\n"
+             "Attributes\n"
+             "----------\n"
+             "lane: int\n"
+             "\tThe lane to be modified.\n"
+             "key: int\n"
+             "\tThe index to be modified.\n"
+             "value: bool\n"
+             "\tThe new value of the key.\n"
+             "Raises\n"
+             "------\n"
+             "IndexError\n"
+             "\tIf the lane or the key index is not a valid index."
+);
+
+static PyObject*
+snek8_batchObjectGetStatus(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8BatchObject* batch = CAST_PTR(Snek8BatchObject, self);
+    if (snek8_batchObjectAcquire(batch) < 0){
+        return NULL;
+    }
+    PyObject* status = PyBytes_FromStringAndSize((const char*) batch->ob_batch->status, batch->ob_lanes);
+    snek8_batchObjectRelease(batch);
+    return status;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_BATCH_GET_STATUS,
+             "getStatus() -> bytes\n\n"
+             "Retrieve the status of every lane.\n"
+             "Returns\n"
+             "-------\n"
+             "bytes\n"
+             "\tOne EXECOUT code per lane: EXECOUT_SUCCESS while the lane runs, the code of\n"
+             "\tthe failing instruction once it halted."
+);
+
+static PyObject*
+snek8_batchObjectGetCycles(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8BatchObject* batch = CAST_PTR(Snek8BatchObject, self);
+    if (snek8_batchObjectAcquire(batch) < 0){
+        return NULL;
+    }
+    unsigned long long cycles = (unsigned long long) batch->ob_batch->cycles;
+    snek8_batchObjectRelease(batch);
+    return PyLong_FromUnsignedLongLong(cycles);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_BATCH_GET_CYCLES,
+             "getCycles() -> int\n\n"
+             "Retrieve the number of steps executed by the batch.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe value of the batch's cycle counter."
+);
+
+static PyObject*
+snek8_batchObjectGetSkippedCycles(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8BatchObject* batch = CAST_PTR(Snek8BatchObject, self);
+    if (snek8_batchObjectAcquire(batch) < 0){
+        return NULL;
+    }
+    unsigned long long cycles = (unsigned long long) batch->ob_batch->skipped_cycles;
+    snek8_batchObjectRelease(batch);
+    return PyLong_FromUnsignedLongLong(cycles);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_BATCH_GET_SKIPPED_CYCLES,
+             "getSkippedCycles() -> int\n\n"
+             "Retrieve the number of steps the batch retired without executing them, because\n"
+             "every lane was spinning in an idle loop or waiting for a key.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe number of skipped steps, which count in getCycles."
 );
 
 static PyObject*
-snek8_emulatorIsPixelActive(PyObject* self, PyObject* args, PyObject* kwargs){
-    int pos_x;
-    int pos_y;
-    char* kw_list[] = {
-        "pox_x",
-        "pos_y",
+snek8_batchObjectGetLane(PyObject* self, PyObject* args, PyObject* kwargs){
+    Py_ssize_t lane;
+    char* kwlist[] = {
+        "lane",
         NULL,
     };
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ii", kw_list, &pos_x, &pos_y)){
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n", kwlist, &lane)){
         return NULL;
     }
-    if (*snek8_cpuGetPixel(&CAST_PTR(Snek8Emulator, self)->ob_cpu, pos_x, pos_y)){
-        Py_RETURN_TRUE;
-    }else{
-        Py_RETURN_FALSE;
+    Snek8BatchObject* batch = CAST_PTR(Snek8BatchObject, self);
+    if (snek8_batchObjectCheckLane(batch, lane) < 0){
+        return NULL;
+    }
+    PyObject* emulator = PyObject_CallNoArgs((PyObject*) &Snek8EmulatorType);
+    if (!emulator){
+        return NULL;
+    }
+    if (snek8_batchObjectAcquire(batch) < 0){
+        Py_DECREF(emulator);
+        return NULL;
     }
+    Snek8CPU* cpu = &CAST_PTR(Snek8Emulator, emulator)->ob_cpu;
+    (void) snek8_batchStoreLane(batch->ob_batch, (size_t) lane, cpu);
+    CAST_PTR(Snek8Emulator, emulator)->ob_is_running = (SNEK8_EXECOUT_SUCCESS == batch->ob_batch->status[lane]);
+    snek8_batchObjectRelease(batch);
+    snek8_emulatorSyncKeys(CAST_PTR(Snek8Emulator, emulator));
+    return emulator;
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_IS_PIXEL_ACT,
-             "isPixelActive(pos_x: int, pos_y: int) -> bool\n\n"
-             "Retrieve whether the pixel at (pos_x, pos_y) is active.\n"
-             "An active (True) pixel is a white pixel and an innactive (False)\n"
-             "is a black pixel."
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_BATCH_GET_LANE,
+             "getLane(lane: int) -> Snek8Emulator\n\n"
+             "Copy the state of a lane into a new emulator, e.g. to inspect it or to keep\n"
+             "running it on its own.\n"
              "Attributes\n"
              "----------\n"
-             "pos_x: int\n"
-             "\tThe x-coordinate. 0 <= pos_x < 64\n"
-             "pos_y: int\n"
-             "\tThe y-coordinate. 0 <= pos_y < 32\n"
+             "lane: int\n"
+             "\tThe lane to be copied.\n"
              "Returns\n"
              "-------\n"
-             "bool\n"
-             "\tThe current value of the requested pixel.\n"
+             "Snek8Emulator\n"
+             "\tAn emulator with the reference engine, running unless the lane halted.\n"
+             "Raises\n"
+             "------\n"
+             "IndexError\n"
+             "\tIf lane is not a valid index."
 );
 
-static PyObject*
-snek8_emulatorGetStack(PyObject* self, PyObject* args){
-    UNUSED(args);
-    PyObject* stack_list = PyList_New(SNEK8_SIZE_STACK);
-    if (!stack_list){
-        PyErr_SetString(PyExc_MemoryError, "Failed to create stack list.");
-        return NULL;
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wcast-function-type"
+
+static struct PyMethodDef snek8_batch_methods[] = {
+    {
+        .ml_name = "loadRom",
+        .ml_meth = (PyCFunction) snek8_batchObjectLoadRom,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_BATCH_LOAD_ROM,
+    },
+    {
+        .ml_name = "run",
+        .ml_meth = (PyCFunction) snek8_batchObjectRun,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_BATCH_RUN,
+    },
+    {
+        .ml_name = "setKeys",
+        .ml_meth = (PyCFunction) snek8_batchObjectSetKeys,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_BATCH_SET_KEYS,
+    },
+    {
+        .ml_name = "setKeyValue",
+        .ml_meth = (PyCFunction) snek8_batchObjectSetKeyValue,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_BATCH_SET_KEY_VALUE,
+    },
+    {
+        .ml_name = "getStatus",
+        .ml_meth = snek8_batchObjectGetStatus,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_BATCH_GET_STATUS,
+    },
+    {
+        .ml_name = "getCycles",
+        .ml_meth = snek8_batchObjectGetCycles,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_BATCH_GET_CYCLES,
+    },
+    {
+        .ml_name = "getSkippedCycles",
+        .ml_meth = snek8_batchObjectGetSkippedCycles,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_BATCH_GET_SKIPPED_CYCLES,
+    },
+    {
+        .ml_name = "getLane",
+        .ml_meth = (PyCFunction) snek8_batchObjectGetLane,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_BATCH_GET_LANE,
+    },
+    {NULL},
+};
+#pragma GCC diagnostic pop
+
+/**
+* @brief Export the screens of the lanes as a read-only (lanes, rows) buffer.
+*/
+static int
+snek8_batchObjectGetBuffer(PyObject* self, Py_buffer* view, int flags){
+    Snek8BatchObject* batch = CAST_PTR(Snek8BatchObject, self);
+    if (flags & PyBUF_WRITABLE){
+        PyErr_SetString(PyExc_BufferError, "The screen buffer is read-only.");
+        return -1;
     }
-    for (size_t i = 0; i < SNEK8_SIZE_STACK; i++){
-        PyObject* value = Py_BuildValue("i", CAST_PTR(Snek8Emulator, self)->ob_cpu.stack.buffer[i]);
-        if (!value){
-            PyErr_SetString(PyExc_MemoryError, "Failed to create register list element.");
-            Py_DECREF(stack_list);
-            return NULL;
-        }
-        PyList_SET_ITEM(stack_list, i, value);
+    if (!batch->ob_batch){
+        PyErr_SetString(PyExc_BufferError, "The batch is not initialized.");
+        return -1;
     }
-    return stack_list;
+    if (!(flags & PyBUF_ND)){
+        PyErr_SetString(PyExc_BufferError, "The screens buffer is two-dimensional.");
+        return -1;
+    }
+    view->obj = Py_NewRef(self);
+    view->buf = batch->ob_batch->graphics;
+    view->len = batch->ob_lanes * SNEK8_SIZE_GRAPHICS_BYTES;
+    view->readonly = 1;
+    view->itemsize = sizeof(uint64_t);
+    view->format = (flags & PyBUF_FORMAT)? "Q": NULL;
+    view->ndim = 2;
+    view->shape = batch->ob_shape;
+    view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES)? batch->ob_strides: NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+    batch->ob_exports++;
+    return 0;
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_STACK,
-             "getStack() -> Annotated[List[int],16]\n\n"
-             "Retrieve the stack list representation.\n"
-             "Returns\n"
-             "-------\n"
-             "Annotated[List[int],16]\n"
-             "\tThe current values of the stack."
+static void
+snek8_batchObjectReleaseBuffer(PyObject* self, Py_buffer* view){
+    UNUSED(view);
+    CAST_PTR(Snek8BatchObject, self)->ob_exports--;
+}
+
+static PyBufferProcs snek8_batch_as_buffer = {
+    .bf_getbuffer = snek8_batchObjectGetBuffer,
+    .bf_releasebuffer = snek8_batchObjectReleaseBuffer,
+};
+
+static PyTypeObject Snek8BatchType = {
+     .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
+     .tp_name = "snek8.core.Snek8Batch",
+     .tp_basicsize = sizeof(Snek8BatchObject),
+     .tp_itemsize = 0,
+     .tp_doc = SNEK8_STR_DOC_SNEK8_BATCH,
+     .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+     .tp_new = PyType_GenericNew,
+     .tp_init = (initproc) snek8_batchObjectInit,
+     .tp_dealloc = (destructor) snek8_batchObjectDel,
+     .tp_members = snek8_batch_members,
+     .tp_as_buffer = &snek8_batch_as_buffer,
+     .tp_methods = snek8_batch_methods,
+};
+
+/*
+* EXTENDED EMULATOR TYPE
+* ----------------------
+*/
+
+typedef struct{
+    PyObject_HEAD
+    Snek8ExtCPU* ob_cpu;
+    int ob_profile;
+    bool ob_is_running;
+    atomic_int ob_state;
+    Snek8Audio ob_audio;
+    Py_buffer ob_audio_view;
+} Snek8ExtEmulator;
+
+PyDoc_STRVAR(SNEK8_STR_DOC_SNEK8_EXT_EMULATOR,
+             "Snek8ExtEmulator(profile: int = PROFILE_SCHIP, implm_flags: int = 0,"
+             " ips: int = DEFAULT_IPS, seed: int = 0)\n\n"
+             "An emulator of the extended dialects of the Chip8: SUPER-CHIP (PROFILE_SCHIP)\n"
+             "and XO-CHIP (PROFILE_XOCHIP).\n\n"
+             "Each profile runs on its own core, which adds the 128x64 hi-res mode, the\n"
+             "scrolls, 16x16 sprites, the big font and the RPL flags to the Chip8 and, for\n"
+             "XO-CHIP, the 64 KB memory, the second bit plane and the audio pattern. The\n"
+             "ROMs are loaded from bytes, since they may exceed SIZE_MAX_ROM_FILE.\n\n"
+             "Attributes\n"
+             "----------\n"
+             "profile: int\n"
+             "\tThe PROFILE constant of the emulator.\n"
+             "is_running: bool\n"
+             "\tWhether the CPU is running, i.e. no instruction failed nor exited.\n"
+             "\n"
+             "Parameters\n"
+             "----------\n"
+             "profile: int\n"
+             "\tThe dialect to emulate.\n"
+             "implm_flags: int\n"
+             "\tThe implementation flags of the Chip8 instructions (see Snek8Emulator).\n"
+             "ips: int\n"
+             "\tThe number of instructions executed per emulated second.\n"
+             "seed: int\n"
+             "\tThe seed of the random number generator.\n"
 );
 
+static PyMemberDef snek8_ext_emulator_members[] = {
+    {
+        .name = "profile",
+        .type = Py_T_INT,
+        .offset = offsetof(Snek8ExtEmulator, ob_profile),
+        .flags = Py_READONLY,
+        .doc = "profile: int\n\tThe PROFILE constant of the emulator.",
+    },
+    {
+        .name = "is_running",
+        .type = Py_T_BOOL,
+        .offset = offsetof(Snek8ExtEmulator, ob_is_running),
+        .flags = Py_READONLY,
+        .doc = "is_running: bool\n\tWhether the CPU is running.",
+    },
+    {NULL},
+};
+
+/**
+* @brief Take the ownership of the CPU for the calling method.
+*
+* @return 0 on success, -1 with a RuntimeError set if the CPU is in use.
+*/
+static int
+snek8_extEmulatorAcquire(Snek8ExtEmulator* self){
+    int expected = SNEK8_EMULATOR_IDLE;
+    if (!atomic_compare_exchange_strong(&self->ob_state, &expected, SNEK8_EMULATOR_BUSY)){
+        PyErr_SetString(PyExc_RuntimeError, "The emulator is already running on another thread.");
+        return -1;
+    }
+    if (!self->ob_cpu){
+        atomic_store(&self->ob_state, SNEK8_EMULATOR_IDLE);
+        PyErr_SetString(PyExc_RuntimeError, "The emulator is not initialized.");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+* @brief Give back the ownership of the CPU taken by `snek8_extEmulatorAcquire`.
+*/
+static void
+snek8_extEmulatorRelease(Snek8ExtEmulator* self){
+    atomic_store(&self->ob_state, SNEK8_EMULATOR_IDLE);
+}
+
+static void
+snek8_extEmulatorDel(PyObject* self){
+    PyMem_RawFree(CAST_PTR(Snek8ExtEmulator, self)->ob_cpu);
+    if (CAST_PTR(Snek8ExtEmulator, self)->ob_audio_view.obj){
+        PyBuffer_Release(&CAST_PTR(Snek8ExtEmulator, self)->ob_audio_view);
+    }
+    Py_TYPE(self)->tp_free(self);
+}
+
+static int
+snek8_extEmulatorInit(PyObject* self, PyObject* args, PyObject* kwargs){
+    int profile = SNEK8_PROFILE_SCHIP;
+    int implm_flags = 0;
+    long ips = SNEK8_CPU_DEFAULT_IPS;
+    unsigned int seed = 0;
+    char* kwlist[] = {
+        "profile",
+        "implm_flags",
+        "ips",
+        "seed",
+        NULL,
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|iilI", kwlist, &profile, &implm_flags, &ips, &seed)){
+        return -1;
+    }
+    Snek8ExtEmulator* emulator = CAST_PTR(Snek8ExtEmulator, self);
+    if (profile < 0 || profile >= SNEK8_PROFILE_COUNT){
+        PyErr_Format(PyExc_ValueError, "Value %d is not a valid profile.", profile);
+        return -1;
+    }
+    if (implm_flags < 0 || (implm_flags & ~SNEK8_IMPLM_MODE_MASK)){
+        PyErr_Format(PyExc_ValueError, "Value %d is invalid for implementation.", implm_flags);
+        return -1;
+    }
+    if (ips < 1 || ips > SNEK8_CPU_MAX_IPS){
+        PyErr_Format(PyExc_ValueError, "Value %ld is not a valid number of instructions per second.", ips);
+        return -1;
+    }
+    int expected = SNEK8_EMULATOR_IDLE;
+    if (!atomic_compare_exchange_strong(&emulator->ob_state, &expected, SNEK8_EMULATOR_BUSY)){
+        PyErr_SetString(PyExc_RuntimeError, "The emulator is already running on another thread.");
+        return -1;
+    }
+    if (!emulator->ob_cpu){
+        emulator->ob_cpu = PyMem_RawMalloc(sizeof(Snek8ExtCPU));
+    }
+    if (!emulator->ob_cpu){
+        snek8_extEmulatorRelease(emulator);
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory for the CPU");
+        return -1;
+    }
+    (void) snek8_extInit(emulator->ob_cpu, (enum Snek8Profile) profile, (uint8_t) implm_flags);
+    (void) snek8_extSetIPS(emulator->ob_cpu, (uint32_t) ips);
+    (void) snek8_extSeed(emulator->ob_cpu, (uint32_t) seed);
+    emulator->ob_profile = profile;
+    emulator->ob_is_running = true;
+    snek8_extEmulatorRelease(emulator);
+    return 0;
+}
+
 static PyObject*
-snek8_emulatorGetKeyValue(PyObject* self, PyObject* args, PyObject* kwargs){
-    int key;
+snek8_extEmulatorLoadRomBytes(PyObject* self, PyObject* args, PyObject* kwargs){
+    Py_buffer rom;
     char* kwlist[] = {
-        "index",
+        "rom",
         NULL,
     };
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i", kwlist, &key)){
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "y*", kwlist, &rom)){
         return NULL;
     }
-    if (key < 0 || key >= 16){
-        PyErr_Format(PyExc_IndexError, "Index must be between 0 and 15 (incl.). Value recieved: %d.", index);
+    Snek8ExtEmulator* emulator = CAST_PTR(Snek8ExtEmulator, self);
+    if (snek8_extEmulatorAcquire(emulator) < 0){
+        PyBuffer_Release(&rom);
         return NULL;
     }
-    bool value = snek8_cpuGetKeyVal(CAST_PTR(Snek8Emulator, self)->ob_cpu, key);
-    return value? Py_True: Py_False;
+    enum Snek8ExecutionOutput out = snek8_extLoadRomBytes(emulator->ob_cpu, rom.buf, (size_t) rom.len);
+    if (SNEK8_EXECOUT_SUCCESS == out){
+        emulator->ob_is_running = true;
+    }
+    snek8_extEmulatorRelease(emulator);
+    PyBuffer_Release(&rom);
+    return PyLong_FromLong((long) out);
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_GET_KEY_VALUE,
-             "getKeyValue(key: int) -> bool\n\n"
-             "Retrieve the graphics list representation.\n"
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_LOAD_ROM_BYTES,
+             "loadRomBytes(rom: Buffer) -> int\n\n"
+             "Reset the CPU, keeping its profile, implementation flags, rate and random\n"
+             "number generator, and load a program.\n"
              "Attributes\n"
              "----------\n"
-             "key: int\n"
-             "\tThe key index to be retrieved. 0 <= key <= 15\n"
+             "rom: Buffer\n"
+             "\tThe program, at most 3584 bytes for SUPER-CHIP and 65024 for XO-CHIP.\n"
              "Returns\n"
              "-------\n"
-             "bool\n"
-             "\tThe current value of the requested key.\n"
-             "Raises\n"
-             "------\n"
-             "IndexError\n"
-             "\tIf key is not a valid index, i.e. key < 0 or key >= 16."
+             "int\n"
+             "\tThe execution output code representing whether the execution was successeful."
 );
 
-/*
-* EMULATION METHODS
-* ------------------
+/**
+* @brief The waveform of the buzzer: the audio pattern of the XO-CHIP, unless the
+* program never loaded one (it is then all zero), and the square wave otherwise.
 */
+static inline const uint8_t*
+snek8_extEmulatorPattern(const Snek8ExtCPU* cpu){
+    if (SNEK8_PROFILE_XOCHIP == cpu->profile){
+        for (size_t i = 0; i < SNEK8_EXT_SIZE_AUDIO; i++){
+            if (cpu->audio[i]){
+                return cpu->audio;
+            }
+        }
+    }
+    return NULL;
+}
 
 static PyObject*
-snek8_emulatorTurnFlagsOn(PyObject* self, PyObject* args, PyObject* kwargs){
-    int flags;
+snek8_extEmulatorEmulationRun(PyObject* self, PyObject* args, PyObject* kwargs){
+    Py_ssize_t max_cycles;
+    int break_flags = SNEK8_RUN_BREAK_ON_DRAW | SNEK8_RUN_BREAK_ON_KEY_WAIT;
     char* kwlist[] = {
-        "flags",
+        "cycles",
+        "break_on",
         NULL,
     };
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i", kwlist, &flags)){
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n|i", kwlist, &max_cycles, &break_flags)){
         return NULL;
     }
-    CAST_PTR(Snek8Emulator, self)->ob_cpu.implm_flags |= ((uint8_t) flags);
-    Py_RETURN_NONE;
+    if (max_cycles < 0){
+        PyErr_Format(PyExc_ValueError, "The number of cycles must be non-negative.");
+        return NULL;
+    }
+    Snek8ExtEmulator* emulator = CAST_PTR(Snek8ExtEmulator, self);
+    if (snek8_extEmulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+    size_t cycles = 0;
+    enum Snek8RunStop stop = SNEK8_RUNSTOP_CYCLES;
+    enum Snek8ExecutionOutput out;
+    Snek8ExtCPU* cpu = emulator->ob_cpu;
+    uint32_t phase = cpu->timer_phase;
+    uint8_t st = cpu->st;
+    uint64_t start = cpu->cycles;
+    Py_BEGIN_ALLOW_THREADS
+    out = snek8_extRun(cpu, (size_t) max_cycles, (uint8_t) break_flags, &cycles, &stop);
+    snek8_audioRun(&emulator->ob_audio, phase, cpu->ips, cpu->cycles - start, st, cpu->st,
+                   snek8_extEmulatorPattern(cpu), cpu->pitch);
+    Py_END_ALLOW_THREADS
+    if (out != SNEK8_EXECOUT_SUCCESS){
+        emulator->ob_is_running = false;
+    }
+    snek8_extEmulatorRelease(emulator);
+    return Py_BuildValue("(nii)", (Py_ssize_t) cycles, stop, out);
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_TURN_FLAGS_ON,
-             "turnFlagsOn(flags: int) -> None\n\n"
-             "Modify the emulator's implementation mode.\n\n"
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_EMU_RUN,
+             "emulationRun(cycles: int, break_on: int = RUN_BREAK_ON_DRAW | RUN_BREAK_ON_KEY_WAIT)"
+             " -> Tuple[int, int, int]\n\n"
+             "Execute up to `cycles` steps with the core of the emulator's profile. The GIL\n"
+             "is released during the execution. EXIT (00FD) stops the CPU with\n"
+             "EXECOUT_EXIT.\n"
              "Attributes\n"
              "----------\n"
-             "flags: int\n"
-             "\tWhich implementation to toggle on. Possible values has to be a "
-             "bitwise or combination of the following:\n"
-             "\t\t-0: IMPLM_MODE_BNNN_USE_VX.\n"
-             "\t\t-1: IMPLM_MODE_SHIFTS_USE_VY.\n"
-             "\t\t-2: IMPLM_MODE_FX_CHANGE_I.\n"
+             "cycles: int\n"
+             "\tThe maximum number of instructions to execute.\n"
+             "break_on: int\n"
+             "\tSame as in Snek8Emulator.emulationRun.\n"
+             "Returns\n"
+             "-------\n"
+             "Tuple[int, int, int]\n"
+             "\tSame as in Snek8Emulator.emulationRun.\n"
              "Raises\n"
              "------\n"
              "ValueError\n"
-             "\tIf the implm is not a valid value."
+             "\tIf cycles is negative."
 );
 
 static PyObject*
-snek8_emulatorTurnFlagsOff(PyObject* self, PyObject* args, PyObject* kwargs){
-    int flags;
-    char* kwlist[] = {
-        "flags",
-        NULL,
-    };
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i", kwlist, &flags)){
+snek8_extEmulatorSetAudioBuffer(PyObject* self, PyObject* args, PyObject* kwargs){
+    PyObject* buffer;
+    unsigned int rate = SNEK8_AUDIO_DEFAULT_RATE;
+    unsigned int tone = SNEK8_AUDIO_DEFAULT_TONE;
+    int volume = SNEK8_AUDIO_DEFAULT_VOLUME;
+    if (snek8_audioParseArgs(args, kwargs, &buffer, &rate, &tone, &volume) < 0){
+        return NULL;
+    }
+    Snek8ExtEmulator* emulator = CAST_PTR(Snek8ExtEmulator, self);
+    if (snek8_extEmulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+    int result = snek8_audioSetBuffer(&emulator->ob_audio, &emulator->ob_audio_view, buffer, rate, tone, volume);
+    snek8_extEmulatorRelease(emulator);
+    if (result < 0){
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_SET_AUDIO_BUFFER,
+             "setAudioBuffer(buffer: Buffer | None, rate: int = AUDIO_DEFAULT_RATE,\n"
+             "               tone: int = AUDIO_DEFAULT_TONE, volume: int = AUDIO_DEFAULT_VOLUME)"
+             " -> None\n\n"
+             "Same as Snek8Emulator.setAudioBuffer. Once an XO-CHIP program loaded an audio\n"
+             "pattern (F002), the buzzer plays it at the rate set by the pitch (FX3A) instead of\n"
+             "the square wave."
+);
+
+static PyObject*
+snek8_extEmulatorGetAudioPosition(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8ExtEmulator* emulator = CAST_PTR(Snek8ExtEmulator, self);
+    return PyLong_FromUnsignedLongLong(emulator->ob_audio_view.obj? snek8_audioWritten(&emulator->ob_audio): 0);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_GET_AUDIO_POSITION,
+             "getAudioPosition() -> int\n\n"
+             "Same as Snek8Emulator.getAudioPosition."
+);
+
+static PyObject*
+snek8_extEmulatorCyclesToFrame(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8ExtEmulator* emulator = CAST_PTR(Snek8ExtEmulator, self);
+    if (snek8_extEmulatorAcquire(emulator) < 0){
         return NULL;
     }
-    CAST_PTR(Snek8Emulator, self)->ob_cpu.implm_flags ^= ((uint8_t) flags);
-    Py_RETURN_NONE;
+    const Snek8ExtCPU* cpu = emulator->ob_cpu;
+    size_t cycles = (cpu->ips - cpu->timer_phase + SNEK8_TIMER_FREQUENCY - 1) / SNEK8_TIMER_FREQUENCY;
+    snek8_extEmulatorRelease(emulator);
+    return PyLong_FromSize_t(cycles);
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_TURN_FLAGS_OFF,
-             "turnFlagsOff(flags: int) -> None\n\n"
-             "Turn the selected implementation flags off.\n\n"
-             "Attributes\n"
-             "----------\n"
-             "flags: int\n"
-             "\tWhich implementation to toggle on. Possible values has to be a "
-             "bitwise or combination of the following:\n"
-             "\t\t-0: IMPLM_MODE_BNNN_USE_VX.\n"
-             "\t\t-1: IMPLM_MODE_SHIFTS_USE_VY.\n"
-             "\t\t-2: IMPLM_MODE_FX_CHANGE_I.\n"
-             "Raises\n"
-             "------\n"
-             "ValueError\n"
-             "\tIf the implm is not a valid value."
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_CYCLES_TO_FRAME,
+             "cyclesToFrame() -> int\n\n"
+             "Retrieve the number of instructions left in the current 60 Hz frame, i.e. up\n"
+             "to and including the next tick of the timers.\n"
+             "Returns\n"
+             "-------\n"
+             "int\n"
+             "\tThe number of cycles to pass to emulationRun to complete the frame."
 );
 
 static PyObject*
-snek8_emulatorSetRunning(PyObject* self, PyObject* args, PyObject* kwargs){
-    bool is_running;
+snek8_extEmulatorSetKeyValue(PyObject* self, PyObject* args, PyObject* kwargs){
+    int index;
+    int value;
     char* kwlist[] = {
-        "is_running",
+        "key",
+        "value",
         NULL,
     };
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "b", kwlist, &is_running)){
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ip", kwlist, &index, &value)){
         return NULL;
     }
-    CAST_PTR(Snek8Emulator, self)->ob_is_running = is_running;
+    if (index < 0 || index >= SNEK8_SIZE_KEYSET){
+        PyErr_Format(PyExc_IndexError, "Key index must be between 0 and 15 (incl.). Value recieved: %d.", index);
+        return NULL;
+    }
+    Snek8ExtEmulator* emulator = CAST_PTR(Snek8ExtEmulator, self);
+    if (snek8_extEmulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+    (void) snek8_extSetKey(emulator->ob_cpu, (size_t) index, value);
+    snek8_extEmulatorRelease(emulator);
     Py_RETURN_NONE;
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_SET_RUNNING,
-             "setRunning(is_running: bool) -> None\n\n"
-             "Determine wether the CPU is running.\n\n"
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_SET_KEY_VALUE,
+             "setKeyValue(key: int, value: bool) -> None\n\n"
+             "Modifies a given key, completing a pending LD VX, K as with\n"
+             "Snek8Emulator.setKeyValue.\n"
              "Attributes\n"
              "----------\n"
-             "is_running: bool\n"
-             "\tDetermine if the CPU should run."
+             "key: int\n"
+             "\tThe index to be modified.\n"
+             "value: bool\n"
+             "\tThe new value of the key.\n"
+             "Raises\n"
+             "------\n"
+             "IndexError\n"
+             "\tIf key is not a valid index."
 );
 
 static PyObject*
-snek8_emulatorSetKeyValue(PyObject* self, PyObject* args, PyObject* kwargs){
+snek8_extEmulatorGetKeyValue(PyObject* self, PyObject* args, PyObject* kwargs){
     int index;
-    bool value;
     char* kwlist[] = {
         "key",
-        "value",
         NULL,
     };
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ib", kwlist, &index, &value)){
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i", kwlist, &index)){
         return NULL;
     }
-            if (index < 0 || index >= 16){
+    if (index < 0 || index >= SNEK8_SIZE_KEYSET){
         PyErr_Format(PyExc_IndexError, "Key index must be between 0 and 15 (incl.). Value recieved: %d.", index);
         return NULL;
     }
-    snek8_cpuSetKey(&CAST_PTR(Snek8Emulator, self)->ob_cpu, index, value);
-    Py_RETURN_NONE;
+    Snek8ExtEmulator* emulator = CAST_PTR(Snek8ExtEmulator, self);
+    if (snek8_extEmulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+    bool value = (emulator->ob_cpu->keys >> index) & 0x1u;
+    snek8_extEmulatorRelease(emulator);
+    return PyBool_FromLong(value);
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_SET_KEY_VALUE,
-             "setKeyValue(key: int, value: bool) -> None\n\n"
-             "Modifies a given key.\n"
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_GET_KEY_VALUE,
+             "getKeyValue(key: int) -> bool\n\n"
+             "Retrieve the value of a key.\n"
              "Attributes\n"
              "----------\n"
              "key: int\n"
-             "\tThe index to be modified.\n"
-             "value: bool\n"
-             "\tThe new value of the key..\n\n"
+             "\tThe key index to be retrieved. 0 <= key <= 15\n"
+             "Returns\n"
+             "-------\n"
+             "bool\n"
+             "\tThe current value of the requested key.\n"
              "Raises\n"
              "------\n"
              "IndexError\n"
-             "\tIf the key index is not a valid index, i.e. key < 0 or key >= 16."
+             "\tIf key is not a valid index."
 );
 
 static PyObject*
-_snek8_emulatorExecOpc(PyObject* self, PyObject* args, PyObject* kwargs){
-    int code = 0;
+snek8_extEmulatorGetGraphics(PyObject* self, PyObject* args, PyObject* kwargs){
+    int plane = 0;
     char* kwlist[] = {
-        "opcode",
+        "plane",
         NULL,
     };
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i", kwlist, &code)){
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|i", kwlist, &plane)){
         return NULL;
     }
-    if (code < 0 || code >= UINT16_MAX){
-        PyErr_Format(PyExc_ValueError, "The opcode must be a valid 16-bit unsigned integer.");
+    if (plane < 0 || plane >= SNEK8_EXT_PLANES){
+        PyErr_Format(PyExc_IndexError, "Plane must be between 0 and %d (incl.). Value recieved: %d.",
+                     SNEK8_EXT_PLANES - 1, plane);
         return NULL;
     }
-    Snek8Instruction instruction = snek8_opcodeDecode((uint16_t) code);
-    enum Snek8ExecutionOutput out = instruction.exec(&CAST_PTR(Snek8Emulator, self)->ob_cpu, code);
-    return PyLong_FromLong((long) out);
+    Snek8ExtEmulator* emulator = CAST_PTR(Snek8ExtEmulator, self);
+    if (snek8_extEmulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+    uint8_t bytes[SNEK8_EXT_HEIGHT * SNEK8_EXT_WIDTH / 8];
+    uint8_t* dst = bytes;
+    for (size_t y = 0; y < SNEK8_EXT_HEIGHT; y++){
+        for (size_t w = 0; w < 2; w++){
+            uint64_t word = emulator->ob_cpu->graphics[plane][y][w];
+            for (int shift = 56; shift >= 0; shift -= 8){
+                *dst++ = (uint8_t) (word >> shift);
+            }
+        }
+    }
+    snek8_extEmulatorRelease(emulator);
+    return PyBytes_FromStringAndSize((const char*) bytes, sizeof(bytes));
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_EXEC_OPT,
-             "_execOpc(opcode: int) -> int\n\n"
-             "Execute a step in the emulation process determined by the opcode.\n"
-             "This function should only be used to test CPU functionallities.\n"
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_GET_GRAPHICS,
+             "getGraphics(plane: int = 0) -> bytes\n\n"
+             "Retrieve a bit plane of the screen, at the hi-res resolution whatever the mode.\n"
              "Attributes\n"
              "----------\n"
-             "opc: int\n"
-             "\tThe opcode to be executed.\n"
+             "plane: int\n"
+             "\tThe plane to retrieve (XO-CHIP has 2 planes, SUPER-CHIP only draws on the\n"
+             "\tfirst one).\n"
              "Returns\n"
              "-------\n"
-             "int\n"
-             "\tThe execution output code representing whether the execution was successeful.\n"
+             "bytes\n"
+             "\t64 rows of 16 bytes, the most significant bit of a byte being its leftmost\n"
+             "\tpixel. In lo-res, every pixel covers 2x2 bits.\n"
              "Raises\n"
              "------\n"
-             "ValueError\n"
-             "\tIf the opcode is not a valid 16-bit unsigned integer."
+             "IndexError\n"
+             "\tIf plane is not a valid index."
 );
 
 static PyObject*
-snek8_emulatorLoadRom(PyObject* self, PyObject* args, PyObject* kwargs){
-    const char* rom_filepath = NULL;
+snek8_extEmulatorGetResolution(PyObject* self, PyObject* args){
+    UNUSED(args);
+    Snek8ExtEmulator* emulator = CAST_PTR(Snek8ExtEmulator, self);
+    if (snek8_extEmulatorAcquire(emulator) < 0){
+        return NULL;
+    }
+    int scale = emulator->ob_cpu->hires? 1: 2;
+    snek8_extEmulatorRelease(emulator);
+    return Py_BuildValue("(ii)", SNEK8_EXT_WIDTH / scale, SNEK8_EXT_HEIGHT / scale);
+}
+
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_GET_RESOLUTION,
+             "getResolution() -> Tuple[int, int]\n\n"
+             "Retrieve the resolution of the current mode.\n"
+             "Returns\n"
+             "-------\n"
+             "Tuple[int, int]\n"
+             "\t(128, 64) in hi-res, (64, 32) in lo-res."
+);
+
+static PyObject*
+snek8_extEmulatorGetRegister(PyObject* self, PyObject* args, PyObject* kwargs){
+    int index;
     char* kwlist[] = {
-        "rom_filepath",
+        "index",
         NULL,
     };
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s", kwlist, &rom_filepath)){
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i", kwlist, &index)){
         return NULL;
     }
-    if (!rom_filepath){
+    if (index < 0 || index >= SNEK8_SIZE_REGISTERS){
+        PyErr_Format(PyExc_IndexError, "Chip8 register's index ranges from 0 to 15 (inclusive).");
         return NULL;
     }
-    enum Snek8ExecutionOutput out = snek8_cpuLoadRom(&CAST_PTR(Snek8Emulator, self)->ob_cpu, rom_filepath);
-    if (out == SNEK8_EXECOUT_SUCCESS){
-        CAST_PTR(Snek8Emulator, self)->ob_is_running = true;
+    Snek8ExtEmulator* emulator = CAST_PTR(Snek8ExtEmulator, self);
+    if (snek8_extEmulatorAcquire(emulator) < 0){
+        return NULL;
     }
-    return PyBool_FromLong((long) out);
+    int value = emulator->ob_cpu->registers[index];
+    snek8_extEmulatorRelease(emulator);
+    return Py_BuildValue("i", value);
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_LOAD_ROM,
-             "loadRom(rom_filepath: str) -> int\n\n"
-             "Load a Chip8's ROM into memory\n"
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_GET_REGISTER,
+             "getRegister(index: int) -> int\n\n"
+             "Retrieve the value of a particular all purpose register.\n"
              "Attributes\n"
              "----------\n"
-             "rom_filepath: str\n"
-             "\tThe filepath to the ROM file.\n"
+             "index: int\n"
+             "\tThe index of the register to retrieve. 0 <= index <= 15.\n"
              "Returns\n"
              "-------\n"
              "int\n"
-             "\tThe execution output code representing whether the execution was successeful."
+             "\tThe current value of the register.\n"
+             "Raises\n"
+             "------\n"
+             "IndexError\n"
+             "\tIf the register index is not valid."
 );
 
 static PyObject*
-snek8_emulatorEmulationStep(PyObject* self, PyObject* args){
+snek8_extEmulatorGetCPUState(PyObject* self, PyObject* args){
     UNUSED(args);
-    Snek8Instruction instruc;
-    enum Snek8ExecutionOutput out = snek8_cpuStep(&CAST_PTR(Snek8Emulator, self)->ob_cpu,
-                                                 &instruc);
-    // printf("%s\n", instruc.code);
-    // TO-DO: DEAL WITH EXEC ERRORS.
-    if (out != SNEK8_EXECOUT_SUCCESS){
-        CAST_PTR(Snek8Emulator, self)->ob_is_running = false;
+    Snek8ExtEmulator* emulator = CAST_PTR(Snek8ExtEmulator, self);
+    if (snek8_extEmulatorAcquire(emulator) < 0){
+        return NULL;
     }
-    return Py_BuildValue("i", out);
+    const Snek8ExtCPU* cpu = emulator->ob_cpu;
+    PyObject* state = Py_BuildValue("{sisisisisisKsO}", "pc", cpu->pc, "ir", cpu->ir, "dt", cpu->dt,
+                                    "st", cpu->st, "planes", cpu->planes,
+                                    "cycles", (unsigned long long) cpu->cycles,
+                                    "hires", cpu->hires? Py_True: Py_False);
+    snek8_extEmulatorRelease(emulator);
+    return state;
 }
 
-PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EMULATOR_EMU_STEP,
-             "emulationStep() -> int\n\n"
-             "Execute one step in the emulation process\n"
+PyDoc_STRVAR(SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_GET_CPU_STATE,
+             "getCPUState() -> Dict[str, int]\n\n"
+             "Retrieve the scalar registers of the CPU.\n"
              "Returns\n"
              "-------\n"
-             "int\n"
-             "\tThe execution output code representing whether the execution was successeful."
+             "Dict[str, int]\n"
+             "\tThe program counter (pc), the index register (ir), the timers (dt, st), the\n"
+             "\tselected planes (planes), the cycle counter (cycles) and whether the screen\n"
+             "\tis in hi-res (hires)."
 );
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wcast-function-type"
 
-static struct PyMethodDef snek8_emulator_methods[] = {
-    {
-        .ml_name = "getMode",
-        .ml_meth = snek8_emulatorGetFlags,
-        .ml_flags = METH_NOARGS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_FLAGS,
-    },
-    {
-        .ml_name = "getPC",
-        .ml_meth = snek8_emulatorGetPC,
-        .ml_flags = METH_NOARGS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_PC,
-    },
-    {
-        .ml_name = "getIR",
-        .ml_meth = snek8_emulatorGetIR,
-        .ml_flags = METH_NOARGS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_IR,
-    },
-    {
-        .ml_name = "getDT",
-        .ml_meth = snek8_emulatorGetDT,
-        .ml_flags = METH_NOARGS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_DT,
-    },
-    {
-        .ml_name = "getST",
-        .ml_meth = snek8_emulatorGetST,
-        .ml_flags = METH_NOARGS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_ST,
-    },
+static struct PyMethodDef snek8_ext_emulator_methods[] = {
     {
-        .ml_name = "getSP",
-        .ml_meth = snek8_emulatorGetSP,
-        .ml_flags = METH_NOARGS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_SP,
-    },
-    {
-        .ml_name = "getGraphics",
-        .ml_meth = snek8_emulatorGetGraphics,
-        .ml_flags = METH_NOARGS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_GRAPHICS,
-    },
-    {
-        .ml_name = "isPixelActive",
-        .ml_meth = (PyCFunction) snek8_emulatorIsPixelActive,
+        .ml_name = "loadRomBytes",
+        .ml_meth = (PyCFunction) snek8_extEmulatorLoadRomBytes,
         .ml_flags = METH_VARARGS | METH_KEYWORDS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_IS_PIXEL_ACT,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_LOAD_ROM_BYTES,
     },
     {
-        .ml_name = "getStack",
-        .ml_meth = snek8_emulatorGetStack,
-        .ml_flags = METH_NOARGS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_STACK,
+        .ml_name = "emulationRun",
+        .ml_meth = (PyCFunction) snek8_extEmulatorEmulationRun,
+        .ml_flags = METH_VARARGS | METH_KEYWORDS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_EMU_RUN,
     },
     {
-        .ml_name = "getRegisters",
-        .ml_meth = snek8_emulatorGetRegisters,
+        .ml_name = "cyclesToFrame",
+        .ml_meth = snek8_extEmulatorCyclesToFrame,
         .ml_flags = METH_NOARGS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_REGISTERS,
-    },
-    {
-        .ml_name = "getRegister",
-        .ml_meth = (PyCFunction) snek8_emulatorGetRegister,
-        .ml_flags = METH_VARARGS | METH_KEYWORDS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_REGISTER,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_CYCLES_TO_FRAME,
     },
     {
-        .ml_name = "loadRom",
-        .ml_meth = (PyCFunction) snek8_emulatorLoadRom,
+        .ml_name = "setKeyValue",
+        .ml_meth = (PyCFunction) snek8_extEmulatorSetKeyValue,
         .ml_flags = METH_VARARGS | METH_KEYWORDS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_LOAD_ROM,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_SET_KEY_VALUE,
     },
     {
-        .ml_name = "turnFlagsOn",
-        .ml_meth = (PyCFunction) snek8_emulatorTurnFlagsOn,
+        .ml_name = "getKeyValue",
+        .ml_meth = (PyCFunction) snek8_extEmulatorGetKeyValue,
         .ml_flags = METH_VARARGS | METH_KEYWORDS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_TURN_FLAGS_ON,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_GET_KEY_VALUE,
     },
     {
-        .ml_name = "turnFlagsOff",
-        .ml_meth = (PyCFunction) snek8_emulatorTurnFlagsOff,
+        .ml_name = "getGraphics",
+        .ml_meth = (PyCFunction) snek8_extEmulatorGetGraphics,
         .ml_flags = METH_VARARGS | METH_KEYWORDS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_TURN_FLAGS_OFF,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_GET_GRAPHICS,
     },
     {
-        .ml_name = "setRunning",
-        .ml_meth = (PyCFunction) snek8_emulatorSetRunning,
-        .ml_flags = METH_VARARGS | METH_KEYWORDS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_SET_RUNNING,
+        .ml_name = "getResolution",
+        .ml_meth = snek8_extEmulatorGetResolution,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_GET_RESOLUTION,
     },
     {
-        .ml_name = "getKeyValue",
-        .ml_meth = (PyCFunction) snek8_emulatorGetKeyValue,
+        .ml_name = "getRegister",
+        .ml_meth = (PyCFunction) snek8_extEmulatorGetRegister,
         .ml_flags = METH_VARARGS | METH_KEYWORDS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_GET_KEY_VALUE,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_GET_REGISTER,
     },
     {
-        .ml_name = "setKeyValue",
-        .ml_meth = (PyCFunction) snek8_emulatorSetKeyValue,
-        .ml_flags = METH_VARARGS | METH_KEYWORDS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_SET_KEY_VALUE,
+        .ml_name = "getCPUState",
+        .ml_meth = snek8_extEmulatorGetCPUState,
+        .ml_flags = METH_NOARGS,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_GET_CPU_STATE,
     },
     {
-        .ml_name = "_execOpc",
-        .ml_meth = (PyCFunction) _snek8_emulatorExecOpc,
+        .ml_name = "setAudioBuffer",
+        .ml_meth = (PyCFunction) snek8_extEmulatorSetAudioBuffer,
         .ml_flags = METH_VARARGS | METH_KEYWORDS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_EXEC_OPT,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_SET_AUDIO_BUFFER,
     },
     {
-        .ml_name = "emulationStep",
-        .ml_meth = snek8_emulatorEmulationStep,
+        .ml_name = "getAudioPosition",
+        .ml_meth = snek8_extEmulatorGetAudioPosition,
         .ml_flags = METH_NOARGS,
-        .ml_doc = SNEK8_DOC_STR_SNEK8_EMULATOR_EMU_STEP,
+        .ml_doc = SNEK8_DOC_STR_SNEK8_EXT_EMULATOR_GET_AUDIO_POSITION,
     },
     {NULL},
 };
 #pragma GCC diagnostic pop
 
-static struct PyMethodDef module_meths[] = {
-    // {
-    //     .ml_name = "version",
-    //     .ml_meth = version,
-    //     .ml_flags = METH_NOARGS,
-    //     .ml_doc = "Versioning of the project."
-    // },
-    {NULL},
-};
-
-static PyTypeObject Snek8EmulatorType = {
+static PyTypeObject Snek8ExtEmulatorType = {
      .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
-     .tp_name = "snek8.core.Snek8Emulator",
-     .tp_basicsize = sizeof(Snek8Emulator),
+     .tp_name = "snek8.core.Snek8ExtEmulator",
+     .tp_basicsize = sizeof(Snek8ExtEmulator),
      .tp_itemsize = 0,
-     .tp_doc = SNEK8_STR_DOC_SNEK8_EMULATOR,
+     .tp_doc = SNEK8_STR_DOC_SNEK8_EXT_EMULATOR,
      .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
-     .tp_new = (newfunc) snek8_emulatorNew,
-     .tp_init = (initproc) snek8_emulatorInit,
-     .tp_dealloc = (destructor) snek8_emulatorDel,
-     .tp_members = snek8_emulator_members,
-     .tp_methods = snek8_emulator_methods,
+     .tp_new = PyType_GenericNew,
+     .tp_init = (initproc) snek8_extEmulatorInit,
+     .tp_dealloc = (destructor) snek8_extEmulatorDel,
+     .tp_members = snek8_ext_emulator_members,
+     .tp_methods = snek8_ext_emulator_methods,
 };
 
 PyDoc_STRVAR(SNEK8_STR_DOC_PY8,
@@ -834,9 +5894,22 @@ PyMODINIT_FUNC
 PyInit_core(void){
     PyObject* module;
     Py_Initialize();
+    snek8_opcodeTableInit();
     if (PyType_Ready(&Snek8EmulatorType) < 0){
         return NULL;
     }
+    if (PyType_Ready(&Snek8EmulatorPoolType) < 0){
+        return NULL;
+    }
+    if (PyType_Ready(&Snek8BatchType) < 0){
+        return NULL;
+    }
+    if (PyType_Ready(&Snek8StateType) < 0){
+        return NULL;
+    }
+    if (PyType_Ready(&Snek8ExtEmulatorType) < 0){
+        return NULL;
+    }
     module = PyModule_Create(&snek8_core);
     if (!module){
         return NULL;
@@ -845,6 +5918,22 @@ PyInit_core(void){
     if (PyModule_AddObject(module, "Snek8Emulator", (PyObject*) &Snek8EmulatorType)){
         Py_DECREF(module);
     }
+    Py_INCREF(&Snek8EmulatorPoolType);
+    if (PyModule_AddObject(module, "Snek8EmulatorPool", (PyObject*) &Snek8EmulatorPoolType)){
+        Py_DECREF(module);
+    }
+    Py_INCREF(&Snek8BatchType);
+    if (PyModule_AddObject(module, "Snek8Batch", (PyObject*) &Snek8BatchType)){
+        Py_DECREF(module);
+    }
+    Py_INCREF(&Snek8StateType);
+    if (PyModule_AddObject(module, "Snek8State", (PyObject*) &Snek8StateType)){
+        Py_DECREF(module);
+    }
+    Py_INCREF(&Snek8ExtEmulatorType);
+    if (PyModule_AddObject(module, "Snek8ExtEmulator", (PyObject*) &Snek8ExtEmulatorType)){
+        Py_DECREF(module);
+    }
     (void) PyModule_AddIntConstant(module, "EXECOUT_SUCCESS",
                             (long) SNEK8_EXECOUT_SUCCESS);
     (void) PyModule_AddIntConstant(module, "EXECOUT_INVALID_OPCODE",
@@ -855,6 +5944,8 @@ PyInit_core(void){
                             (long) SNEK8_EXECOUT_STACK_OVERFLOW);
     (void) PyModule_AddIntConstant(module, "EXECOUT_MEM_ADDR_OUT_BOUNDS",
                             (long) SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS);
+    (void) PyModule_AddIntConstant(module, "EXECOUT_ROM_FILE_INVALID",
+                            (long) SNEK8_EXECOUT_ROM_FILE_INVALID);
     (void) PyModule_AddIntConstant(module, "EXECOUT_ROM_FILE_NOT_FOUND",
                             (long) SNEK8_EXECOUT_ROM_FILE_NOT_FOUND);
     (void) PyModule_AddIntConstant(module, "EXECOUT_ROM_FILE_FAILED_TO_OPEN",
@@ -865,6 +5956,44 @@ PyInit_core(void){
                             (long) SNEK8_EXECOUT_ROM_FILE_EXCEEDS_MAX_MEM);
     (void) PyModule_AddIntConstant(module, "EXECOUT_EMPTY_STRUCT",
                             (long) SNEK8_EXECOUT_EMPTY_STRUCT);
+    (void) PyModule_AddIntConstant(module, "EXECOUT_SNAPSHOT_INVALID",
+                            (long) SNEK8_EXECOUT_SNAPSHOT_INVALID);
+    (void) PyModule_AddIntConstant(module, "EXECOUT_REPLAY_INVALID",
+                            (long) SNEK8_EXECOUT_REPLAY_INVALID);
+    (void) PyModule_AddIntConstant(module, "EXECOUT_OUT_OF_MEMORY",
+                            (long) SNEK8_EXECOUT_OUT_OF_MEMORY);
+    (void) PyModule_AddIntConstant(module, "EXECOUT_EXIT",
+                            (long) SNEK8_EXECOUT_EXIT);
+    (void) PyModule_AddIntConstant(module, "EXECOUT_INVALID_ARG",
+                            (long) SNEK8_EXECOUT_INVALID_ARG);
+    (void) PyModule_AddIntConstant(module, "RUNSTOP_CYCLES", (long) SNEK8_RUNSTOP_CYCLES);
+    (void) PyModule_AddIntConstant(module, "RUNSTOP_ERROR", (long) SNEK8_RUNSTOP_ERROR);
+    (void) PyModule_AddIntConstant(module, "RUNSTOP_DRAW", (long) SNEK8_RUNSTOP_DRAW);
+    (void) PyModule_AddIntConstant(module, "RUNSTOP_KEY_WAIT", (long) SNEK8_RUNSTOP_KEY_WAIT);
+    (void) PyModule_AddIntConstant(module, "RUNSTOP_BREAKPOINT", (long) SNEK8_RUNSTOP_BREAKPOINT);
+    (void) PyModule_AddIntConstant(module, "RUNSTOP_WATCHPOINT", (long) SNEK8_RUNSTOP_WATCHPOINT);
+    (void) PyModule_AddIntConstant(module, "DEBUG_EQ", SNEK8_DEBUG_EQ);
+    (void) PyModule_AddIntConstant(module, "DEBUG_NE", SNEK8_DEBUG_NE);
+    (void) PyModule_AddIntConstant(module, "DEBUG_LT", SNEK8_DEBUG_LT);
+    (void) PyModule_AddIntConstant(module, "DEBUG_LE", SNEK8_DEBUG_LE);
+    (void) PyModule_AddIntConstant(module, "DEBUG_GT", SNEK8_DEBUG_GT);
+    (void) PyModule_AddIntConstant(module, "DEBUG_GE", SNEK8_DEBUG_GE);
+    (void) PyModule_AddIntConstant(module, "DEBUG_REG_I", SNEK8_DEBUG_REG_I);
+    (void) PyModule_AddIntConstant(module, "DEBUG_WATCH_READ", SNEK8_DEBUG_WATCH_READ);
+    (void) PyModule_AddIntConstant(module, "DEBUG_WATCH_WRITE", SNEK8_DEBUG_WATCH_WRITE);
+    (void) PyModule_AddIntConstant(module, "DEBUG_MAX_CONDITIONS", SNEK8_DEBUG_MAX_CONDITIONS);
+    (void) PyModule_AddIntConstant(module, "RUN_BREAK_ON_DRAW", SNEK8_RUN_BREAK_ON_DRAW);
+    (void) PyModule_AddIntConstant(module, "RUN_BREAK_ON_KEY_WAIT", SNEK8_RUN_BREAK_ON_KEY_WAIT);
+    (void) PyModule_AddIntConstant(module, "ENGINE_REFERENCE", (long) SNEK8_ENGINE_REFERENCE);
+    (void) PyModule_AddIntConstant(module, "ENGINE_THREADED", (long) SNEK8_ENGINE_THREADED);
+    (void) PyModule_AddIntConstant(module, "ENGINE_BLOCK", (long) SNEK8_ENGINE_BLOCK);
+    (void) PyModule_AddIntConstant(module, "PROFILE_SCHIP", (long) SNEK8_PROFILE_SCHIP);
+    (void) PyModule_AddIntConstant(module, "PROFILE_XOCHIP", (long) SNEK8_PROFILE_XOCHIP);
+    (void) PyModule_AddIntConstant(module, "SIZE_EXT_GRAPHICS_WIDTH", SNEK8_EXT_WIDTH);
+    (void) PyModule_AddIntConstant(module, "SIZE_EXT_GRAPHICS_HEIGHT", SNEK8_EXT_HEIGHT);
+    (void) PyModule_AddIntConstant(module, "TIMER_FREQUENCY", SNEK8_TIMER_FREQUENCY);
+    (void) PyModule_AddIntConstant(module, "DEFAULT_IPS", SNEK8_CPU_DEFAULT_IPS);
+    (void) PyModule_AddIntConstant(module, "MAX_IPS", SNEK8_CPU_MAX_IPS);
     (void) PyModule_AddIntConstant(module, "SIZE_KEYSET", SNEK8_SIZE_KEYSET);
     (void) PyModule_AddIntConstant(module, "SIZE_STACK", SNEK8_SIZE_STACK);
     (void) PyModule_AddIntConstant(module, "SIZE_REGISTERS", SNEK8_SIZE_REGISTERS);
@@ -875,11 +6004,25 @@ PyInit_core(void){
     (void) PyModule_AddIntConstant(module, "SIZE_GRAPHICS", SNEK8_SIZE_GRAPHICS);
     (void) PyModule_AddIntConstant(module, "SIZE_FONTSET_PIXELS", SNEK8_SIZE_FONTSET_PIXELS);
     (void) PyModule_AddIntConstant(module, "SIZE_FONTSET_SPRITE", SNEK8_SIZE_FONTSET_PIXEL_PER_SPRITE);
+    (void) PyModule_AddIntConstant(module, "SIZE_STATE", SNEK8_SIZE_SNAPSHOT);
+    (void) PyModule_AddIntConstant(module, "REWIND_MIN_BUDGET", SNEK8_REWIND_MIN_BUDGET);
+    (void) PyModule_AddIntConstant(module, "SIZE_REPLAY_HEADER", SNEK8_SIZE_REPLAY_HEADER);
+    (void) PyModule_AddIntConstant(module, "ROM_CACHE_SIZE", SNEK8_ROM_CACHE_SIZE);
     (void) PyModule_AddIntConstant(module, "MEM_ADDR_PROGRM_START", SNEK8_MEM_ADDR_PROG_START);
     (void) PyModule_AddIntConstant(module, "MEM_ADDR_FONTSET_START", SNEK8_MEM_ADDR_FONTSET_START);
     (void) PyModule_AddIntConstant(module, "IMPL_MODE_SHIFTS_USE_VY", SNEK8_IMPLM_MODE_SHIFTS_USE_VY);
     (void) PyModule_AddIntConstant(module, "IMPL_MODE_BNNN_USES_VX", SNEK8_IMPLM_MODE_BNNN_USES_VX);
     (void) PyModule_AddIntConstant(module, "IMPL_MODE_FX_CHANGES_I", SNEK8_IMPLM_MODE_FX_CHANGES_I);
+    (void) PyModule_AddIntConstant(module, "STATS", SNEK8_STATS);
+    (void) PyModule_AddIntConstant(module, "BLIT_MAX_SCALE", SNEK8_BLIT_MAX_SCALE);
+    (void) PyModule_AddIntConstant(module, "AUDIO_DEFAULT_RATE", SNEK8_AUDIO_DEFAULT_RATE);
+    (void) PyModule_AddIntConstant(module, "AUDIO_DEFAULT_TONE", SNEK8_AUDIO_DEFAULT_TONE);
+    (void) PyModule_AddIntConstant(module, "AUDIO_DEFAULT_VOLUME", SNEK8_AUDIO_DEFAULT_VOLUME);
+    (void) PyModule_AddIntConstant(module, "STREAM_MAX_FRAME", SNEK8_STREAM_MAX_FRAME);
+    (void) PyModule_AddIntConstant(module, "STREAM_DEFAULT_CAPACITY", SNEK8_STREAM_DEFAULT_CAPACITY);
+    (void) PyModule_AddIntConstant(module, "STREAM_DEFAULT_KEYFRAME_INTERVAL", SNEK8_STREAM_DEFAULT_KEYFRAME_INTERVAL);
+    (void) PyModule_AddIntConstant(module, "STREAM_KEYFRAME", SNEK8_STREAM_KEYFRAME);
+    (void) PyModule_AddIntConstant(module, "STREAM_DELTA", SNEK8_STREAM_DELTA);
     return module;
 }
 
@@ -12,9 +12,12 @@
     extern "C"{
 #endif
 
-#include <time.h>
 #include <stdlib.h>
+#include <stdatomic.h>
 #include "cpu.h"
+#include "cpu_exec.h"
+#include "block.h"
+#include "rom.h"
 
 #define SIZE_U8 sizeof(uint8_t)
 #define SIZE_U16 sizeof(uint16_t)
@@ -51,84 +54,387 @@ snek8_stackPop(Snek8Stack *stack, uint16_t* pc){
     return SNEK8_EXECOUT_SUCCESS;
 }
 
+/**
+* @brief CHIP8's hexadecimal font, one 5-byte sprite per digit.
+*/
+const uint8_t snek8_fontset[SNEK8_SIZE_FONTSET_PIXELS] = {
+    0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
+    0x20, 0x60, 0x20, 0x20, 0x70, // 1
+    0xF0, 0x10, 0xF0, 0x80, 0xF0, // 2
+    0xF0, 0x10, 0xF0, 0x10, 0xF0, // 3
+    0x90, 0x90, 0xF0, 0x10, 0x10, // 4
+    0xF0, 0x80, 0xF0, 0x10, 0xF0, // 5
+    0xF0, 0x80, 0xF0, 0x90, 0xF0, // 6
+    0xF0, 0x10, 0x20, 0x40, 0x40, // 7
+    0xF0, 0x90, 0xF0, 0x90, 0xF0, // 8
+    0xF0, 0x90, 0xF0, 0x10, 0xF0, // 9
+    0xF0, 0x90, 0xF0, 0x90, 0x90, // A
+    0xE0, 0x90, 0xE0, 0x90, 0xE0, // B
+    0xF0, 0x80, 0x80, 0x80, 0xF0, // C
+    0xE0, 0x90, 0x90, 0x90, 0xE0, // D
+    0xF0, 0x80, 0xF0, 0x80, 0xF0, // E
+    0xF0, 0x80, 0xF0, 0x80, 0x80, // F
+};
+
+#define SNEK8_BCD_1(n)          {(n) / 100, (n) / 10 % 10, (n) % 10}
+#define SNEK8_BCD_4(n)          SNEK8_BCD_1(n), SNEK8_BCD_1((n) + 1), SNEK8_BCD_1((n) + 2), SNEK8_BCD_1((n) + 3)
+#define SNEK8_BCD_16(n)         SNEK8_BCD_4(n), SNEK8_BCD_4((n) + 4), SNEK8_BCD_4((n) + 8), SNEK8_BCD_4((n) + 12)
+#define SNEK8_BCD_64(n)         SNEK8_BCD_16(n), SNEK8_BCD_16((n) + 16), SNEK8_BCD_16((n) + 32), SNEK8_BCD_16((n) + 48)
+
+/**
+* @brief The decimal digits of every byte, so that LD B, V{0xX} is a single copy.
+*/
+const uint8_t snek8_bcd[256][SNEK8_SIZE_BCD_DIGITS] = {
+    SNEK8_BCD_64(0), SNEK8_BCD_64(64), SNEK8_BCD_64(128), SNEK8_BCD_64(192),
+};
+
+#undef SNEK8_BCD_64
+#undef SNEK8_BCD_16
+#undef SNEK8_BCD_4
+#undef SNEK8_BCD_1
+
 enum Snek8ExecutionOutput
 snek8_cpuInit(Snek8CPU* cpu, uint8_t implm_flags){
     if (!cpu){
         return SNEK8_EXECOUT_EMPTY_STRUCT;
     }
-    srand(time(NULL));
-    cpu->implm_flags = implm_flags;
-    uint8_t fontset[SNEK8_SIZE_FONTSET_PIXELS] = {
-        0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
-        0x20, 0x60, 0x20, 0x20, 0x70, // 1
-        0xF0, 0x10, 0xF0, 0x80, 0xF0, // 2
-        0xF0, 0x10, 0xF0, 0x10, 0xF0, // 3
-        0x90, 0x90, 0xF0, 0x10, 0x10, // 4
-        0xF0, 0x80, 0xF0, 0x10, 0xF0, // 5
-        0xF0, 0x80, 0xF0, 0x90, 0xF0, // 6
-        0xF0, 0x10, 0x20, 0x40, 0x40, // 7
-        0xF0, 0x90, 0xF0, 0x90, 0xF0, // 8
-        0xF0, 0x90, 0xF0, 0x10, 0xF0, // 9
-        0xF0, 0x90, 0xF0, 0x90, 0x90, // A
-        0xE0, 0x90, 0xE0, 0x90, 0xE0, // B
-        0xF0, 0x80, 0x80, 0x80, 0xF0, // C
-        0xE0, 0x90, 0x90, 0x90, 0xE0, // D
-        0xF0, 0x80, 0xF0, 0x80, 0xF0, // E
-        0xF0, 0x80, 0xF0, 0x80, 0x80, // F
-    };
+    snek8_opcodeTableInit();
+    (void) snek8_cpuSetImplmFlags(cpu, implm_flags);
     cpu->keys = 0;
     cpu->pc = SNEK8_MEM_ADDR_PROG_START;
     cpu->ir = 0;
-    cpu->sp = 0;
     cpu->dt = 0;
-    cpu->sp = 0;
+    cpu->st = 0;
+    cpu->key_wait = false;
+    cpu->key_armed = 0;
+    cpu->cycles = 0;
+    cpu->ips = SNEK8_CPU_DEFAULT_IPS;
+    cpu->timer_phase = 0;
+    cpu->rng = snek8_cpuSeedState(0);
+    cpu->dirty_pages = UINT16_MAX;
+    cpu->snapshot_id = 0;
+    cpu->blocks = NULL;
     (void) snek8_stackInit(&cpu->stack);
     (void) memset(&cpu->registers, 0, SNEK8_SIZE_REGISTERS * SIZE_U8);
     (void) memset(&cpu->memory, 0, SNEK8_SIZE_RAM * SIZE_U8);
-    (void) memset(&cpu->graphics, 0, SNEK8_SIZE_GRAPHICS * SIZE_U8);
-    (void) memcpy(cpu->memory + SNEK8_MEM_ADDR_FONTSET_START, fontset, SNEK8_SIZE_FONTSET_PIXELS * SIZE_U8);
+    (void) memset(&cpu->graphics, 0, SNEK8_SIZE_GRAPHICS_BYTES);
+    cpu->graphics_gen = 0;
+    cpu->graphics_dirty = UINT32_MAX;
+#if SNEK8_STATS
+    snek8_statsClear(&cpu->stats);
+#endif
+    (void) memcpy(cpu->memory + SNEK8_MEM_ADDR_FONTSET_START, snek8_fontset, SNEK8_SIZE_FONTSET_PIXELS * SIZE_U8);
     return SNEK8_EXECOUT_SUCCESS;
 }
 
+enum Snek8ExecutionOutput
+snek8_cpuReset(Snek8CPU* cpu, const Snek8CPU* image){
+    if (!cpu || !image){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    Snek8BlockCache* blocks = cpu->blocks;
+    uint32_t graphics_gen = cpu->graphics_gen;
+#if SNEK8_STATS
+    Snek8Stats stats = cpu->stats;
+#endif
+    *cpu = *image;
+    cpu->blocks = blocks;
+#if SNEK8_STATS
+    cpu->stats = stats;
+#endif
+    cpu->graphics_gen = graphics_gen + 1;
+    cpu->graphics_dirty = UINT32_MAX;
+    cpu->dirty_pages = UINT16_MAX;
+    cpu->snapshot_id = 0;
+    if (cpu->blocks){
+        snek8_blockFlush(cpu->blocks);
+    }
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+void
+snek8_statsClear(Snek8Stats* stats){
+    (void) memset(stats, 0, sizeof(Snek8Stats));
+}
+
+void
+snek8_statsDraw(Snek8Stats* stats, const uint8_t* sprite, size_t n, bool collision){
+    uint64_t pixels = 0;
+    for (size_t i = 0; i < n; i++){
+        for (uint8_t row = sprite[i]; row; row &= (uint8_t) (row - 1)){
+            pixels++;
+        }
+    }
+    stats->drw_pixels += pixels;
+    stats->drw_collisions += collision;
+}
+
 enum Snek8ExecutionOutput
 snek8_cpuLoadRom(Snek8CPU* cpu, const char* rom_file_path){
     if (!cpu){
         return SNEK8_EXECOUT_EMPTY_STRUCT;
-    }else if (!rom_file_path){
-        return SNEK8_EXECOUT_ROM_FILE_INVALID;
     }
-    FILE* rom_file = fopen(rom_file_path, "rb");
-    if (!rom_file_path){
-        return SNEK8_EXECOUT_ROM_FILE_FAILED_TO_OPEN;
+    Snek8Rom rom;
+    enum Snek8ExecutionOutput out = snek8_romRead(rom_file_path, &rom);
+    if (SNEK8_EXECOUT_SUCCESS != out){
+        return out;
+    }
+    return snek8_cpuLoadRomBytes(cpu, rom.data, rom.size);
+}
+
+enum Snek8ExecutionOutput
+snek8_cpuLoadRomBytes(Snek8CPU* cpu, const uint8_t* rom, size_t size){
+    if (!cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }else if (!rom && size){
+        return SNEK8_EXECOUT_ROM_FILE_INVALID;
     }
-    (void) fseek(rom_file, 0, SEEK_END);
-    size_t rom_size = ftell(rom_file);
-    if (rom_size > SNEK8_SIZE_MAX_ROM_FILE){
-        fclose(rom_file);
+    if (size > SNEK8_SIZE_MAX_ROM_FILE){
         return SNEK8_EXECOUT_ROM_FILE_EXCEEDS_MAX_MEM;
     }
-    rewind(rom_file);
-    size_t nread = fread(cpu->memory + SNEK8_MEM_ADDR_PROG_START, 1, rom_size, rom_file);
-    if (nread != rom_size){
-        fclose(rom_file);
-        return SNEK8_EXECOUT_ROM_FILE_FAILED_TO_READ;
+    if (size){
+        (void) memcpy(cpu->memory + SNEK8_MEM_ADDR_PROG_START, rom, size);
+    }
+    cpu->dirty_pages = UINT16_MAX;
+    if (cpu->blocks){
+        snek8_blockFlush(cpu->blocks);
     }
-    (void) fclose(rom_file);
     return SNEK8_EXECOUT_SUCCESS;
 }
 
+/*
+* Snapshots.
+*/
+
+#define SNEK8_SNAPSHOT_OFFSET_REGISTERS  44
+#define SNEK8_SNAPSHOT_OFFSET_STACK      60
+#define SNEK8_SNAPSHOT_OFFSET_GRAPHICS   92
+#define SNEK8_SNAPSHOT_OFFSET_MEMORY     348
+#define SNEK8_SNAPSHOT_OFFSET_KEY_WAIT   4444
+
+_Static_assert(SNEK8_SNAPSHOT_OFFSET_MEMORY + SNEK8_SIZE_RAM == SNEK8_SNAPSHOT_OFFSET_KEY_WAIT,
+               "The snapshot memory overlaps the key wait.");
+_Static_assert(SNEK8_SNAPSHOT_OFFSET_KEY_WAIT + 4 == SNEK8_SIZE_SNAPSHOT,
+               "The snapshot layout does not match its size.");
+_Static_assert(SNEK8_SIZE_PAGE * SNEK8_SIZE_PAGES == SNEK8_SIZE_RAM,
+               "The memory pages do not cover the RAM.");
+
+static const uint8_t _snek8_snapshot_magic[4] = {'S', '8', 'S', 'T'};
+
 /**
-* @brief Manages the CPU timers.
+* @brief Source of the snapshot identifiers, shared by all the CPUs so that a
+* snapshot taken from a CPU is never mistaken for one synchronized with another.
+*/
+static atomic_uint_fast64_t _snek8_snapshot_ids = 1;
+
+static inline void
+_snek8_snapshotPut16(uint8_t* data, uint16_t value){
+    data[0] = (uint8_t) value;
+    data[1] = (uint8_t) (value >> 8);
+}
+
+static inline void
+_snek8_snapshotPut32(uint8_t* data, uint32_t value){
+    _snek8_snapshotPut16(data, (uint16_t) value);
+    _snek8_snapshotPut16(data + 2, (uint16_t) (value >> 16));
+}
+
+static inline void
+_snek8_snapshotPut64(uint8_t* data, uint64_t value){
+    _snek8_snapshotPut32(data, (uint32_t) value);
+    _snek8_snapshotPut32(data + 4, (uint32_t) (value >> 32));
+}
+
+static inline uint16_t
+_snek8_snapshotGet16(const uint8_t* data){
+    return (uint16_t) (data[0] | (data[1] << 8));
+}
+
+static inline uint32_t
+_snek8_snapshotGet32(const uint8_t* data){
+    return _snek8_snapshotGet16(data) | ((uint32_t) _snek8_snapshotGet16(data + 2) << 16);
+}
+
+static inline uint64_t
+_snek8_snapshotGet64(const uint8_t* data){
+    return _snek8_snapshotGet32(data) | ((uint64_t) _snek8_snapshotGet32(data + 4) << 32);
+}
+
+/**
+* @brief Retrieves the memory pages that differ between the CPU and the snapshot.
+*
+* @param `cpu`.
+* @param `id` The identifier of the snapshot.
+* @return The pages written since the CPU was synchronized with the snapshot, or
+* every page if it was not.
+*/
+static inline uint16_t
+_snek8_snapshotStalePages(const Snek8CPU* cpu, uint64_t id){
+    return (id && id == cpu->snapshot_id)? cpu->dirty_pages: UINT16_MAX;
+}
+
+/**
+* @brief Serializes everything but the memory.
 *
 * @param `cpu`.
+* @param `data` The snapshot's data.
 */
 static inline void
-_snek8_cpuTickTimers(Snek8CPU* cpu){
-    if (cpu->dt){
-        cpu->dt--;
+_snek8_snapshotWriteHead(const Snek8CPU* cpu, uint8_t* data){
+    (void) memcpy(data, _snek8_snapshot_magic, sizeof(_snek8_snapshot_magic));
+    _snek8_snapshotPut16(data + 4, SNEK8_SNAPSHOT_VERSION);
+    data[6] = cpu->implm_flags & SNEK8_IMPLM_MODE_MASK;
+    data[7] = cpu->stack.sp;
+    _snek8_snapshotPut16(data + 8, cpu->pc);
+    _snek8_snapshotPut16(data + 10, cpu->ir);
+    _snek8_snapshotPut16(data + 12, cpu->keys);
+    data[14] = cpu->dt;
+    data[15] = cpu->st;
+    _snek8_snapshotPut64(data + 16, cpu->cycles);
+    _snek8_snapshotPut32(data + 24, cpu->ips);
+    _snek8_snapshotPut32(data + 28, cpu->timer_phase);
+    _snek8_snapshotPut32(data + 32, cpu->graphics_gen);
+    _snek8_snapshotPut32(data + 36, cpu->graphics_dirty);
+    _snek8_snapshotPut32(data + 40, cpu->rng);
+    (void) memcpy(data + SNEK8_SNAPSHOT_OFFSET_REGISTERS, cpu->registers, SNEK8_SIZE_REGISTERS);
+    for (size_t i = 0; i < SNEK8_SIZE_STACK; i++){
+        _snek8_snapshotPut16(data + SNEK8_SNAPSHOT_OFFSET_STACK + 2 * i, cpu->stack.buffer[i]);
+    }
+    for (size_t row = 0; row < SNEK8_GRAPHICS_HEIGTH; row++){
+        _snek8_snapshotPut64(data + SNEK8_SNAPSHOT_OFFSET_GRAPHICS + 8 * row, cpu->graphics[row]);
+    }
+    data[SNEK8_SNAPSHOT_OFFSET_KEY_WAIT] = cpu->key_wait;
+    data[SNEK8_SNAPSHOT_OFFSET_KEY_WAIT + 1] = 0;
+    _snek8_snapshotPut16(data + SNEK8_SNAPSHOT_OFFSET_KEY_WAIT + 2, cpu->key_armed);
+}
+
+enum Snek8ExecutionOutput
+snek8_cpuSnapshot(Snek8CPU* cpu, Snek8Snapshot* snapshot){
+    if (!cpu || !snapshot){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    uint8_t* data = snapshot->data;
+    _snek8_snapshotWriteHead(cpu, data);
+    uint16_t pages = _snek8_snapshotStalePages(cpu, snapshot->id);
+    for (size_t page = 0; pages; page++, pages >>= 1){
+        if (pages & 1u){
+            (void) memcpy(data + SNEK8_SNAPSHOT_OFFSET_MEMORY + page * SNEK8_SIZE_PAGE,
+                          cpu->memory + page * SNEK8_SIZE_PAGE, SNEK8_SIZE_PAGE);
+        }
+    }
+    snapshot->id = atomic_fetch_add(&_snek8_snapshot_ids, 1);
+    cpu->snapshot_id = snapshot->id;
+    cpu->dirty_pages = 0;
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+enum Snek8ExecutionOutput
+snek8_cpuSerialize(const Snek8CPU* cpu, uint8_t* data){
+    if (!cpu || !data){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    _snek8_snapshotWriteHead(cpu, data);
+    (void) memcpy(data + SNEK8_SNAPSHOT_OFFSET_MEMORY, cpu->memory, SNEK8_SIZE_RAM);
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+enum Snek8ExecutionOutput
+snek8_snapshotValidate(const uint8_t* data, size_t size){
+    if (!data){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (size != SNEK8_SIZE_SNAPSHOT
+        || memcmp(data, _snek8_snapshot_magic, sizeof(_snek8_snapshot_magic))
+        || _snek8_snapshotGet16(data + 4) != SNEK8_SNAPSHOT_VERSION
+        || (data[6] & ~SNEK8_IMPLM_MODE_MASK)
+        || data[7] > SNEK8_SIZE_STACK
+        // LD [I], V{0xX} and LD V{0xX}, [I] leave I right past the memory when they
+        // reach its last byte and increment I.
+        || _snek8_snapshotGet16(data + 10) > SNEK8_MEM_ADDR_RAM_END + 1){
+        return SNEK8_EXECOUT_SNAPSHOT_INVALID;
     }
-    if (cpu->st){
-        cpu->st--;
+    uint32_t ips = _snek8_snapshotGet32(data + 24);
+    if (ips < 1 || ips > SNEK8_CPU_MAX_IPS || _snek8_snapshotGet32(data + 28) >= ips
+        || !_snek8_snapshotGet32(data + 40)){
+        return SNEK8_EXECOUT_SNAPSHOT_INVALID;
+    }
+    const uint8_t* wait = data + SNEK8_SNAPSHOT_OFFSET_KEY_WAIT;
+    if (wait[0] > 1 || wait[1] || (!wait[0] && _snek8_snapshotGet16(wait + 2))){
+        return SNEK8_EXECOUT_SNAPSHOT_INVALID;
+    }
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+enum Snek8ExecutionOutput
+snek8_cpuRestore(Snek8CPU* cpu, const Snek8Snapshot* snapshot){
+    if (!cpu || !snapshot){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    const uint8_t* data = snapshot->data;
+    enum Snek8ExecutionOutput out = snek8_snapshotValidate(data, SNEK8_SIZE_SNAPSHOT);
+    if (SNEK8_EXECOUT_SUCCESS != out){
+        return out;
+    }
+    (void) snek8_cpuSetImplmFlags(cpu, data[6]);
+    cpu->stack.sp = data[7];
+    cpu->pc = _snek8_snapshotGet16(data + 8);
+    cpu->ir = _snek8_snapshotGet16(data + 10);
+    cpu->keys = _snek8_snapshotGet16(data + 12);
+    cpu->dt = data[14];
+    cpu->st = data[15];
+    cpu->cycles = _snek8_snapshotGet64(data + 16);
+    cpu->ips = _snek8_snapshotGet32(data + 24);
+    cpu->timer_phase = _snek8_snapshotGet32(data + 28);
+    // The screen changes to the snapshot's, which the generations seen so far predate.
+    cpu->graphics_gen++;
+    cpu->graphics_dirty = UINT32_MAX;
+    cpu->rng = _snek8_snapshotGet32(data + 40);
+    (void) memcpy(cpu->registers, data + SNEK8_SNAPSHOT_OFFSET_REGISTERS, SNEK8_SIZE_REGISTERS);
+    for (size_t i = 0; i < SNEK8_SIZE_STACK; i++){
+        cpu->stack.buffer[i] = _snek8_snapshotGet16(data + SNEK8_SNAPSHOT_OFFSET_STACK + 2 * i);
+    }
+    for (size_t row = 0; row < SNEK8_GRAPHICS_HEIGTH; row++){
+        cpu->graphics[row] = _snek8_snapshotGet64(data + SNEK8_SNAPSHOT_OFFSET_GRAPHICS + 8 * row);
+    }
+    cpu->key_wait = data[SNEK8_SNAPSHOT_OFFSET_KEY_WAIT];
+    cpu->key_armed = _snek8_snapshotGet16(data + SNEK8_SNAPSHOT_OFFSET_KEY_WAIT + 2);
+    uint16_t pages = _snek8_snapshotStalePages(cpu, snapshot->id);
+    if (UINT16_MAX == pages){
+        (void) memcpy(cpu->memory, data + SNEK8_SNAPSHOT_OFFSET_MEMORY, SNEK8_SIZE_RAM);
+        if (cpu->blocks){
+            snek8_blockFlush(cpu->blocks);
+        }
+    }else{
+        for (size_t page = 0; pages; page++, pages >>= 1){
+            if (pages & 1u){
+                (void) memcpy(cpu->memory + page * SNEK8_SIZE_PAGE,
+                              data + SNEK8_SNAPSHOT_OFFSET_MEMORY + page * SNEK8_SIZE_PAGE,
+                              SNEK8_SIZE_PAGE);
+                if (cpu->blocks){
+                    snek8_blockInvalidate(cpu->blocks, (uint16_t) (page * SNEK8_SIZE_PAGE),
+                                          SNEK8_SIZE_PAGE);
+                }
+            }
+        }
+    }
+    cpu->snapshot_id = snapshot->id;
+    cpu->dirty_pages = snapshot->id? 0: UINT16_MAX;
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+/**
+* @brief Retires an instruction: counts it and ticks the timers when due.
+*
+* @param `cpu`.
+*/
+static inline void
+_snek8_cpuRetire(Snek8CPU* cpu){
+    cpu->cycles++;
+    SNEK8_STATS_CYCLES(cpu, 1);
+    uint32_t ticks = snek8_cpuClockTicks(&cpu->timer_phase, cpu->ips, 1);
+    if (ticks){
+        cpu->dt = (cpu->dt > ticks)? cpu->dt - ticks: 0;
+        cpu->st = (cpu->st > ticks)? cpu->st - ticks: 0;
     }
 }
 
@@ -147,6 +453,21 @@ _snek8_cpuDecrementPC(Snek8CPU* cpu){
     cpu->pc -= 2;
 }
 
+/**
+* @brief Notifies the attached block cache, if any, of a write to the memory.
+*
+* @param `cpu`.
+* @param `addr` The first address written to.
+* @param `len` The number of bytes written.
+*/
+static inline void
+_snek8_cpuOnWrite(Snek8CPU* cpu, uint16_t addr, size_t len){
+    cpu->dirty_pages |= snek8_cpuPagesMask(addr, len);
+    if (cpu->blocks){
+        snek8_blockInvalidate(cpu->blocks, addr, len);
+    }
+}
+
 /**
 * @brief Retrieves the opcode from memory.
 *
@@ -154,22 +475,62 @@ _snek8_cpuDecrementPC(Snek8CPU* cpu){
 * @return The opcode specified by the emulation process.
 */
 static inline uint16_t
-_snek8_cpuGetOpcode(Snek8CPU cpu){
-    uint16_t opcode = cpu.memory[cpu.pc];
+_snek8_cpuGetOpcode(const Snek8CPU* cpu){
+    uint16_t opcode = cpu->memory[cpu->pc & SNEK8_MEM_ADDR_RAM_END];
     opcode <<= 8;
-    opcode |= cpu.memory[cpu.pc + 1];
+    opcode |= cpu->memory[(cpu->pc + 1) & SNEK8_MEM_ADDR_RAM_END];
     return opcode;
 }
 
+enum Snek8ExecutionOutput
+snek8_cpuSeed(Snek8CPU* cpu, uint32_t seed){
+    if (!cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    cpu->rng = snek8_cpuSeedState(seed);
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+enum Snek8ExecutionOutput
+snek8_cpuSetIPS(Snek8CPU* cpu, uint32_t ips){
+    if (!cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (ips < 1 || ips > SNEK8_CPU_MAX_IPS){
+        return SNEK8_EXECOUT_INDEX_OUT_RANGE;
+    }
+    // Keep the progress towards the next tick, rescaled to the new rate.
+    cpu->timer_phase = (uint32_t) ((uint64_t) cpu->timer_phase * ips / cpu->ips);
+    cpu->ips = ips;
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
 enum Snek8ExecutionOutput
 snek8_cpuSetKey(Snek8CPU* cpu, size_t key, bool value){
     if (!cpu){
         return SNEK8_EXECOUT_EMPTY_STRUCT;
     }
+    if (key >= SNEK8_SIZE_KEYSET){
+        return SNEK8_EXECOUT_INDEX_OUT_RANGE;
+    }
+    uint16_t bit = (uint16_t) (1u << key);
+    bool was = (cpu->keys & bit)? true: false;
     if (value){
-        cpu->keys |= (1 << key);
+        cpu->keys |= bit;
     }else{
-        cpu->keys &= (~(1 << key));
+        cpu->keys &= (uint16_t) ~bit;
+    }
+    if (!cpu->key_wait || was == value){
+        return SNEK8_EXECOUT_SUCCESS;
+    }
+    if (value){
+        cpu->key_armed |= bit;
+    }else if (cpu->key_armed & bit){
+        // The program counter is still on LD V{0xX}, K.
+        cpu->registers[cpu->memory[cpu->pc & SNEK8_MEM_ADDR_RAM_END] & 0x0Fu] = (uint8_t) key;
+        _snek8_cpuIncrementPC(cpu);
+        cpu->key_wait = false;
+        cpu->key_armed = 0;
     }
     return SNEK8_EXECOUT_SUCCESS;
 }
@@ -191,7 +552,9 @@ snek8_cpuExecutionError(Snek8CPU* cpu, uint16_t opcode){
 enum Snek8ExecutionOutput
 snek8_cpuCLS(Snek8CPU* cpu, uint16_t opcode){
     UNUSED opcode;
-    UNUSED memset(&cpu->graphics, 0, SNEK8_SIZE_GRAPHICS * SIZE_U8);
+    UNUSED memset(&cpu->graphics, 0, SNEK8_SIZE_GRAPHICS_BYTES);
+    cpu->graphics_gen++;
+    cpu->graphics_dirty = UINT32_MAX;
     return SNEK8_EXECOUT_SUCCESS;
 }
 
@@ -414,12 +777,12 @@ snek8_cpuSUBN_VX_VY(Snek8CPU* cpu, uint16_t opcode){
 * and thus, if the flag assignment occurs before the SHR operation is done,
 * the value stored in V{0xF} is lost and the operation's result is incorrect.
 */
-enum Snek8ExecutionOutput
-snek8_cpuSHR_VX_VY(Snek8CPU* cpu, uint16_t opcode){
+static inline enum Snek8ExecutionOutput
+_snek8_cpuSHR_VX_VY(Snek8CPU* cpu, uint16_t opcode, bool use_vy){
     uint8_t x = snek8_opcodeGetNibble(opcode, 2);
     uint8_t y = snek8_opcodeGetNibble(opcode, 1);
     uint8_t shr_underflow = cpu->registers[x] & 0x1;
-    if (cpu->implm_flags & SNEK8_IMPLM_MODE_SHIFTS_USE_VY){
+    if (use_vy){
         cpu->registers[x] = cpu->registers[y];
     }
     cpu->registers[x] >>= 1;
@@ -427,6 +790,11 @@ snek8_cpuSHR_VX_VY(Snek8CPU* cpu, uint16_t opcode){
     return SNEK8_EXECOUT_SUCCESS;
 }
 
+enum Snek8ExecutionOutput
+snek8_cpuSHR_VX_VY(Snek8CPU* cpu, uint16_t opcode){
+    return _snek8_cpuSHR_VX_VY(cpu, opcode, cpu->implm_flags & SNEK8_IMPLM_MODE_SHIFTS_USE_VY);
+}
+
 /*
 * SHL V{0xX}, V{0xY}.
 * 0x8XYE
@@ -435,12 +803,12 @@ snek8_cpuSHR_VX_VY(Snek8CPU* cpu, uint16_t opcode){
 * and thus, if the flag assignment occurs before the SHR operation is done,
 * the value stored in V{0xF} is lost and the operation's result is incorrect.
 */
-enum Snek8ExecutionOutput
-snek8_cpuSHL_VX_VY(Snek8CPU* cpu, uint16_t opcode){
+static inline enum Snek8ExecutionOutput
+_snek8_cpuSHL_VX_VY(Snek8CPU* cpu, uint16_t opcode, bool use_vy){
     uint8_t x = snek8_opcodeGetNibble(opcode, 2);
     uint8_t y = snek8_opcodeGetNibble(opcode, 1);
     uint8_t shl_overflow = (cpu->registers[x] & 0x80) >> 7u;
-    if (cpu->implm_flags & SNEK8_IMPLM_MODE_SHIFTS_USE_VY){
+    if (use_vy){
             cpu->registers[x] = cpu->registers[y];
     }
     cpu->registers[x] <<= 1;
@@ -448,6 +816,11 @@ snek8_cpuSHL_VX_VY(Snek8CPU* cpu, uint16_t opcode){
     return SNEK8_EXECOUT_SUCCESS;
 }
 
+enum Snek8ExecutionOutput
+snek8_cpuSHL_VX_VY(Snek8CPU* cpu, uint16_t opcode){
+    return _snek8_cpuSHL_VX_VY(cpu, opcode, cpu->implm_flags & SNEK8_IMPLM_MODE_SHIFTS_USE_VY);
+}
+
 /*
 * LD I, 0x0NNN
 * 0xANNN
@@ -465,17 +838,22 @@ snek8_cpuLD_I_ADDR(Snek8CPU* cpu, uint16_t opcode){
 * JP V{0xX}, 0x0XNN.
 * 0xBXNN
 */
-enum Snek8ExecutionOutput
-snek8_cpuJP_V0_ADDR(Snek8CPU* cpu, uint16_t opcode){
+static inline enum Snek8ExecutionOutput
+_snek8_cpuJP_V0_ADDR(Snek8CPU* cpu, uint16_t opcode, bool uses_vx){
     uint16_t addr = snek8_opcodeGetAddr(opcode);
     uint8_t x = 0;
-    if (cpu->implm_flags & SNEK8_IMPLM_MODE_BNNN_USES_VX){
-        x = snek8_opcodeGetNibble(opcode, x);
+    if (uses_vx){
+        x = snek8_opcodeGetNibble(opcode, 2);
     }
     cpu->pc = addr + cpu->registers[x];
     return SNEK8_EXECOUT_SUCCESS;
 }
 
+enum Snek8ExecutionOutput
+snek8_cpuJP_V0_ADDR(Snek8CPU* cpu, uint16_t opcode){
+    return _snek8_cpuJP_V0_ADDR(cpu, opcode, cpu->implm_flags & SNEK8_IMPLM_MODE_BNNN_USES_VX);
+}
+
 /*
 * RND V{0xX}, 0xKK.
 */
@@ -483,7 +861,7 @@ enum Snek8ExecutionOutput
 snek8_cpuRND_VX_BYTE(Snek8CPU* cpu, uint16_t opcode){
     uint8_t kk = snek8_opcodeGetByte(opcode);
     uint8_t x = snek8_opcodeGetNibble(opcode, 2);
-    cpu->registers[x] = rand() & kk;
+    cpu->registers[x] = snek8_cpuRand(&cpu->rng) & kk;
     return SNEK8_EXECOUT_SUCCESS;
 }
 
@@ -501,19 +879,19 @@ snek8_cpuDRW_VX_VY_N(Snek8CPU* cpu, uint16_t opcode){
     if (cpu->ir + n > SNEK8_MEM_ADDR_RAM_END){
         return SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS;
     }
-    uint8_t px = cpu->registers[x];
+    uint8_t px = cpu->registers[x] & 63;
     uint8_t py = cpu->registers[y];
     for (uint8_t col = 0; col < n; col++){
-        uint8_t byte = cpu->memory[cpu->ir + col];
-        for (uint8_t row = 0; row < 8; row++){
-            uint8_t bit = byte & (0x80u >> row);
-            uint8_t* pixel_ptr = snek8_cpuGetPixel(cpu, px + row, py + col);
-            *pixel_ptr ^= bit;
-            if (bit && *pixel_ptr == 0){
-                cpu->registers[0xF] = 1;
-            }
+        uint64_t sprite = snek8_cpuSpriteRow(cpu->memory[cpu->ir + col], px);
+        uint64_t* line = &cpu->graphics[(py + col) & 31];
+        if (*line & sprite){
+            cpu->registers[0xF] = 1;
         }
+        *line ^= sprite;
     }
+    cpu->graphics_gen++;
+    cpu->graphics_dirty |= snek8_cpuSpriteRows(py, n);
+    SNEK8_STATS_DRAW(cpu, cpu->memory + cpu->ir, n, cpu->registers[0xF]);
     return SNEK8_EXECOUT_SUCCESS;
 }
 
@@ -525,7 +903,7 @@ enum Snek8ExecutionOutput
 snek8_cpuSKP_VX(Snek8CPU* cpu, uint16_t opcode){
     uint8_t x = snek8_opcodeGetNibble(opcode, 2);
     uint8_t key = cpu->registers[x];
-    if (snek8_cpuGetKeyVal(*cpu, key)){
+    if (snek8_cpuGetKeyVal(cpu, key)){
         _snek8_cpuIncrementPC(cpu);
     }
     return SNEK8_EXECOUT_SUCCESS;
@@ -539,7 +917,7 @@ enum Snek8ExecutionOutput
 snek8_cpuSKNP_VX(Snek8CPU* cpu, uint16_t opcode){
     uint8_t x = snek8_opcodeGetNibble(opcode, 2);
     uint8_t key = cpu->registers[x];
-    if (!snek8_cpuGetKeyVal(*cpu, key)){
+    if (!snek8_cpuGetKeyVal(cpu, key)){
         _snek8_cpuIncrementPC(cpu);
     }
     return SNEK8_EXECOUT_SUCCESS;
@@ -562,17 +940,13 @@ snek8_cpuLD_VX_DT(Snek8CPU* cpu, uint16_t opcode){
 */
 enum Snek8ExecutionOutput
 snek8_cpuLD_VX_K(Snek8CPU* cpu, uint16_t opcode){
-    uint8_t x = snek8_opcodeGetNibble(opcode, 2);
-    if (!cpu->keys){
-        _snek8_cpuDecrementPC(cpu);
-        return SNEK8_EXECOUT_SUCCESS;
-    }
-    for (size_t key = 0; key < SNEK8_SIZE_KEYSET; key++){
-        if (snek8_cpuGetKeyVal(*cpu, key)){
-            cpu->registers[x] = key;
-            break;
-        }
+    UNUSED opcode;
+    // V{0xX} is loaded by `snek8_cpuSetKey`, once a key is pressed and released.
+    if (!cpu->key_wait){
+        cpu->key_wait = true;
+        cpu->key_armed = 0;
     }
+    _snek8_cpuDecrementPC(cpu);
     return SNEK8_EXECOUT_SUCCESS;
 }
 
@@ -630,12 +1004,8 @@ snek8_cpuLD_B_VX(Snek8CPU* cpu, uint16_t opcode){
         return SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS;
     }
     uint8_t x = snek8_opcodeGetNibble(opcode, 2);
-    uint8_t value = cpu->registers[x];
-    cpu->memory[cpu->ir + 2] = value % 10;
-    value /= 10;
-    cpu->memory[cpu->ir + 1] = value % 10;
-    value /= 10;
-    cpu->memory[cpu->ir] = value % 10;
+    (void) memcpy(cpu->memory + cpu->ir, snek8_bcd[cpu->registers[x]], SNEK8_SIZE_BCD_DIGITS);
+    _snek8_cpuOnWrite(cpu, cpu->ir, SNEK8_SIZE_BCD_DIGITS);
     return SNEK8_EXECOUT_SUCCESS;
 }
 
@@ -643,48 +1013,136 @@ snek8_cpuLD_B_VX(Snek8CPU* cpu, uint16_t opcode){
 * LD [I], V{0xX}
 * 0xFX55
 */
-enum Snek8ExecutionOutput
-snek8_cpuLD_I_V0_VX(Snek8CPU* cpu, uint16_t opcode){
+static inline enum Snek8ExecutionOutput
+_snek8_cpuLD_I_V0_VX(Snek8CPU* cpu, uint16_t opcode, bool changes_i){
     uint8_t x = snek8_opcodeGetNibble(opcode, 2);
     if (cpu->ir + x > SNEK8_MEM_ADDR_RAM_END){
         return SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS;
     }
-    if (cpu->implm_flags & SNEK8_IMPLM_MODE_FX_CHANGES_I){
-        for (uint8_t i = 0; i <= x; i++){
-            cpu->memory[cpu->ir + i] = cpu->registers[i];
-            cpu->ir++;
-        }
-    }else {
-        for (uint8_t i = 0; i <= x; i++){
-            cpu->memory[cpu->ir + i] = cpu->registers[i];
-        }
+    snek8_cpuCopyRegisters(cpu->memory + cpu->ir, cpu->registers, x + 1);
+    _snek8_cpuOnWrite(cpu, cpu->ir, x + 1);
+    if (changes_i){
+        cpu->ir += x + 1;
     }
     return SNEK8_EXECOUT_SUCCESS;
 }
 
+enum Snek8ExecutionOutput
+snek8_cpuLD_I_V0_VX(Snek8CPU* cpu, uint16_t opcode){
+    return _snek8_cpuLD_I_V0_VX(cpu, opcode, cpu->implm_flags & SNEK8_IMPLM_MODE_FX_CHANGES_I);
+}
+
 /*
 * LD V{0xX}, [I]
 * 0xFX65
 */
-enum Snek8ExecutionOutput
-snek8_cpuLD_VX_V0_I(Snek8CPU* cpu, uint16_t opcode){
+static inline enum Snek8ExecutionOutput
+_snek8_cpuLD_VX_V0_I(Snek8CPU* cpu, uint16_t opcode, bool changes_i){
     uint8_t x = snek8_opcodeGetNibble(opcode, 2);
     if (cpu->ir + x > SNEK8_MEM_ADDR_RAM_END){
         return SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS;
     }
-    if (cpu->implm_flags & SNEK8_IMPLM_MODE_FX_CHANGES_I){
-        for (uint8_t i=0; i<=x; i++){
-            cpu->registers[i] = cpu->memory[cpu->ir + i];
-            cpu->ir++;
-        }
-    }else {
-        for (uint8_t i=0; i<=x; i++){
-            cpu->registers[i] = cpu->memory[cpu->ir + i];
-        }
+    snek8_cpuCopyRegisters(cpu->registers, cpu->memory + cpu->ir, x + 1);
+    if (changes_i){
+        cpu->ir += x + 1;
     }
     return SNEK8_EXECOUT_SUCCESS;
 }
 
+enum Snek8ExecutionOutput
+snek8_cpuLD_VX_V0_I(Snek8CPU* cpu, uint16_t opcode){
+    return _snek8_cpuLD_VX_V0_I(cpu, opcode, cpu->implm_flags & SNEK8_IMPLM_MODE_FX_CHANGES_I);
+}
+
+/*
+* Handler sets of the reference engine.
+*
+* The handlers of the families depending on a flag are generated for both values of
+* the flag from the functions above, in which the flag then folds away.
+*/
+#define SNEK8_CPU_QUIRK_HANDLERS(family)                                            \
+    static enum Snek8ExecutionOutput                                                \
+    _snek8_cpu##family##_0(Snek8CPU* cpu, uint16_t opcode){                         \
+        return _snek8_cpu##family(cpu, opcode, false);                              \
+    }                                                                               \
+    static enum Snek8ExecutionOutput                                                \
+    _snek8_cpu##family##_1(Snek8CPU* cpu, uint16_t opcode){                         \
+        return _snek8_cpu##family(cpu, opcode, true);                               \
+    }
+
+SNEK8_CPU_QUIRK_HANDLERS(SHR_VX_VY)
+SNEK8_CPU_QUIRK_HANDLERS(SHL_VX_VY)
+SNEK8_CPU_QUIRK_HANDLERS(JP_V0_ADDR)
+SNEK8_CPU_QUIRK_HANDLERS(LD_I_V0_VX)
+SNEK8_CPU_QUIRK_HANDLERS(LD_VX_V0_I)
+
+#define snek8_cpuNOP            snek8_cpuExecutionError
+#define SNEK8_CPU_HANDLER(family)       snek8_cpu##family
+#define SNEK8_CPU_HANDLER_Q(family, b)  _snek8_cpu##family##_##b
+
+static const Snek8InstructionExec _snek8_exec_tables[SNEK8_SIZE_QUIRK_SETS][SNEK8_INSTRUC_COUNT] =
+    SNEK8_EXEC_HANDLER_SETS(SNEK8_CPU_HANDLER, SNEK8_CPU_HANDLER_Q);
+
+#undef SNEK8_CPU_HANDLER_Q
+#undef SNEK8_CPU_HANDLER
+#undef snek8_cpuNOP
+
+static const Snek8InstructionExec*
+_snek8_opcodeHandlers(uint8_t quirks);
+
+enum Snek8ExecutionOutput
+snek8_cpuSetImplmFlags(Snek8CPU* cpu, uint8_t implm_flags){
+    if (!cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    cpu->implm_flags = implm_flags;
+    cpu->exec_table = _snek8_opcodeHandlers(implm_flags & SNEK8_IMPLM_MODE_MASK);
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+static const char* const _snek8_family_names[SNEK8_INSTRUC_COUNT] = {
+    [SNEK8_INSTRUC_NOP] = "NOP",
+    [SNEK8_INSTRUC_CLS] = "CLS",
+    [SNEK8_INSTRUC_RET] = "RET",
+    [SNEK8_INSTRUC_JMP_ADDR] = "JMP_ADDR",
+    [SNEK8_INSTRUC_CALL] = "CALL",
+    [SNEK8_INSTRUC_SE_VX_BYTE] = "SE_VX_BYTE",
+    [SNEK8_INSTRUC_SNE_VX_BYTE] = "SNE_VX_BYTE",
+    [SNEK8_INSTRUC_SE_VX_VY] = "SE_VX_VY",
+    [SNEK8_INSTRUC_LD_VX_BYTE] = "LD_VX_BYTE",
+    [SNEK8_INSTRUC_ADD_VX_BYTE] = "ADD_VX_BYTE",
+    [SNEK8_INSTRUC_LD_VX_VY] = "LD_VX_VY",
+    [SNEK8_INSTRUC_OR_VX_VY] = "OR_VX_VY",
+    [SNEK8_INSTRUC_AND_VX_VY] = "AND_VX_VY",
+    [SNEK8_INSTRUC_XOR_VX_VY] = "XOR_VX_VY",
+    [SNEK8_INSTRUC_ADD_VX_VY] = "ADD_VX_VY",
+    [SNEK8_INSTRUC_SUB_VX_VY] = "SUB_VX_VY",
+    [SNEK8_INSTRUC_SHR_VX_VY] = "SHR_VX_VY",
+    [SNEK8_INSTRUC_SUBN_VX_VY] = "SUBN_VX_VY",
+    [SNEK8_INSTRUC_SHL_VX_VY] = "SHL_VX_VY",
+    [SNEK8_INSTRUC_SNE_VX_VY] = "SNE_VX_VY",
+    [SNEK8_INSTRUC_LD_I_ADDR] = "LD_I_ADDR",
+    [SNEK8_INSTRUC_JP_V0_ADDR] = "JP_V0_ADDR",
+    [SNEK8_INSTRUC_RND_VX_BYTE] = "RND_VX_BYTE",
+    [SNEK8_INSTRUC_DRW_VX_VY_N] = "DRW_VX_VY_N",
+    [SNEK8_INSTRUC_SKP_VX] = "SKP_VX",
+    [SNEK8_INSTRUC_SKNP_VX] = "SKNP_VX",
+    [SNEK8_INSTRUC_LD_VX_DT] = "LD_VX_DT",
+    [SNEK8_INSTRUC_LD_VX_K] = "LD_VX_K",
+    [SNEK8_INSTRUC_LD_DT_VX] = "LD_DT_VX",
+    [SNEK8_INSTRUC_LD_ST_VX] = "LD_ST_VX",
+    [SNEK8_INSTRUC_ADD_I_VX] = "ADD_I_VX",
+    [SNEK8_INSTRUC_LD_F_VX] = "LD_F_VX",
+    [SNEK8_INSTRUC_LD_B_VX] = "LD_B_VX",
+    [SNEK8_INSTRUC_LD_I_V0_VX] = "LD_I_V0_VX",
+    [SNEK8_INSTRUC_LD_VX_V0_I] = "LD_VX_V0_I",
+};
+
+const char*
+snek8_familyName(enum Snek8InstructionFamily family){
+    return ((unsigned) family < SNEK8_INSTRUC_COUNT)? _snek8_family_names[family]: NULL;
+}
+
 Snek8Instruction
 snek8_opcodeDecode(uint16_t opcode){
     Snek8Instruction instruction;
@@ -697,17 +1155,22 @@ snek8_opcodeDecode(uint16_t opcode){
                 case 0x0:
                     instruction = (Snek8Instruction) {
                         .code = "CLS",
-                        .exec = snek8_cpuCLS};
+                        .exec = snek8_cpuCLS,
+                        .family = SNEK8_INSTRUC_CLS,
+                    };
                     break;
                 case 0xE:
                     instruction = (Snek8Instruction) {
                         .code="RET",
-                        .exec = snek8_cpuRET};
+                        .exec = snek8_cpuRET,
+                        .family = SNEK8_INSTRUC_RET,
+                    };
                     break;
                 default:
                     instruction = (Snek8Instruction) {
-                        .code = "NOP", 
-                        .exec = snek8_cpuExecutionError
+                        .code = "NOP",
+                        .exec = snek8_cpuExecutionError,
+                        .family = SNEK8_INSTRUC_NOP,
                     };
                     break;
             }
@@ -716,42 +1179,49 @@ snek8_opcodeDecode(uint16_t opcode){
             instruction = (Snek8Instruction) {
                 .code = "JP 0x0NNN",
                 .exec = snek8_cpuJMP_ADDR,
+                .family = SNEK8_INSTRUC_JMP_ADDR,
             };
             break;
         case 0x2:
             instruction = (Snek8Instruction) {
                 .code = "CALL 0x0NNN",
                 .exec = snek8_cpuCALL,
+                .family = SNEK8_INSTRUC_CALL,
             };
             break;
         case 0x3:
             instruction = (Snek8Instruction) {
                 .code = "SE V{0xX}, 0xKK",
                 .exec = snek8_cpuSE_VX_BYTE,
+                .family = SNEK8_INSTRUC_SE_VX_BYTE,
             };
             break;
         case 0x4:
             instruction = (Snek8Instruction) {
                 .code = "SNE V{0xX}, 0xKK",
                 .exec = snek8_cpuSNE_VX_BYTE,
+                .family = SNEK8_INSTRUC_SNE_VX_BYTE,
             };
             break;
         case 0x5:
             instruction = (Snek8Instruction) {
                 .code = "SE V{0xX}, V{0xY}",
                 .exec = snek8_cpuSE_VX_VY,
+                .family = SNEK8_INSTRUC_SE_VX_VY,
             };
             break;
         case 0x6:
             instruction = (Snek8Instruction) {
                 .code = "LD V{0xX}, 0xKK",
                 .exec = snek8_cpuLD_VX_BYTE,
+                .family = SNEK8_INSTRUC_LD_VX_BYTE,
             };
             break;
         case 0x7:
             instruction = (Snek8Instruction) {
                 .code = "ADD V{0xX}, 0xKK",
                 .exec = snek8_cpuADD_VX_BYTE,
+                .family = SNEK8_INSTRUC_ADD_VX_BYTE,
             };
             break;
         case 0x8:
@@ -760,60 +1230,70 @@ snek8_opcodeDecode(uint16_t opcode){
                     instruction = (Snek8Instruction) {
                         .code = "LD V{0xX}, V{0xY}",
                         .exec = snek8_cpuLD_VX_VY,
+                        .family = SNEK8_INSTRUC_LD_VX_VY,
                     };
                     break;
                 case 0x1:
                     instruction = (Snek8Instruction) {
                         .code = "OR V{0xX}, V{0xY}",
                         .exec = snek8_cpuOR_VX_VY,
+                        .family = SNEK8_INSTRUC_OR_VX_VY,
                     };
                     break;
                 case 0x2:
                     instruction = (Snek8Instruction) {
                         .code = "AND V{0xX}, V{0xY}",
                         .exec = snek8_cpuAND_VX_VY,
+                        .family = SNEK8_INSTRUC_AND_VX_VY,
                     };
                     break;
                 case 0x3:
                     instruction = (Snek8Instruction) {
                         .code = "XOR V{0xX}, V{0xY}",
                         .exec = snek8_cpuXOR_VX_VY,
+                        .family = SNEK8_INSTRUC_XOR_VX_VY,
                     };
                     break;
                 case 0x4:
                     instruction = (Snek8Instruction) {
                         .code = "ADD V{0xX}, V{0xY}",
                         .exec = snek8_cpuADD_VX_VY,
+                        .family = SNEK8_INSTRUC_ADD_VX_VY,
                     };
                     break;
                 case 0x5:
                     instruction = (Snek8Instruction) {
                         .code = "SUB V{0xX}, V{0xY}",
                         .exec = snek8_cpuSUB_VX_VY,
+                        .family = SNEK8_INSTRUC_SUB_VX_VY,
                     };
                     break;
                 case 0x6:
                     instruction = (Snek8Instruction) {
                         .code = "SHR V{0xX}, V{0xY}",
                         .exec = snek8_cpuSHR_VX_VY,
+                        .family = SNEK8_INSTRUC_SHR_VX_VY,
                     };
                     break;
                 case 0x7:
                     instruction = (Snek8Instruction) {
                         .code = "SUBN V{0xX}, V{0xY}",
                         .exec = snek8_cpuSUBN_VX_VY,
+                        .family = SNEK8_INSTRUC_SUBN_VX_VY,
                     };
                     break;
                 case 0xE:
                     instruction = (Snek8Instruction) {
                         .code = "SHL V{0xX}, V{0xY}",
                         .exec = snek8_cpuSHL_VX_VY,
+                        .family = SNEK8_INSTRUC_SHL_VX_VY,
                     };
                     break;
                 default:
                     instruction = (Snek8Instruction) {
                         .code = "NOP",
                         .exec = snek8_cpuExecutionError,
+                        .family = SNEK8_INSTRUC_NOP,
                     };
                     break;
             }
@@ -822,30 +1302,35 @@ snek8_opcodeDecode(uint16_t opcode){
                 instruction = (Snek8Instruction) {
                     .code = "SNE V{0xX}, V{0xY}",
                     .exec = snek8_cpuSNE_VX_VY,
+                    .family = SNEK8_INSTRUC_SNE_VX_VY,
                 };
             break;
         case 0xA:
                 instruction = (Snek8Instruction) {
                     .code = "LD I, 0x0NNN",
                     .exec = snek8_cpuLD_I_ADDR,
+                    .family = SNEK8_INSTRUC_LD_I_ADDR,
                 };
             break;
         case 0xB:
                 instruction = (Snek8Instruction) {
                     .code = "JP V{0x0}, 0x0NNN",
                     .exec = snek8_cpuJP_V0_ADDR,
+                    .family = SNEK8_INSTRUC_JP_V0_ADDR,
                 };
             break;
         case 0xC:
                 instruction = (Snek8Instruction) {
                     .code = "RND V{0xX}, 0xKK",
                     .exec = snek8_cpuRND_VX_BYTE,
+                    .family = SNEK8_INSTRUC_RND_VX_BYTE,
                 };
             break;
         case 0xD:
                 instruction = (Snek8Instruction) {
                     .code = "DRW V{0xX}, V{0xY}, 0xN",
                     .exec = snek8_cpuDRW_VX_VY_N,
+                    .family = SNEK8_INSTRUC_DRW_VX_VY_N,
                 };
             break;
         case 0xE:
@@ -854,18 +1339,21 @@ snek8_opcodeDecode(uint16_t opcode){
                     instruction = (Snek8Instruction) {
                         .code = "SKP V{0xX}",
                         .exec = snek8_cpuSKP_VX,
+                        .family = SNEK8_INSTRUC_SKP_VX,
                     };
                     break;
                 case 0x1:
                     instruction = (Snek8Instruction) {
                         .code = "SKNP V{0xX}",
                         .exec = snek8_cpuSKNP_VX,
+                        .family = SNEK8_INSTRUC_SKNP_VX,
                     };
                     break;
                 default:
                     instruction = (Snek8Instruction) {
                         .code = "NOP",
-                        .exec = snek8_cpuExecutionError, };
+                        .exec = snek8_cpuExecutionError,
+                        .family = SNEK8_INSTRUC_NOP, };
                     break;
             }
             break;
@@ -875,12 +1363,14 @@ snek8_opcodeDecode(uint16_t opcode){
                     instruction = (Snek8Instruction) {
                         .code = "LD V{0xX}, DT",
                         .exec = snek8_cpuLD_VX_DT,
+                        .family = SNEK8_INSTRUC_LD_VX_DT,
                     };
                     break;
                 case 0xA:
                     instruction = (Snek8Instruction) {
                         .code = "LD V{0xX}, K{0xK}",
                         .exec = snek8_cpuLD_VX_K,
+                        .family = SNEK8_INSTRUC_LD_VX_K,
                     };
                     break;
                 case 0x5:
@@ -889,24 +1379,28 @@ snek8_opcodeDecode(uint16_t opcode){
                             instruction = (Snek8Instruction) {
                                 .code = "LD DT, V{0xX}",
                                 .exec = snek8_cpuLD_DT_VX,
+                                .family = SNEK8_INSTRUC_LD_DT_VX,
                             };
                             break;
                         case 0x5:
                             instruction = (Snek8Instruction) {
                                 .code = "LD [I], V{0xX}",
                                 .exec = snek8_cpuLD_I_V0_VX,
+                                .family = SNEK8_INSTRUC_LD_I_V0_VX,
                             };
                             break;
                         case 0x6:
                             instruction = (Snek8Instruction) {
                                 .code = "LD V{0xX}, [I]",
                                 .exec = snek8_cpuLD_VX_V0_I,
+                                .family = SNEK8_INSTRUC_LD_VX_V0_I,
                             };
                             break;
                         default:
                             instruction = (Snek8Instruction) {
                                 .code = "NOP",
                                 .exec = snek8_cpuExecutionError,
+                                .family = SNEK8_INSTRUC_NOP,
                             };
                             break;
                     }
@@ -915,30 +1409,35 @@ snek8_opcodeDecode(uint16_t opcode){
                     instruction = (Snek8Instruction) {
                         .code = "LD ST, V{0xX}",
                         .exec = snek8_cpuLD_ST_VX,
+                        .family = SNEK8_INSTRUC_LD_ST_VX,
                     };
                     break;
                 case 0xE:
                     instruction = (Snek8Instruction) {
                         .code = "ADD I, V{0xX}",
                         .exec = snek8_cpuADD_I_VX,
+                        .family = SNEK8_INSTRUC_ADD_I_VX,
                     };
                     break;
                 case 0x9:
                     instruction = (Snek8Instruction) {
                         .code = "LD F, V{0xX}",
                         .exec = snek8_cpuLD_F_VX,
+                        .family = SNEK8_INSTRUC_LD_F_VX,
                     };
                     break;
                 case 0x3:
                     instruction = (Snek8Instruction) {
                         .code = "LD B, V{0xX}",
                         .exec = snek8_cpuLD_B_VX,
+                        .family = SNEK8_INSTRUC_LD_B_VX,
                     };
                     break;
                 default:
                     instruction = (Snek8Instruction) {
                         .code = "NOP",
                         .exec = snek8_cpuExecutionError,
+                        .family = SNEK8_INSTRUC_NOP,
                     };
                     break;
             }
@@ -947,16 +1446,599 @@ snek8_opcodeDecode(uint16_t opcode){
     return instruction;
 }
 
+/**
+* @brief The states of a table built once by the first of its (possibly concurrent)
+* users.
+*/
+enum{
+    SNEK8_TABLE_EMPTY = 0,
+    SNEK8_TABLE_BUILDING,
+    SNEK8_TABLE_READY,
+};
+
+/**
+* @brief Whether the caller has to build a table: true for exactly one caller, which
+* must then call `_snek8_tableReady`. The others wait until it did.
+*/
+static bool
+_snek8_tableClaim(atomic_uchar* state){
+    unsigned char expected = SNEK8_TABLE_EMPTY;
+    if (atomic_load_explicit(state, memory_order_acquire) == SNEK8_TABLE_READY){
+        return false;
+    }
+    if (atomic_compare_exchange_strong_explicit(state, &expected, SNEK8_TABLE_BUILDING,
+                                                memory_order_acquire, memory_order_acquire)){
+        return true;
+    }
+    while (atomic_load_explicit(state, memory_order_acquire) != SNEK8_TABLE_READY){
+        ;
+    }
+    return false;
+}
+
+static inline void
+_snek8_tableReady(atomic_uchar* state){
+    atomic_store_explicit(state, SNEK8_TABLE_READY, memory_order_release);
+}
+
+/**
+* @brief The opcode dispatch table.
+*
+* @see snek8_opcodeTableInit.
+*/
+static Snek8InstructionExec _snek8_opcode_table[SNEK8_SIZE_OPCODE_TABLE];
+static uint8_t _snek8_family_table[SNEK8_SIZE_OPCODE_TABLE];
+static atomic_uchar _snek8_opcode_table_state = SNEK8_TABLE_EMPTY;
+
+void
+snek8_opcodeTableInit(void){
+    if (!_snek8_tableClaim(&_snek8_opcode_table_state)){
+        return;
+    }
+    for (size_t opcode = 0; opcode < SNEK8_SIZE_OPCODE_TABLE; opcode++){
+        Snek8Instruction instruction = snek8_opcodeDecode((uint16_t) opcode);
+        _snek8_opcode_table[opcode] = instruction.exec;
+        _snek8_family_table[opcode] = (uint8_t) instruction.family;
+    }
+    _snek8_tableReady(&_snek8_opcode_table_state);
+}
+
+/**
+* @brief The handlers of the reference engine by opcode, for every quirk set: the
+* family table and the handler sets folded together, so dispatching an opcode is a
+* single load.
+*
+* Each table takes 512 KiB, so it is only built when a CPU first selects its quirk
+* set; the tables of the sets never selected stay untouched (zero) pages.
+*/
+static Snek8InstructionExec _snek8_opcode_handlers[SNEK8_SIZE_QUIRK_SETS][SNEK8_SIZE_OPCODE_TABLE];
+static atomic_uchar _snek8_opcode_handlers_state[SNEK8_SIZE_QUIRK_SETS];
+
+static const Snek8InstructionExec*
+_snek8_opcodeHandlers(uint8_t quirks){
+    Snek8InstructionExec* handlers = _snek8_opcode_handlers[quirks];
+    if (_snek8_tableClaim(&_snek8_opcode_handlers_state[quirks])){
+        snek8_opcodeTableInit();
+        for (size_t opcode = 0; opcode < SNEK8_SIZE_OPCODE_TABLE; opcode++){
+            handlers[opcode] = _snek8_exec_tables[quirks][_snek8_family_table[opcode]];
+        }
+        _snek8_tableReady(&_snek8_opcode_handlers_state[quirks]);
+    }
+    return handlers;
+}
+
+Snek8InstructionExec
+snek8_opcodeLookup(uint16_t opcode){
+    return _snek8_opcode_table[opcode];
+}
+
+enum Snek8InstructionFamily
+snek8_opcodeFamily(uint16_t opcode){
+    return (enum Snek8InstructionFamily) _snek8_family_table[opcode];
+}
+
 enum Snek8ExecutionOutput
 snek8_cpuStep(Snek8CPU* cpu, Snek8Instruction* instruction){
-    uint16_t opcode = _snek8_cpuGetOpcode(*cpu);
+    uint16_t opcode = _snek8_cpuGetOpcode(cpu);
+    if (cpu->key_wait){
+        if (instruction){
+            *instruction = snek8_opcodeDecode(opcode);
+        }
+        return snek8_cpuRunWaiting(cpu, 1, 0, NULL, NULL);
+    }
     _snek8_cpuIncrementPC(cpu);
-    *instruction = snek8_opcodeDecode(opcode);
-    enum Snek8ExecutionOutput out = instruction->exec(cpu, opcode);
-    _snek8_cpuTickTimers(cpu);
+    SNEK8_STATS_INSTRUC(cpu, _snek8_family_table[opcode]);
+    enum Snek8ExecutionOutput out;
+    if (instruction){
+        *instruction = snek8_opcodeDecode(opcode);
+        out = instruction->exec(cpu, opcode);
+    }else{
+        out = cpu->exec_table[opcode](cpu, opcode);
+    }
+    _snek8_cpuRetire(cpu);
     return out;
 }
 
+size_t
+snek8_cpuIdleSkip(Snek8CPU* cpu, Snek8IdleWatch* watch, size_t budget){
+    bool reads_dt = false;
+    size_t length = snek8_cpuIdleLoop(cpu->memory, cpu->pc, cpu->registers, cpu->dt,
+                                      cpu->keys, cpu->implm_flags, &reads_dt);
+    snek8_idleWatchUpdate(watch, 0 != length);
+    if (!length){
+        return 0;
+    }
+    size_t idle = snek8_cpuIdleCycles(length, reads_dt, cpu->dt, cpu->timer_phase, cpu->ips, budget);
+    snek8_cpuClockIdle(&cpu->timer_phase, cpu->ips, &cpu->dt, &cpu->st, idle);
+    SNEK8_STATS_SKIPPED(cpu, idle);
+    return idle;
+}
+
+enum Snek8ExecutionOutput
+snek8_cpuRun(Snek8CPU* cpu, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+             enum Snek8RunStop* stop){
+    if (!cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    enum Snek8ExecutionOutput out = SNEK8_EXECOUT_SUCCESS;
+    enum Snek8RunStop reason = SNEK8_RUNSTOP_CYCLES;
+    size_t executed = 0;
+    const Snek8InstructionExec* const exec_table = cpu->exec_table;
+    while (executed < max_cycles){
+        if (cpu->key_wait){
+            size_t idle = 0;
+            out = snek8_cpuRunWaiting(cpu, max_cycles - executed, break_flags, &idle, &reason);
+            executed += idle;
+            break;
+        }
+        uint16_t opcode = _snek8_cpuGetOpcode(cpu);
+        _snek8_cpuIncrementPC(cpu);
+        SNEK8_STATS_INSTRUC(cpu, _snek8_family_table[opcode]);
+        out = exec_table[opcode](cpu, opcode);
+        _snek8_cpuRetire(cpu);
+        executed++;
+        if (out != SNEK8_EXECOUT_SUCCESS){
+            reason = SNEK8_RUNSTOP_ERROR;
+            break;
+        }
+        if ((break_flags & SNEK8_RUN_BREAK_ON_DRAW) && (opcode & 0xF000u) == 0xD000u){
+            reason = SNEK8_RUNSTOP_DRAW;
+            break;
+        }
+        if ((break_flags & SNEK8_RUN_BREAK_ON_KEY_WAIT) && cpu->key_wait){
+            reason = SNEK8_RUNSTOP_KEY_WAIT;
+            break;
+        }
+    }
+    if (cycles){
+        *cycles = executed;
+    }
+    if (stop){
+        *stop = reason;
+    }
+    return out;
+}
+
+enum Snek8ExecutionOutput
+snek8_cpuRunWaiting(Snek8CPU* cpu, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+                    enum Snek8RunStop* stop){
+    if (!cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    bool brk = (break_flags & SNEK8_RUN_BREAK_ON_KEY_WAIT) && max_cycles;
+    size_t idle = brk? 1: max_cycles;
+    snek8_cpuClockIdle(&cpu->timer_phase, cpu->ips, &cpu->dt, &cpu->st, idle);
+    cpu->cycles += idle;
+    SNEK8_STATS_CYCLES(cpu, idle);
+    SNEK8_STATS_IDLE(cpu, idle);
+    if (cycles){
+        *cycles = idle;
+    }
+    if (stop){
+        *stop = brk? SNEK8_RUNSTOP_KEY_WAIT: SNEK8_RUNSTOP_CYCLES;
+    }
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+/**
+* @brief Whether the instructions of a family may belong to an idle loop: they only
+* read the registers, the delay timer and the keys, and only write the registers and
+* the program counter.
+*
+* @param `family`.
+*/
+static inline bool
+_snek8_cpuIdleFamily(enum Snek8InstructionFamily family){
+    switch (family){
+        case SNEK8_INSTRUC_JMP_ADDR:
+        case SNEK8_INSTRUC_SE_VX_BYTE:
+        case SNEK8_INSTRUC_SNE_VX_BYTE:
+        case SNEK8_INSTRUC_SE_VX_VY:
+        case SNEK8_INSTRUC_LD_VX_BYTE:
+        case SNEK8_INSTRUC_ADD_VX_BYTE:
+        case SNEK8_INSTRUC_LD_VX_VY:
+        case SNEK8_INSTRUC_OR_VX_VY:
+        case SNEK8_INSTRUC_AND_VX_VY:
+        case SNEK8_INSTRUC_XOR_VX_VY:
+        case SNEK8_INSTRUC_ADD_VX_VY:
+        case SNEK8_INSTRUC_SUB_VX_VY:
+        case SNEK8_INSTRUC_SHR_VX_VY:
+        case SNEK8_INSTRUC_SUBN_VX_VY:
+        case SNEK8_INSTRUC_SHL_VX_VY:
+        case SNEK8_INSTRUC_SNE_VX_VY:
+        case SNEK8_INSTRUC_SKP_VX:
+        case SNEK8_INSTRUC_SKNP_VX:
+        case SNEK8_INSTRUC_LD_VX_DT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+size_t
+snek8_cpuIdleLoop(const uint8_t* memory, uint16_t pc, const uint8_t* registers, uint8_t dt,
+                  uint16_t keys, uint8_t implm_flags, bool* reads_dt){
+    // The handlers of the families above only touch these fields of the CPU, so the
+    // iteration runs on them through the reference engine.
+    Snek8CPU scratch;
+    (void) memcpy(scratch.registers, registers, SNEK8_SIZE_REGISTERS * SIZE_U8);
+    scratch.pc = pc;
+    scratch.dt = dt;
+    scratch.keys = keys;
+    const Snek8InstructionExec* const exec_table = _snek8_exec_tables[implm_flags & SNEK8_IMPLM_MODE_MASK];
+    *reads_dt = false;
+    for (size_t length = 1; length <= SNEK8_IDLE_LOOP_MAX; length++){
+        uint16_t opcode = (uint16_t) (memory[scratch.pc & SNEK8_MEM_ADDR_RAM_END] << 8)
+                        | memory[(scratch.pc + 1) & SNEK8_MEM_ADDR_RAM_END];
+        enum Snek8InstructionFamily family = _snek8_family_table[opcode];
+        if (!_snek8_cpuIdleFamily(family)){
+            return 0;
+        }
+        *reads_dt |= (SNEK8_INSTRUC_LD_VX_DT == family);
+        _snek8_cpuIncrementPC(&scratch);
+        (void) exec_table[family](&scratch, opcode);
+        if (scratch.pc == pc){
+            return memcmp(scratch.registers, registers, SNEK8_SIZE_REGISTERS * SIZE_U8)? 0: length;
+        }
+    }
+    return 0;
+}
+
+/*
+* Threaded engine.
+*
+* Every handler below ends by retiring its instruction and, with computed gotos,
+* by fetching and dispatching the next one itself, so that each instruction gets its
+* own indirect branch. Without computed gotos, the handlers are the cases of a
+* `switch` inside the run loop.
+*/
+#define SNEK8_X_R(i)            v[(i)]
+#define SNEK8_X_R_STORE(p, n)   snek8_cpuCopyRegisters((p), v, (n))
+#define SNEK8_X_R_LOAD(p, n)    snek8_cpuCopyRegisters(v, (p), (n))
+#define SNEK8_X_PC              pc
+#define SNEK8_X_IR              ir
+#define SNEK8_X_DT              dt
+#define SNEK8_X_ST              st
+#define SNEK8_X_CLOCK           phase
+#define SNEK8_X_IPS             ips
+#define SNEK8_X_KEYS            cpu->keys
+#define SNEK8_X_KEY_WAIT        cpu->key_wait
+#define SNEK8_X_KEY_ARMED       cpu->key_armed
+#define SNEK8_X_MEM             mem
+#define SNEK8_X_MEM_END         SNEK8_MEM_ADDR_RAM_END
+#define SNEK8_X_GFX             cpu->graphics
+#define SNEK8_X_GFX_GEN         cpu->graphics_gen
+#define SNEK8_X_GFX_DIRTY       cpu->graphics_dirty
+#define SNEK8_X_STACK           (&cpu->stack)
+#define SNEK8_X_RAND()          snek8_cpuRand(&cpu->rng)
+#define SNEK8_X_FAIL(code)                                                          \
+    do{                                                                             \
+        out = (code);                                                               \
+        reason = SNEK8_RUNSTOP_ERROR;                                               \
+        goto _snek8_retire_and_exit;                                                \
+    }while (0)
+#define SNEK8_X_ON_KEY_WAIT()                                                       \
+    do{                                                                             \
+        reason = SNEK8_RUNSTOP_KEY_WAIT;                                            \
+        goto _snek8_retire_and_exit;                                                \
+    }while (0)
+#define SNEK8_X_ON_WRITE(addr, len)                                                 \
+    _snek8_cpuOnWrite(cpu, (addr), (len))
+#define SNEK8_X_ON_DRAW(sprite, n, hit)                                             \
+    SNEK8_STATS_DRAW(cpu, (sprite), (n), (hit))
+
+#define SNEK8_T_X               ((opcode >> 8) & 0xFu)
+#define SNEK8_T_Y               ((opcode >> 4) & 0xFu)
+#define SNEK8_T_N               (opcode & 0xFu)
+#define SNEK8_T_KK              ((uint8_t) (opcode & 0x00FFu))
+#define SNEK8_T_NNN             ((uint16_t) (opcode & 0x0FFFu))
+
+#define SNEK8_T_FETCH()                                                             \
+    do{                                                                             \
+        opcode = (uint16_t) (mem[pc & SNEK8_MEM_ADDR_RAM_END] << 8)                 \
+               | mem[(pc + 1) & SNEK8_MEM_ADDR_RAM_END];                            \
+        pc += 2;                                                                    \
+    }while (0)
+
+#define SNEK8_T_RETIRE()                                                            \
+    do{                                                                             \
+        executed++;                                                                 \
+        SNEK8_EXEC_CLOCK(1);                                                        \
+    }while (0)
+
+#if SNEK8_COMPUTED_GOTO
+    #define SNEK8_T_OP(family)  _snek8_op_##family: SNEK8_STATS_INSTRUC(cpu, SNEK8_INSTRUC_##family);
+    #define SNEK8_T_OP_Q(family, b)                                                 \
+        _snek8_op_##family##_##b: SNEK8_STATS_INSTRUC(cpu, SNEK8_INSTRUC_##family);
+    #define SNEK8_T_LABEL(family)         &&_snek8_op_##family
+    #define SNEK8_T_LABEL_Q(family, b)    &&_snek8_op_##family##_##b
+    #define SNEK8_T_DISPATCH()                                                      \
+        do{                                                                         \
+            if (executed >= max_cycles){                                            \
+                goto _snek8_exit;                                                   \
+            }                                                                       \
+            SNEK8_T_FETCH();                                                        \
+            goto *table[_snek8_family_table[opcode]];                               \
+        }while (0)
+    #define SNEK8_T_RESUME()    SNEK8_T_DISPATCH()
+    #define SNEK8_T_NEXT()                                                          \
+        SNEK8_T_RETIRE();                                                           \
+        SNEK8_T_DISPATCH()
+#else
+    #define SNEK8_T_OP(family)  case SNEK8_INSTRUC_##family: SNEK8_STATS_INSTRUC(cpu, SNEK8_INSTRUC_##family);
+    #define SNEK8_T_OP_Q(family, b)                                                 \
+        case SNEK8_EXEC_ID_Q(family, b): SNEK8_STATS_INSTRUC(cpu, SNEK8_INSTRUC_##family);
+    #define SNEK8_T_RESUME()    continue
+    #define SNEK8_T_NEXT()                                                          \
+        SNEK8_T_RETIRE();                                                           \
+        continue
+#endif
+
+/*
+* The search for idle loops runs on the CPU, which the locals are synchronized with
+* (the loops found leave the registers as they are).
+*/
+#define SNEK8_T_IDLE()                                                              \
+    do{                                                                             \
+        if (snek8_idleWatchDue(&watch, pc)){                                        \
+            (void) memcpy(cpu->registers, v, SNEK8_SIZE_REGISTERS * SIZE_U8);       \
+            cpu->pc = pc;                                                           \
+            cpu->dt = dt;                                                           \
+            cpu->st = st;                                                           \
+            cpu->timer_phase = phase;                                               \
+            executed += snek8_cpuIdleSkip(cpu, &watch, max_cycles - executed);      \
+            dt = cpu->dt;                                                           \
+            st = cpu->st;                                                           \
+            phase = cpu->timer_phase;                                               \
+        }                                                                           \
+    }while (0)
+
+#if SNEK8_COMPUTED_GOTO
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+
+enum Snek8ExecutionOutput
+snek8_cpuRunThreaded(Snek8CPU* cpu, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+                     enum Snek8RunStop* stop){
+    if (!cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (cpu->key_wait){
+        return snek8_cpuRunWaiting(cpu, max_cycles, break_flags, cycles, stop);
+    }
+    enum Snek8ExecutionOutput out = SNEK8_EXECOUT_SUCCESS;
+    enum Snek8RunStop reason = SNEK8_RUNSTOP_CYCLES;
+    size_t executed = 0;
+    uint8_t v[SNEK8_SIZE_REGISTERS];
+    (void) memcpy(v, cpu->registers, SNEK8_SIZE_REGISTERS * SIZE_U8);
+    uint16_t pc = cpu->pc;
+    uint16_t ir = cpu->ir;
+    uint8_t dt = cpu->dt;
+    uint8_t st = cpu->st;
+    uint32_t phase = cpu->timer_phase;
+    const uint32_t ips = cpu->ips;
+    uint8_t* const mem = cpu->memory;
+    uint16_t opcode = 0;
+    Snek8IdleWatch watch = SNEK8_IDLE_WATCH_INIT;
+#if SNEK8_COMPUTED_GOTO
+    static const void* const labels[SNEK8_SIZE_QUIRK_SETS][SNEK8_INSTRUC_COUNT] =
+        SNEK8_EXEC_HANDLER_SETS(SNEK8_T_LABEL, SNEK8_T_LABEL_Q);
+    const void* const* const table = labels[cpu->implm_flags & SNEK8_IMPLM_MODE_MASK];
+#else
+    static const uint8_t ids[SNEK8_SIZE_QUIRK_SETS][SNEK8_INSTRUC_COUNT] =
+        SNEK8_EXEC_HANDLER_SETS(SNEK8_EXEC_ID, SNEK8_EXEC_ID_Q);
+    const uint8_t* const table = ids[cpu->implm_flags & SNEK8_IMPLM_MODE_MASK];
+#endif
+#if SNEK8_COMPUTED_GOTO
+    SNEK8_T_DISPATCH();
+    {
+#else
+    for (;;){
+        if (executed >= max_cycles){
+            goto _snek8_exit;
+        }
+        SNEK8_T_FETCH();
+        switch (table[_snek8_family_table[opcode]]){
+#endif
+        SNEK8_T_OP(NOP)
+            SNEK8_EXEC_NOP();
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(CLS)
+            SNEK8_EXEC_CLS();
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(RET)
+            SNEK8_EXEC_RET();
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(JMP_ADDR)
+            if (SNEK8_T_NNN < pc){
+                // A backward jump, which may close an idle loop.
+                SNEK8_EXEC_JMP_ADDR(SNEK8_T_NNN);
+                SNEK8_T_RETIRE();
+                SNEK8_T_IDLE();
+                SNEK8_T_RESUME();
+            }
+            SNEK8_EXEC_JMP_ADDR(SNEK8_T_NNN);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(CALL)
+            SNEK8_EXEC_CALL(SNEK8_T_NNN);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(SE_VX_BYTE)
+            SNEK8_EXEC_SE_VX_BYTE(SNEK8_T_X, SNEK8_T_KK);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(SNE_VX_BYTE)
+            SNEK8_EXEC_SNE_VX_BYTE(SNEK8_T_X, SNEK8_T_KK);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(SE_VX_VY)
+            SNEK8_EXEC_SE_VX_VY(SNEK8_T_X, SNEK8_T_Y);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(LD_VX_BYTE)
+            SNEK8_EXEC_LD_VX_BYTE(SNEK8_T_X, SNEK8_T_KK);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(ADD_VX_BYTE)
+            SNEK8_EXEC_ADD_VX_BYTE(SNEK8_T_X, SNEK8_T_KK);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(LD_VX_VY)
+            SNEK8_EXEC_LD_VX_VY(SNEK8_T_X, SNEK8_T_Y);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(OR_VX_VY)
+            SNEK8_EXEC_OR_VX_VY(SNEK8_T_X, SNEK8_T_Y);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(AND_VX_VY)
+            SNEK8_EXEC_AND_VX_VY(SNEK8_T_X, SNEK8_T_Y);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(XOR_VX_VY)
+            SNEK8_EXEC_XOR_VX_VY(SNEK8_T_X, SNEK8_T_Y);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(ADD_VX_VY)
+            SNEK8_EXEC_ADD_VX_VY(SNEK8_T_X, SNEK8_T_Y);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(SUB_VX_VY)
+            SNEK8_EXEC_SUB_VX_VY(SNEK8_T_X, SNEK8_T_Y);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP_Q(SHR_VX_VY, 0)
+            SNEK8_EXEC_SHR_VX_VY(SNEK8_T_X, SNEK8_T_Y, 0);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP_Q(SHR_VX_VY, 1)
+            SNEK8_EXEC_SHR_VX_VY(SNEK8_T_X, SNEK8_T_Y, 1);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(SUBN_VX_VY)
+            SNEK8_EXEC_SUBN_VX_VY(SNEK8_T_X, SNEK8_T_Y);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP_Q(SHL_VX_VY, 0)
+            SNEK8_EXEC_SHL_VX_VY(SNEK8_T_X, SNEK8_T_Y, 0);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP_Q(SHL_VX_VY, 1)
+            SNEK8_EXEC_SHL_VX_VY(SNEK8_T_X, SNEK8_T_Y, 1);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(SNE_VX_VY)
+            SNEK8_EXEC_SNE_VX_VY(SNEK8_T_X, SNEK8_T_Y);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(LD_I_ADDR)
+            SNEK8_EXEC_LD_I_ADDR(SNEK8_T_NNN);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP_Q(JP_V0_ADDR, 0)
+            SNEK8_EXEC_JP_V0_ADDR(SNEK8_T_X, SNEK8_T_NNN, 0);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP_Q(JP_V0_ADDR, 1)
+            SNEK8_EXEC_JP_V0_ADDR(SNEK8_T_X, SNEK8_T_NNN, 1);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(RND_VX_BYTE)
+            SNEK8_EXEC_RND_VX_BYTE(SNEK8_T_X, SNEK8_T_KK);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(DRW_VX_VY_N)
+            SNEK8_EXEC_DRW_VX_VY_N(SNEK8_T_X, SNEK8_T_Y, SNEK8_T_N);
+            if (break_flags & SNEK8_RUN_BREAK_ON_DRAW){
+                reason = SNEK8_RUNSTOP_DRAW;
+                goto _snek8_retire_and_exit;
+            }
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(SKP_VX)
+            SNEK8_EXEC_SKP_VX(SNEK8_T_X);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(SKNP_VX)
+            SNEK8_EXEC_SKNP_VX(SNEK8_T_X);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(LD_VX_DT)
+            SNEK8_EXEC_LD_VX_DT(SNEK8_T_X);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(LD_VX_K)
+            SNEK8_EXEC_LD_VX_K(SNEK8_T_X);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(LD_DT_VX)
+            SNEK8_EXEC_LD_DT_VX(SNEK8_T_X);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(LD_ST_VX)
+            SNEK8_EXEC_LD_ST_VX(SNEK8_T_X);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(ADD_I_VX)
+            SNEK8_EXEC_ADD_I_VX(SNEK8_T_X);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(LD_F_VX)
+            SNEK8_EXEC_LD_F_VX(SNEK8_T_X);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP(LD_B_VX)
+            SNEK8_EXEC_LD_B_VX(SNEK8_T_X);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP_Q(LD_I_V0_VX, 0)
+            SNEK8_EXEC_LD_I_V0_VX(SNEK8_T_X, 0);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP_Q(LD_I_V0_VX, 1)
+            SNEK8_EXEC_LD_I_V0_VX(SNEK8_T_X, 1);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP_Q(LD_VX_V0_I, 0)
+            SNEK8_EXEC_LD_VX_V0_I(SNEK8_T_X, 0);
+            SNEK8_T_NEXT();
+        SNEK8_T_OP_Q(LD_VX_V0_I, 1)
+            SNEK8_EXEC_LD_VX_V0_I(SNEK8_T_X, 1);
+            SNEK8_T_NEXT();
+#if !SNEK8_COMPUTED_GOTO
+        }
+#endif
+    }
+_snek8_retire_and_exit:
+    SNEK8_T_RETIRE();
+_snek8_exit:
+    (void) memcpy(cpu->registers, v, SNEK8_SIZE_REGISTERS * SIZE_U8);
+    cpu->pc = pc;
+    cpu->ir = ir;
+    cpu->dt = dt;
+    cpu->st = st;
+    cpu->timer_phase = phase;
+    cpu->cycles += executed;
+    SNEK8_STATS_CYCLES(cpu, executed);
+    if (SNEK8_RUNSTOP_KEY_WAIT == reason && !(break_flags & SNEK8_RUN_BREAK_ON_KEY_WAIT)){
+        size_t idle = 0;
+        (void) snek8_cpuRunWaiting(cpu, max_cycles - executed, break_flags, &idle, &reason);
+        executed += idle;
+    }
+    if (cycles){
+        *cycles = executed;
+    }
+    if (stop){
+        *stop = reason;
+    }
+    return out;
+}
+
+#if SNEK8_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#endif
+
+Snek8RunEngine
+snek8_cpuGetRunEngine(enum Snek8Engine engine){
+    switch (engine){
+        case SNEK8_ENGINE_REFERENCE:
+            return snek8_cpuRun;
+        case SNEK8_ENGINE_THREADED:
+            return snek8_cpuRunThreaded;
+        case SNEK8_ENGINE_BLOCK:
+            return snek8_cpuRunBlocks;
+        default:
+            return NULL;
+    }
+}
+
 #ifdef __cplusplus
     }
 #endif
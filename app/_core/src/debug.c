@@ -0,0 +1,262 @@
+/**
+* @file debug.c
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Implementation of the debugger.
+*/
+#ifndef SNEK8_DEBUG_C
+    #define SNEK8_DEBUG_C
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include "debug.h"
+
+Snek8Debugger*
+snek8_debugNew(void){
+    Snek8Debugger* debugger = malloc(sizeof(Snek8Debugger));
+    if (!debugger){
+        return NULL;
+    }
+    (void) memset(debugger->flags, 0, sizeof(debugger->flags));
+    debugger->breakpoints = 0;
+    debugger->watched = 0;
+    debugger->conditions_count = 0;
+    debugger->resume = false;
+    debugger->hit = (Snek8DebugHit) {.stop = SNEK8_RUNSTOP_CYCLES, .pc = 0, .address = 0, .access = 0};
+    return debugger;
+}
+
+void
+snek8_debugDel(Snek8Debugger* debugger){
+    free(debugger);
+}
+
+enum Snek8ExecutionOutput
+snek8_debugSetBreakpoint(Snek8Debugger* debugger, uint16_t address,
+                         const Snek8DebugCondition* condition){
+    if (address > SNEK8_MEM_ADDR_RAM_END){
+        return SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS;
+    }
+    uint8_t* flags = &debugger->flags[address];
+    bool had = *flags & (SNEK8_DEBUG_BREAK | SNEK8_DEBUG_CONDITION);
+    if (condition){
+        if (condition->reg > SNEK8_DEBUG_REG_I || condition->compare >= SNEK8_DEBUG_COMPARE_COUNT
+            || (condition->reg < SNEK8_DEBUG_REG_I && condition->value > UINT8_MAX)){
+            return SNEK8_EXECOUT_INDEX_OUT_RANGE;
+        }
+        if (SNEK8_DEBUG_MAX_CONDITIONS == debugger->conditions_count){
+            return SNEK8_EXECOUT_OUT_OF_MEMORY;
+        }
+        Snek8DebugCondition* added = &debugger->conditions[debugger->conditions_count++];
+        *added = *condition;
+        added->address = address;
+        *flags |= SNEK8_DEBUG_CONDITION;
+    }else{
+        *flags |= SNEK8_DEBUG_BREAK;
+    }
+    debugger->breakpoints += !had;
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+bool
+snek8_debugClearBreakpoint(Snek8Debugger* debugger, uint16_t address){
+    if (address > SNEK8_MEM_ADDR_RAM_END
+        || !(debugger->flags[address] & (SNEK8_DEBUG_BREAK | SNEK8_DEBUG_CONDITION))){
+        return false;
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < debugger->conditions_count; i++){
+        if (debugger->conditions[i].address != address){
+            debugger->conditions[kept++] = debugger->conditions[i];
+        }
+    }
+    debugger->conditions_count = kept;
+    debugger->flags[address] &= (uint8_t) ~(SNEK8_DEBUG_BREAK | SNEK8_DEBUG_CONDITION);
+    debugger->breakpoints--;
+    return true;
+}
+
+enum Snek8ExecutionOutput
+snek8_debugWatch(Snek8Debugger* debugger, uint16_t start, size_t size, uint8_t access,
+                 bool watch){
+    if (start > SNEK8_MEM_ADDR_RAM_END || size > (size_t) (SNEK8_SIZE_RAM - start)){
+        return SNEK8_EXECOUT_MEM_ADDR_OUT_OF_BOUNDS;
+    }
+    if (access & (uint8_t) ~SNEK8_DEBUG_WATCH){
+        return SNEK8_EXECOUT_INDEX_OUT_RANGE;
+    }
+    for (size_t addr = start; addr < start + size; addr++){
+        uint8_t* flags = &debugger->flags[addr];
+        bool was = *flags & SNEK8_DEBUG_WATCH;
+        *flags = watch? (*flags | access): (*flags & (uint8_t) ~access);
+        bool is = *flags & SNEK8_DEBUG_WATCH;
+        debugger->watched += (size_t) is - (size_t) was;
+    }
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+/**
+* @brief Whether a condition holds for the CPU.
+*/
+static inline bool
+_snek8_debugHolds(const Snek8DebugCondition* condition, const Snek8CPU* cpu){
+    uint16_t value = (SNEK8_DEBUG_REG_I == condition->reg)? cpu->ir: cpu->registers[condition->reg];
+    switch (condition->compare){
+        case SNEK8_DEBUG_EQ:
+            return value == condition->value;
+        case SNEK8_DEBUG_NE:
+            return value != condition->value;
+        case SNEK8_DEBUG_LT:
+            return value < condition->value;
+        case SNEK8_DEBUG_LE:
+            return value <= condition->value;
+        case SNEK8_DEBUG_GT:
+            return value > condition->value;
+        case SNEK8_DEBUG_GE:
+            return value >= condition->value;
+        default:
+            return false;
+    }
+}
+
+/**
+* @brief Whether the breakpoints of an address stop the CPU.
+*/
+static bool
+_snek8_debugBreaks(const Snek8Debugger* debugger, const Snek8CPU* cpu, uint16_t address){
+    if (debugger->flags[address] & SNEK8_DEBUG_BREAK){
+        return true;
+    }
+    for (size_t i = 0; i < debugger->conditions_count; i++){
+        const Snek8DebugCondition* condition = &debugger->conditions[i];
+        if (condition->address == address && _snek8_debugHolds(condition, cpu)){
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+* @brief Finds out which bytes of the memory an instruction accesses through the index
+* register, before it executes.
+*
+* @param[out] `start`.
+* @param[out] `access` `SNEK8_DEBUG_WATCH_READ` or `SNEK8_DEBUG_WATCH_WRITE`.
+* @return The number of bytes accessed, 0 if the instruction does not access any.
+*/
+static inline size_t
+_snek8_debugAccess(const Snek8CPU* cpu, uint16_t opcode, uint16_t* start, uint8_t* access){
+    size_t size = 0;
+    *start = cpu->ir;
+    if (0xD000u == (opcode & 0xF000u)){
+        size = opcode & 0x000Fu;
+        *access = SNEK8_DEBUG_WATCH_READ;
+    }else if (0xF000u == (opcode & 0xF000u)){
+        size_t count = ((opcode & 0x0F00u) >> 8) + 1;
+        switch (opcode & 0x00FFu){
+            case 0x33:
+                size = SNEK8_SIZE_BCD_DIGITS;
+                *access = SNEK8_DEBUG_WATCH_WRITE;
+                break;
+            case 0x55:
+                size = count;
+                *access = SNEK8_DEBUG_WATCH_WRITE;
+                break;
+            case 0x65:
+                size = count;
+                *access = SNEK8_DEBUG_WATCH_READ;
+                break;
+            default:
+                break;
+        }
+    }
+    // The accesses past the end of the memory fail before taking place.
+    return (*start + size > SNEK8_SIZE_RAM)? 0: size;
+}
+
+/**
+* @brief Finds the first byte of a range watched for an access.
+*
+* @return Whether there is one.
+*/
+static inline bool
+_snek8_debugWatched(const Snek8Debugger* debugger, uint16_t start, size_t size, uint8_t access,
+                    uint16_t* address){
+    for (size_t i = 0; i < size; i++){
+        if (debugger->flags[start + i] & access){
+            *address = (uint16_t) (start + i);
+            return true;
+        }
+    }
+    return false;
+}
+
+enum Snek8ExecutionOutput
+snek8_debugRun(Snek8Debugger* debugger, Snek8CPU* cpu, size_t max_cycles, uint8_t break_flags,
+               size_t* cycles, enum Snek8RunStop* stop){
+    if (!debugger || !cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    enum Snek8ExecutionOutput out = SNEK8_EXECOUT_SUCCESS;
+    enum Snek8RunStop reason = SNEK8_RUNSTOP_CYCLES;
+    size_t executed = 0;
+    bool resume = debugger->resume && debugger->hit.pc == cpu->pc;
+    debugger->resume = false;
+    debugger->hit.stop = SNEK8_RUNSTOP_CYCLES;
+    while (executed < max_cycles){
+        if (cpu->key_wait){
+            size_t idle = 0;
+            out = snek8_cpuRunWaiting(cpu, max_cycles - executed, break_flags, &idle, &reason);
+            executed += idle;
+            break;
+        }
+        uint16_t pc = cpu->pc & SNEK8_MEM_ADDR_RAM_END;
+        if ((debugger->flags[pc] & (SNEK8_DEBUG_BREAK | SNEK8_DEBUG_CONDITION))
+            && !(resume && !executed) && _snek8_debugBreaks(debugger, cpu, pc)){
+            debugger->hit = (Snek8DebugHit) {.stop = SNEK8_RUNSTOP_BREAKPOINT, .pc = pc, .address = pc, .access = 0};
+            debugger->resume = true;
+            reason = SNEK8_RUNSTOP_BREAKPOINT;
+            break;
+        }
+        uint16_t opcode = (uint16_t) ((cpu->memory[pc] << 8) | cpu->memory[(pc + 1) & SNEK8_MEM_ADDR_RAM_END]);
+        uint16_t start = 0;
+        uint8_t access = 0;
+        size_t size = debugger->watched? _snek8_debugAccess(cpu, opcode, &start, &access): 0;
+        out = snek8_cpuStep(cpu, NULL);
+        executed++;
+        if (out != SNEK8_EXECOUT_SUCCESS){
+            reason = SNEK8_RUNSTOP_ERROR;
+            break;
+        }
+        uint16_t address = 0;
+        if (size && _snek8_debugWatched(debugger, start, size, access, &address)){
+            debugger->hit = (Snek8DebugHit) {.stop = SNEK8_RUNSTOP_WATCHPOINT, .pc = pc, .address = address,
+                                             .access = access};
+            reason = SNEK8_RUNSTOP_WATCHPOINT;
+            break;
+        }
+        if ((break_flags & SNEK8_RUN_BREAK_ON_DRAW) && (opcode & 0xF000u) == 0xD000u){
+            reason = SNEK8_RUNSTOP_DRAW;
+            break;
+        }
+        if ((break_flags & SNEK8_RUN_BREAK_ON_KEY_WAIT) && cpu->key_wait){
+            reason = SNEK8_RUNSTOP_KEY_WAIT;
+            break;
+        }
+    }
+    if (cycles){
+        *cycles = executed;
+    }
+    if (stop){
+        *stop = reason;
+    }
+    return out;
+}
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_DEBUG_C
@@ -0,0 +1,344 @@
+/**
+* @file disasm.c
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Implementation of the disassembler and of the static analysis of the programs.
+*/
+#ifndef SNEK8_DISASM_C
+    #define SNEK8_DISASM_C
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include "disasm.h"
+
+/*
+* Disassembler.
+*
+* The text of an instruction is its template in `snek8_opcodeDecode` with the operands
+* written in: "{0xX}" and "{0xY}" become the registers' nibbles, "0x0NNN", "0xKK" and
+* "0xN" the address, the byte and the nibble.
+*/
+typedef struct{
+    char* text;
+    size_t size;
+    size_t length;
+} Snek8DisasmWriter;
+
+static void
+_snek8_disasmPut(Snek8DisasmWriter* writer, const char* format, unsigned value){
+    size_t left = (writer->length < writer->size)? writer->size - writer->length: 0;
+    int written = snprintf(left? writer->text + writer->length: NULL, left, format, value);
+    if (written > 0){
+        writer->length += (size_t) written;
+    }
+}
+
+size_t
+snek8_disasmFormat(uint16_t opcode, char* text, size_t size){
+    Snek8DisasmWriter writer = {.text = text, .size = size, .length = 0};
+    Snek8Instruction instruction = snek8_opcodeDecode(opcode);
+    if (SNEK8_INSTRUC_NOP == instruction.family){
+        _snek8_disasmPut(&writer, "DW 0x%04X", opcode);
+        return writer.length;
+    }
+    if (size){
+        *text = '\0';
+    }
+    for (const char* c = instruction.code; *c;){
+        if (!strncmp(c, "{0xX}", 5)){
+            _snek8_disasmPut(&writer, "%X", snek8_opcodeGetNibble(opcode, 2));
+            c += 5;
+        }
+        else if (!strncmp(c, "{0xY}", 5)){
+            _snek8_disasmPut(&writer, "%X", snek8_opcodeGetNibble(opcode, 1));
+            c += 5;
+        }
+        else if (!strncmp(c, "{0x0}", 5)){
+            _snek8_disasmPut(&writer, "%X", 0);
+            c += 5;
+        }
+        else if (!strncmp(c, "{0xK}", 5)){
+            c += 5;
+        }
+        else if (!strncmp(c, "0x0NNN", 6)){
+            _snek8_disasmPut(&writer, "0x%03X", snek8_opcodeGetAddr(opcode));
+            c += 6;
+        }
+        else if (!strncmp(c, "0xKK", 4)){
+            _snek8_disasmPut(&writer, "0x%02X", snek8_opcodeGetByte(opcode));
+            c += 4;
+        }
+        else if (!strncmp(c, "0xN", 3)){
+            _snek8_disasmPut(&writer, "0x%X", snek8_opcodeGetNibble(opcode, 0));
+            c += 3;
+        }
+        else{
+            if (writer.length + 1 < size){
+                text[writer.length] = *c;
+                text[writer.length + 1] = '\0';
+            }
+            writer.length++;
+            c++;
+        }
+    }
+    return writer.length;
+}
+
+/*
+* Analysis.
+*/
+static const char* const _snek8_exit_names[SNEK8_ANALYSIS_EXIT_COUNT] = {
+    [SNEK8_ANALYSIS_EXIT_FALLTHROUGH] = "FALLTHROUGH",
+    [SNEK8_ANALYSIS_EXIT_JUMP] = "JUMP",
+    [SNEK8_ANALYSIS_EXIT_CALL] = "CALL",
+    [SNEK8_ANALYSIS_EXIT_RETURN] = "RETURN",
+    [SNEK8_ANALYSIS_EXIT_SKIP] = "SKIP",
+    [SNEK8_ANALYSIS_EXIT_INDIRECT] = "INDIRECT",
+    [SNEK8_ANALYSIS_EXIT_INVALID] = "INVALID",
+};
+
+const char*
+snek8_analysisExitName(enum Snek8AnalysisExit exit){
+    return ((unsigned) exit < SNEK8_ANALYSIS_EXIT_COUNT)? _snek8_exit_names[exit]: NULL;
+}
+
+static inline uint16_t
+_snek8_analysisOpcode(const uint8_t* memory, uint16_t addr){
+    return (uint16_t) (memory[addr & SNEK8_MEM_ADDR_RAM_END] << 8)
+         | memory[(addr + 1) & SNEK8_MEM_ADDR_RAM_END];
+}
+
+/**
+* @brief Whether an instruction only proceeds to the next one.
+*
+* @param `family`.
+*/
+static inline bool
+_snek8_analysisFallsThrough(enum Snek8InstructionFamily family){
+    switch (family){
+        case SNEK8_INSTRUC_NOP:
+        case SNEK8_INSTRUC_RET:
+        case SNEK8_INSTRUC_JMP_ADDR:
+        case SNEK8_INSTRUC_CALL:
+        case SNEK8_INSTRUC_SE_VX_BYTE:
+        case SNEK8_INSTRUC_SNE_VX_BYTE:
+        case SNEK8_INSTRUC_SE_VX_VY:
+        case SNEK8_INSTRUC_SNE_VX_VY:
+        case SNEK8_INSTRUC_JP_V0_ADDR:
+        case SNEK8_INSTRUC_SKP_VX:
+        case SNEK8_INSTRUC_SKNP_VX:
+            return false;
+        default:
+            return true;
+    }
+}
+
+/**
+* @brief Sets the exit and the successors of the block ending with the instruction
+* at `addr`, if it ends one.
+*
+* @return Whether the instruction ends a block.
+*/
+static bool
+_snek8_analysisExit(Snek8AnalysisBlock* block, enum Snek8InstructionFamily family,
+                    uint16_t addr, uint16_t opcode){
+    uint16_t next = (addr + 2) & SNEK8_MEM_ADDR_RAM_END;
+    switch (family){
+        case SNEK8_INSTRUC_NOP:
+            block->exit = SNEK8_ANALYSIS_EXIT_INVALID;
+            return true;
+        case SNEK8_INSTRUC_RET:
+            block->exit = SNEK8_ANALYSIS_EXIT_RETURN;
+            return true;
+        case SNEK8_INSTRUC_JP_V0_ADDR:
+            block->exit = SNEK8_ANALYSIS_EXIT_INDIRECT;
+            return true;
+        case SNEK8_INSTRUC_JMP_ADDR:
+            block->exit = SNEK8_ANALYSIS_EXIT_JUMP;
+            block->successors[block->successors_count++] = snek8_opcodeGetAddr(opcode);
+            return true;
+        case SNEK8_INSTRUC_CALL:
+            block->exit = SNEK8_ANALYSIS_EXIT_CALL;
+            block->successors[block->successors_count++] = snek8_opcodeGetAddr(opcode);
+            if (snek8_opcodeGetAddr(opcode) != next){
+                block->successors[block->successors_count++] = next;
+            }
+            return true;
+        case SNEK8_INSTRUC_SE_VX_BYTE:
+        case SNEK8_INSTRUC_SNE_VX_BYTE:
+        case SNEK8_INSTRUC_SE_VX_VY:
+        case SNEK8_INSTRUC_SNE_VX_VY:
+        case SNEK8_INSTRUC_SKP_VX:
+        case SNEK8_INSTRUC_SKNP_VX:
+            block->exit = SNEK8_ANALYSIS_EXIT_SKIP;
+            block->successors[block->successors_count++] = next;
+            block->successors[block->successors_count++] = (next + 2) & SNEK8_MEM_ADDR_RAM_END;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void
+_snek8_analysisMark(Snek8Analysis* analysis, size_t addr, size_t len, uint8_t flag){
+    for (size_t i = 0; i < len && addr + i <= SNEK8_MEM_ADDR_RAM_END; i++){
+        analysis->flags[addr + i] |= flag;
+    }
+}
+
+/**
+* @brief Follows the index register through an instruction, marking the bytes it
+* reads and writes.
+*
+* @param `ir` The index register, or -1 when unknown.
+*/
+static void
+_snek8_analysisAccess(Snek8Analysis* analysis, enum Snek8InstructionFamily family,
+                      uint16_t opcode, uint8_t implm_flags, int32_t* ir){
+    uint8_t x = snek8_opcodeGetNibble(opcode, 2);
+    switch (family){
+        case SNEK8_INSTRUC_LD_I_ADDR:
+            *ir = snek8_opcodeGetAddr(opcode);
+            break;
+        case SNEK8_INSTRUC_ADD_I_VX:
+        case SNEK8_INSTRUC_LD_F_VX:
+            *ir = -1;
+            break;
+        case SNEK8_INSTRUC_DRW_VX_VY_N:
+            if (*ir >= 0){
+                _snek8_analysisMark(analysis, (size_t) *ir, snek8_opcodeGetNibble(opcode, 0),
+                                    SNEK8_ANALYSIS_READ);
+            }
+            break;
+        case SNEK8_INSTRUC_LD_B_VX:
+            if (*ir >= 0){
+                _snek8_analysisMark(analysis, (size_t) *ir, SNEK8_SIZE_BCD_DIGITS,
+                                    SNEK8_ANALYSIS_WRITTEN);
+            }
+            else{
+                analysis->unresolved_writes++;
+            }
+            break;
+        case SNEK8_INSTRUC_LD_I_V0_VX:
+        case SNEK8_INSTRUC_LD_VX_V0_I:
+            if (*ir >= 0){
+                _snek8_analysisMark(analysis, (size_t) *ir, x + 1u,
+                                    (SNEK8_INSTRUC_LD_I_V0_VX == family)?
+                                    SNEK8_ANALYSIS_WRITTEN: SNEK8_ANALYSIS_READ);
+                if (implm_flags & SNEK8_IMPLM_MODE_FX_CHANGES_I){
+                    *ir += x + 1;
+                }
+            }
+            else if (SNEK8_INSTRUC_LD_I_V0_VX == family){
+                analysis->unresolved_writes++;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+* @brief Queues the address as the start of a block, once.
+*/
+static void
+_snek8_analysisPush(Snek8Analysis* analysis, uint16_t* queue, size_t* queued, uint16_t addr){
+    addr &= SNEK8_MEM_ADDR_RAM_END;
+    if (!(analysis->flags[addr] & SNEK8_ANALYSIS_LEADER)){
+        analysis->flags[addr] |= SNEK8_ANALYSIS_LEADER;
+        queue[(*queued)++] = addr;
+    }
+}
+
+enum Snek8ExecutionOutput
+snek8_disasmAnalyze(Snek8Analysis* analysis, const uint8_t* memory, size_t rom_size,
+                    uint8_t implm_flags){
+    if (!analysis || !memory){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (rom_size > SNEK8_SIZE_MAX_ROM_FILE){
+        return SNEK8_EXECOUT_ROM_FILE_EXCEEDS_MAX_MEM;
+    }
+    snek8_opcodeTableInit();
+    (void) memset(analysis->flags, 0, SNEK8_SIZE_RAM * sizeof(uint8_t));
+    analysis->rom_end = (uint16_t) (SNEK8_MEM_ADDR_PROG_START + rom_size);
+    analysis->instructions = 0;
+    analysis->self_modifying = 0;
+    analysis->unresolved_writes = 0;
+    analysis->blocks_count = 0;
+    // Every address is queued at most once, so the queue never holds more than
+    // SNEK8_SIZE_RAM of them. The instructions met on the way are only decoded once:
+    // a walk stops at the first instruction another walk already went through.
+    uint16_t queue[SNEK8_SIZE_RAM];
+    size_t queued = 0;
+    _snek8_analysisPush(analysis, queue, &queued, SNEK8_MEM_ADDR_PROG_START);
+    while (queued){
+        uint16_t addr = queue[--queued];
+        while (!(analysis->flags[addr] & SNEK8_ANALYSIS_INSTRUC)){
+            uint16_t opcode = _snek8_analysisOpcode(memory, addr);
+            enum Snek8InstructionFamily family = snek8_opcodeFamily(opcode);
+            uint16_t next = (addr + 2) & SNEK8_MEM_ADDR_RAM_END;
+            analysis->flags[addr] |= SNEK8_ANALYSIS_INSTRUC | SNEK8_ANALYSIS_CODE;
+            analysis->flags[(addr + 1) & SNEK8_MEM_ADDR_RAM_END] |= SNEK8_ANALYSIS_CODE;
+            analysis->instructions++;
+            if (_snek8_analysisFallsThrough(family)){
+                addr = next;
+                continue;
+            }
+            Snek8AnalysisBlock exit = {0};
+            (void) _snek8_analysisExit(&exit, family, addr, opcode);
+            if (SNEK8_ANALYSIS_EXIT_INVALID == exit.exit){
+                analysis->flags[addr] |= SNEK8_ANALYSIS_INVALID;
+            }
+            else if (SNEK8_ANALYSIS_EXIT_INDIRECT == exit.exit){
+                analysis->flags[addr] |= SNEK8_ANALYSIS_INDIRECT;
+            }
+            for (uint8_t i = 0; i < exit.successors_count; i++){
+                _snek8_analysisPush(analysis, queue, &queued, exit.successors[i]);
+            }
+            break;
+        }
+    }
+    // The leaders are only all known now, so the blocks are split in a second pass.
+    for (uint16_t start = 0; start <= SNEK8_MEM_ADDR_RAM_END; start++){
+        if (!(analysis->flags[start] & SNEK8_ANALYSIS_LEADER)){
+            continue;
+        }
+        Snek8AnalysisBlock* block = &analysis->blocks[analysis->blocks_count++];
+        *block = (Snek8AnalysisBlock){.start = start};
+        int32_t ir = -1;
+        uint16_t addr = start;
+        for (;;){
+            uint16_t opcode = _snek8_analysisOpcode(memory, addr);
+            enum Snek8InstructionFamily family = snek8_opcodeFamily(opcode);
+            block->length++;
+            _snek8_analysisAccess(analysis, family, opcode, implm_flags, &ir);
+            if (_snek8_analysisExit(block, family, addr, opcode)){
+                break;
+            }
+            addr = (addr + 2) & SNEK8_MEM_ADDR_RAM_END;
+            if (analysis->flags[addr] & SNEK8_ANALYSIS_LEADER){
+                block->exit = SNEK8_ANALYSIS_EXIT_FALLTHROUGH;
+                block->successors[block->successors_count++] = addr;
+                break;
+            }
+        }
+    }
+    for (size_t addr = 0; addr < SNEK8_SIZE_RAM; addr++){
+        uint8_t flags = analysis->flags[addr];
+        if ((flags & SNEK8_ANALYSIS_CODE) && (flags & SNEK8_ANALYSIS_WRITTEN)){
+            analysis->self_modifying++;
+        }
+        if (addr >= SNEK8_MEM_ADDR_PROG_START && addr < analysis->rom_end
+            && !(flags & SNEK8_ANALYSIS_CODE)){
+            analysis->flags[addr] |= SNEK8_ANALYSIS_DATA;
+        }
+    }
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_DISASM_C
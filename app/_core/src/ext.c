@@ -0,0 +1,414 @@
+/**
+* @file ext.c
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Implementation of the extended CPU profiles: SUPER-CHIP and XO-CHIP.
+*/
+#ifndef SNEK8_EXT_C
+    #define SNEK8_EXT_C
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include "ext.h"
+#include "cpu_exec.h"
+
+/**
+* @brief SUPER-CHIP's big hexadecimal font, one 8x10 sprite per digit.
+*/
+static const uint8_t _snek8_bigfont[SNEK8_EXT_SIZE_BIGFONT] = {
+    0x3C, 0x7E, 0xE7, 0xC3, 0xC3, 0xC3, 0xC3, 0xE7, 0x7E, 0x3C, // 0
+    0x18, 0x38, 0x58, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x3C, // 1
+    0x3E, 0x7F, 0xC3, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xFF, 0xFF, // 2
+    0x3C, 0x7E, 0xC3, 0x03, 0x0E, 0x0E, 0x03, 0xC3, 0x7E, 0x3C, // 3
+    0x06, 0x0E, 0x1E, 0x36, 0x66, 0xC6, 0xFF, 0xFF, 0x06, 0x06, // 4
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFC, 0xFE, 0x03, 0xC3, 0x7E, 0x3C, // 5
+    0x3E, 0x7C, 0xC0, 0xC0, 0xFC, 0xFE, 0xC3, 0xC3, 0x7E, 0x3C, // 6
+    0xFF, 0xFF, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x60, 0x60, // 7
+    0x3C, 0x7E, 0xC3, 0xC3, 0x7E, 0x7E, 0xC3, 0xC3, 0x7E, 0x3C, // 8
+    0x3C, 0x7E, 0xC3, 0xC3, 0x7F, 0x3F, 0x03, 0x03, 0x3E, 0x7C, // 9
+    0x18, 0x3C, 0x66, 0xC3, 0xC3, 0xFF, 0xFF, 0xC3, 0xC3, 0xC3, // A
+    0xFC, 0xFE, 0xC3, 0xC3, 0xFE, 0xFE, 0xC3, 0xC3, 0xFE, 0xFC, // B
+    0x3C, 0x7E, 0xC3, 0xC0, 0xC0, 0xC0, 0xC0, 0xC3, 0x7E, 0x3C, // C
+    0xFC, 0xFE, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xC3, 0xFE, 0xFC, // D
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFC, 0xFC, 0xC0, 0xC0, 0xFF, 0xFF, // E
+    0xFF, 0xFF, 0xC0, 0xC0, 0xFC, 0xFC, 0xC0, 0xC0, 0xC0, 0xC0, // F
+};
+
+enum Snek8ExecutionOutput
+snek8_extInit(Snek8ExtCPU* cpu, enum Snek8Profile profile, uint8_t implm_flags){
+    if (!cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (profile >= SNEK8_PROFILE_COUNT){
+        return SNEK8_EXECOUT_INDEX_OUT_RANGE;
+    }
+    (void) memset(cpu, 0, sizeof(Snek8ExtCPU));
+    cpu->profile = (uint8_t) profile;
+    cpu->implm_flags = implm_flags;
+    cpu->mem_end = (SNEK8_PROFILE_XOCHIP == profile)? UINT16_MAX: SNEK8_MEM_ADDR_RAM_END;
+    cpu->pc = SNEK8_MEM_ADDR_PROG_START;
+    cpu->planes = 1;
+    cpu->pitch = 64;
+    cpu->ips = SNEK8_CPU_DEFAULT_IPS;
+    cpu->rng = snek8_cpuSeedState(0);
+    cpu->graphics_dirty = UINT64_MAX;
+    (void) snek8_stackInit(&cpu->stack);
+    (void) memcpy(cpu->memory + SNEK8_MEM_ADDR_FONTSET_START, snek8_fontset, SNEK8_SIZE_FONTSET_PIXELS);
+    (void) memcpy(cpu->memory + SNEK8_EXT_MEM_ADDR_BIGFONT_START, _snek8_bigfont, SNEK8_EXT_SIZE_BIGFONT);
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+enum Snek8ExecutionOutput
+snek8_extSetIPS(Snek8ExtCPU* cpu, uint32_t ips){
+    if (!cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (ips < 1 || ips > SNEK8_CPU_MAX_IPS){
+        return SNEK8_EXECOUT_INDEX_OUT_RANGE;
+    }
+    cpu->timer_phase = (uint32_t) ((uint64_t) cpu->timer_phase * ips / cpu->ips);
+    cpu->ips = ips;
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+enum Snek8ExecutionOutput
+snek8_extSeed(Snek8ExtCPU* cpu, uint32_t seed){
+    if (!cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    cpu->rng = snek8_cpuSeedState(seed);
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+enum Snek8ExecutionOutput
+snek8_extLoadRomBytes(Snek8ExtCPU* cpu, const uint8_t* rom, size_t size){
+    if (!cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (!rom && size){
+        return SNEK8_EXECOUT_ROM_FILE_INVALID;
+    }
+    if (size > (size_t) cpu->mem_end + 1 - SNEK8_MEM_ADDR_PROG_START){
+        return SNEK8_EXECOUT_ROM_FILE_EXCEEDS_MAX_MEM;
+    }
+    uint32_t ips = cpu->ips;
+    uint32_t rng = cpu->rng;
+    (void) snek8_extInit(cpu, (enum Snek8Profile) cpu->profile, cpu->implm_flags);
+    cpu->ips = ips;
+    cpu->rng = rng;
+    if (size){
+        (void) memcpy(cpu->memory + SNEK8_MEM_ADDR_PROG_START, rom, size);
+    }
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+enum Snek8ExecutionOutput
+snek8_extSetKey(Snek8ExtCPU* cpu, size_t key, bool value){
+    if (!cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (key >= SNEK8_SIZE_KEYSET){
+        return SNEK8_EXECOUT_INDEX_OUT_RANGE;
+    }
+    uint16_t bit = (uint16_t) (1u << key);
+    bool was = (cpu->keys & bit)? true: false;
+    if (value){
+        cpu->keys |= bit;
+    }else{
+        cpu->keys &= (uint16_t) ~bit;
+    }
+    if (!cpu->key_wait || was == value){
+        return SNEK8_EXECOUT_SUCCESS;
+    }
+    if (value){
+        cpu->key_armed |= bit;
+    }else if (cpu->key_armed & bit){
+        cpu->registers[cpu->memory[cpu->pc & cpu->mem_end] & 0x0Fu] = (uint8_t) key;
+        cpu->pc += 2;
+        cpu->key_wait = false;
+        cpu->key_armed = 0;
+    }
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+/**
+* @brief Retires idle cycles while LD V{0xX}, K waits (see `snek8_cpuRunWaiting`).
+*/
+static enum Snek8ExecutionOutput
+_snek8_extRunWaiting(Snek8ExtCPU* cpu, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+                     enum Snek8RunStop* stop){
+    bool brk = (break_flags & SNEK8_RUN_BREAK_ON_KEY_WAIT) && max_cycles;
+    size_t idle = brk? 1: max_cycles;
+    snek8_cpuClockIdle(&cpu->timer_phase, cpu->ips, &cpu->dt, &cpu->st, idle);
+    cpu->cycles += idle;
+    if (cycles){
+        *cycles = idle;
+    }
+    if (stop){
+        *stop = brk? SNEK8_RUNSTOP_KEY_WAIT: SNEK8_RUNSTOP_CYCLES;
+    }
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+/*
+* Screen kernels.
+*
+* A plane is `SNEK8_EXT_HEIGHT` rows of two words, so that the vertical scrolls move
+* whole rows and the horizontal ones shift a pair of words per row, carrying the bits
+* that cross the middle of the row from one word into the other.
+*/
+
+/**
+* @brief Clears the planes of `planes`.
+*/
+static inline void
+_snek8_extClear(Snek8ExtCPU* cpu, unsigned planes){
+    for (size_t p = 0; p < SNEK8_EXT_PLANES; p++){
+        if (planes & (1u << p)){
+            (void) memset(cpu->graphics[p], 0, sizeof(cpu->graphics[p]));
+        }
+    }
+    cpu->graphics_dirty = UINT64_MAX;
+    cpu->graphics_gen++;
+}
+
+/**
+* @brief Scrolls the planes of `planes` down by `n` physical rows.
+*/
+static inline void
+_snek8_extScrollDown(Snek8ExtCPU* cpu, unsigned planes, size_t n){
+    if (!n){
+        return;
+    }
+    for (size_t p = 0; p < SNEK8_EXT_PLANES; p++){
+        if (planes & (1u << p)){
+            uint64_t (*rows)[2] = cpu->graphics[p];
+            (void) memmove(rows + n, rows, (SNEK8_EXT_HEIGHT - n) * sizeof(rows[0]));
+            (void) memset(rows, 0, n * sizeof(rows[0]));
+        }
+    }
+    cpu->graphics_dirty = UINT64_MAX;
+    cpu->graphics_gen++;
+}
+
+/**
+* @brief Scrolls the planes of `planes` up by `n` physical rows.
+*/
+static inline void
+_snek8_extScrollUp(Snek8ExtCPU* cpu, unsigned planes, size_t n){
+    if (!n){
+        return;
+    }
+    for (size_t p = 0; p < SNEK8_EXT_PLANES; p++){
+        if (planes & (1u << p)){
+            uint64_t (*rows)[2] = cpu->graphics[p];
+            (void) memmove(rows, rows + n, (SNEK8_EXT_HEIGHT - n) * sizeof(rows[0]));
+            (void) memset(rows + SNEK8_EXT_HEIGHT - n, 0, n * sizeof(rows[0]));
+        }
+    }
+    cpu->graphics_dirty = UINT64_MAX;
+    cpu->graphics_gen++;
+}
+
+/**
+* @brief Scrolls the planes of `planes` right by `n` physical columns (0 < n < 64).
+*/
+static inline void
+_snek8_extScrollRight(Snek8ExtCPU* cpu, unsigned planes, unsigned n){
+    for (size_t p = 0; p < SNEK8_EXT_PLANES; p++){
+        if (planes & (1u << p)){
+            for (size_t y = 0; y < SNEK8_EXT_HEIGHT; y++){
+                uint64_t* row = cpu->graphics[p][y];
+                row[1] = (row[1] >> n) | (row[0] << (64 - n));
+                row[0] >>= n;
+            }
+        }
+    }
+    cpu->graphics_dirty = UINT64_MAX;
+    cpu->graphics_gen++;
+}
+
+/**
+* @brief Scrolls the planes of `planes` left by `n` physical columns (0 < n < 64).
+*/
+static inline void
+_snek8_extScrollLeft(Snek8ExtCPU* cpu, unsigned planes, unsigned n){
+    for (size_t p = 0; p < SNEK8_EXT_PLANES; p++){
+        if (planes & (1u << p)){
+            for (size_t y = 0; y < SNEK8_EXT_HEIGHT; y++){
+                uint64_t* row = cpu->graphics[p][y];
+                row[0] = (row[0] << n) | (row[1] >> (64 - n));
+                row[1] <<= n;
+            }
+        }
+    }
+    cpu->graphics_dirty = UINT64_MAX;
+    cpu->graphics_gen++;
+}
+
+/**
+* @brief Doubles every bit of a 16-bit sprite row, for the 2x2 pixels of lo-res.
+*/
+static inline uint32_t
+_snek8_extDouble(uint32_t bits){
+    bits = (bits | (bits << 8)) & 0x00FF00FFu;
+    bits = (bits | (bits << 4)) & 0x0F0F0F0Fu;
+    bits = (bits | (bits << 2)) & 0x33333333u;
+    bits = (bits | (bits << 1)) & 0x55555555u;
+    return bits | (bits << 1);
+}
+
+/**
+* @brief Draws a sprite on the planes of `planes`.
+*
+* @param[in, out] `cpu`.
+* @param[in] `planes`.
+* @param[in] `sprite` The sprite data, one sprite per selected plane, in order.
+* @param[in] `vx` The column of the sprite, in pixels of the current mode.
+* @param[in] `vy` The row of the sprite, in pixels of the current mode.
+* @param[in] `n` The number of rows of the sprite, 0 for a 16x16 sprite.
+* @param[in] `wrap` Whether the sprite wraps around the screen (else it is clipped).
+* @param[in] `row_hits` Whether, in hi-res, the result counts the sprite rows that
+*            collided or were clipped.
+* @return The value of V{0xF}.
+*/
+static inline uint8_t
+_snek8_extDraw(Snek8ExtCPU* cpu, unsigned planes, const uint8_t* sprite, uint8_t vx, uint8_t vy,
+               uint8_t n, bool wrap, bool row_hits){
+    const size_t scale = cpu->hires? 1: 2;
+    const size_t width = SNEK8_EXT_WIDTH / scale;
+    const size_t height = SNEK8_EXT_HEIGHT / scale;
+    const bool wide = !n;
+    const size_t rows = wide? 16: n;
+    const size_t bits = (wide? 16: 8) * scale;
+    const size_t x = (vx % width) * scale;
+    const size_t y = vy % height;
+    uint32_t hit = 0;
+    uint32_t clipped = 0;
+    for (size_t p = 0; p < SNEK8_EXT_PLANES; p++){
+        if (!(planes & (1u << p))){
+            continue;
+        }
+        for (size_t r = 0; r < rows; r++){
+            uint32_t data = wide? (uint32_t) ((sprite[2 * r] << 8) | sprite[2 * r + 1]): sprite[r];
+            size_t row = y + r;
+            if (row >= height){
+                if (!wrap){
+                    clipped |= 1u << r;
+                    continue;
+                }
+                row -= height;
+            }
+            if (2 == scale){
+                data = _snek8_extDouble(data);
+            }
+            uint64_t pattern = (uint64_t) data << (64 - bits);
+            uint64_t w0, w1;
+            if (x < 64){
+                w0 = pattern >> x;
+                w1 = x? pattern << (64 - x): 0;
+            }else{
+                w0 = (wrap && x > 64)? pattern << (128 - x): 0;
+                w1 = pattern >> (x - 64);
+            }
+            for (size_t s = 0; s < scale; s++){
+                uint64_t* line = cpu->graphics[p][row * scale + s];
+                if ((line[0] & w0) | (line[1] & w1)){
+                    hit |= 1u << r;
+                }
+                line[0] ^= w0;
+                line[1] ^= w1;
+            }
+            cpu->graphics_dirty |= ((UINT64_C(1) << scale) - 1) << (row * scale);
+        }
+        sprite += rows * (wide? 2: 1);
+    }
+    cpu->graphics_gen++;
+    if (!(row_hits && cpu->hires)){
+        return hit? 1: 0;
+    }
+    uint8_t count = 0;
+    for (uint32_t mask = hit | clipped; mask; mask &= mask - 1){
+        count++;
+    }
+    return count;
+}
+
+/*
+* Profile cores.
+*/
+#define SNEK8_X_R(i)            v[(i)]
+#define SNEK8_X_R_STORE(p, n)   snek8_cpuCopyRegisters((p), v, (n))
+#define SNEK8_X_R_LOAD(p, n)    snek8_cpuCopyRegisters(v, (p), (n))
+#define SNEK8_X_PC              pc
+#define SNEK8_X_IR              ir
+#define SNEK8_X_DT              dt
+#define SNEK8_X_ST              st
+#define SNEK8_X_CLOCK           phase
+#define SNEK8_X_IPS             ips
+#define SNEK8_X_KEYS            cpu->keys
+#define SNEK8_X_KEY_WAIT        cpu->key_wait
+#define SNEK8_X_KEY_ARMED       cpu->key_armed
+#define SNEK8_X_MEM             mem
+#define SNEK8_X_MEM_END         SNEK8_E_MEM_END
+#define SNEK8_X_STACK           (&cpu->stack)
+#define SNEK8_X_RAND()          snek8_cpuRand(&cpu->rng)
+#define SNEK8_X_FAIL(code)                                                          \
+    do{                                                                             \
+        out = (code);                                                               \
+        reason = SNEK8_RUNSTOP_ERROR;                                               \
+        goto _snek8_retire_and_exit;                                                \
+    }while (0)
+#define SNEK8_X_ON_KEY_WAIT()                                                       \
+    do{                                                                             \
+        reason = SNEK8_RUNSTOP_KEY_WAIT;                                            \
+        goto _snek8_retire_and_exit;                                                \
+    }while (0)
+#define SNEK8_X_ON_WRITE(addr, len)                                                 \
+    ((void) (addr), (void) (len))
+
+#define SNEK8_T_X               ((opcode >> 8) & 0xFu)
+#define SNEK8_T_Y               ((opcode >> 4) & 0xFu)
+#define SNEK8_T_N               (opcode & 0xFu)
+#define SNEK8_T_KK              ((uint8_t) (opcode & 0x00FFu))
+#define SNEK8_T_NNN             ((uint16_t) (opcode & 0x0FFFu))
+
+#define SNEK8_E_NAME            snek8_extRunSCHIP
+#define SNEK8_E_XO              0
+#define SNEK8_E_PLANES          1
+#define SNEK8_E_MEM_END         SNEK8_MEM_ADDR_RAM_END
+#define SNEK8_E_FLAGS           8
+#define SNEK8_E_WRAP            0
+#define SNEK8_E_ROW_HITS        1
+#define SNEK8_E_LORES_SCROLL    1
+#define SNEK8_E_MODE_CLEARS     0
+#include "ext_core.h"
+
+#define SNEK8_E_NAME            snek8_extRunXOCHIP
+#define SNEK8_E_XO              1
+#define SNEK8_E_PLANES          2
+#define SNEK8_E_MEM_END         0xFFFF
+#define SNEK8_E_FLAGS           16
+#define SNEK8_E_WRAP            1
+#define SNEK8_E_ROW_HITS        0
+#define SNEK8_E_LORES_SCROLL    2
+#define SNEK8_E_MODE_CLEARS     1
+#include "ext_core.h"
+
+enum Snek8ExecutionOutput
+snek8_extRun(Snek8ExtCPU* cpu, size_t max_cycles, uint8_t break_flags, size_t* cycles,
+             enum Snek8RunStop* stop){
+    if (!cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (SNEK8_PROFILE_XOCHIP == cpu->profile){
+        return snek8_extRunXOCHIP(cpu, max_cycles, break_flags, cycles, stop);
+    }
+    return snek8_extRunSCHIP(cpu, max_cycles, break_flags, cycles, stop);
+}
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_EXT_C
@@ -0,0 +1,252 @@
+/**
+* @file replay.c
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Implementation of the input replays.
+*/
+#ifndef SNEK8_REPLAY_C
+    #define SNEK8_REPLAY_C
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include <stdlib.h>
+#include "replay.h"
+
+static const uint8_t _snek8_replay_magic[4] = {'S', '8', 'R', 'P'};
+
+Snek8Replay*
+snek8_replayNew(const Snek8CPU* cpu){
+    if (!cpu){
+        return NULL;
+    }
+    Snek8Replay* replay = malloc(sizeof(Snek8Replay));
+    if (!replay){
+        return NULL;
+    }
+    replay->start.id = 0;
+    (void) snek8_cpuSerialize(cpu, replay->start.data);
+    replay->end_cycle = cpu->cycles;
+    replay->keys = cpu->keys;
+    replay->out = SNEK8_EXECOUT_SUCCESS;
+    replay->failed = false;
+    replay->count = 0;
+    replay->capacity = 0;
+    replay->events = NULL;
+    return replay;
+}
+
+void
+snek8_replayDel(Snek8Replay* replay){
+    if (!replay){
+        return;
+    }
+    free(replay->events);
+    free(replay);
+}
+
+enum Snek8ExecutionOutput
+snek8_replayRecord(Snek8Replay* replay, uint64_t cycle, uint16_t keys){
+    if (!replay){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    uint16_t changed = replay->keys ^ keys;
+    for (uint8_t key = 0; changed; key++, changed >>= 1){
+        if (!(changed & 1u)){
+            continue;
+        }
+        if (replay->count == replay->capacity){
+            size_t capacity = replay->capacity? 2 * replay->capacity: 64;
+            Snek8ReplayEvent* events = realloc(replay->events, capacity * sizeof(Snek8ReplayEvent));
+            if (!events){
+                replay->failed = true;
+                return SNEK8_EXECOUT_OUT_OF_MEMORY;
+            }
+            replay->events = events;
+            replay->capacity = capacity;
+        }
+        bool value = (keys >> key) & 1u;
+        replay->events[replay->count++] = (Snek8ReplayEvent) {.cycle = cycle, .key = key, .value = value};
+        replay->keys ^= (uint16_t) (1u << key);
+    }
+    replay->end_cycle = cycle;
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+static inline size_t
+_snek8_replayVarintSize(uint64_t value){
+    size_t n = 1;
+    while (value >= 0x80u){
+        value >>= 7;
+        n++;
+    }
+    return n;
+}
+
+size_t
+snek8_replaySize(const Snek8Replay* replay){
+    size_t size = SNEK8_SIZE_REPLAY_HEADER;
+    uint64_t cycle = 0;
+    for (size_t i = 0; i < replay->count; i++){
+        size += _snek8_replayVarintSize(replay->events[i].cycle - cycle) + 1;
+        cycle = replay->events[i].cycle;
+    }
+    return size;
+}
+
+static inline void
+_snek8_replayPut(uint8_t* data, uint64_t value, size_t bytes){
+    for (size_t i = 0; i < bytes; i++){
+        data[i] = (uint8_t) (value >> (8 * i));
+    }
+}
+
+static inline uint64_t
+_snek8_replayGet(const uint8_t* data, size_t bytes){
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++){
+        value |= (uint64_t) data[i] << (8 * i);
+    }
+    return value;
+}
+
+void
+snek8_replayWrite(const Snek8Replay* replay, uint8_t* data){
+    (void) memcpy(data, _snek8_replay_magic, sizeof(_snek8_replay_magic));
+    _snek8_replayPut(data + 4, SNEK8_REPLAY_VERSION, 2);
+    _snek8_replayPut(data + 6, replay->out, 2);
+    _snek8_replayPut(data + 8, replay->count, 4);
+    _snek8_replayPut(data + 12, replay->end_cycle, 8);
+    (void) memcpy(data + 20, replay->start.data, SNEK8_SIZE_SNAPSHOT);
+    size_t n = SNEK8_SIZE_REPLAY_HEADER;
+    // The initial cycle is stored in the initial state, so the first delta is absolute.
+    uint64_t cycle = 0;
+    for (size_t i = 0; i < replay->count; i++){
+        uint64_t delta = replay->events[i].cycle - cycle;
+        while (delta >= 0x80u){
+            data[n++] = (uint8_t) (delta | 0x80u);
+            delta >>= 7;
+        }
+        data[n++] = (uint8_t) delta;
+        data[n++] = (uint8_t) (replay->events[i].key | (replay->events[i].value << 4));
+        cycle = replay->events[i].cycle;
+    }
+}
+
+enum Snek8ExecutionOutput
+snek8_replayRead(const uint8_t* data, size_t size, Snek8Replay** replay){
+    if (!data || !replay){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    if (size < SNEK8_SIZE_REPLAY_HEADER
+        || memcmp(data, _snek8_replay_magic, sizeof(_snek8_replay_magic))
+        || _snek8_replayGet(data + 4, 2) != SNEK8_REPLAY_VERSION
+        || _snek8_replayGet(data + 6, 2) > SNEK8_EXECOUT_OUT_OF_MEMORY
+        || SNEK8_EXECOUT_SUCCESS != snek8_snapshotValidate(data + 20, SNEK8_SIZE_SNAPSHOT)){
+        return SNEK8_EXECOUT_REPLAY_INVALID;
+    }
+    size_t count = (size_t) _snek8_replayGet(data + 8, 4);
+    // Every event takes at least 2 bytes.
+    if (count > (size - SNEK8_SIZE_REPLAY_HEADER) / 2){
+        return SNEK8_EXECOUT_REPLAY_INVALID;
+    }
+    Snek8Replay* parsed = malloc(sizeof(Snek8Replay));
+    Snek8ReplayEvent* events = malloc((count? count: 1) * sizeof(Snek8ReplayEvent));
+    if (!parsed || !events){
+        free(parsed);
+        free(events);
+        return SNEK8_EXECOUT_OUT_OF_MEMORY;
+    }
+    parsed->start.id = 0;
+    (void) memcpy(parsed->start.data, data + 20, SNEK8_SIZE_SNAPSHOT);
+    parsed->end_cycle = _snek8_replayGet(data + 12, 8);
+    parsed->out = (enum Snek8ExecutionOutput) _snek8_replayGet(data + 6, 2);
+    parsed->failed = false;
+    parsed->count = count;
+    parsed->capacity = count;
+    parsed->events = events;
+    // The initial cycle and keys are the ones of the initial state (offsets 16 and 12).
+    uint64_t cycle = _snek8_replayGet(parsed->start.data + 16, 8);
+    uint16_t keys = (uint16_t) _snek8_replayGet(parsed->start.data + 12, 2);
+    uint64_t previous = 0;
+    size_t n = SNEK8_SIZE_REPLAY_HEADER;
+    for (size_t i = 0; i < count; i++){
+        uint64_t delta = 0;
+        unsigned shift = 0;
+        uint8_t byte;
+        do{
+            if (n >= size || shift > 63){
+                snek8_replayDel(parsed);
+                return SNEK8_EXECOUT_REPLAY_INVALID;
+            }
+            byte = data[n++];
+            delta |= (uint64_t) (byte & 0x7Fu) << shift;
+            shift += 7;
+        }while (byte & 0x80u);
+        if (n >= size || data[n] & 0xE0u || previous + delta < previous){
+            snek8_replayDel(parsed);
+            return SNEK8_EXECOUT_REPLAY_INVALID;
+        }
+        previous += delta;
+        events[i].cycle = previous;
+        events[i].key = data[n] & 0x0Fu;
+        events[i].value = (data[n] >> 4) & 1u;
+        keys = events[i].value? (uint16_t) (keys | (1u << events[i].key)):
+                                (uint16_t) (keys & ~(1u << events[i].key));
+        n++;
+    }
+    if (n != size || (count && events[0].cycle < cycle) || parsed->end_cycle < (count? previous: cycle)){
+        snek8_replayDel(parsed);
+        return SNEK8_EXECOUT_REPLAY_INVALID;
+    }
+    parsed->keys = keys;
+    *replay = parsed;
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+/**
+* @brief Runs the CPU until its cycle counter reaches `target`.
+*
+* @param `cpu`.
+* @param `run`.
+* @param `target`.
+* @return The execution output of the run.
+*/
+static enum Snek8ExecutionOutput
+_snek8_replayRunTo(Snek8CPU* cpu, Snek8RunEngine run, uint64_t target){
+    while (cpu->cycles < target){
+        uint64_t left = target - cpu->cycles;
+        size_t cycles = (left < SIZE_MAX)? (size_t) left: SIZE_MAX;
+        enum Snek8ExecutionOutput out = run(cpu, cycles, 0, NULL, NULL);
+        if (SNEK8_EXECOUT_SUCCESS != out){
+            return out;
+        }
+    }
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+enum Snek8ExecutionOutput
+snek8_replayPlay(const Snek8Replay* replay, Snek8CPU* cpu, Snek8RunEngine run){
+    if (!replay || !cpu || !run){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    enum Snek8ExecutionOutput out = snek8_cpuRestore(cpu, &replay->start);
+    for (size_t i = 0; SNEK8_EXECOUT_SUCCESS == out && i < replay->count; i++){
+        out = _snek8_replayRunTo(cpu, run, replay->events[i].cycle);
+        if (SNEK8_EXECOUT_SUCCESS == out){
+            (void) snek8_cpuSetKey(cpu, replay->events[i].key, replay->events[i].value);
+        }
+    }
+    if (SNEK8_EXECOUT_SUCCESS == out){
+        out = _snek8_replayRunTo(cpu, run, replay->end_cycle);
+    }
+    if (SNEK8_EXECOUT_SUCCESS == out && SNEK8_EXECOUT_SUCCESS != replay->out){
+        out = run(cpu, 1, 0, NULL, NULL);
+    }
+    return out;
+}
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_REPLAY_C
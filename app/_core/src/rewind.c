@@ -0,0 +1,248 @@
+/**
+* @file rewind.c
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Implementation of the rewind buffer.
+*/
+#ifndef SNEK8_REWIND_C
+    #define SNEK8_REWIND_C
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include <stdlib.h>
+#include "rewind.h"
+
+/**
+* @def SNEK8_REWIND_MIN_GAP
+* @brief The number of unchanged bytes that ends a literal run. Shorter gaps are
+* cheaper to store inside the literals than as a new run.
+*/
+#define SNEK8_REWIND_MIN_GAP            3
+
+Snek8Rewind*
+snek8_rewindNew(size_t budget){
+    if (budget < SNEK8_REWIND_MIN_BUDGET){
+        return NULL;
+    }
+    Snek8Rewind* rewind = malloc(sizeof(Snek8Rewind));
+    if (!rewind){
+        return NULL;
+    }
+    rewind->ring = malloc(budget);
+    if (!rewind->ring){
+        free(rewind);
+        return NULL;
+    }
+    rewind->budget = budget;
+    rewind->latest.id = 0;
+    snek8_rewindClear(rewind);
+    return rewind;
+}
+
+void
+snek8_rewindDel(Snek8Rewind* rewind){
+    if (!rewind){
+        return;
+    }
+    free(rewind->ring);
+    free(rewind);
+}
+
+void
+snek8_rewindClear(Snek8Rewind* rewind){
+    rewind->head = 0;
+    rewind->used = 0;
+    rewind->frames = 0;
+    rewind->primed = false;
+}
+
+/**
+* @brief Counts the bytes, starting at `pos`, that are equal in both states.
+*
+* @param `a`.
+* @param `b`.
+* @param `pos` The first position.
+* @param `end` The position the count stops at.
+* @return The length of the run.
+*/
+static inline size_t
+_snek8_rewindSameRun(const uint8_t* a, const uint8_t* b, size_t pos, size_t end){
+    size_t i = pos;
+    while (i + sizeof(uint64_t) <= end){
+        uint64_t wa, wb;
+        (void) memcpy(&wa, a + i, sizeof(uint64_t));
+        (void) memcpy(&wb, b + i, sizeof(uint64_t));
+        if (wa != wb){
+            break;
+        }
+        i += sizeof(uint64_t);
+    }
+    while (i < end && a[i] == b[i]){
+        i++;
+    }
+    return i - pos;
+}
+
+static inline size_t
+_snek8_rewindPutSize(uint8_t* out, size_t value){
+    size_t n = 0;
+    while (value >= 0x80u){
+        out[n++] = (uint8_t) (value | 0x80u);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t) value;
+    return n;
+}
+
+static inline size_t
+_snek8_rewindGetSize(const uint8_t* in, size_t* n){
+    size_t value = 0;
+    unsigned shift = 0;
+    uint8_t byte;
+    do{
+        byte = in[(*n)++];
+        value |= (size_t) (byte & 0x7Fu) << shift;
+        shift += 7;
+    }while (byte & 0x80u);
+    return value;
+}
+
+/**
+* @brief Encodes the XOR of two states as runs of unchanged bytes and literals.
+*
+* @param `a` The state being recorded.
+* @param `b` The state it is compared to.
+* @param `out` The payload (at least `SNEK8_REWIND_MAX_ENTRY` - 4 bytes).
+* @return The size of the payload.
+*/
+static size_t
+_snek8_rewindEncode(const uint8_t* a, const uint8_t* b, uint8_t* out){
+    size_t size = 0;
+    size_t pos = 0;
+    while (pos < SNEK8_SIZE_SNAPSHOT){
+        size_t zeros = _snek8_rewindSameRun(a, b, pos, SNEK8_SIZE_SNAPSHOT);
+        size_t start = pos + zeros;
+        if (SNEK8_SIZE_SNAPSHOT == start){
+            break;
+        }
+        size_t end = start + 1;
+        while (end < SNEK8_SIZE_SNAPSHOT){
+            if (a[end] != b[end]){
+                end++;
+                continue;
+            }
+            size_t limit = (end + SNEK8_REWIND_MIN_GAP < SNEK8_SIZE_SNAPSHOT)?
+                           end + SNEK8_REWIND_MIN_GAP: SNEK8_SIZE_SNAPSHOT;
+            size_t gap = _snek8_rewindSameRun(a, b, end, limit);
+            if (end + gap == limit){
+                break;
+            }
+            end += gap;
+        }
+        size += _snek8_rewindPutSize(out + size, zeros);
+        size += _snek8_rewindPutSize(out + size, end - start);
+        for (size_t i = start; i < end; i++){
+            out[size++] = a[i] ^ b[i];
+        }
+        pos = end;
+    }
+    return size;
+}
+
+/**
+* @brief Applies an encoded XOR to a state.
+*
+* @param `state`.
+* @param `in` The payload.
+* @param `size` The size of the payload.
+*/
+static void
+_snek8_rewindDecode(uint8_t* state, const uint8_t* in, size_t size){
+    size_t n = 0;
+    size_t pos = 0;
+    while (n < size){
+        pos += _snek8_rewindGetSize(in, &n);
+        size_t literals = _snek8_rewindGetSize(in, &n);
+        for (size_t i = 0; i < literals; i++){
+            state[pos++] ^= in[n++];
+        }
+    }
+}
+
+static inline void
+_snek8_rewindWrite(Snek8Rewind* rewind, size_t offset, const uint8_t* src, size_t len){
+    size_t first = (len < rewind->budget - offset)? len: rewind->budget - offset;
+    (void) memcpy(rewind->ring + offset, src, first);
+    (void) memcpy(rewind->ring, src + first, len - first);
+}
+
+static inline void
+_snek8_rewindRead(const Snek8Rewind* rewind, size_t offset, uint8_t* dst, size_t len){
+    size_t first = (len < rewind->budget - offset)? len: rewind->budget - offset;
+    (void) memcpy(dst, rewind->ring + offset, first);
+    (void) memcpy(dst + first, rewind->ring, len - first);
+}
+
+/**
+* @brief Reads the 16-bit size stored at an offset of the ring.
+*/
+static inline size_t
+_snek8_rewindReadSize(const Snek8Rewind* rewind, size_t offset){
+    uint8_t bytes[2];
+    _snek8_rewindRead(rewind, offset % rewind->budget, bytes, 2);
+    return (size_t) (bytes[0] | (bytes[1] << 8));
+}
+
+enum Snek8ExecutionOutput
+snek8_rewindRecord(Snek8Rewind* rewind, const Snek8CPU* cpu){
+    if (!rewind || !cpu){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }
+    (void) snek8_cpuSerialize(cpu, rewind->current);
+    if (!rewind->primed){
+        (void) memcpy(rewind->latest.data, rewind->current, SNEK8_SIZE_SNAPSHOT);
+        rewind->primed = true;
+        return SNEK8_EXECOUT_SUCCESS;
+    }
+    // The entry restores the latest state from the current one.
+    size_t size = _snek8_rewindEncode(rewind->latest.data, rewind->current, rewind->entry + 2);
+    rewind->entry[0] = rewind->entry[size + 2] = (uint8_t) size;
+    rewind->entry[1] = rewind->entry[size + 3] = (uint8_t) (size >> 8);
+    size_t total = size + 4;
+    while (rewind->budget - rewind->used < total){
+        size_t tail = (rewind->head + rewind->budget - rewind->used) % rewind->budget;
+        rewind->used -= _snek8_rewindReadSize(rewind, tail) + 4;
+        rewind->frames--;
+    }
+    _snek8_rewindWrite(rewind, rewind->head, rewind->entry, total);
+    rewind->head = (rewind->head + total) % rewind->budget;
+    rewind->used += total;
+    rewind->frames++;
+    (void) memcpy(rewind->latest.data, rewind->current, SNEK8_SIZE_SNAPSHOT);
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+size_t
+snek8_rewindRewind(Snek8Rewind* rewind, Snek8CPU* cpu, size_t frames){
+    if (!rewind || !cpu || !rewind->primed){
+        return 0;
+    }
+    size_t done = 0;
+    for (; done < frames && rewind->frames; done++){
+        size_t size = _snek8_rewindReadSize(rewind, rewind->head + rewind->budget - 2);
+        size_t start = (rewind->head + rewind->budget - size - 4) % rewind->budget;
+        _snek8_rewindRead(rewind, (start + 2) % rewind->budget, rewind->entry, size);
+        _snek8_rewindDecode(rewind->latest.data, rewind->entry, size);
+        rewind->head = start;
+        rewind->used -= size + 4;
+        rewind->frames--;
+    }
+    (void) snek8_cpuRestore(cpu, &rewind->latest);
+    return done;
+}
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_REWIND_C
@@ -0,0 +1,199 @@
+/**
+* @file rom.c
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Implementation of the ROM files reading and of the ROM cache.
+*/
+#ifndef SNEK8_ROM_C
+    #define SNEK8_ROM_C
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#ifndef _WIN32
+    #define _POSIX_C_SOURCE 200809L
+#endif
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/stat.h>
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+#endif
+#include "rom.h"
+
+#if defined(_WIN32)
+    typedef struct _stat64 Snek8RomStat;
+    #define SNEK8_ROM_STAT(path, st)    _stat64(path, st)
+    #define SNEK8_ROM_MTIME(st)         ((int64_t) (st).st_mtime * 1000000000)
+#elif defined(__APPLE__)
+    typedef struct stat Snek8RomStat;
+    #define SNEK8_ROM_STAT(path, st)    stat(path, st)
+    #define SNEK8_ROM_MTIME(st)         ((int64_t) (st).st_mtimespec.tv_sec * 1000000000 + (st).st_mtimespec.tv_nsec)
+#else
+    typedef struct stat Snek8RomStat;
+    #define SNEK8_ROM_STAT(path, st)    stat(path, st)
+    #define SNEK8_ROM_MTIME(st)         ((int64_t) (st).st_mtim.tv_sec * 1000000000 + (st).st_mtim.tv_nsec)
+#endif
+
+/**
+* @brief Checks the metadata of a ROM file.
+*
+* @param `st`.
+* @return `SNEK8_EXECOUT_ROM_FILE_INVALID` if it is not a regular file,
+* `SNEK8_EXECOUT_ROM_FILE_EXCEEDS_MAX_MEM` if it is too large and
+* `SNEK8_EXECOUT_SUCCESS` otherwise.
+*/
+static inline enum Snek8ExecutionOutput
+_snek8_romCheck(const Snek8RomStat* st){
+    if (S_IFREG != (st->st_mode & S_IFMT)){
+        return SNEK8_EXECOUT_ROM_FILE_INVALID;
+    }
+    if (st->st_size < 0 || (uint64_t) st->st_size > SNEK8_SIZE_MAX_ROM_FILE){
+        return SNEK8_EXECOUT_ROM_FILE_EXCEEDS_MAX_MEM;
+    }
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+#ifndef _WIN32
+enum Snek8ExecutionOutput
+snek8_romRead(const char* rom_file_path, Snek8Rom* rom){
+    if (!rom){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }else if (!rom_file_path){
+        return SNEK8_EXECOUT_ROM_FILE_INVALID;
+    }
+    int fd = open(rom_file_path, O_RDONLY);
+    if (fd < 0){
+        return (ENOENT == errno)? SNEK8_EXECOUT_ROM_FILE_NOT_FOUND: SNEK8_EXECOUT_ROM_FILE_FAILED_TO_OPEN;
+    }
+    Snek8RomStat st;
+    if (fstat(fd, &st) < 0){
+        (void) close(fd);
+        return SNEK8_EXECOUT_ROM_FILE_FAILED_TO_READ;
+    }
+    enum Snek8ExecutionOutput out = _snek8_romCheck(&st);
+    if (SNEK8_EXECOUT_SUCCESS != out){
+        (void) close(fd);
+        return out;
+    }
+    size_t size = (size_t) st.st_size;
+    // Empty files cannot be mapped, and there is nothing to copy anyway.
+    if (size){
+        void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (MAP_FAILED == map){
+            (void) close(fd);
+            return SNEK8_EXECOUT_ROM_FILE_FAILED_TO_READ;
+        }
+        (void) memcpy(rom->data, map, size);
+        (void) munmap(map, size);
+    }
+    (void) close(fd);
+    rom->mtime = SNEK8_ROM_MTIME(st);
+    rom->size = size;
+    return SNEK8_EXECOUT_SUCCESS;
+}
+#else
+enum Snek8ExecutionOutput
+snek8_romRead(const char* rom_file_path, Snek8Rom* rom){
+    if (!rom){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }else if (!rom_file_path){
+        return SNEK8_EXECOUT_ROM_FILE_INVALID;
+    }
+    Snek8RomStat st;
+    if (SNEK8_ROM_STAT(rom_file_path, &st) < 0){
+        return (ENOENT == errno)? SNEK8_EXECOUT_ROM_FILE_NOT_FOUND: SNEK8_EXECOUT_ROM_FILE_FAILED_TO_OPEN;
+    }
+    enum Snek8ExecutionOutput out = _snek8_romCheck(&st);
+    if (SNEK8_EXECOUT_SUCCESS != out){
+        return out;
+    }
+    FILE* rom_file = fopen(rom_file_path, "rb");
+    if (!rom_file){
+        return SNEK8_EXECOUT_ROM_FILE_FAILED_TO_OPEN;
+    }
+    size_t size = (size_t) st.st_size;
+    size_t nread = fread(rom->data, 1, size, rom_file);
+    (void) fclose(rom_file);
+    if (nread != size){
+        return SNEK8_EXECOUT_ROM_FILE_FAILED_TO_READ;
+    }
+    rom->mtime = SNEK8_ROM_MTIME(st);
+    rom->size = size;
+    return SNEK8_EXECOUT_SUCCESS;
+}
+#endif
+
+static inline void
+_snek8_romCacheDrop(Snek8RomCacheEntry* entry){
+    free(entry->path);
+    entry->path = NULL;
+}
+
+enum Snek8ExecutionOutput
+snek8_romCacheGet(Snek8RomCache* cache, const char* rom_file_path, const Snek8Rom** rom){
+    if (!cache || !rom){
+        return SNEK8_EXECOUT_EMPTY_STRUCT;
+    }else if (!rom_file_path){
+        return SNEK8_EXECOUT_ROM_FILE_INVALID;
+    }
+    cache->clock++;
+    Snek8RomCacheEntry* entry = NULL;
+    Snek8RomCacheEntry* victim = &cache->entries[0];
+    for (size_t i = 0; i < SNEK8_ROM_CACHE_SIZE; i++){
+        Snek8RomCacheEntry* candidate = &cache->entries[i];
+        if (candidate->path && !strcmp(candidate->path, rom_file_path)){
+            entry = candidate;
+            break;
+        }
+        if (victim->path && (!candidate->path || candidate->used < victim->used)){
+            victim = candidate;
+        }
+    }
+    if (entry){
+        Snek8RomStat st;
+        if (SNEK8_ROM_STAT(rom_file_path, &st) < 0){
+            _snek8_romCacheDrop(entry);
+            return (ENOENT == errno)? SNEK8_EXECOUT_ROM_FILE_NOT_FOUND: SNEK8_EXECOUT_ROM_FILE_FAILED_TO_OPEN;
+        }
+        if (SNEK8_ROM_MTIME(st) == entry->rom.mtime && (uint64_t) st.st_size == entry->rom.size){
+            entry->used = cache->clock;
+            *rom = &entry->rom;
+            return SNEK8_EXECOUT_SUCCESS;
+        }
+    }else{
+        entry = victim;
+        _snek8_romCacheDrop(entry);
+        size_t len = strlen(rom_file_path) + 1;
+        entry->path = malloc(len);
+        if (!entry->path){
+            return SNEK8_EXECOUT_ROM_FILE_FAILED_TO_READ;
+        }
+        (void) memcpy(entry->path, rom_file_path, len);
+    }
+    enum Snek8ExecutionOutput out = snek8_romRead(rom_file_path, &entry->rom);
+    if (SNEK8_EXECOUT_SUCCESS != out){
+        _snek8_romCacheDrop(entry);
+        return out;
+    }
+    entry->used = cache->clock;
+    *rom = &entry->rom;
+    return SNEK8_EXECOUT_SUCCESS;
+}
+
+void
+snek8_romCacheClear(Snek8RomCache* cache){
+    if (!cache){
+        return;
+    }
+    for (size_t i = 0; i < SNEK8_ROM_CACHE_SIZE; i++){
+        _snek8_romCacheDrop(&cache->entries[i]);
+    }
+}
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_ROM_C
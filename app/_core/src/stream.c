@@ -0,0 +1,202 @@
+/**
+* @file stream.c
+* @author Paulo Arruda
+* @license GPL-3
+* @brief Implementation of the frame stream.
+*/
+#ifndef SNEK8_STREAM_C
+    #define SNEK8_STREAM_C
+#ifdef __cplusplus
+    extern "C"{
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include "stream.h"
+
+Snek8Stream*
+snek8_streamNew(size_t capacity, uint32_t keyframe_interval){
+    if (capacity < SNEK8_STREAM_MAX_FRAME || !keyframe_interval){
+        return NULL;
+    }
+    Snek8Stream* stream = malloc(sizeof(Snek8Stream));
+    if (!stream){
+        return NULL;
+    }
+    stream->ring = malloc(capacity);
+    if (!stream->ring){
+        free(stream);
+        return NULL;
+    }
+    stream->capacity = capacity;
+    atomic_init(&stream->head, 0);
+    atomic_init(&stream->tail, 0);
+    atomic_init(&stream->requested, false);
+    atomic_init(&stream->dropped, 0);
+    stream->sequence = 0;
+    stream->keyframe_interval = keyframe_interval;
+    stream->since_keyframe = 0;
+    stream->resync = true;
+    (void) memset(stream->rows, 0, sizeof(stream->rows));
+    return stream;
+}
+
+void
+snek8_streamDel(Snek8Stream* stream){
+    if (!stream){
+        return;
+    }
+    free(stream->ring);
+    free(stream);
+}
+
+/**
+* @brief Writes the XOR of a row into a frame.
+*
+* @return The size of the row's entry, 0 if the row did not change.
+*/
+static inline size_t
+_snek8_streamEncodeRow(uint8_t* entry, uint8_t row, uint64_t diff){
+    if (!diff){
+        return 0;
+    }
+    size_t size = 2;
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < 8; i++){
+        uint8_t byte = (uint8_t) (diff >> (56 - 8 * i));
+        if (byte){
+            mask |= (uint8_t) (1u << i);
+            entry[size++] = byte;
+        }
+    }
+    entry[0] = row;
+    entry[1] = mask;
+    return size;
+}
+
+/**
+* @brief Copies bytes into the ring, from the position `at`, wrapping around its end.
+*/
+static inline void
+_snek8_streamWrite(Snek8Stream* stream, uint64_t at, const uint8_t* data, size_t size){
+    size_t offset = (size_t) (at % stream->capacity);
+    size_t first = (size < stream->capacity - offset)? size: stream->capacity - offset;
+    (void) memcpy(stream->ring + offset, data, first);
+    (void) memcpy(stream->ring, data + first, size - first);
+}
+
+/**
+* @brief Copies bytes out of the ring, from the position `at`, wrapping around its end.
+*/
+static inline void
+_snek8_streamCopy(const Snek8Stream* stream, uint64_t at, uint8_t* data, size_t size){
+    size_t offset = (size_t) (at % stream->capacity);
+    size_t first = (size < stream->capacity - offset)? size: stream->capacity - offset;
+    (void) memcpy(data, stream->ring + offset, first);
+    (void) memcpy(data + first, stream->ring, size - first);
+}
+
+bool
+snek8_streamPush(Snek8Stream* stream, const uint64_t* graphics){
+    bool requested = atomic_exchange_explicit(&stream->requested, false, memory_order_relaxed);
+    bool keyframe = requested || stream->resync || stream->since_keyframe >= stream->keyframe_interval;
+    if (!keyframe && !memcmp(stream->rows, graphics, sizeof(stream->rows))){
+        return false;
+    }
+    uint8_t* entry = stream->entry;
+    size_t size = SNEK8_STREAM_SIZE_HEADER;
+    uint8_t rows = 0;
+    for (uint8_t row = 0; row < SNEK8_GRAPHICS_HEIGTH; row++){
+        uint64_t diff = keyframe? graphics[row]: graphics[row] ^ stream->rows[row];
+        size_t written = _snek8_streamEncodeRow(entry + size, row, diff);
+        size += written;
+        rows += (written != 0);
+    }
+    (void) memcpy(stream->rows, graphics, sizeof(stream->rows));
+    uint32_t sequence = stream->sequence++;
+    for (size_t i = 0; i < 4; i++){
+        entry[i] = (uint8_t) (sequence >> (8 * i));
+    }
+    entry[4] = (uint8_t) size;
+    entry[5] = (uint8_t) (size >> 8);
+    entry[6] = keyframe? SNEK8_STREAM_KEYFRAME: SNEK8_STREAM_DELTA;
+    entry[7] = rows;
+    uint64_t head = atomic_load_explicit(&stream->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&stream->tail, memory_order_acquire);
+    if (head - tail + size > stream->capacity){
+        atomic_fetch_add_explicit(&stream->dropped, 1, memory_order_relaxed);
+        stream->resync = true;
+        return false;
+    }
+    _snek8_streamWrite(stream, head, entry, size);
+    atomic_store_explicit(&stream->head, head + size, memory_order_release);
+    stream->resync = false;
+    stream->since_keyframe = keyframe? 1: stream->since_keyframe + 1;
+    return true;
+}
+
+size_t
+snek8_streamRead(Snek8Stream* stream, uint8_t* data, size_t size){
+    uint64_t tail = atomic_load_explicit(&stream->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&stream->head, memory_order_acquire);
+    size_t copied = 0;
+    while (tail < head){
+        uint8_t header[SNEK8_STREAM_SIZE_HEADER];
+        _snek8_streamCopy(stream, tail, header, SNEK8_STREAM_SIZE_HEADER);
+        size_t frame = (size_t) header[4] | ((size_t) header[5] << 8);
+        if (frame > size - copied){
+            break;
+        }
+        _snek8_streamCopy(stream, tail, data + copied, frame);
+        copied += frame;
+        tail += frame;
+    }
+    atomic_store_explicit(&stream->tail, tail, memory_order_release);
+    return copied;
+}
+
+size_t
+snek8_streamDecode(uint64_t* graphics, const uint8_t* data, size_t size){
+    if (size < SNEK8_STREAM_SIZE_HEADER){
+        return 0;
+    }
+    size_t frame = (size_t) data[4] | ((size_t) data[5] << 8);
+    if (frame < SNEK8_STREAM_SIZE_HEADER || frame > size || data[6] > SNEK8_STREAM_DELTA){
+        return 0;
+    }
+    uint64_t rows[SNEK8_GRAPHICS_HEIGTH];
+    if (SNEK8_STREAM_KEYFRAME == data[6]){
+        (void) memset(rows, 0, sizeof(rows));
+    }else{
+        (void) memcpy(rows, graphics, sizeof(rows));
+    }
+    size_t at = SNEK8_STREAM_SIZE_HEADER;
+    for (uint8_t i = 0; i < data[7]; i++){
+        if (frame - at < 2 || data[at] >= SNEK8_GRAPHICS_HEIGTH){
+            return 0;
+        }
+        uint8_t row = data[at];
+        uint8_t mask = data[at + 1];
+        at += 2;
+        uint64_t diff = 0;
+        for (uint8_t byte = 0; byte < 8; byte++){
+            if ((mask >> byte) & 0x1u){
+                if (at == frame){
+                    return 0;
+                }
+                diff |= (uint64_t) data[at++] << (56 - 8 * byte);
+            }
+        }
+        rows[row] ^= diff;
+    }
+    if (at != frame){
+        return 0;
+    }
+    (void) memcpy(graphics, rows, sizeof(rows));
+    return frame;
+}
+
+#ifdef __cplusplus
+    }
+#endif
+#endif // SNEK8_STREAM_C
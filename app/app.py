@@ -7,6 +7,7 @@ PARENT_DIR: str = 'snek8'
 """
 import os
 import sys
+from array import array
 from snek8 import core as snek8core
 from main_window import Snek8MainWindow
 from screen import Snek8Screen
@@ -14,7 +15,7 @@ from typing import List, Dict, Callable
 from PyQt6.QtWidgets import QApplication, QFileDialog
 from PyQt6.QtGui import QIcon, QGuiApplication
 from PyQt6.QtCore import Qt, QBasicTimer, QTimer
-from PyQt6.QtMultimedia import QSoundEffect
+from PyQt6.QtMultimedia import QAudioFormat, QAudioSink, QMediaDevices
 
 
 class Snek8App(QApplication):
@@ -38,6 +39,7 @@ class Snek8App(QApplication):
     is_paused: bool = NotImplemented
     timer: QTimer = NotImplemented
     fps: int = NotImplemented
+    ips: int = NotImplemented
 
     @property
     def STATUS_BAR_DEFAULT(self) -> str:
@@ -129,6 +131,7 @@ class Snek8App(QApplication):
             Qt.Key.Key_P: lambda: self.pause(),
             Qt.Key.Key_Escape: lambda: self.snek8_main_win.close(),
             Qt.Key.Key_L: lambda: self.loadRom(),
+            Qt.Key.Key_Backspace: lambda: self.rewind(),
         }
 
     @property
@@ -145,7 +148,7 @@ class Snek8App(QApplication):
         self.initUI()
         self.snek8_main_win.show()
         self.timer.timeout.connect(self.emulate)
-        self.timer.start(1)
+        self.timer.start(1000 // self.fps)
         # self.emulate()
 
     def initUI(self) -> None:
@@ -156,7 +159,7 @@ class Snek8App(QApplication):
         self.snek8_main_win.centerWindowOnScreen(QGuiApplication.primaryScreen().geometry().width(),
                                            QGuiApplication.primaryScreen().geometry().height())
         self.snek8_main_win.setKeys(self.CPU_KEY_MAP, self.APP_KEY_MAP)
-        self.snek8_screen = Snek8Screen(self.snek8_main_win, self.snek8_emulator.isPixelActive)
+        self.snek8_screen = Snek8Screen(self.snek8_main_win, self.snek8_emulator)
         self.snek8_main_win.setCentralWidget(self.snek8_screen)
         self.setStatusBarDefualt()
         self.initMenus()
@@ -167,8 +170,27 @@ class Snek8App(QApplication):
         self.snek8_impl_fx_changes_ir = False
         self.timer = QTimer()
         self.is_paused = False
-        self.fps = 120
-        self.snek8_emulator = snek8core.Snek8Emulator(implm_flags = 0)
+        self.fps = snek8core.TIMER_FREQUENCY
+        self.ips = 1000
+        self.rewind_budget = 1 << 22
+        self.snek8_emulator = snek8core.Snek8Emulator(implm_flags = 0, ips = self.ips)
+        self.snek8_emulator.setRewindBudget(self.rewind_budget)
+        self.snek8_state = None
+        self.initAudio()
+
+    def initAudio(self) -> None:
+        # The core writes the buzzer into the ring as it runs, a tenth of a second of
+        # samples is plenty between two frames of the timer.
+        self.audio_rate = snek8core.AUDIO_DEFAULT_RATE
+        self.audio_ring = array('h', bytes(2 * (self.audio_rate // 10)))
+        self.audio_position = 0
+        self.snek8_emulator.setAudioBuffer(self.audio_ring, rate = self.audio_rate)
+        audio_format = QAudioFormat()
+        audio_format.setSampleRate(self.audio_rate)
+        audio_format.setChannelCount(1)
+        audio_format.setSampleFormat(QAudioFormat.SampleFormat.Int16)
+        self.audio_sink = QAudioSink(QMediaDevices.defaultAudioOutput(), audio_format)
+        self.audio_device = self.audio_sink.start()
 
     def initMenus(self) -> None:
         # File menu
@@ -180,6 +202,7 @@ class Snek8App(QApplication):
         self.snek8_main_win.addMenuItem("Options", "Reset", self.resetEmulation)
         self.snek8_main_win.addMenuItem("Options", "Pause", self.pause)
         self.snek8_main_win.addMenuItem("Options", "Save state", self.saveState)
+        self.snek8_main_win.addMenuItem("Options", "Load state", self.loadState)
         # Implementation
         self.snek8_main_win.addMenu("Implementation")
         self.snek8_main_win.addCheckMenu('Implementation', "Shifts use VY", self.implmModeShifts)
@@ -193,8 +216,20 @@ class Snek8App(QApplication):
     def showError(self, err_msg: str) -> None:
         pass
 
-    def handleSound(self, soundtimer: int) -> None:
-        pass
+    def handleSound(self) -> None:
+        position = self.snek8_emulator.getAudioPosition()
+        capacity = len(self.audio_ring)
+        # Drop what the sink cannot take anymore rather than lagging behind.
+        start = max(self.audio_position, position - capacity)
+        self.audio_position = position
+        if self.audio_device is None or start == position:
+            return
+        first, last = start % capacity, position % capacity
+        if first < last:
+            samples = self.audio_ring[first:last]
+        else:
+            samples = self.audio_ring[first:] + self.audio_ring[:last]
+        self.audio_device.write(samples.tobytes())
 
     def setStatusBarPaused(self) -> None:
         self.snek8_main_win.status_bar.setText(self.STATUS_BAR_PAUSED)
@@ -266,7 +301,7 @@ class Snek8App(QApplication):
     def emulate(self) -> None:
         if self.is_paused or (not self.snek8_emulator.is_running):
             return
-        out: int = self.snek8_emulator.emulationStep()
+        _, _, out = self.snek8_emulator.emulationFrame(break_on = 0)
         match out:
             case snek8core.EXECOUT_SUCCESS:
                 pass
@@ -280,24 +315,32 @@ class Snek8App(QApplication):
                 pass
             case _:
                 pass
-        self.handleSound(self.snek8_emulator.getST())
-        self.snek8_screen.update()
+        self.handleSound()
+        self.snek8_screen.refresh()
 
     def resetEmulation(self) -> None:
-        del(self.snek8_emulator)
-        impl_flags = 0
-        if self.snek8_impl_shifts_use_vy:
-            impl_flags |= 1
-        if self.snek8_impl_bnnn_uses_vx:
-            impl_flags |= (1 << 1)
-        if self.snek8_impl_fx_changes_ir:
-            impl_flags |= (1 << 2)
-        self.snek8_emulator = snek8core.Snek8Emulator(implm_flags = impl_flags)
-        self.snek8_screen.update()
+        # The implementation flags, kept by reset, follow the menu's check boxes.
+        self.snek8_emulator.reset(keep_rom = False)
         self.setStatusBarDefualt()
 
     def saveState(self) -> None:
-        pass
+        if not self.snek8_emulator.is_running:
+            return
+        self.snek8_state = self.snek8_emulator.saveState(into = self.snek8_state)
+
+    def loadState(self) -> None:
+        if self.snek8_state is None:
+            return
+        if self.snek8_emulator.loadState(self.snek8_state) == snek8core.EXECOUT_SUCCESS:
+            self.snek8_screen.setEmulator(self.snek8_emulator)
+            if self.is_paused:
+                self.setStatusBarPaused()
+            else:
+                self.setStatusBarRunning()
+
+    def rewind(self) -> None:
+        if self.snek8_emulator.rewind(self.fps):
+            self.snek8_screen.setEmulator(self.snek8_emulator)
 
     def showKeyBoardMap(self) -> None:
         pass
@@ -5,9 +5,9 @@
 @brief: Implementation of the emulator' display.
 """
 
-from typing import List, Annotated, Callable
-from snek8.core import SIZE_GRAPHICS_WIDTH, SIZE_GRAPHICS_HEIGHT, SIZE_GRAPHICS
-from PyQt6.QtGui import QColor, QPainter, QPaintEvent
+from typing import List, Annotated
+from snek8.core import SIZE_GRAPHICS_WIDTH, SIZE_GRAPHICS_HEIGHT, SIZE_GRAPHICS, Snek8Emulator
+from PyQt6.QtGui import QColor, QImage, QPainter, QPaintEvent
 from PyQt6.QtWidgets import QWidget, QFrame
 
 class Snek8Screen(QFrame):
@@ -19,11 +19,19 @@ class Snek8Screen(QFrame):
     parent: QWidget
         The QT widget that controls the screen. In our implementation, this
         would be the main window.
+    emulator: Snek8Emulator
+        The emulator whose screen is displayed.
 
     Attributes
     ----------
     snek8_screen: Annotaded[List[int], SIZE_GRAPHICS]
         The array representation of CHIP8's screen.
+    snek8_emulator: Snek8Emulator
+        The emulator whose screen is displayed.
+    snek8_image: QImage
+        The emulator's screen at SIZE_PIXEL scale, rendered by the emulator's blitter.
+    snek8_image_bits: sip.voidptr
+        The writable pixels of snek8_image.
     COLOUR_BCKG: QColor
         The background color to display.
     COLOUR_FRGR: QColor
@@ -33,13 +41,64 @@ class Snek8Screen(QFrame):
         in the app as a SIZE_PIXEL x SIZE_PIXEL square.
     """
     snek8_screen: Annotated[List[int], SIZE_GRAPHICS] = NotImplemented
-    snek8_lookup_fun: Callable[[int, int], bool]
+    snek8_emulator: Snek8Emulator
+    snek8_image: QImage
 
-    def __init__(self, parent: QWidget, lookup_fun: Callable[[int, int], bool]) -> None:
+    def __init__(self, parent: QWidget, emulator: Snek8Emulator) -> None:
         super().__init__(parent)
-        self.snek8_lookup_fun = lookup_fun
+        self.snek8_image = QImage(SIZE_GRAPHICS_WIDTH * self.SIZE_PIXEL,
+                                  SIZE_GRAPHICS_HEIGHT * self.SIZE_PIXEL,
+                                  QImage.Format.Format_ARGB32)
+        self.snek8_image_bits = self.snek8_image.bits()
+        self.snek8_image_bits.setsize(self.snek8_image.sizeInBytes())
+        self.setEmulator(emulator)
         # self.clearScreen()
 
+    def setEmulator(self, emulator: Snek8Emulator) -> None:
+        """
+        Display the screen of another emulator.
+        """
+        self.snek8_emulator = emulator
+        self.snek8_emulator.getDamage()
+        self.blitRows(0xFFFFFFFF)
+        self.update()
+
+    def blitRows(self, rows: int) -> None:
+        """
+        Render the given rows (a mask, the bit y standing for the row y) of the
+        emulator's screen into snek8_image.
+        """
+        self.snek8_emulator.blit(self.snek8_image_bits,
+                                 scale = self.SIZE_PIXEL,
+                                 foreground = self.COLOUR_FRGR.rgba(),
+                                 background = self.COLOUR_BCKG.rgba(),
+                                 stride = self.snek8_image.bytesPerLine(),
+                                 rows = rows)
+
+    def refresh(self) -> None:
+        """
+        Schedule the repaint of the rows the emulator modified since the last call.
+
+        Each run of consecutive damaged rows is scheduled as a single rectangle; nothing
+        is scheduled if the screen did not change.
+        """
+        damage = self.snek8_emulator.getDamage()
+        if damage:
+            self.blitRows(damage)
+        y = 0
+        while damage:
+            if not damage & 1:
+                skip = (damage & -damage).bit_length() - 1
+                damage >>= skip
+                y += skip
+            height = (~damage & (damage + 1)).bit_length() - 1
+            self.update(0,
+                        y * self.SIZE_PIXEL,
+                        SIZE_GRAPHICS_WIDTH * self.SIZE_PIXEL,
+                        height * self.SIZE_PIXEL)
+            damage >>= height
+            y += height
+
     @property
     def COLOUR_BCKG(self) -> QColor:
         return QColor(0, 0, 0)
@@ -70,31 +129,10 @@ class Snek8Screen(QFrame):
 
     def paintEvent(self, a0: QPaintEvent | None) -> None:
         """
-        Draw the screen.
+        Draw the region to repaint from the rendered screen.
         """
-        _ = a0
         painter = QPainter(self)
-        painter.eraseRect(0, 0, SIZE_GRAPHICS_WIDTH, SIZE_GRAPHICS_HEIGHT)
-        for y in range(SIZE_GRAPHICS_HEIGHT):
-            for x in range(SIZE_GRAPHICS_WIDTH):
-                if self.snek8_lookup_fun(x, y):
-                    colour = self.COLOUR_FRGR
-                else:
-                    colour = self.COLOUR_BCKG
-                painter.fillRect(x * self.SIZE_PIXEL,
-                                  y * self.SIZE_PIXEL,
-                                  self.SIZE_PIXEL,
-                                  self.SIZE_PIXEL,
-                                  colour)
-
-
-                
-                # if self.snek8_screen[y * SIZE_GRAPHICS_WIDTH + x]:
-                #     colour = self.COLOUR_FRGR
-                # else:
-                #     colour = self.COLOUR_BCKG
-                # painter.fillRect(x * self.SIZE_PIXEL,
-                #                   y * self.SIZE_PIXEL,
-                #                   self.SIZE_PIXEL,
-                #                   self.SIZE_PIXEL,
-                #                   colour)
+        if a0 is None:
+            painter.drawImage(0, 0, self.snek8_image)
+        else:
+            painter.drawImage(a0.rect(), self.snek8_image, a0.rect())
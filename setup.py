@@ -5,12 +5,23 @@
 @brief Building script for the package.
 """
 
-from setuptools import setup, Extension
+from setuptools import setup, Extension, Command
+from setuptools.command.build_ext import build_ext
 import os
+import shlex
+import subprocess
 import sys
 
 PARENT_DIR: str = 'app/'
 
+BENCH_SOURCES: list[str] = [
+    os.path.join(PARENT_DIR, '_core/src/cpu.c'),
+    os.path.join(PARENT_DIR, '_core/src/block.c'),
+    os.path.join(PARENT_DIR, '_core/src/batch.c'),
+    os.path.join(PARENT_DIR, '_core/src/rom.c'),
+    os.path.join(PARENT_DIR, '_core/bench/bench.c'),
+]
+
 def read(filename: str) -> str:
     return open(os.path.join(os.path.dirname(__file__), filename)).read()
 
@@ -21,6 +32,17 @@ if os.name != 'nt':
         name = 'snek8.core',
         sources = [
             os.path.join(PARENT_DIR, '_core/src/cpu.c'),
+            os.path.join(PARENT_DIR, '_core/src/block.c'),
+            os.path.join(PARENT_DIR, '_core/src/batch.c'),
+            os.path.join(PARENT_DIR, '_core/src/rewind.c'),
+            os.path.join(PARENT_DIR, '_core/src/replay.c'),
+            os.path.join(PARENT_DIR, '_core/src/rom.c'),
+            os.path.join(PARENT_DIR, '_core/src/blit.c'),
+            os.path.join(PARENT_DIR, '_core/src/ext.c'),
+            os.path.join(PARENT_DIR, '_core/src/disasm.c'),
+            os.path.join(PARENT_DIR, '_core/src/audio.c'),
+            os.path.join(PARENT_DIR, '_core/src/stream.c'),
+            os.path.join(PARENT_DIR, '_core/src/debug.c'),
             os.path.join(PARENT_DIR, '_core/src/core.c'),
         ],
         include_dirs = [
@@ -42,7 +64,18 @@ else:
         name = "snek8.core",
         sources = [
             os.path.join(PARENT_DIR, '_core/src/cpu.c'),
-            os.path.join(PARENT_DIR, '_core/src/emulator.c'),
+            os.path.join(PARENT_DIR, '_core/src/block.c'),
+            os.path.join(PARENT_DIR, '_core/src/batch.c'),
+            os.path.join(PARENT_DIR, '_core/src/rewind.c'),
+            os.path.join(PARENT_DIR, '_core/src/replay.c'),
+            os.path.join(PARENT_DIR, '_core/src/rom.c'),
+            os.path.join(PARENT_DIR, '_core/src/blit.c'),
+            os.path.join(PARENT_DIR, '_core/src/ext.c'),
+            os.path.join(PARENT_DIR, '_core/src/disasm.c'),
+            os.path.join(PARENT_DIR, '_core/src/audio.c'),
+            os.path.join(PARENT_DIR, '_core/src/stream.c'),
+            os.path.join(PARENT_DIR, '_core/src/debug.c'),
+            os.path.join(PARENT_DIR, '_core/src/core.c'),
         ],
         include_dirs = os.path.join(PARENT_DIR, '_core/include/'),
         language = 'c',
@@ -57,6 +90,57 @@ else:
         ],
     )
 
+class BenchCompiler(build_ext):
+    """
+    @brief build_ext, which sets up a compiler for the platform and the interpreter,
+    handing that compiler to `on_compiler` instead of building the extensions.
+    """
+    on_compiler = None
+
+    def build_extensions(self) -> None:
+        self.on_compiler(self.compiler)
+
+class BenchCommand(Command):
+    """
+    @brief Builds the native benchmark harness, which links the CPU sources without
+    Python, and optionally runs it (see app/_core/bench/bench.c for its options and
+    its JSON output).
+    """
+    description = 'build (and optionally run) the native benchmark harness'
+    user_options = [
+        ('build-dir=', 'b', 'directory of the executable [default: build/bench]'),
+        ('run-bench', 'r', 'run the benchmark once it is built'),
+        ('bench-args=', 'a', 'arguments of the run, e.g. "-c 50 -e threaded,block rom.ch8"'),
+    ]
+    boolean_options = ['run-bench']
+
+    def initialize_options(self) -> None:
+        self.build_dir = None
+        self.run_bench = False
+        self.bench_args = ''
+
+    def finalize_options(self) -> None:
+        if self.build_dir is None:
+            self.build_dir = os.path.join('build', 'bench')
+
+    def run(self) -> None:
+        builder = BenchCompiler(self.distribution)
+        builder.on_compiler = self.build_bench
+        builder.ensure_finalized()
+        builder.run()
+
+    def build_bench(self, compiler) -> None:
+        objects = compiler.compile(
+            BENCH_SOURCES,
+            output_dir = self.build_dir,
+            include_dirs = [os.path.join(PARENT_DIR, '_core/include/')],
+            extra_postargs = snek8_core.extra_compile_args,
+        )
+        compiler.link_executable(objects, 'snek8-bench', output_dir = self.build_dir)
+        if self.run_bench:
+            executable = os.path.join(self.build_dir, compiler.executable_filename('snek8-bench'))
+            subprocess.check_call([executable] + shlex.split(self.bench_args))
+
 setup(
     name = 'snek8',
     version = '0.1',
@@ -68,6 +152,7 @@ setup(
     license = 'GPL-3',
     url = 'https://github.com/paulomarruda/snek8/',
     ext_modules = [snek8_core],
+    cmdclass = {'bench': BenchCommand},
     packages = ['snek8'],
     package_dir = {'snek8': PARENT_DIR},
     python_requires = '>=3.13',